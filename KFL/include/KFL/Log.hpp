@@ -33,11 +33,81 @@
 
 #pragma once
 
+#include <KFL/Types.hpp>
+
+#include <atomic>
+#include <cstdarg>
+
 namespace KlayGE
 {
+	enum LogLevel
+	{
+		LL_Info,
+		LL_Warn,
+		LL_Error,
+
+		// Only for LogMinLevel, turns off all the messages
+		LL_None
+	};
+
+	enum LogCategory
+	{
+		LC_General = 1UL << 0,
+		LC_Resource = 1UL << 1,
+		LC_Shader = 1UL << 2,
+		LC_Render = 1UL << 3,
+		LC_Audio = 1UL << 4,
+		LC_Input = 1UL << 5,
+		LC_Network = 1UL << 6,
+		LC_Script = 1UL << 7,
+
+		LC_All = 0xFFFFFFFF
+	};
+
+	// Messages are formatted on the calling thread into a ring of that thread, and written out by a background thread.
+	//  A message longer than 1023 characters is truncated. When the ring is full, the message is dropped and counted.
+	//  Errors are never dropped, LogError returns after the message is written.
 	void LogInfo(char const * fmt, ...);
 	void LogWarn(char const * fmt, ...);
 	void LogError(char const * fmt, ...);
+	void LogMessage(LogLevel level, uint32_t category, char const * fmt, ...);
+
+	// Filtered messages cost a couple of atomic loads, nothing is formatted
+	void LogMinLevel(LogLevel level);
+	LogLevel LogMinLevel();
+	void LogCategoryMask(uint32_t mask);
+	uint32_t LogCategoryMask();
+
+	// Blocks until all the messages logged before are written
+	void LogFlush();
+	uint64_t LogNumDropped();
+
+	// Writes out the queued messages and joins the background thread. Has to be called before the module is unloaded,
+	//  after the other threads stop logging. DllLoader::Free does it for the module it loaded. Messages logged later
+	//  are written synchronously.
+	void LogShutdown();
+
+	// The filters and the sink a module logs through. Each module linking KFL has its own logger, whose background
+	//  thread starts with the first message. DllLoader::Load hands the host of the loading module to the loaded one,
+	//  so all the modules share one filter setting and one background thread.
+	struct LogHost
+	{
+		std::atomic<int>* min_level;
+		std::atomic<uint32_t>* category_mask;
+		void (*vlog)(LogLevel level, uint32_t category, char const * fmt, va_list args);
+		void (*flush)();
+		uint64_t (*num_dropped)();
+	};
+
+	LogHost const * LogModuleHost();
+}
+
+extern "C"
+{
+	// Exported from every module that logs. The loader attaches a module to its own host after loading it, and shuts
+	//  down the logger of the module before unloading it. A nullptr host detaches the module.
+	KLAYGE_SYMBOL_EXPORT void KFLLogAttach(KlayGE::LogHost const * host);
+	KLAYGE_SYMBOL_EXPORT void KFLLogShutdown();
 }
 
 #endif		// _KFL_LOG_HPP
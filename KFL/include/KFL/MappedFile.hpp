@@ -0,0 +1,78 @@
+/**
+ * @file MappedFile.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KFL_MAPPEDFILE_HPP
+#define _KFL_MAPPEDFILE_HPP
+
+#pragma once
+
+#include <string>
+#include <boost/noncopyable.hpp>
+
+namespace KlayGE
+{
+	// A read-only view of a whole file mapped into the address space.
+	// On POSIX systems another process can still truncate the file while it's mapped, and touching the pages past the
+	//  new end raises SIGBUS. Intact() re-checks the size, so readers can stop using the mapping before that happens.
+	//  It can't help with a truncation between the check and the access. Windows doesn't allow truncating a mapped file.
+	class MappedFile : boost::noncopyable
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		// Returns false if the file can't be mapped, for example if it's empty
+		bool Map(std::string const & file_name);
+		void Unmap();
+
+		void const * Data() const
+		{
+			return data_;
+		}
+		uint64_t Size() const
+		{
+			return size_;
+		}
+
+		// False if the file is now shorter than the mapping
+		bool Intact() const;
+
+	private:
+		void const * data_;
+		uint64_t size_;
+
+		void* file_handle_;
+		void* mapping_handle_;
+		// Kept open on POSIX systems to re-check the size
+		int fd_;
+	};
+}
+
+#endif		// _KFL_MAPPEDFILE_HPP
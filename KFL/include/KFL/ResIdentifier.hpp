@@ -34,6 +34,9 @@
 #pragma once
 
 #include <KFL/PreDeclare.hpp>
+#include <KFL/CustomizedStreamBuf.hpp>
+#include <KFL/MappedFile.hpp>
+#include <fstream>
 #include <istream>
 #include <vector>
 #include <string>
@@ -45,14 +48,39 @@ namespace KlayGE
 	public:
 		ResIdentifier(std::string const & name, uint64_t timestamp,
 				std::shared_ptr<std::istream> const & is)
-			: res_name_(name), timestamp_(timestamp), istream_(is)
+			: res_name_(name), timestamp_(timestamp), istream_(is),
+				data_(nullptr), size_(0)
 		{
 		}
 		ResIdentifier(std::string const & name, uint64_t timestamp,
 				std::shared_ptr<std::istream> const & is, std::shared_ptr<std::streambuf> const & streambuf)
-			: res_name_(name), timestamp_(timestamp), istream_(is), streambuf_(streambuf)
+			: res_name_(name), timestamp_(timestamp), istream_(is), streambuf_(streambuf),
+				data_(nullptr), size_(0)
 		{
 		}
+		// A resource backed by a contiguous block of memory, such as a mapped file or a decoded buffer.
+		//  The owner keeps the memory alive as long as the resource.
+		ResIdentifier(std::string const & name, uint64_t timestamp,
+				void const * data, uint64_t size, std::shared_ptr<void> const & owner)
+			: res_name_(name), timestamp_(timestamp),
+				streambuf_(std::make_shared<MemStreamBuf>(data, static_cast<uint8_t const *>(data) + size)),
+				data_(static_cast<uint8_t const *>(data)), size_(size), owner_(owner)
+		{
+			istream_ = std::make_shared<std::istream>(streambuf_.get());
+		}
+		// A resource backed by a mapped file. read() and read_in_place() re-check the file first. If it was truncated,
+		//  the resource falls back to reading file_name as a stream from the same position, which fails at the new end
+		//  instead of crashing. Pointers that were handed out earlier, and data(), are not protected.
+		ResIdentifier(std::string const & name, uint64_t timestamp,
+				std::string const & file_name, std::shared_ptr<MappedFile> const & mapped_file)
+			: res_name_(name), timestamp_(timestamp),
+				streambuf_(std::make_shared<MemStreamBuf>(mapped_file->Data(),
+					static_cast<uint8_t const *>(mapped_file->Data()) + mapped_file->Size())),
+				data_(static_cast<uint8_t const *>(mapped_file->Data())), size_(mapped_file->Size()), owner_(mapped_file),
+				file_name_(file_name), mapped_file_(mapped_file)
+		{
+			istream_ = std::make_shared<std::istream>(streambuf_.get());
+		}
 
 		void ResName(std::string const & name)
 		{
@@ -74,9 +102,27 @@ namespace KlayGE
 
 		void read(void* p, size_t size)
 		{
+			this->CheckMapping();
 			istream_->read(static_cast<char*>(p), static_cast<std::streamsize>(size));
 		}
 
+		// Returns the next size bytes without copying them, and moves the read position past them. Returns nullptr
+		//  if the resource isn't backed by memory, or has less than size bytes left.
+		void const * read_in_place(size_t size)
+		{
+			this->CheckMapping();
+			if (data_ && *istream_)
+			{
+				int64_t const pos = this->tellg();
+				if ((pos >= 0) && (static_cast<uint64_t>(pos) + size <= size_))
+				{
+					this->seekg(static_cast<int64_t>(size), std::ios_base::cur);
+					return data_ + pos;
+				}
+			}
+			return nullptr;
+		}
+
 		int64_t gcount() const
 		{
 			return static_cast<int64_t>(istream_->gcount());
@@ -112,11 +158,56 @@ namespace KlayGE
 			return *istream_;
 		}
 
+		// The whole content of a memory backed resource, or nullptr for a stream only resource
+		void const * data() const
+		{
+			return data_;
+		}
+		uint64_t size() const
+		{
+			return size_;
+		}
+
+	private:
+		void CheckMapping()
+		{
+			if (mapped_file_ && !mapped_file_->Intact())
+			{
+				int64_t const pos = this->tellg();
+				bool const good = !!*istream_;
+
+				// The static_cast is a workaround for a bug in clang/c2
+				istream_ = std::make_shared<std::ifstream>(file_name_.c_str(),
+					static_cast<std::ios_base::openmode>(std::ios_base::binary));
+				if (good && (pos >= 0))
+				{
+					istream_->seekg(static_cast<std::istream::off_type>(pos), std::ios_base::beg);
+				}
+				else
+				{
+					istream_->setstate(std::ios_base::failbit);
+				}
+				streambuf_.reset();
+				data_ = nullptr;
+				size_ = 0;
+
+				// owner_ keeps the mapping, for the pointers handed out already
+				mapped_file_.reset();
+			}
+		}
+
 	private:
 		std::string res_name_;
 		uint64_t timestamp_;
 		std::shared_ptr<std::istream> istream_;
 		std::shared_ptr<std::streambuf> streambuf_;
+
+		uint8_t const * data_;
+		uint64_t size_;
+		std::shared_ptr<void> owner_;
+
+		std::string file_name_;
+		std::shared_ptr<MappedFile> mapped_file_;
 	};
 }
 
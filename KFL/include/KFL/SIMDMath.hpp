@@ -34,6 +34,7 @@
 #pragma once
 
 #include <KFL/PreDeclare.hpp>
+#include <KFL/Math.hpp>
 
 #if defined(KLAYGE_SSE_SUPPORT) && !defined(KLAYGE_COMPILER_CLANGC2)
 	#define SIMD_MATH_SSE
@@ -252,6 +253,19 @@ namespace KlayGE
 		void ObliqueClipping(SIMDMatrixF4& proj, SIMDVectorF4 const & clip_plane);
 
 
+		// Bound
+		///////////////////////////////////////////////////////////////////////////////
+		// Intersects num AABBs, given as arrays of centers and half sizes, with a frustum. 4 AABBs are tested at a time.
+		void IntersectAABBFrustum(BoundOverlap* overlaps, float const * center_x, float const * center_y, float const * center_z,
+			float const * extent_x, float const * extent_y, float const * extent_z, size_t num, Frustum const & frustum);
+
+		// Array
+		///////////////////////////////////////////////////////////////////////////////
+		// dst[i] += src[i] * s, for num floats
+		void MultiplyAddArray(float* dst, float const * src, float s, size_t num);
+		// Sum of num 4D vectors packed in src, each scaled by its weight. dst receives 4 floats.
+		void WeightedSumVector4(float* dst, float const * src, float const * weights, size_t num);
+
 		// Color
 		///////////////////////////////////////////////////////////////////////////////
 		SIMDVectorF4 NegativeColor(SIMDVectorF4 const & rhs);
@@ -0,0 +1,230 @@
+/**
+ * @file TaskScheduler.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KFL_TASKSCHEDULER_HPP
+#define _KFL_TASKSCHEDULER_HPP
+
+#pragma once
+
+#include <boost/assert.hpp>
+#include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <deque>
+
+namespace KlayGE
+{
+	class task_scheduler;
+
+	namespace detail
+	{
+		struct task;
+		class work_stealing_deque;
+	}
+
+	// A reference counted handle to a task submitted to a task_scheduler. An empty handle is treated as a finished task.
+	class task_handle
+	{
+		friend class task_scheduler;
+
+	public:
+		task_handle();
+		task_handle(task_handle const & rhs);
+		task_handle(task_handle&& rhs);
+		~task_handle();
+
+		task_handle& operator=(task_handle const & rhs);
+		task_handle& operator=(task_handle&& rhs);
+
+		bool valid() const
+		{
+			return task_ != nullptr;
+		}
+
+		// Returns true if the task and its function have been executed
+		bool done() const;
+
+	private:
+		explicit task_handle(detail::task* t);
+
+	private:
+		detail::task* task_;
+	};
+
+	// A job system with one lock-free work-stealing deque per worker. Tasks can depend on other tasks, and are only
+	//  scheduled when all the prerequisites are finished. A thread waiting for a task executes other tasks while waiting,
+	//  so the main thread never blocks idly on a join.
+	class task_scheduler : boost::noncopyable
+	{
+	public:
+		// num_workers == 0 means one worker per hardware thread, minus the calling thread
+		explicit task_scheduler(uint32_t num_workers = 0);
+		~task_scheduler();
+
+		uint32_t num_workers() const
+		{
+			return static_cast<uint32_t>(workers_.size());
+		}
+
+		task_handle submit(std::function<void()> const & func);
+		task_handle submit(std::function<void()> const & func, task_handle const * deps, size_t num_deps);
+		task_handle submit(std::function<void()> const & func, std::vector<task_handle> const & deps)
+		{
+			return this->submit(func, deps.data(), deps.size());
+		}
+		// Runs func after prev is finished
+		task_handle continue_with(task_handle const & prev, std::function<void()> const & func)
+		{
+			return this->submit(func, &prev, 1);
+		}
+
+		// Waits until the task is finished, executing other tasks in the meantime. If the task's function threw,
+		//  the exception is rethrown here.
+		void wait(task_handle const & t);
+		// Waits until all the tasks are finished, even if some of them threw. The first exception is rethrown after that.
+		void wait_all(task_handle const * tasks, size_t num_tasks);
+		void wait_all(std::vector<task_handle> const & tasks)
+		{
+			this->wait_all(tasks.data(), tasks.size());
+		}
+
+		// Calls func(sub_begin, sub_end) over [begin, end) split into ranges of at least grain_size elements.
+		//  Returns after all the ranges are processed.
+		template <typename Func>
+		void parallel_for(uint32_t begin, uint32_t end, uint32_t grain_size, Func const & func)
+		{
+			if (begin >= end)
+			{
+				return;
+			}
+
+			uint32_t const chunk = this->chunk_size(end - begin, grain_size);
+			if (end - begin <= chunk)
+			{
+				func(begin, end);
+				return;
+			}
+
+			std::vector<task_handle> tasks;
+			tasks.reserve((end - begin + chunk - 1) / chunk);
+			for (uint32_t sub_begin = begin + chunk; sub_begin < end; sub_begin += chunk)
+			{
+				uint32_t const sub_end = std::min(sub_begin + chunk, end);
+				tasks.push_back(this->submit([&func, sub_begin, sub_end]
+					{
+						func(sub_begin, sub_end);
+					}));
+			}
+			try
+			{
+				func(begin, begin + chunk);
+			}
+			catch (...)
+			{
+				// The tasks reference func, so they have to be finished before unwinding
+				try
+				{
+					this->wait_all(tasks);
+				}
+				catch (...)
+				{
+				}
+				throw;
+			}
+			this->wait_all(tasks);
+		}
+
+		// Maps each range of [begin, end) with map_func(sub_begin, sub_end) -> T, then folds the partial results
+		//  in range order with reduce_func(T, T) -> T, so the result is deterministic.
+		template <typename T, typename MapFunc, typename ReduceFunc>
+		T parallel_reduce(uint32_t begin, uint32_t end, uint32_t grain_size, T const & identity,
+			MapFunc const & map_func, ReduceFunc const & reduce_func)
+		{
+			if (begin >= end)
+			{
+				return identity;
+			}
+
+			uint32_t const chunk = this->chunk_size(end - begin, grain_size);
+			uint32_t const num_chunks = (end - begin + chunk - 1) / chunk;
+			std::vector<T> partials(num_chunks, identity);
+			this->parallel_for(0, num_chunks, 1, [&](uint32_t chunk_begin, uint32_t chunk_end)
+				{
+					for (uint32_t i = chunk_begin; i < chunk_end; ++ i)
+					{
+						uint32_t const sub_begin = begin + i * chunk;
+						partials[i] = map_func(sub_begin, std::min(sub_begin + chunk, end));
+					}
+				});
+
+			T ret = identity;
+			for (auto const & partial : partials)
+			{
+				ret = reduce_func(ret, partial);
+			}
+			return ret;
+		}
+
+		// Index of the calling worker, or -1 if it's not a worker of this scheduler
+		int32_t current_worker_index() const;
+
+	private:
+		uint32_t chunk_size(uint32_t count, uint32_t grain_size) const;
+
+		void enqueue(detail::task* t);
+		detail::task* acquire_task(int32_t worker_index);
+		void execute(detail::task* t);
+		void finish(detail::task* t);
+		void worker_func(uint32_t index);
+
+	private:
+		std::vector<std::unique_ptr<detail::work_stealing_deque>> worker_queues_;
+		std::vector<std::thread> workers_;
+
+		// Tasks submitted from outside of workers, or overflowing a full worker deque
+		std::mutex global_queue_mutex_;
+		std::deque<detail::task*> global_queue_;
+
+		std::atomic<int32_t> num_pending_tasks_;
+		std::atomic<int32_t> num_sleeping_workers_;
+		std::mutex sleep_mutex_;
+		std::condition_variable sleep_cond_;
+		std::atomic<bool> quit_;
+	};
+}
+
+#endif		// _KFL_TASKSCHEDULER_HPP
@@ -37,6 +37,8 @@
 #include <dlfcn.h>
 #endif
 
+#include <KFL/Log.hpp>
+
 #include <KFL/DllLoader.hpp>
 
 namespace KlayGE
@@ -65,6 +67,17 @@ namespace KlayGE
 		dll_handle_ = ::dlopen(dll_name.c_str(), RTLD_LAZY);
 #endif
 
+		if (dll_handle_)
+		{
+			// The module logs through the logger of this one, instead of starting a background thread of its own
+			typedef void (*LogAttachFunc)(LogHost const * host);
+			LogAttachFunc log_attach = reinterpret_cast<LogAttachFunc>(this->GetProcAddress("KFLLogAttach"));
+			if (log_attach && (log_attach != &KFLLogAttach))
+			{
+				log_attach(LogModuleHost());
+			}
+		}
+
 		return (dll_handle_ != nullptr);
 	}
 
@@ -72,11 +85,21 @@ namespace KlayGE
 	{
 		if (dll_handle_)
 		{
+			// The logger thread of the module can't be joined in its static destructors, they run under the loader lock.
+			//  dlsym searches the dependencies too, so for a module without a logger it returns the one of this module.
+			typedef void (*LogShutdownFunc)();
+			LogShutdownFunc log_shutdown = reinterpret_cast<LogShutdownFunc>(this->GetProcAddress("KFLLogShutdown"));
+			if (log_shutdown && (log_shutdown != &KFLLogShutdown))
+			{
+				log_shutdown();
+			}
+
 #ifdef KLAYGE_PLATFORM_WINDOWS
 			::FreeLibrary(static_cast<HMODULE>(dll_handle_));
 #else
 			::dlclose(dll_handle_);
 #endif
+			dll_handle_ = nullptr;
 		}
 	}
 
@@ -30,8 +30,16 @@
 
 #include <KFL/KFL.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #ifdef KLAYGE_PLATFORM_ANDROID
 #include <android/log.h>
@@ -42,74 +50,557 @@
 
 #include <KFL/Log.hpp>
 
-#ifdef KLAYGE_DEBUG
-#ifndef KLAYGE_PLATFORM_ANDROID
 namespace
 {
-	std::ofstream log_file("KlayGE.log");
-}
+	using namespace KlayGE;
+
+	// Must be a power of 2
+	uint32_t const LOG_RING_SIZE = 128;
+	uint32_t const LOG_TEXT_SIZE = 1024;
+
+	std::chrono::seconds const REPEAT_REPORT_INTERVAL(1);
+
+	std::atomic<int> log_min_level(LL_Info);
+	std::atomic<uint32_t> log_category_mask(LC_All);
+
+	// Set by LogShutdown, the messages logged after it are written synchronously
+	std::atomic<bool> logger_stopped(false);
+	// The sink thread is started with the first message, not for every module linking KFL
+	std::atomic<bool> logger_created(false);
+
+	// The logger of the module that loaded this one, set by KFLLogAttach
+	std::atomic<LogHost const *> attached_host(nullptr);
+
+	struct LogEntry
+	{
+		uint64_t seq;
+		LogLevel level;
+		uint32_t category;
+		std::array<char, LOG_TEXT_SIZE> text;
+	};
+
+	// Written only by the owner thread, read only by the sink thread
+	struct LogRing
+	{
+		std::array<LogEntry, LOG_RING_SIZE> entries;
+		std::atomic<uint32_t> head;
+		std::atomic<uint32_t> tail;
+		std::atomic<bool> retired;
+	};
+
+	// The ring is shared with the sink, so the messages of an exiting thread are still written
+	struct ThreadLogRing
+	{
+		~ThreadLogRing()
+		{
+			if (ring)
+			{
+				ring->retired.store(true, std::memory_order_release);
+			}
+		}
+
+		std::shared_ptr<LogRing> ring;
+	};
+
+	thread_local ThreadLogRing tls_log_ring;
+
+	class Logger
+	{
+	public:
+		Logger()
+			: seq_(0), num_pending_(0), num_dropped_(0),
+				wake_(false), quit_(false), flush_request_(0), flushed_(0),
+				num_reported_dropped_(0), has_last_(false), last_level_(LL_Info), last_category_(0), num_repeats_(0)
+#if defined(KLAYGE_DEBUG) && !defined(KLAYGE_PLATFORM_ANDROID)
+				, log_file_("KlayGE.log")
 #endif
+		{
+			sink_thread_ = std::thread(&Logger::SinkFunc, this);
+			logger_created.store(true, std::memory_order_release);
+		}
+
+		// Never joins the sink thread in a static destructor. It runs under the loader lock when a module is unloaded,
+		//  and the exiting sink thread needs that lock too. Shutdown has to be called before.
+		~Logger() = delete;
+
+		void Shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(sink_mutex_);
+				quit_ = true;
+			}
+			sink_cv_.notify_one();
+			sink_thread_.join();
+		}
+
+		void VLog(LogLevel level, uint32_t category, char const * fmt, va_list args)
+		{
+			LogRing& ring = this->ThreadRing();
+			uint32_t const head = ring.head.load(std::memory_order_relaxed);
+			uint32_t tail = ring.tail.load(std::memory_order_acquire);
+			if (head - tail >= LOG_RING_SIZE)
+			{
+				if (level < LL_Error)
+				{
+					// Reported by the sink after it drains the ring
+					num_dropped_.fetch_add(1, std::memory_order_relaxed);
+					this->MessagePending();
+					return;
+				}
+
+				this->Flush();
+				tail = ring.tail.load(std::memory_order_acquire);
+			}
+
+			LogEntry& entry = ring.entries[head & (LOG_RING_SIZE - 1)];
+			entry.level = level;
+			entry.category = category;
+			vsnprintf(&entry.text[0], entry.text.size(), fmt, args);
+			entry.seq = seq_.fetch_add(1, std::memory_order_relaxed);
+			ring.head.store(head + 1, std::memory_order_release);
+
+			if (level >= LL_Error)
+			{
+				this->Flush();
+			}
+			else
+			{
+				this->MessagePending();
+			}
+		}
+
+		void Flush()
+		{
+			std::unique_lock<std::mutex> lock(sink_mutex_);
+			if (quit_)
+			{
+				return;
+			}
+
+			uint64_t const request = ++ flush_request_;
+			sink_cv_.notify_one();
+			flushed_cv_.wait(lock, [this, request] { return flushed_ >= request; });
+		}
+
+		uint64_t NumDropped() const
+		{
+			return num_dropped_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		LogRing& ThreadRing()
+		{
+			if (!tls_log_ring.ring)
+			{
+				auto ring = std::make_shared<LogRing>();
+				ring->head.store(0, std::memory_order_relaxed);
+				ring->tail.store(0, std::memory_order_relaxed);
+				ring->retired.store(false, std::memory_order_relaxed);
+
+				std::lock_guard<std::mutex> lock(rings_mutex_);
+				rings_.push_back(ring);
+				tls_log_ring.ring = ring;
+			}
+			return *tls_log_ring.ring;
+		}
+
+		// Only the first message since the sink took the pending ones wakes it up
+		void MessagePending()
+		{
+			if (0 == num_pending_.fetch_add(1, std::memory_order_acq_rel))
+			{
+				this->WakeSink();
+			}
+		}
+
+		void WakeSink()
+		{
+			{
+				std::lock_guard<std::mutex> lock(sink_mutex_);
+				wake_ = true;
+			}
+			sink_cv_.notify_one();
+		}
+
+		// Sleeps until a message, a flush or the shutdown. Only a pending repeat count needs a timeout.
+		void SinkFunc()
+		{
+			std::unique_lock<std::mutex> lock(sink_mutex_);
+			for (;;)
+			{
+				auto const woken = [this]
+				{
+					return quit_ || (flush_request_ != flushed_) || wake_;
+				};
+				if (num_repeats_ > 0)
+				{
+					sink_cv_.wait_until(lock, last_repeat_report_ + REPEAT_REPORT_INTERVAL, woken);
+				}
+				else
+				{
+					sink_cv_.wait(lock, woken);
+				}
+				bool const quit = quit_;
+				uint64_t const request = flush_request_;
+				wake_ = false;
+				lock.unlock();
+
+				// The messages published before this are drained below. Any later one finds 0 and wakes the sink again.
+				num_pending_.exchange(0, std::memory_order_acq_rel);
+
+				this->Drain(quit);
+
+				lock.lock();
+				flushed_ = request;
+				flushed_cv_.notify_all();
+				if (quit)
+				{
+					break;
+				}
+			}
+		}
+
+		// Writes out the messages in all the rings in the order they are logged
+		void Drain(bool final_pass)
+		{
+			std::vector<std::shared_ptr<LogRing>> rings;
+			{
+				std::lock_guard<std::mutex> lock(rings_mutex_);
+				rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+					[](std::shared_ptr<LogRing> const & ring)
+					{
+						return ring->retired.load(std::memory_order_acquire)
+							&& (ring->head.load(std::memory_order_acquire) == ring->tail.load(std::memory_order_relaxed));
+					}), rings_.end());
+				rings = rings_;
+			}
+
+			pending_.clear();
+			heads_.resize(rings.size());
+			for (size_t i = 0; i < rings.size(); ++ i)
+			{
+				LogRing& ring = *rings[i];
+				uint32_t const tail = ring.tail.load(std::memory_order_relaxed);
+				heads_[i] = ring.head.load(std::memory_order_acquire);
+				for (uint32_t j = tail; j != heads_[i]; ++ j)
+				{
+					pending_.push_back(&ring.entries[j & (LOG_RING_SIZE - 1)]);
+				}
+			}
+			std::sort(pending_.begin(), pending_.end(),
+				[](LogEntry const * lhs, LogEntry const * rhs)
+				{
+					return lhs->seq < rhs->seq;
+				});
+
+			for (auto const * entry : pending_)
+			{
+				this->Write(entry->level, entry->category, &entry->text[0]);
+			}
+			for (size_t i = 0; i < rings.size(); ++ i)
+			{
+				rings[i]->tail.store(heads_[i], std::memory_order_release);
+			}
+
+			uint64_t const num_dropped = this->NumDropped();
+			if (num_dropped != num_reported_dropped_)
+			{
+				std::string const msg = std::to_string(num_dropped - num_reported_dropped_) + " log message(s) dropped";
+				this->Write(LL_Warn, LC_General, msg.c_str());
+				num_reported_dropped_ = num_dropped;
+			}
+
+			if ((num_repeats_ > 0)
+				&& (final_pass || (std::chrono::steady_clock::now() - last_repeat_report_ >= REPEAT_REPORT_INTERVAL)))
+			{
+				this->ReportRepeats();
+			}
+
+#ifndef KLAYGE_PLATFORM_ANDROID
+			if (!batch_.empty())
+			{
+				std::clog << batch_;
+				std::clog.flush();
+#ifdef KLAYGE_DEBUG
+				log_file_ << batch_;
+				log_file_.flush();
 #endif
+				batch_.clear();
+			}
+#endif
+		}
 
-namespace KlayGE
-{
-	void LogInfo(char const * fmt, ...)
-	{
-		va_list args;
-		va_start(args, fmt);
+		// Identical consecutive messages are written once, followed by a count at most once per REPEAT_REPORT_INTERVAL
+		void Write(LogLevel level, uint32_t category, char const * text)
+		{
+			if (has_last_ && (level == last_level_) && (category == last_category_) && (last_text_ == text))
+			{
+				++ num_repeats_;
+				return;
+			}
+
+			if (num_repeats_ > 0)
+			{
+				this->ReportRepeats();
+			}
+
+			this->Output(level, text);
+
+			has_last_ = true;
+			last_level_ = level;
+			last_category_ = category;
+			last_text_ = text;
+			last_repeat_report_ = std::chrono::steady_clock::now();
+		}
 
+		void ReportRepeats()
+		{
+			std::string const msg = "Last message repeated " + std::to_string(num_repeats_) + " time(s)";
+			this->Output(last_level_, msg.c_str());
+			num_repeats_ = 0;
+			last_repeat_report_ = std::chrono::steady_clock::now();
+		}
+
+		void Output(LogLevel level, char const * text)
+		{
 #ifdef KLAYGE_PLATFORM_ANDROID
-		__android_log_vprint(ANDROID_LOG_INFO, "KlayGE", fmt, args);
+			int prio;
+			switch (level)
+			{
+			case LL_Info:
+				prio = ANDROID_LOG_INFO;
+				break;
+
+			case LL_Warn:
+				prio = ANDROID_LOG_WARN;
+				break;
+
+			default:
+				prio = ANDROID_LOG_ERROR;
+				break;
+			}
+			__android_log_write(prio, "KlayGE", text);
 #else
-		std::array<char, 1024> buffer;
-		vsprintf(&buffer[0], fmt, args);
+			switch (level)
+			{
+			case LL_Info:
+				batch_ += "(INFO) KlayGE: ";
+				break;
+
+			case LL_Warn:
+				batch_ += "(WARN) KlayGE: ";
+				break;
+
+			default:
+				batch_ += "(ERROR) KlayGE: ";
+				break;
+			}
+			batch_ += text;
+			batch_ += '\n';
+#endif
+		}
+
+	private:
+		std::atomic<uint64_t> seq_;
+		std::atomic<uint32_t> num_pending_;
+		std::atomic<uint64_t> num_dropped_;
+
+		std::mutex rings_mutex_;
+		std::vector<std::shared_ptr<LogRing>> rings_;
 
-		std::clog << "(INFO) KlayGE: " << &buffer[0] << std::endl;
+		std::mutex sink_mutex_;
+		std::condition_variable sink_cv_;
+		std::condition_variable flushed_cv_;
+		bool wake_;
+		bool quit_;
+		uint64_t flush_request_;
+		uint64_t flushed_;
+		std::thread sink_thread_;
+
+		// Only touched by the sink thread
+		std::vector<LogEntry const *> pending_;
+		std::vector<uint32_t> heads_;
+		uint64_t num_reported_dropped_;
+
+		bool has_last_;
+		LogLevel last_level_;
+		uint32_t last_category_;
+		std::string last_text_;
+		uint32_t num_repeats_;
+		std::chrono::steady_clock::time_point last_repeat_report_;
+
+#ifndef KLAYGE_PLATFORM_ANDROID
+		std::string batch_;
 #ifdef KLAYGE_DEBUG
-		log_file << "(INFO) KlayGE: " << &buffer[0] << std::endl;
+		std::ofstream log_file_;
 #endif
 #endif
+	};
 
-		va_end(args);
+	// Never destroyed, see ~Logger
+	Logger& LoggerInstance()
+	{
+		static Logger* logger = new Logger;
+		return *logger;
 	}
 
-	void LogWarn(char const * fmt, ...)
+	void ModuleVLog(LogLevel level, uint32_t category, char const * fmt, va_list args)
 	{
-		va_list args;
-		va_start(args, fmt);
-
+		if (logger_stopped.load(std::memory_order_acquire))
+		{
 #ifdef KLAYGE_PLATFORM_ANDROID
-		__android_log_vprint(ANDROID_LOG_WARN, "KlayGE", fmt, args);
+			__android_log_vprint((level >= LL_Error) ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, "KlayGE", fmt, args);
 #else
-		std::array<char, 1024> buffer;
-		vsprintf(&buffer[0], fmt, args);
-
-		std::clog << "(WARN) KlayGE: " << &buffer[0] << std::endl;
-#ifdef KLAYGE_DEBUG
-		log_file << "(WARN) KlayGE: " << &buffer[0] << std::endl;
-#endif
+			vfprintf(stderr, fmt, args);
+			fputc('\n', stderr);
 #endif
+		}
+		else
+		{
+			LoggerInstance().VLog(level, category, fmt, args);
+		}
+	}
 
-		va_end(args);
+	void ModuleFlush()
+	{
+		if (!logger_stopped.load(std::memory_order_acquire) && logger_created.load(std::memory_order_acquire))
+		{
+			LoggerInstance().Flush();
+		}
+	}
+
+	uint64_t ModuleNumDropped()
+	{
+		return logger_created.load(std::memory_order_acquire) ? LoggerInstance().NumDropped() : 0;
+	}
+
+	LogHost const module_host = { &log_min_level, &log_category_mask, ModuleVLog, ModuleFlush, ModuleNumDropped };
+
+	LogHost const & CurrentHost()
+	{
+		LogHost const * host = attached_host.load(std::memory_order_acquire);
+		return host ? *host : module_host;
+	}
+
+	bool LogEnabled(LogLevel level, uint32_t category)
+	{
+		LogHost const & host = CurrentHost();
+		return (level >= host.min_level->load(std::memory_order_relaxed))
+			&& (category & host.category_mask->load(std::memory_order_relaxed));
+	}
+
+	void VLog(LogLevel level, uint32_t category, char const * fmt, va_list args)
+	{
+		CurrentHost().vlog(level, category, fmt, args);
+	}
+}
+
+namespace KlayGE
+{
+	void LogInfo(char const * fmt, ...)
+	{
+		if (LogEnabled(LL_Info, LC_General))
+		{
+			va_list args;
+			va_start(args, fmt);
+			VLog(LL_Info, LC_General, fmt, args);
+			va_end(args);
+		}
+	}
+
+	void LogWarn(char const * fmt, ...)
+	{
+		if (LogEnabled(LL_Warn, LC_General))
+		{
+			va_list args;
+			va_start(args, fmt);
+			VLog(LL_Warn, LC_General, fmt, args);
+			va_end(args);
+		}
 	}
 
 	void LogError(char const * fmt, ...)
 	{
-		va_list args;
-		va_start(args, fmt);
+		if (LogEnabled(LL_Error, LC_General))
+		{
+			va_list args;
+			va_start(args, fmt);
+			VLog(LL_Error, LC_General, fmt, args);
+			va_end(args);
+		}
+	}
 
-#ifdef KLAYGE_PLATFORM_ANDROID
-		__android_log_vprint(ANDROID_LOG_ERROR, "KlayGE", fmt, args);
-#else
-		std::array<char, 1024> buffer;
-		vsprintf(&buffer[0], fmt, args);
+	void LogMessage(LogLevel level, uint32_t category, char const * fmt, ...)
+	{
+		BOOST_ASSERT(level < LL_None);
 
-		std::clog << "(ERROR) KlayGE: " << &buffer[0] << std::endl;
-#ifdef KLAYGE_DEBUG
-		log_file << "(ERROR) KlayGE: " << &buffer[0] << std::endl;
-#endif
-#endif
+		if (LogEnabled(level, category))
+		{
+			va_list args;
+			va_start(args, fmt);
+			VLog(level, category, fmt, args);
+			va_end(args);
+		}
+	}
 
-		va_end(args);
+	void LogMinLevel(LogLevel level)
+	{
+		CurrentHost().min_level->store(level, std::memory_order_relaxed);
 	}
+
+	LogLevel LogMinLevel()
+	{
+		return static_cast<LogLevel>(CurrentHost().min_level->load(std::memory_order_relaxed));
+	}
+
+	void LogCategoryMask(uint32_t mask)
+	{
+		CurrentHost().category_mask->store(mask, std::memory_order_relaxed);
+	}
+
+	uint32_t LogCategoryMask()
+	{
+		return CurrentHost().category_mask->load(std::memory_order_relaxed);
+	}
+
+	void LogFlush()
+	{
+		CurrentHost().flush();
+	}
+
+	uint64_t LogNumDropped()
+	{
+		return CurrentHost().num_dropped();
+	}
+
+	void LogShutdown()
+	{
+		if (!logger_stopped.exchange(true, std::memory_order_acq_rel))
+		{
+			// A module logging through its loader only lets go of it
+			attached_host.store(nullptr, std::memory_order_release);
+			if (logger_created.load(std::memory_order_acquire))
+			{
+				LoggerInstance().Shutdown();
+			}
+		}
+	}
+
+	LogHost const * LogModuleHost()
+	{
+		return &CurrentHost();
+	}
+}
+
+void KFLLogAttach(KlayGE::LogHost const * host)
+{
+	if (host != &module_host)
+	{
+		attached_host.store(host, std::memory_order_release);
+	}
+}
+
+void KFLLogShutdown()
+{
+	KlayGE::LogShutdown();
 }
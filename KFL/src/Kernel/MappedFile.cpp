@@ -0,0 +1,168 @@
+/**
+ * @file MappedFile.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KFL/KFL.hpp>
+
+#ifdef KLAYGE_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <KFL/MappedFile.hpp>
+
+namespace KlayGE
+{
+	MappedFile::MappedFile()
+		: data_(nullptr), size_(0), file_handle_(nullptr), mapping_handle_(nullptr), fd_(-1)
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		this->Unmap();
+	}
+
+	bool MappedFile::Map(std::string const & file_name)
+	{
+		this->Unmap();
+
+#ifdef KLAYGE_PLATFORM_WINDOWS
+#ifdef KLAYGE_PLATFORM_WINDOWS_DESKTOP
+		HANDLE file = ::CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+#else
+		std::wstring wname;
+		Convert(wname, file_name);
+		HANDLE file = ::CreateFile2(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+#endif
+		if (INVALID_HANDLE_VALUE == file)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+		if (!::GetFileSizeEx(file, &file_size) || (0 == file_size.QuadPart))
+		{
+			::CloseHandle(file);
+			return false;
+		}
+
+#ifdef KLAYGE_PLATFORM_WINDOWS_DESKTOP
+		HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+#else
+		HANDLE mapping = ::CreateFileMappingFromApp(file, nullptr, PAGE_READONLY, 0, nullptr);
+#endif
+		if (nullptr == mapping)
+		{
+			::CloseHandle(file);
+			return false;
+		}
+
+#ifdef KLAYGE_PLATFORM_WINDOWS_DESKTOP
+		void const * data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		void const * data = ::MapViewOfFileFromApp(mapping, FILE_MAP_READ, 0, 0);
+#endif
+		if (nullptr == data)
+		{
+			::CloseHandle(mapping);
+			::CloseHandle(file);
+			return false;
+		}
+
+		data_ = data;
+		size_ = static_cast<uint64_t>(file_size.QuadPart);
+		file_handle_ = file;
+		mapping_handle_ = mapping;
+#else
+		int fd = ::open(file_name.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat file_stat;
+		if ((::fstat(fd, &file_stat) != 0) || (file_stat.st_size <= 0))
+		{
+			::close(fd);
+			return false;
+		}
+
+		void* data = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (MAP_FAILED == data)
+		{
+			::close(fd);
+			return false;
+		}
+
+		data_ = data;
+		size_ = static_cast<uint64_t>(file_stat.st_size);
+		fd_ = fd;
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Unmap()
+	{
+		if (data_)
+		{
+#ifdef KLAYGE_PLATFORM_WINDOWS
+			::UnmapViewOfFile(data_);
+			::CloseHandle(static_cast<HANDLE>(mapping_handle_));
+			::CloseHandle(static_cast<HANDLE>(file_handle_));
+#else
+			::munmap(const_cast<void*>(data_), static_cast<size_t>(size_));
+			::close(fd_);
+			fd_ = -1;
+#endif
+
+			data_ = nullptr;
+			size_ = 0;
+			file_handle_ = nullptr;
+			mapping_handle_ = nullptr;
+		}
+	}
+
+	bool MappedFile::Intact() const
+	{
+#ifdef KLAYGE_PLATFORM_WINDOWS
+		return data_ != nullptr;
+#else
+		struct stat file_stat;
+		return (data_ != nullptr) && (0 == ::fstat(fd_, &file_stat))
+			&& (static_cast<uint64_t>(file_stat.st_size) >= size_);
+#endif
+	}
+}
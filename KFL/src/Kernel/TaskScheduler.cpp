@@ -0,0 +1,488 @@
+/**
+ * @file TaskScheduler.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KFL/KFL.hpp>
+
+#include <exception>
+
+#include <KFL/TaskScheduler.hpp>
+
+namespace
+{
+	using namespace KlayGE;
+
+	thread_local task_scheduler const * tls_scheduler = nullptr;
+	thread_local int32_t tls_worker_index = -1;
+
+	uint32_t const WORK_STEALING_DEQUE_SIZE = 4096;
+	uint32_t const NUM_SPINS_BEFORE_SLEEP = 64;
+}
+
+namespace KlayGE
+{
+	namespace detail
+	{
+		struct task
+		{
+			task(std::function<void()> const & f)
+				: func(f), ref_count(1), num_unfinished_deps(1), finished(false)
+			{
+			}
+
+			void add_ref()
+			{
+				ref_count.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			void release()
+			{
+				if (1 == ref_count.fetch_sub(1, std::memory_order_acq_rel))
+				{
+					delete this;
+				}
+			}
+
+			std::function<void()> func;
+			std::atomic<int32_t> ref_count;
+			std::atomic<int32_t> num_unfinished_deps;
+			std::atomic<bool> finished;
+
+			std::mutex continuation_mutex;
+			std::vector<task*> continuations;
+
+			std::exception_ptr exception;
+		};
+
+		// Chase-Lev deque with a fixed capacity. Only the owner worker can push and pop from the bottom, any thread
+		//  can steal from the top.
+		class work_stealing_deque : boost::noncopyable
+		{
+		public:
+			work_stealing_deque()
+				: top_(0), bottom_(0)
+			{
+				for (auto& item : items_)
+				{
+					item.store(nullptr, std::memory_order_relaxed);
+				}
+			}
+
+			bool push(task* t)
+			{
+				int64_t const b = bottom_.load(std::memory_order_relaxed);
+				int64_t const top = top_.load(std::memory_order_acquire);
+				if (b - top >= static_cast<int64_t>(WORK_STEALING_DEQUE_SIZE))
+				{
+					return false;
+				}
+
+				items_[b & (WORK_STEALING_DEQUE_SIZE - 1)].store(t, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				bottom_.store(b + 1, std::memory_order_relaxed);
+				return true;
+			}
+
+			task* pop()
+			{
+				int64_t const b = bottom_.load(std::memory_order_relaxed) - 1;
+				bottom_.store(b, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t top = top_.load(std::memory_order_relaxed);
+
+				task* ret = nullptr;
+				if (top <= b)
+				{
+					ret = items_[b & (WORK_STEALING_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+					if (top == b)
+					{
+						// The last item, race against thieves
+						if (!top_.compare_exchange_strong(top, top + 1,
+							std::memory_order_seq_cst, std::memory_order_relaxed))
+						{
+							ret = nullptr;
+						}
+						bottom_.store(b + 1, std::memory_order_relaxed);
+					}
+				}
+				else
+				{
+					bottom_.store(b + 1, std::memory_order_relaxed);
+				}
+				return ret;
+			}
+
+			task* steal()
+			{
+				int64_t top = top_.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t const b = bottom_.load(std::memory_order_acquire);
+
+				task* ret = nullptr;
+				if (top < b)
+				{
+					ret = items_[top & (WORK_STEALING_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+					if (!top_.compare_exchange_strong(top, top + 1,
+						std::memory_order_seq_cst, std::memory_order_relaxed))
+					{
+						ret = nullptr;
+					}
+				}
+				return ret;
+			}
+
+		private:
+			std::atomic<int64_t> top_;
+			std::atomic<int64_t> bottom_;
+			std::atomic<task*> items_[WORK_STEALING_DEQUE_SIZE];
+		};
+	}
+
+
+	task_handle::task_handle()
+		: task_(nullptr)
+	{
+	}
+
+	task_handle::task_handle(detail::task* t)
+		: task_(t)
+	{
+		if (task_)
+		{
+			task_->add_ref();
+		}
+	}
+
+	task_handle::task_handle(task_handle const & rhs)
+		: task_handle(rhs.task_)
+	{
+	}
+
+	task_handle::task_handle(task_handle&& rhs)
+		: task_(rhs.task_)
+	{
+		rhs.task_ = nullptr;
+	}
+
+	task_handle::~task_handle()
+	{
+		if (task_)
+		{
+			task_->release();
+		}
+	}
+
+	task_handle& task_handle::operator=(task_handle const & rhs)
+	{
+		if (task_ != rhs.task_)
+		{
+			task_handle tmp(rhs);
+			std::swap(task_, tmp.task_);
+		}
+		return *this;
+	}
+
+	task_handle& task_handle::operator=(task_handle&& rhs)
+	{
+		if (this != &rhs)
+		{
+			std::swap(task_, rhs.task_);
+		}
+		return *this;
+	}
+
+	bool task_handle::done() const
+	{
+		return !task_ || task_->finished.load(std::memory_order_acquire);
+	}
+
+
+	task_scheduler::task_scheduler(uint32_t num_workers)
+		: num_pending_tasks_(0), num_sleeping_workers_(0), quit_(false)
+	{
+		if (0 == num_workers)
+		{
+			num_workers = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+		}
+
+		worker_queues_.resize(num_workers);
+		for (auto& queue : worker_queues_)
+		{
+			queue = MakeUniquePtr<detail::work_stealing_deque>();
+		}
+
+		workers_.reserve(num_workers);
+		for (uint32_t i = 0; i < num_workers; ++ i)
+		{
+			workers_.emplace_back(&task_scheduler::worker_func, this, i);
+		}
+	}
+
+	task_scheduler::~task_scheduler()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+			quit_ = true;
+			sleep_cond_.notify_all();
+		}
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+
+		// Flush the tasks that are still queued, so that their continuations and handles are released properly
+		while (detail::task* t = this->acquire_task(-1))
+		{
+			this->execute(t);
+		}
+	}
+
+	task_handle task_scheduler::submit(std::function<void()> const & func)
+	{
+		return this->submit(func, nullptr, 0);
+	}
+
+	task_handle task_scheduler::submit(std::function<void()> const & func, task_handle const * deps, size_t num_deps)
+	{
+		// The initial reference is owned by the scheduler until the task is finished, and the initial unfinished
+		//  dependency guards the task from being scheduled before all the dependencies are registered.
+		detail::task* t = new detail::task(func);
+		task_handle ret(t);
+
+		for (size_t i = 0; i < num_deps; ++ i)
+		{
+			detail::task* dep = deps[i].task_;
+			if (dep)
+			{
+				std::lock_guard<std::mutex> lock(dep->continuation_mutex);
+				if (!dep->finished.load(std::memory_order_relaxed))
+				{
+					t->num_unfinished_deps.fetch_add(1, std::memory_order_relaxed);
+					dep->continuations.push_back(t);
+				}
+			}
+		}
+
+		if (1 == t->num_unfinished_deps.fetch_sub(1, std::memory_order_acq_rel))
+		{
+			this->enqueue(t);
+		}
+
+		return ret;
+	}
+
+	void task_scheduler::wait(task_handle const & t)
+	{
+		if (!t.task_)
+		{
+			return;
+		}
+
+		int32_t const worker_index = this->current_worker_index();
+		while (!t.task_->finished.load(std::memory_order_acquire))
+		{
+			if (detail::task* other = this->acquire_task(worker_index))
+			{
+				this->execute(other);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		if (t.task_->exception)
+		{
+			std::rethrow_exception(t.task_->exception);
+		}
+	}
+
+	void task_scheduler::wait_all(task_handle const * tasks, size_t num_tasks)
+	{
+		std::exception_ptr exception;
+		for (size_t i = 0; i < num_tasks; ++ i)
+		{
+			try
+			{
+				this->wait(tasks[i]);
+			}
+			catch (...)
+			{
+				if (!exception)
+				{
+					exception = std::current_exception();
+				}
+			}
+		}
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	int32_t task_scheduler::current_worker_index() const
+	{
+		return (tls_scheduler == this) ? tls_worker_index : -1;
+	}
+
+	uint32_t task_scheduler::chunk_size(uint32_t count, uint32_t grain_size) const
+	{
+		// Around 4 ranges per thread, including the calling one, for load balancing
+		uint32_t const num_ranges = (this->num_workers() + 1) * 4;
+		return std::max(std::max((count + num_ranges - 1) / num_ranges, grain_size), 1U);
+	}
+
+	void task_scheduler::enqueue(detail::task* t)
+	{
+		int32_t const worker_index = this->current_worker_index();
+		if ((worker_index < 0) || !worker_queues_[worker_index]->push(t))
+		{
+			std::lock_guard<std::mutex> lock(global_queue_mutex_);
+			global_queue_.push_back(t);
+		}
+
+		num_pending_tasks_.fetch_add(1);
+		if (num_sleeping_workers_.load() > 0)
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+			sleep_cond_.notify_one();
+		}
+	}
+
+	detail::task* task_scheduler::acquire_task(int32_t worker_index)
+	{
+		detail::task* t = nullptr;
+
+		if (worker_index >= 0)
+		{
+			t = worker_queues_[worker_index]->pop();
+		}
+
+		if (!t)
+		{
+			std::lock_guard<std::mutex> lock(global_queue_mutex_);
+			if (!global_queue_.empty())
+			{
+				t = global_queue_.front();
+				global_queue_.pop_front();
+			}
+		}
+
+		if (!t)
+		{
+			uint32_t const num_queues = static_cast<uint32_t>(worker_queues_.size());
+			uint32_t const start = (worker_index >= 0) ? worker_index + 1 : 0;
+			for (uint32_t i = 0; (i < num_queues) && !t; ++ i)
+			{
+				uint32_t const victim = (start + i) % num_queues;
+				if (static_cast<int32_t>(victim) != worker_index)
+				{
+					t = worker_queues_[victim]->steal();
+				}
+			}
+		}
+
+		if (t)
+		{
+			num_pending_tasks_.fetch_sub(1);
+		}
+		return t;
+	}
+
+	void task_scheduler::execute(detail::task* t)
+	{
+		try
+		{
+			t->func();
+		}
+		catch (...)
+		{
+			t->exception = std::current_exception();
+		}
+		t->func = std::function<void()>();
+
+		this->finish(t);
+	}
+
+	void task_scheduler::finish(detail::task* t)
+	{
+		std::vector<detail::task*> continuations;
+		{
+			std::lock_guard<std::mutex> lock(t->continuation_mutex);
+			t->finished.store(true, std::memory_order_release);
+			continuations.swap(t->continuations);
+		}
+
+		for (auto cont : continuations)
+		{
+			if (1 == cont->num_unfinished_deps.fetch_sub(1, std::memory_order_acq_rel))
+			{
+				this->enqueue(cont);
+			}
+		}
+
+		t->release();
+	}
+
+	void task_scheduler::worker_func(uint32_t index)
+	{
+		tls_scheduler = this;
+		tls_worker_index = static_cast<int32_t>(index);
+
+		uint32_t num_spins = 0;
+		while (!quit_)
+		{
+			if (detail::task* t = this->acquire_task(index))
+			{
+				this->execute(t);
+				num_spins = 0;
+			}
+			else if (num_spins < NUM_SPINS_BEFORE_SLEEP)
+			{
+				++ num_spins;
+				std::this_thread::yield();
+			}
+			else
+			{
+				std::unique_lock<std::mutex> lock(sleep_mutex_);
+				num_sleeping_workers_.fetch_add(1);
+				while ((num_pending_tasks_.load() <= 0) && !quit_)
+				{
+					sleep_cond_.wait(lock);
+				}
+				num_sleeping_workers_.fetch_sub(1);
+				num_spins = 0;
+			}
+		}
+
+		tls_scheduler = nullptr;
+		tls_worker_index = -1;
+	}
+}
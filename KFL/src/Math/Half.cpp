@@ -100,7 +100,12 @@ namespace KlayGE
 
 		if (0 == e)
 		{
-			if (m != 0)
+			if (0 == m)
+			{
+				// Plus or minus zero
+				e = -(127 - 15);
+			}
+			else
 			{
 				// Denormalized number -- renormalize it
 
@@ -118,11 +123,8 @@ namespace KlayGE
 		{
 			if (31 == e)
 			{
-				if (m != 0)
-				{
-					// Nan -- preserve sign and significand bits
-					e = 0xFF - (127 - 15);
-				}
+				// Inf or Nan -- preserve sign and significand bits
+				e = 0xFF - (127 - 15);
 			}
 		}
 
@@ -2155,6 +2155,135 @@ namespace KlayGE
 			proj.Col(2, clip_plane * SetVector(c));
 		}
 
+		// Bound
+		///////////////////////////////////////////////////////////////////////////////
+		void IntersectAABBFrustum(BoundOverlap* overlaps, float const * center_x, float const * center_y, float const * center_z,
+			float const * extent_x, float const * extent_y, float const * extent_z, size_t num, Frustum const & frustum)
+		{
+			// Same as MathLib::intersect_aabb_frustum, in the center-extent form. For each plane, d is the distance of the center,
+			//  and r is the projected extent. The box is out if d + r < 0, and crosses the plane if d - r < 0.
+			size_t i = 0;
+
+#if defined(SIMD_MATH_SSE)
+			__m128 plane_a[6];
+			__m128 plane_b[6];
+			__m128 plane_c[6];
+			__m128 plane_d[6];
+			__m128 abs_plane_a[6];
+			__m128 abs_plane_b[6];
+			__m128 abs_plane_c[6];
+			for (int p = 0; p < 6; ++ p)
+			{
+				Plane const & plane = frustum.FrustumPlane(p);
+				plane_a[p] = _mm_set1_ps(plane.a());
+				plane_b[p] = _mm_set1_ps(plane.b());
+				plane_c[p] = _mm_set1_ps(plane.c());
+				plane_d[p] = _mm_set1_ps(plane.d());
+				abs_plane_a[p] = _mm_set1_ps(std::abs(plane.a()));
+				abs_plane_b[p] = _mm_set1_ps(std::abs(plane.b()));
+				abs_plane_c[p] = _mm_set1_ps(std::abs(plane.c()));
+			}
+
+			__m128 const zero = _mm_setzero_ps();
+			for (; i + 4 <= num; i += 4)
+			{
+				__m128 const cx = _mm_loadu_ps(center_x + i);
+				__m128 const cy = _mm_loadu_ps(center_y + i);
+				__m128 const cz = _mm_loadu_ps(center_z + i);
+				__m128 const ex = _mm_loadu_ps(extent_x + i);
+				__m128 const ey = _mm_loadu_ps(extent_y + i);
+				__m128 const ez = _mm_loadu_ps(extent_z + i);
+
+				__m128 outside = zero;
+				__m128 intersect = zero;
+				for (int p = 0; p < 6; ++ p)
+				{
+					__m128 const d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane_a[p], cx), _mm_mul_ps(plane_b[p], cy)),
+						_mm_add_ps(_mm_mul_ps(plane_c[p], cz), plane_d[p]));
+					__m128 const r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abs_plane_a[p], ex), _mm_mul_ps(abs_plane_b[p], ey)),
+						_mm_mul_ps(abs_plane_c[p], ez));
+					outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+					intersect = _mm_or_ps(intersect, _mm_cmplt_ps(_mm_sub_ps(d, r), zero));
+				}
+
+				int const outside_mask = _mm_movemask_ps(outside);
+				int const intersect_mask = _mm_movemask_ps(intersect);
+				for (int j = 0; j < 4; ++ j)
+				{
+					overlaps[i + j] = (outside_mask & (1 << j)) ? BO_No : ((intersect_mask & (1 << j)) ? BO_Partial : BO_Yes);
+				}
+			}
+#endif
+
+			for (; i < num; ++ i)
+			{
+				bool outside = false;
+				bool intersect = false;
+				for (int p = 0; p < 6; ++ p)
+				{
+					Plane const & plane = frustum.FrustumPlane(p);
+					float const d = plane.a() * center_x[i] + plane.b() * center_y[i] + plane.c() * center_z[i] + plane.d();
+					float const r = std::abs(plane.a()) * extent_x[i] + std::abs(plane.b()) * extent_y[i]
+						+ std::abs(plane.c()) * extent_z[i];
+					outside |= (d + r < 0);
+					intersect |= (d - r < 0);
+				}
+				overlaps[i] = outside ? BO_No : (intersect ? BO_Partial : BO_Yes);
+			}
+		}
+
+		// Array
+		///////////////////////////////////////////////////////////////////////////////
+		void MultiplyAddArray(float* dst, float const * src, float s, size_t num)
+		{
+			size_t i = 0;
+
+#if defined(SIMD_MATH_SSE)
+			__m128 const scale = _mm_set1_ps(s);
+			for (; i + 8 <= num; i += 8)
+			{
+				__m128 const d0 = _mm_loadu_ps(dst + i + 0);
+				__m128 const d1 = _mm_loadu_ps(dst + i + 4);
+				_mm_storeu_ps(dst + i + 0, _mm_add_ps(d0, _mm_mul_ps(_mm_loadu_ps(src + i + 0), scale)));
+				_mm_storeu_ps(dst + i + 4, _mm_add_ps(d1, _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale)));
+			}
+			for (; i + 4 <= num; i += 4)
+			{
+				_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), scale)));
+			}
+#endif
+
+			for (; i < num; ++ i)
+			{
+				dst[i] += src[i] * s;
+			}
+		}
+
+		void WeightedSumVector4(float* dst, float const * src, float const * weights, size_t num)
+		{
+#if defined(SIMD_MATH_SSE)
+			__m128 sum = _mm_setzero_ps();
+			for (size_t i = 0; i < num; ++ i)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + i * 4), _mm_set1_ps(weights[i])));
+			}
+			_mm_storeu_ps(dst, sum);
+#else
+			float sum[4] = { 0, 0, 0, 0 };
+			for (size_t i = 0; i < num; ++ i)
+			{
+				for (size_t j = 0; j < 4; ++ j)
+				{
+					sum[j] += src[i * 4 + j] * weights[i];
+				}
+			}
+			for (size_t j = 0; j < 4; ++ j)
+			{
+				dst[j] = sum[j];
+			}
+#endif
+		}
+
 		// Color
 		///////////////////////////////////////////////////////////////////////////////
 		SIMDVectorF4 NegativeColor(SIMDVectorF4 const & rhs)
@@ -670,6 +670,9 @@ namespace KlayGE
 
 	KLAYGE_CORE_API void ConvertToABGR32F(ElementFormat fmt, void const * input, uint32_t num_elems, Color* output);
 	KLAYGE_CORE_API void ConvertFromABGR32F(ElementFormat fmt, Color const * input, uint32_t num_elems, void* output);
+	// Skips the float conversion between 8-bit formats that only differ in the channel order or count
+	KLAYGE_CORE_API void ConvertFormat(ElementFormat src_fmt, void const * input, uint32_t num_elems,
+		ElementFormat dst_fmt, void* output);
 
 
 	enum ElementAccessHint
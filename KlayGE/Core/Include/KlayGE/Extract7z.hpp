@@ -36,6 +36,8 @@
 #include <KlayGE/PreDeclare.hpp>
 
 #include <string>
+#include <mutex>
+#include <unordered_map>
 
 namespace KlayGE
 {
@@ -46,6 +48,34 @@ namespace KlayGE
 		std::string const & password,
 		std::string const & extract_file_path,
 		std::shared_ptr<std::ostream> const & os);
+
+	// Keeps 7z packages open together with their entry tables, so accessing many files in one package doesn't
+	//  parse the package again every time. A package is reopened when its timestamp changes. Thread safe.
+	class KLAYGE_CORE_API ArchiveCache : boost::noncopyable
+	{
+	public:
+		ArchiveCache();
+		~ArchiveCache();
+
+		// The package file is only opened if it is not cached yet, or its timestamp is changed
+		bool Contains(std::string const & archive_path, uint64_t timestamp,
+			std::string const & password, std::string const & extract_file_path);
+		// Entries that the archive format can expose as a stream, such as the stored ones, are read on demand
+		//  from the package. The others are decompressed once into a buffer of their exact size, or into a growing
+		//  stream if the package doesn't record the size.
+		ResIdentifierPtr Open(std::string const & archive_path, uint64_t timestamp,
+			std::string const & password, std::string const & extract_file_path, std::string const & res_name);
+
+		void Clear();
+
+	private:
+		struct Archive;
+		std::shared_ptr<Archive> Acquire(std::string const & archive_path, uint64_t timestamp, std::string const & password);
+
+	private:
+		std::mutex mutex_;
+		std::unordered_map<std::string, std::shared_ptr<Archive>> archives_;
+	};
 }
 
 #endif		// _KFL_EXTRACT7Z_HPP
@@ -19,10 +19,14 @@
 #include <KlayGE/Texture.hpp>
 #include <KlayGE/RenderStateObject.hpp>
 #include <KlayGE/TexCompressionBC.hpp>
+#include <KFL/TaskScheduler.hpp>
 
 #include <vector>
 #include <deque>
+#include <list>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <KlayGE/LZMACodec.hpp>
 
@@ -62,8 +66,21 @@ namespace KlayGE
 
 		static uint32_t const LEVEL_SHIFT = 28;
 
+		struct StreamedTile
+		{
+			uint32_t tile_id;
+			uint32_t attr;
+			std::vector<std::vector<uint8_t>> mip_data;
+			std::vector<uint32_t> mip_row_pitches;
+		};
+
+	public:
+		// Tiles built at the same time at most. The others are requested again in a later frame.
+		static uint32_t const MAX_PENDING_TILES = 64;
+
 	public:
 		JudaTexture(uint32_t num_tiles, uint32_t tile_size, ElementFormat format);
+		~JudaTexture();
 
 		uint32_t EncodeTileID(uint32_t level, uint32_t tile_x, uint32_t tile_y) const;
 		void DecodeTileID(uint32_t& level, uint32_t& tile_x, uint32_t& tile_y, uint32_t tile_id) const;
@@ -88,12 +105,26 @@ namespace KlayGE
 
 		void SetParams(RenderEffect const & effect);
 
+		// Tiles not in the cache are built on the task scheduler, and show up in a later frame. Never blocks.
 		void UpdateCache(std::vector<uint32_t> const & tile_ids);
 
+		// Bytes of tiles uploaded to the cache per UpdateCache
+		void UploadBudget(uint32_t bytes);
+		uint32_t UploadBudget() const;
+		uint32_t NumPendingTiles() const;
+		uint32_t NumCachedTiles() const;
+		bool TileCached(uint32_t tile_id) const;
+		// Blocks until the tiles in flight are built, so they are uploaded in the next UpdateCache. A tile that failed to
+		//  build is released there.
+		void WaitForPendingTiles();
+
 	private:
 		void DecodeATile(std::vector<uint8_t>* data, uint32_t shuff, uint32_t mipmaps);
 		uint32_t DecodeAAttr(uint32_t shuff);
-		uint8_t* RetriveATile(uint32_t data_index);
+		uint8_t const * RetriveATile(std::shared_ptr<std::vector<uint8_t>>& block, uint32_t data_index);
+
+		void BuildCacheTile(StreamedTile& tile);
+		void UploadReadyTiles();
 
 		uint32_t NumNonEmptySubNodes(quadtree_node_ptr const & node) const;
 		quadtree_node_ptr const & GetNode(uint32_t shuff);
@@ -169,19 +200,12 @@ namespace KlayGE
 		// Input only
 		ResIdentifierPtr input_file_;
 		uint32_t data_blocks_offset_;
-		LZMACodec lzma_dec_;
-		struct DecodedBlockInfo
-		{
-			std::shared_ptr<std::vector<uint8_t>> data;
-			uint64_t tick;
-
-			DecodedBlockInfo(std::shared_ptr<std::vector<uint8_t>> const & d, uint64_t t)
-				: data(d), tick(t)
-			{
-			}
-		};
-		std::unordered_map<uint32_t, DecodedBlockInfo> decoded_block_cache_;
-		uint64_t decode_tick_;
+		std::mutex input_file_mutex_;
+		typedef std::list<std::pair<uint32_t, std::shared_ptr<std::vector<uint8_t>>>> DecodedBlockList;
+		DecodedBlockList decoded_block_lru_;
+		std::unordered_map<uint32_t, DecodedBlockList::iterator> decoded_block_map_;
+		size_t num_decoded_blocks_;
+		std::mutex decoded_block_mutex_;
 
 	private:
 		// Cache
@@ -197,10 +221,19 @@ namespace KlayGE
 			uint32_t x, y, z;
 			uint32_t attr;
 			uint64_t tick;
+			std::list<uint32_t>::iterator lru_iter;
 		};
 		std::unordered_map<uint32_t, TileInfo> tile_info_map_;
-		std::deque<std::pair<uint32_t, uint32_t>> tile_free_list_;
+		std::list<uint32_t> tile_lru_;
+		std::vector<uint32_t> free_cache_slots_;
 		uint64_t tile_tick_;
+
+		std::unordered_set<uint32_t> pending_tiles_;
+		std::vector<task_handle> tile_tasks_;
+		std::deque<std::shared_ptr<StreamedTile>> ready_tiles_;
+		std::vector<uint32_t> failed_tiles_;
+		std::mutex ready_tiles_mutex_;
+		uint32_t upload_budget_;
 	};
 }
 
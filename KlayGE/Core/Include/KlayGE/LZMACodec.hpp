@@ -37,12 +37,21 @@
 
 namespace KlayGE
 {
+	// With a non-zero block size, inputs larger than a block are split into blocks that are compressed independently
+	//  and stored behind a block index, so they can be encoded and decoded on all the threads of the task scheduler.
+	//  Decode recognizes both the blocked and the single stream data.
 	class KLAYGE_CORE_API LZMACodec : boost::noncopyable
 	{
 	public:
 		LZMACodec();
+		explicit LZMACodec(uint32_t block_size);
 		~LZMACodec();
 
+		uint32_t BlockSize() const
+		{
+			return block_size_;
+		}
+
 		uint64_t Encode(std::ostream& os, ResIdentifierPtr const & res, uint64_t len);
 		uint64_t Encode(std::ostream& os, void const * input, uint64_t len);
 		void Encode(std::vector<uint8_t>& output, ResIdentifierPtr const & res, uint64_t len);
@@ -52,7 +61,11 @@ namespace KlayGE
 		uint64_t Decode(std::ostream& os, void const * input, uint64_t len, uint64_t original_len);
 		void Decode(std::vector<uint8_t>& output, ResIdentifierPtr const & res, uint64_t len, uint64_t original_len);
 		void Decode(std::vector<uint8_t>& output, void const * input, uint64_t len, uint64_t original_len);
+		void Decode(void* output, ResIdentifierPtr const & res, uint64_t len, uint64_t original_len);
 		void Decode(void* output, void const * input, uint64_t len, uint64_t original_len);
+
+	private:
+		uint32_t block_size_;
 	};
 }
 
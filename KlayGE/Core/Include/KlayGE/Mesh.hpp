@@ -332,10 +332,18 @@ namespace KlayGE
 		void AttachKeyFrames(std::shared_ptr<KeyFramesType> const & kf)
 		{
 			key_frames_ = kf;
+			key_frames_loader_ = nullptr;
 		}
-		std::shared_ptr<KeyFramesType> const & GetKeyFrames() const
+		// The key frames are loaded by the loader when they're first needed
+		void AttachKeyFramesLoader(std::function<std::shared_ptr<KeyFramesType>()> const & kf_loader)
 		{
-			return key_frames_;
+			key_frames_.reset();
+			key_frames_loader_ = kf_loader;
+		}
+		std::shared_ptr<KeyFramesType> const & GetKeyFrames();
+		std::function<std::shared_ptr<KeyFramesType>()> const & GetKeyFramesLoader() const
+		{
+			return key_frames_loader_;
 		}
 		uint32_t NumFrames() const
 		{
@@ -380,6 +388,7 @@ namespace KlayGE
 		RotationsType bind_duals_;
 
 		std::shared_ptr<KeyFramesType> key_frames_;
+		std::function<std::shared_ptr<KeyFramesType>()> key_frames_loader_;
 		float last_frame_;
 
 		uint32_t num_frames_;
@@ -445,6 +454,17 @@ namespace KlayGE
 		std::vector<Joint>& joints, std::shared_ptr<AnimationActionsType>& actions,
 		std::shared_ptr<KeyFramesType>& kfs, uint32_t& num_frames, uint32_t& frame_rate,
 		std::vector<std::shared_ptr<AABBKeyFrames>>& frame_pos_bbs);
+	// Same as above, but the key frames are decoded by kfs_loader on its first call
+	KLAYGE_CORE_API void LoadModel(std::string const & meshml_name, std::vector<RenderMaterialPtr>& mtls,
+		std::vector<vertex_element>& merged_ves, char& all_is_index_16_bit,
+		std::vector<std::vector<uint8_t>>& merged_buff, std::vector<uint8_t>& merged_indices,
+		std::vector<std::string>& mesh_names, std::vector<int32_t>& mtl_ids,
+		std::vector<AABBox>& pos_bbs, std::vector<AABBox>& tc_bbs,
+		std::vector<uint32_t>& mesh_num_vertices, std::vector<uint32_t>& mesh_base_vertices,
+		std::vector<uint32_t>& mesh_num_indices, std::vector<uint32_t>& mesh_base_indices,
+		std::vector<Joint>& joints, std::shared_ptr<AnimationActionsType>& actions,
+		std::function<std::shared_ptr<KeyFramesType>()>& kfs_loader, uint32_t& num_frames, uint32_t& frame_rate,
+		std::vector<std::shared_ptr<AABBKeyFrames>>& frame_pos_bbs);
 	KLAYGE_CORE_API RenderModelPtr SyncLoadModel(std::string const & meshml_name, uint32_t access_hint,
 		std::function<RenderModelPtr(std::wstring const &)> CreateModelFactoryFunc = CreateModelFactory<RenderModel>(),
 		std::function<StaticMeshPtr(RenderModelPtr const &, std::wstring const &)> CreateMeshFactoryFunc = CreateMeshFactory<StaticMesh>());
@@ -36,40 +36,103 @@
 #include <KlayGE/PreDeclare.hpp>
 #include <KFL/Timer.hpp>
 
-#include <map>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace KlayGE
 {
 	class KLAYGE_CORE_API PerfRange : boost::noncopyable
 	{
 	public:
-		PerfRange();
+		PerfRange(int category, std::string const & name);
 
 		void Begin();
 		void End();
 
 		void CollectData();
 
+		int Category() const;
+		std::string const & Name() const;
+
+		double CPUBegin() const;
 		double CPUTime() const;
 		double GPUTime() const;
 		bool Dirty() const;
 
 	private:
-		Timer cpu_timer_;
+		int category_;
+		std::string name_;
+
 		QueryPtr gpu_timer_query_;
 
+		double cpu_begin_;
 		double cpu_time_;
 		double gpu_time_;
 
+		bool recording_;
 		bool dirty_;
 	};
 
+	// A counter created by the profiler, which owns its name. Samples are recorded on the calling thread, without looking up
+	//  the profiler.
+	class KLAYGE_CORE_API PerfCounter : boost::noncopyable
+	{
+	public:
+		PerfCounter(PerfProfiler& profiler, std::string const & name);
+
+		void Value(double value);
+
+		std::string const & Name() const;
+
+	private:
+		PerfProfiler& profiler_;
+		std::string name_;
+	};
+
+	// Records a CPU range of the calling thread, from the construction to the destruction. Scopes on the same thread nest.
+	//  The name isn't copied, so it has to outlive the profiler. Normally it's a string literal.
+	class KLAYGE_CORE_API PerfScope : boost::noncopyable
+	{
+	public:
+		explicit PerfScope(char const * name);
+		~PerfScope();
+
+	private:
+		char const * name_;
+		double begin_;
+		bool recording_;
+	};
+
+#ifndef KLAYGE_SHIP
+	#define KLAYGE_PERF_SCOPE_CONCAT_IMPL(x, y) x##y
+	#define KLAYGE_PERF_SCOPE_CONCAT(x, y) KLAYGE_PERF_SCOPE_CONCAT_IMPL(x, y)
+	#define KLAYGE_PERF_SCOPE(name) KlayGE::PerfScope KLAYGE_PERF_SCOPE_CONCAT(perf_scope_, __LINE__)(name)
+#else
+	#define KLAYGE_PERF_SCOPE(name)
+#endif
+
 	class KLAYGE_CORE_API PerfProfiler : boost::noncopyable
 	{
+	public:
+		// A CPU range or a counter sample. Times are in seconds since the profiler is created.
+		struct Event
+		{
+			char const * name;
+			double begin;
+			double value;
+			uint32_t frame_id;
+			uint32_t depth;
+			bool is_counter;
+		};
+
 	public:
 		PerfProfiler();
+		~PerfProfiler();
 
 		static PerfProfiler& Instance();
 		static void Destroy();
@@ -77,17 +140,55 @@ namespace KlayGE
 		void Suspend();
 		void Resume();
 
+		// Follows Config().perf_profiler, refreshed once per frame in CollectData.
+		bool Enabled() const
+		{
+			return enabled_.load(std::memory_order_relaxed);
+		}
+
 		PerfRangePtr CreatePerfRange(int category, std::string const & name);
+		// Can be called on any thread. The counter lives as long as the profiler.
+		PerfCounterPtr CreatePerfCounter(std::string const & name);
 		void CollectData();
 
+		// Records a sample of a counter on the calling thread. Same lifetime rule of the name as PerfScope.
+		void Counter(char const * name, double value);
+
+		double Now() const;
+		uint32_t FrameID() const
+		{
+			return frame_id_.load(std::memory_order_relaxed);
+		}
+
+		// Used by PerfScope and PerfRange. BeginScope returns the begin time, EndScope returns the duration.
+		double BeginScope();
+		double EndScope(char const * name, double begin);
+
 		void ExportToCSV(std::string const & file_name) const;
+		// In the Chrome trace event format, can be opened by chrome://tracing
+		void ExportToTrace(std::string const & file_name) const;
+
+	private:
+		struct ThreadEvents;
+
+		ThreadEvents& CurrentThreadEvents();
+		void RecordEvent(ThreadEvents& te, Event const & ev);
 
 	private:
 		static std::unique_ptr<PerfProfiler> perf_profiler_instance_;
 
+		uint32_t const id_;
+		Timer timer_;
+		std::atomic<bool> enabled_;
+		std::atomic<uint32_t> frame_id_;
+
+		mutable std::mutex threads_mutex_;
+		std::vector<std::unique_ptr<ThreadEvents>> threads_;
+		std::vector<PerfCounterPtr> perf_counters_;
+
+		// Only the latest frames of each range are kept
 		std::vector<std::tuple<int, std::string, PerfRangePtr,
-			std::vector<std::tuple<uint32_t, double, double>>>> perf_ranges_;
-		uint32_t frame_id_;
+			std::deque<std::tuple<uint32_t, double, double, double>>>> perf_ranges_;
 	};
 }
 
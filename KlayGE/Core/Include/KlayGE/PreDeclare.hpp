@@ -40,8 +40,11 @@ namespace KlayGE
 	class ResLoadingDesc;
 	typedef std::shared_ptr<ResLoadingDesc> ResLoadingDescPtr;
 	class ResLoader;
+	class ArchiveCache;
 	class PerfRange;
 	typedef std::shared_ptr<PerfRange> PerfRangePtr;
+	class PerfCounter;
+	typedef std::shared_ptr<PerfCounter> PerfCounterPtr;
 	class PerfProfiler;
 	typedef std::shared_ptr<PerfProfiler> PerfProfilerPtr;
 
@@ -146,10 +149,16 @@ namespace KlayGE
 	typedef std::shared_ptr<TexCompressionETC2RGB8> TexCompressionETC2RGB8Ptr;
 	class TexCompressionETC2RGB8A1;
 	typedef std::shared_ptr<TexCompressionETC2RGB8A1> TexCompressionETC2RGB8A1Ptr;
+	class TexCompressionETC2RGBA8;
+	typedef std::shared_ptr<TexCompressionETC2RGBA8> TexCompressionETC2RGBA8Ptr;
 	class TexCompressionETC2R11;
 	typedef std::shared_ptr<TexCompressionETC2R11> TexCompressionETC2R11Ptr;
+	class TexCompressionETC2SignedR11;
+	typedef std::shared_ptr<TexCompressionETC2SignedR11> TexCompressionETC2SignedR11Ptr;
 	class TexCompressionETC2RG11;
 	typedef std::shared_ptr<TexCompressionETC2RG11> TexCompressionETC2RG11Ptr;
+	class TexCompressionETC2SignedRG11;
+	typedef std::shared_ptr<TexCompressionETC2SignedRG11> TexCompressionETC2SignedRG11Ptr;
 	class JudaTexture;
 	typedef std::shared_ptr<JudaTexture> JudaTexturePtr;
 	class FrameBuffer;
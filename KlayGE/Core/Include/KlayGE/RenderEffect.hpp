@@ -271,7 +271,7 @@ namespace KlayGE
 				if (val_in_cbuff != value)
 				{
 					val_in_cbuff = value;
-					data_.cbuff_desc.cbuff->Dirty(true);
+					data_.cbuff_desc.cbuff->DirtyRange(data_.cbuff_desc.offset, sizeof(T));
 				}
 			}
 			else
@@ -409,7 +409,8 @@ namespace KlayGE
 					memcpy(target + i * this->data_.cbuff_desc.stride, &value[i], sizeof(value[i]));
 				}
 
-				this->data_.cbuff_desc.cbuff->Dirty(true);
+				this->data_.cbuff_desc.cbuff->DirtyRange(this->data_.cbuff_desc.offset,
+					static_cast<uint32_t>(value.size()) * this->data_.cbuff_desc.stride);
 			}
 			else
 			{
@@ -597,6 +598,29 @@ namespace KlayGE
 		std::string str_;
 	};
 
+	// Maps hashes of names to indices in an open addressed table. The first index of a hash wins, like a linear scan.
+	class KLAYGE_CORE_API HashIndexTable
+	{
+	public:
+		static uint32_t const InvalidIndex = 0xFFFFFFFF;
+
+	public:
+		HashIndexTable();
+
+		void Build(std::vector<size_t> const & hashes);
+		void Clear();
+
+		uint32_t NumIndices() const
+		{
+			return num_indices_;
+		}
+		uint32_t Find(size_t hash) const;
+
+	private:
+		std::vector<std::pair<size_t, uint32_t>> slots_;
+		uint32_t num_indices_;
+	};
+
 	// ȾЧ
 	//////////////////////////////////////////////////////////////////////////////////
 	class KLAYGE_CORE_API RenderEffect : boost::noncopyable
@@ -615,8 +639,11 @@ namespace KlayGE
 		{
 			return static_cast<uint32_t>(params_.size());
 		}
+		// The hash versions take CT_HASH("name"). The results can be cached, they stay valid for the life of the effect.
 		RenderEffectParameter* ParameterBySemantic(std::string const & semantic) const;
+		RenderEffectParameter* ParameterBySemantic(size_t semantic_hash) const;
 		RenderEffectParameter* ParameterByName(std::string const & name) const;
+		RenderEffectParameter* ParameterByName(size_t name_hash) const;
 		RenderEffectParameter* ParameterByIndex(uint32_t n) const
 		{
 			BOOST_ASSERT(n < this->NumParameters());
@@ -628,6 +655,7 @@ namespace KlayGE
 			return static_cast<uint32_t>(cbuffers_.size());
 		}
 		RenderEffectConstantBuffer* CBufferByName(std::string const & name) const;
+		RenderEffectConstantBuffer* CBufferByName(size_t name_hash) const;
 		RenderEffectConstantBuffer* CBufferByIndex(uint32_t n) const
 		{
 			BOOST_ASSERT(n < this->NumCBuffers());
@@ -636,6 +664,7 @@ namespace KlayGE
 
 		uint32_t NumTechniques() const;
 		RenderTechnique* TechniqueByName(std::string const & name) const;
+		RenderTechnique* TechniqueByName(size_t name_hash) const;
 		RenderTechnique* TechniqueByIndex(uint32_t n) const;
 
 		uint32_t NumShaderFragments() const;
@@ -670,6 +699,8 @@ namespace KlayGE
 
 	class KLAYGE_CORE_API RenderEffectTemplate : boost::noncopyable
 	{
+		friend class RenderEffect;
+
 	public:
 		void Load(std::string const & name, RenderEffect& effect);
 
@@ -692,6 +723,7 @@ namespace KlayGE
 			return static_cast<uint32_t>(techniques_.size());
 		}
 		RenderTechnique* TechniqueByName(std::string const & name) const;
+		RenderTechnique* TechniqueByName(size_t name_hash) const;
 		RenderTechnique* TechniqueByIndex(uint32_t n) const
 		{
 			BOOST_ASSERT(n < this->NumTechniques());
@@ -738,6 +770,7 @@ namespace KlayGE
 		void InsertIncludeNodes(XMLDocument& target_doc, XMLNode& target_root,
 			XMLNodePtr const & target_place, XMLNode const & include_root) const;
 #endif
+		void BuildLookupTables(RenderEffect const & effect);
 
 	private:
 		std::string res_name_;
@@ -748,6 +781,12 @@ namespace KlayGE
 
 		std::vector<std::unique_ptr<RenderTechnique>> techniques_;
 
+		// Built after loading. Parameters and constant buffers are in the same order in all the clones of an effect.
+		HashIndexTable tech_name_table_;
+		HashIndexTable param_name_table_;
+		HashIndexTable param_semantic_table_;
+		HashIndexTable cbuffer_name_table_;
+
 		std::shared_ptr<std::vector<std::pair<std::pair<std::string, std::string>, bool>>> macros_;
 		std::vector<RenderShaderFragment> shader_frags_;
 #if KLAYGE_IS_DEV_PLATFORM
@@ -924,10 +963,7 @@ namespace KlayGE
 	class KLAYGE_CORE_API RenderEffectConstantBuffer : boost::noncopyable
 	{
 	public:
-		RenderEffectConstantBuffer()
-			: dirty_(true)
-		{
-		}
+		RenderEffectConstantBuffer();
 
 #if KLAYGE_IS_DEV_PLATFORM
 		void Load(std::string const & name);
@@ -987,11 +1023,26 @@ namespace KlayGE
 
 		void Dirty(bool dirty)
 		{
-			dirty_ = dirty;
+			if (dirty)
+			{
+				dirty_begin_ = 0;
+				dirty_end_ = 0xFFFFFFFF;
+			}
+			else
+			{
+				dirty_begin_ = 0xFFFFFFFF;
+				dirty_end_ = 0;
+			}
 		}
 		bool Dirty() const
 		{
-			return dirty_;
+			return dirty_begin_ < dirty_end_;
+		}
+		// Only the range changed since the last Update is uploaded, if the device can update a part of a cbuffer
+		void DirtyRange(uint32_t offset, uint32_t size)
+		{
+			dirty_begin_ = std::min(dirty_begin_, offset);
+			dirty_end_ = std::max(dirty_end_, offset + size);
 		}
 
 		void Update();
@@ -1007,7 +1058,9 @@ namespace KlayGE
 
 		GraphicsBufferPtr hw_buff_;
 		std::vector<uint8_t> buff_;
-		bool dirty_;
+		uint32_t dirty_begin_;
+		uint32_t dirty_end_;
+		bool partial_update_;
 	};
 
 	class KLAYGE_CORE_API RenderEffectParameter : boost::noncopyable
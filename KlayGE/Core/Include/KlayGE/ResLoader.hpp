@@ -37,19 +37,9 @@
 #include <istream>
 #include <vector>
 #include <string>
-#if defined(KLAYGE_COMPILER_MSVC)
-#pragma warning(push)
-#pragma warning(disable: 4512) // consume_via_copy in lockfree doesn't have assignment operator.
-#elif defined(KLAYGE_COMPILER_CLANG)
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter 'x', 'alloc'
-#endif
-#include <boost/lockfree/spsc_queue.hpp>
-#if defined(KLAYGE_COMPILER_MSVC)
-#pragma warning(pop)
-#elif defined(KLAYGE_COMPILER_CLANG)
-#pragma clang diagnostic pop
-#endif
+#include <unordered_map>
+#include <atomic>
+#include <condition_variable>
 
 #include <KFL/ResIdentifier.hpp>
 #include <KFL/Thread.hpp>
@@ -76,6 +66,12 @@ namespace KlayGE
 
 		virtual bool HasSubThreadStage() const = 0;
 
+		// A key of the content that Match compares, descs that match must have the same hash. The default one only
+		//  hashes the type, which is correct but makes all descs of this type share one bucket.
+		virtual size_t Hash() const
+		{
+			return static_cast<size_t>(this->Type());
+		}
 		virtual bool Match(ResLoadingDesc const & rhs) const = 0;
 		virtual void CopyDataFrom(ResLoadingDesc const & rhs) = 0;
 		virtual std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) = 0;
@@ -83,6 +79,16 @@ namespace KlayGE
 		virtual std::shared_ptr<void> Resource() const = 0;
 	};
 
+	// The order in which the loading threads pick up asynchronous requests, and the main thread stages run
+	enum ResLoadingPriority
+	{
+		// Needed for the current frame
+		RLP_High = 0,
+		RLP_Normal,
+		// Prefetched for later use
+		RLP_Low
+	};
+
 	class KLAYGE_CORE_API ResLoader : boost::noncopyable
 	{
 	public:
@@ -107,7 +113,7 @@ namespace KlayGE
 		std::string AbsPath(std::string const & path);
 
 		std::shared_ptr<void> SyncQuery(ResLoadingDescPtr const & res_desc);
-		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const & res_desc);
+		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const & res_desc, ResLoadingPriority priority = RLP_Normal);
 		void Unload(std::shared_ptr<void> const & res);
 
 		template <typename T>
@@ -117,9 +123,9 @@ namespace KlayGE
 		}
 
 		template <typename T>
-		std::shared_ptr<T> ASyncQueryT(ResLoadingDescPtr const & res_desc)
+		std::shared_ptr<T> ASyncQueryT(ResLoadingDescPtr const & res_desc, ResLoadingPriority priority = RLP_Normal)
 		{
-			return std::static_pointer_cast<T>(this->ASyncQuery(res_desc));
+			return std::static_pointer_cast<T>(this->ASyncQuery(res_desc, priority));
 		}
 
 		template <typename T>
@@ -130,17 +136,39 @@ namespace KlayGE
 
 		void Update();
 
+		// Time in ms that Update can spend on main thread stages per frame. 0 means unlimited.
+		void MainThreadStageBudget(float budget)
+		{
+			main_thread_stage_budget_ = budget;
+		}
+		float MainThreadStageBudget() const
+		{
+			return main_thread_stage_budget_;
+		}
+
+		uint32_t NumLoadingThreads() const
+		{
+			return static_cast<uint32_t>(loading_threads_.size());
+		}
+
 	private:
 		std::string RealPath(std::string const & path);
 
 		void AddLoadedResource(ResLoadingDescPtr const & res_desc, std::shared_ptr<void> const & res);
 		std::shared_ptr<void> FindMatchLoadedResource(ResLoadingDescPtr const & res_desc);
 		void RemoveUnrefResources();
+		void RemoveLoadedResource(size_t index);
 
 		void LoadingThreadFunc();
 
-		ResIdentifierPtr LocatePkt(std::string const & name, std::string const & res_name,
+		// Splits a name inside a package into the package, its password and the entry. Doesn't open the package,
+		//  ArchiveCache does that only when it needs to.
+		bool LocatePkt(std::string const & res_name, std::string& pkt_name, uint64_t& timestamp,
 			std::string& password, std::string& internal_name);
+#if !(defined(KLAYGE_PLATFORM_ANDROID) || defined(KLAYGE_PLATFORM_IOS))
+		struct ResolvedPath;
+		ResolvedPath const * Resolve(std::string const & name);
+#endif
 #if defined(KLAYGE_PLATFORM_ANDROID)
 		AAsset* LocateFileAndroid(std::string const & name);
 #elif defined(KLAYGE_PLATFORM_IOS)
@@ -155,24 +183,78 @@ namespace KlayGE
 		enum LoadingStatus
 		{
 			LS_Loading,
+			// Claimed by one thread, which is running the sub thread stage
+			LS_SubThreadStage,
 			LS_Complete,
 			LS_CanBeRemoved
 		};
 
+		struct LoadedResource
+		{
+			ResLoadingDescPtr res_desc;
+			std::weak_ptr<void> res;
+			size_t hash;
+		};
+
+		struct LoadingRequest
+		{
+			ResLoadingDescPtr res_desc;
+			std::shared_ptr<std::atomic<LoadingStatus>> status;
+			ResLoadingPriority priority;
+			uint64_t sequence;
+
+			// Higher priority first, then first in first out
+			bool operator<(LoadingRequest const & rhs) const
+			{
+				return (priority != rhs.priority) ? (priority > rhs.priority) : (sequence > rhs.sequence);
+			}
+		};
+
 		std::string exe_path_;
 		std::string local_path_;
 		std::vector<std::string> paths_;
 		std::mutex paths_mutex_;
 
+#if !(defined(KLAYGE_PLATFORM_ANDROID) || defined(KLAYGE_PLATFORM_IOS))
+		// Where a logical name was found, either a loose file or an entry of a package
+		struct ResolvedPath
+		{
+			std::string path;
+			std::string res_name;
+			bool in_package;
+		};
+
+		// Guarded by paths_mutex_
+		std::unordered_map<std::string, ResolvedPath> resolved_paths_;
+		// Opened packages with their entry tables
+		std::unique_ptr<ArchiveCache> archive_cache_;
+#endif
+
 		std::mutex loaded_mutex_;
 		std::mutex loading_mutex_;
-		std::vector<std::pair<ResLoadingDescPtr, std::weak_ptr<void>>> loaded_res_;
-		std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> loading_res_;
-		boost::lockfree::spsc_queue<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>,
-			boost::lockfree::capacity<1024>> loading_res_queue_;
+		std::vector<LoadedResource> loaded_res_;
+		// Maps ResLoadingDesc::Hash to the indices in loaded_res_
+		std::unordered_multimap<size_t, size_t> loaded_res_index_;
+		// Where the next incremental sweep of unreferenced resources starts
+		size_t unref_sweep_cursor_;
+#ifndef KLAYGE_SHIP
+		// Created on the first loaded resource, guarded by loaded_mutex_
+		PerfCounterPtr loaded_res_counter_;
+#endif
+		std::unordered_multimap<size_t, LoadingRequest> loading_res_;
+		uint64_t loading_sequence_;
+
+		// A priority heap of requests waiting for their sub thread stage
+		std::vector<LoadingRequest> loading_res_queue_;
+		std::mutex loading_queue_mutex_;
+		std::condition_variable loading_queue_cond_;
+		// Notified under loading_queue_mutex_ when a sub thread stage finishes
+		std::condition_variable loading_done_cond_;
 
-		std::unique_ptr<joiner<void>> loading_thread_;
+		std::vector<joiner<void>> loading_threads_;
 		volatile bool quit_;
+
+		float main_thread_stage_budget_;
 	};
 }
 
@@ -27,6 +27,7 @@
 #include <KFL/Frustum.hpp>
 #include <KFL/Thread.hpp>
 
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 
@@ -34,6 +35,14 @@ namespace KlayGE
 {
 	class KLAYGE_CORE_API SceneManager : boost::noncopyable
 	{
+	public:
+		// A camera to cull the scene for, optionally cropped to one of the cascades of the cascaded shadow
+		struct CullingView
+		{
+			Camera const * camera;
+			int32_t cascade_index;
+		};
+
 	public:
 		SceneManager();
 		virtual ~SceneManager();
@@ -43,7 +52,12 @@ namespace KlayGE
 
 		void SmallObjectThreshold(float area);
 		void SceneUpdateElapse(float elapse);
-		virtual void ClipScene();
+
+		// Culls the scene for several views in one walk, and caches the results for this frame. The Flush of these views
+		//  only looks the visibility up. Views already cached are skipped. The scene is locked against the update thread
+		//  during the cull, CullViewsLocked is for callers that hold the lock already.
+		void CullViews(CullingView const * views, uint32_t num_views);
+		void CullViewsLocked(CullingView const * views, uint32_t num_views);
 
 		void AddCamera(CameraPtr const & camera);
 		void DelCamera(CameraPtr const & camera);
@@ -100,6 +114,29 @@ namespace KlayGE
 		virtual void DoResume() = 0;
 
 		void UpdateThreadFunc();
+		// A round of the update thread, and the publishing of the objects updated out of the lock in the main thread
+		void SubThreadUpdate(float app_time, float elapsed_time);
+		void PublishSubThreadUpdate();
+
+		// Everything a view is culled with, and the marks of scene_objs_ it gets
+		struct ClipView
+		{
+			Camera const * camera;
+			int32_t cascade_index;
+			size_t key;
+			float4x4 view_proj;
+			Frustum frustum;
+			bool omni_directional;
+
+			std::vector<BoundOverlap> marks;
+		};
+		// Views are tracked in 32-bit masks while walking a spatial structure
+		static uint32_t const MAX_CLIP_VIEWS = 32;
+
+		virtual void ClipScene(std::vector<ClipView>& views);
+		size_t VisibleSeed() const;
+		ClipView MakeClipView(CullingView const & view, size_t visible_seed) const;
+		void ClipAndCacheViews();
 
 		BoundOverlap VisibleTestFromParent(SceneObject* obj, float3 const & view_dir, float3 const & eye_pos,
 			float4x4 const & view_proj);
@@ -111,18 +148,50 @@ namespace KlayGE
 		std::vector<SceneObjectPtr> scene_objs_;
 		std::vector<SceneObjectPtr> overlay_scene_objs_;
 
-		std::unordered_map<size_t, std::shared_ptr<std::vector<BoundOverlap>>> visible_marks_map_;
+		// One bit per object in scene_objs_ for each view culled in this frame
+		std::unordered_map<size_t, std::vector<uint32_t>> visible_bits_map_;
+		std::vector<ClipView> clip_views_;
 
 		float small_obj_threshold_;
 		float update_elapse_;
 
+		// Culling data of scene_objs_, packed in structure of arrays so the bounds can be tested in batches
+		struct CullingSoA
+		{
+			std::vector<uint32_t> attribs;
+			std::vector<float> center_x;
+			std::vector<float> center_y;
+			std::vector<float> center_z;
+			std::vector<float> extent_x;
+			std::vector<float> extent_y;
+			std::vector<float> extent_z;
+			// Per view, num_views blocks of the objects
+			std::vector<uint8_t> large_enough;
+			std::vector<BoundOverlap> overlaps;
+
+			void Resize(uint32_t num, uint32_t num_views);
+		};
+		CullingSoA culling_soa_;
+
 	private:
 		void FlushScene();
+		void SortRenderQueue(Camera const & camera);
 
 	private:
 		uint32_t urt_;
 
-		std::vector<std::pair<RenderTechnique const *, std::vector<Renderable*>>> render_queue_;
+		std::vector<std::pair<RenderTechnique const *, Renderable*>> render_queue_;
+
+		// Scratch of SortRenderQueue, kept around to avoid allocations every frame
+		std::vector<RenderTechnique const *> render_techs_;
+		std::vector<uint32_t> render_tech_order_;
+		std::vector<uint32_t> render_tech_ranks_;
+		std::vector<uint32_t> render_tech_indices_;
+		std::vector<RenderLayout const *> render_layouts_;
+		std::vector<uint64_t> render_keys_;
+		std::vector<uint64_t> render_keys_tmp_;
+		std::vector<uint32_t> render_indices_;
+		std::vector<uint32_t> render_indices_tmp_;
 
 		uint32_t num_objects_rendered_;
 		uint32_t num_renderables_rendered_;
@@ -135,6 +204,13 @@ namespace KlayGE
 		std::unique_ptr<joiner<void>> update_thread_;
 		volatile bool quit_;
 
+		// Objects updated by the last round of the update thread. The SOA_ParallelUpdate ones are updated out of the
+		//  lock into back buffers. While sub_thread_update_ready_ is true, the update thread waits for the main thread
+		//  to publish them.
+		std::vector<SceneObjectPtr> sub_thread_objs_;
+		std::vector<SceneObject*> sub_thread_parallel_objs_;
+		std::atomic<bool> sub_thread_update_ready_;
+
 		bool deferred_mode_;
 	};
 }
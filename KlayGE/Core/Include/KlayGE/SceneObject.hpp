@@ -35,7 +35,10 @@ namespace KlayGE
 			SOA_Moveable = 1UL << 2,
 			SOA_Invisible = 1UL << 3,
 			SOA_NotCastShadow = 1UL << 4,
-			SOA_SSS = 1UL << 5
+			SOA_SSS = 1UL << 5,
+			// SubThreadUpdate only changes ModelMatrix and Visible of this object, so it can run without the update lock,
+			//  in parallel with other objects'
+			SOA_ParallelUpdate = 1UL << 6
 		};
 
 	public:
@@ -70,6 +73,11 @@ namespace KlayGE
 		virtual void SubThreadUpdate(float app_time, float elapsed_time);
 		virtual bool MainThreadUpdate(float app_time, float elapsed_time);
 
+		// Calls SubThreadUpdate with ModelMatrix and Visible redirected to a back buffer, which is copied to the
+		//  rendering state by PublishSubThreadUpdate in the main thread.
+		void BufferedSubThreadUpdate(float app_time, float elapsed_time);
+		void PublishSubThreadUpdate();
+
 		uint32_t Attrib() const;
 		bool Visible() const;
 		void Visible(bool vis);
@@ -109,6 +117,11 @@ namespace KlayGE
 
 		std::function<void(SceneObject&, float, float)> sub_thread_update_func_;
 		std::function<void(SceneObject&, float, float)> main_thread_update_func_;
+
+		float4x4 sub_thread_model_;
+		bool sub_thread_model_dirty_;
+		bool sub_thread_visible_;
+		bool sub_thread_visible_dirty_;
 	};
 }
 
@@ -101,10 +101,11 @@ namespace KlayGE
 		}
 
 		virtual bool AttachNativeShader(ShaderType type, RenderEffect const & effect,
-			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids, std::vector<uint8_t> const & native_shader_block) = 0;
+			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids,
+			uint8_t const * native_shader_block, size_t native_shader_block_size) = 0;
 
-		virtual bool StreamIn(ResIdentifierPtr const & res, ShaderType type, RenderEffect const & effect,
-			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids) = 0;
+		bool StreamIn(ResIdentifierPtr const & res, ShaderType type, RenderEffect const & effect,
+			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids);
 		virtual void StreamOut(std::ostream& os, ShaderType type) = 0;
 
 		virtual void AttachShader(ShaderType type, RenderEffect const & effect,
@@ -55,6 +55,10 @@ namespace KlayGE
 	class KLAYGE_CORE_API TexCompression : boost::noncopyable
 	{
 	public:
+		TexCompression()
+			: thread_safe_encoding_(false)
+		{
+		}
 		virtual ~TexCompression()
 		{
 		}
@@ -83,6 +87,11 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) = 0;
 		virtual void DecodeBlock(void* output, void const * input) = 0;
 
+		// Encodes num_blocks blocks stored one after another, in both input and output. Codecs can override it to
+		//  work on several blocks at once. The result must be the same as calling EncodeBlock one by one.
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method);
+
+		// Rows of blocks are encoded in parallel if the codec's EncodeBlock can be called from several threads
 		virtual void EncodeMem(uint32_t width, uint32_t height, 
 			void* output, uint32_t out_row_pitch, uint32_t out_slice_pitch,
 			void const * input, uint32_t in_row_pitch, uint32_t in_slice_pitch,
@@ -94,12 +103,18 @@ namespace KlayGE
 		virtual void EncodeTex(TexturePtr const & out_tex, TexturePtr const & in_tex, TexCompressionMethod method);
 		virtual void DecodeTex(TexturePtr const & out_tex, TexturePtr const & in_tex);
 
+	private:
+		void EncodeBlockRows(uint32_t width, uint32_t height, uint32_t row_begin, uint32_t row_end,
+			void* output, uint32_t out_row_pitch, void const * input, uint32_t in_row_pitch,
+			TexCompressionMethod method);
+
 	protected:
 		uint32_t block_width_;
 		uint32_t block_height_;
 		uint32_t block_depth_;
 		uint32_t block_bytes_;
 		ElementFormat decoded_fmt_;
+		bool thread_safe_encoding_;
 	};
 
 	class ARGBColor32 : boost::equality_comparable<ARGBColor32>
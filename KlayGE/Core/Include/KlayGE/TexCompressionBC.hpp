@@ -121,6 +121,7 @@ namespace KlayGE
 		TexCompressionBC4();
 
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 	};
 
@@ -130,6 +131,7 @@ namespace KlayGE
 		TexCompressionBC3();
 
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
 	private:
@@ -143,6 +145,7 @@ namespace KlayGE
 		TexCompressionBC5();
 
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
 	private:
@@ -157,12 +160,24 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
+		void EncodeBC6Internal(void* output, void const * input, TexCompressionMethod method, bool signed_fmt);
 		void DecodeBC6Internal(void* output, void const * input, bool signed_fmt);
 
 	private:
+		struct CompressParams;
+
+		int Quantize(int comp, uint8_t bits_per_comp, bool signed_fmt);
 		int Unquantize(int comp, uint8_t bits_per_comp, bool signed_fmt);
 		int FinishUnquantize(int comp, bool signed_fmt);
 
+		void TryMode(uint32_t mode_index, uint32_t shape, std::pair<float3, float3> const * fitted_end_pts,
+			int3 const * texels, bool signed_fmt, CompressParams& best);
+		void ClampEndpointsToDeltas(CompressParams& params) const;
+		bool EndpointsFitDeltas(CompressParams const & params) const;
+		uint64_t AssignIndices(CompressParams& params, int3 const * texels, bool signed_fmt);
+		void RefineEndpoints(CompressParams& params, int3 const * texels, bool signed_fmt);
+		void PackBC6Block(void* output, CompressParams const & params) const;
+
 	private:
 		static uint32_t const BC6_MAX_REGIONS = 2;
 		static uint32_t const BC6_MAX_INDICES = 16;
@@ -205,6 +220,16 @@ namespace KlayGE
 			ARGBColor32 rgba_prec[BC6_MAX_REGIONS][2];
 		};
 
+		struct CompressParams
+		{
+			uint32_t mode_index;
+			uint32_t shape;
+			// Quantized end points of the regions, before the delta transform
+			std::array<std::pair<int3, int3>, BC6_MAX_REGIONS> end_pts;
+			std::array<uint8_t, 16> indices;
+			uint64_t error;
+		};
+
 		static ModeDescriptor const mode_desc_[][82];
 		static ModeInfo const mode_info_[];
 		static int const mode_to_info_[];
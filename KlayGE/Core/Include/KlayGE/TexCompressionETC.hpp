@@ -132,7 +132,9 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
-		uint64_t EncodeETC1BlockInternal(ETC1Block& output, ARGBColor32 const * argb, TexCompressionMethod method);
+		// ETC2 punch-through formats have no individual mode, so they need diff_only
+		uint64_t EncodeETC1BlockInternal(ETC1Block& output, ARGBColor32 const * argb, TexCompressionMethod method,
+			bool diff_only);
 		void DecodeETCIndividualModeInternal(ARGBColor32* argb, ETC1Block const & etc1) const;
 		void DecodeETCDifferentialModeInternal(ARGBColor32* argb, ETC1Block const & etc1, bool alpha) const;
 
@@ -213,10 +215,21 @@ namespace KlayGE
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
+		// With punchthrough, texels with alpha < 128 are encoded as transparent, and the opaque bit replaces the diff bit
+		uint64_t EncodeETC2BlockInternal(ETC2Block& output, ARGBColor32 const * argb, TexCompressionMethod method,
+			bool punchthrough);
 		void DecodeETCTModeInternal(ARGBColor32* argb, ETC2TModeBlock const & etc2, bool alpha);
 		void DecodeETCHModeInternal(ARGBColor32* argb, ETC2HModeBlock const & etc2, bool alpha);
 		void DecodeETCPlanarModeInternal(ARGBColor32* argb, ETC2PlanarModeBlock const & etc2);
 
+	private:
+		uint64_t EncodeETCTHModeInternal(ETC2Block& output, ARGBColor32 const * argb, bool const * transparent,
+			TexCompressionMethod method, bool h_mode);
+		uint64_t EncodeETCDifferentialPunchthroughInternal(ETC1Block& output, ARGBColor32 const * argb,
+			bool const * transparent, TexCompressionMethod method);
+		uint64_t EncodeETCPlanarModeInternal(ETC2PlanarModeBlock& output, ARGBColor32 const * argb,
+			TexCompressionMethod method);
+
 	private:
 		TexCompressionETC1Ptr etc1_codec_;
 	};
@@ -233,6 +246,68 @@ namespace KlayGE
 		TexCompressionETC1Ptr etc1_codec_;
 		TexCompressionETC2RGB8Ptr etc2_rgb8_codec_;
 	};
+
+	class KLAYGE_CORE_API TexCompressionETC2RGBA8 : public TexCompression
+	{
+	public:
+		TexCompressionETC2RGBA8();
+
+		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void DecodeBlock(void* output, void const * input) override;
+
+	private:
+		TexCompressionETC2RGB8Ptr etc2_rgb8_codec_;
+	};
+
+	class KLAYGE_CORE_API TexCompressionETC2R11 : public TexCompression
+	{
+	public:
+		TexCompressionETC2R11();
+
+		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void DecodeBlock(void* output, void const * input) override;
+
+		// Texels are stride bytes apart, so a channel of EF_GR8 can be used in place
+		void EncodeR11Internal(void* output, void const * input, uint32_t stride, TexCompressionMethod method,
+			bool signed_fmt);
+		void DecodeR11Internal(void* output, uint32_t stride, void const * input, bool signed_fmt);
+	};
+
+	class KLAYGE_CORE_API TexCompressionETC2SignedR11 : public TexCompression
+	{
+	public:
+		TexCompressionETC2SignedR11();
+
+		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void DecodeBlock(void* output, void const * input) override;
+
+	private:
+		TexCompressionETC2R11 r11_codec_;
+	};
+
+	class KLAYGE_CORE_API TexCompressionETC2RG11 : public TexCompression
+	{
+	public:
+		TexCompressionETC2RG11();
+
+		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void DecodeBlock(void* output, void const * input) override;
+
+	private:
+		TexCompressionETC2R11 r11_codec_;
+	};
+
+	class KLAYGE_CORE_API TexCompressionETC2SignedRG11 : public TexCompression
+	{
+	public:
+		TexCompressionETC2SignedRG11();
+
+		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
+		virtual void DecodeBlock(void* output, void const * input) override;
+
+	private:
+		TexCompressionETC2R11 r11_codec_;
+	};
 }
 
 #endif		// _TEXCOMPRESSIONETC_HPP
@@ -332,11 +332,34 @@ namespace KlayGE
 		ElementFormat format, std::vector<ElementInitData> const & init_data);
 	KLAYGE_CORE_API void SaveTexture(TexturePtr const & texture, std::string const & tex_name);
 
+	enum TexResizeFilter
+	{
+		TRF_Point,
+		// Samples 2 texels per axis like a GPU bilinear filter, without widening the footprint when minifying
+		TRF_Bilinear,
+		TRF_Box,
+		TRF_Kaiser,
+		TRF_Lanczos3
+	};
+
+	// Same as TRF_Point or TRF_Bilinear
 	KLAYGE_CORE_API void ResizeTexture(void* dst_data, uint32_t dst_row_pitch, uint32_t dst_slice_pitch, ElementFormat dst_format,
 		uint32_t dst_width, uint32_t dst_height, uint32_t dst_depth,
 		void const * src_data, uint32_t src_row_pitch, uint32_t src_slice_pitch, ElementFormat src_format,
 		uint32_t src_width, uint32_t src_height, uint32_t src_depth,
 		bool linear);
+	// Filters in linear space, one axis at a time. Box, Kaiser and Lanczos3 widen with the minification ratio.
+	KLAYGE_CORE_API void ResizeTexture(void* dst_data, uint32_t dst_row_pitch, uint32_t dst_slice_pitch, ElementFormat dst_format,
+		uint32_t dst_width, uint32_t dst_height, uint32_t dst_depth,
+		void const * src_data, uint32_t src_row_pitch, uint32_t src_slice_pitch, ElementFormat src_format,
+		uint32_t src_width, uint32_t src_height, uint32_t src_depth,
+		TexResizeFilter filter);
+	// Builds num_mipmaps levels from the given level 0. The source is converted to float once, and each level is filtered from
+	//  the float data of the previous one. mip_data points into data_block.
+	KLAYGE_CORE_API void BuildMipChain(std::vector<ElementInitData>& mip_data, std::vector<uint8_t>& data_block,
+		ElementFormat format, uint32_t width, uint32_t height, uint32_t depth, uint32_t num_mipmaps,
+		void const * src_data, uint32_t src_row_pitch, uint32_t src_slice_pitch,
+		TexResizeFilter filter);
 
 	// return the lookat and up vector in cubemap view
 	//////////////////////////////////////////////////////////////////////////////////
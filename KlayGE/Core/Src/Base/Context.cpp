@@ -34,6 +34,7 @@
 #include <KFL/XMLDom.hpp>
 #include <KlayGE/DeferredRenderingLayer.hpp>
 #include <KFL/Thread.hpp>
+#include <KFL/TaskScheduler.hpp>
 #include <KlayGE/PerfProfiler.hpp>
 #include <KlayGE/UI.hpp>
 #include <KFL/Hash.hpp>
@@ -100,6 +101,7 @@ namespace KlayGE
 #endif
 
 		gtp_instance_ = MakeUniquePtr<thread_pool>(1, 16);
+		task_scheduler_instance_ = MakeUniquePtr<task_scheduler>();
 	}
 
 	Context::~Context()
@@ -124,6 +126,7 @@ namespace KlayGE
 
 		app_ = nullptr;
 
+		task_scheduler_instance_.reset();
 		gtp_instance_.reset();
 	}
 
@@ -147,6 +150,8 @@ namespace KlayGE
 		{
 			context_instance_->DestroyAll();
 			context_instance_.reset();
+
+			LogShutdown();
 		}
 	}
 
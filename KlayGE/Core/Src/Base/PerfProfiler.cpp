@@ -31,6 +31,7 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/RenderEngine.hpp>
+#include <KlayGE/SceneManager.hpp>
 #include <KlayGE/Query.hpp>
 #include <KFL/Thread.hpp>
 
@@ -40,15 +41,56 @@
 
 namespace
 {
+	using namespace KlayGE;
+
 	std::mutex singleton_mutex;
+
+	// Must be a power of 2
+	uint32_t const THREAD_EVENTS_CAPACITY = 1UL << 16;
+	uint32_t const MAX_RECORDED_FRAMES = 1024;
+
+	std::atomic<uint32_t> profiler_id_counter(1);
+
+	// Each thread caches its event buffer of the last profiler it touched
+	thread_local uint32_t tls_profiler_id = 0;
+	thread_local void* tls_thread_events = nullptr;
+
+	void WriteJsonString(std::ostream& os, char const * str)
+	{
+		os << '"';
+		for (char const * p = str; *p; ++ p)
+		{
+			char const ch = *p;
+			if (('"' == ch) || ('\\' == ch))
+			{
+				os << '\\' << ch;
+			}
+			else if (static_cast<unsigned char>(ch) >= 0x20)
+			{
+				os << ch;
+			}
+		}
+		os << '"';
+	}
 }
 
 namespace KlayGE
 {
+	// Only the owner thread writes to the ring, so no lock is needed. num_events is published with release order, and
+	//  exporting while the owner is wrapping around could read a few overwritten events.
+	struct PerfProfiler::ThreadEvents
+	{
+		uint32_t thread_index;
+		uint32_t depth;
+		std::vector<PerfProfiler::Event> events;
+		std::atomic<uint64_t> num_events;
+	};
+
 	std::unique_ptr<PerfProfiler> PerfProfiler::perf_profiler_instance_;
 
-	PerfRange::PerfRange()
-		: cpu_time_(0), gpu_time_(0), dirty_(false)
+	PerfRange::PerfRange(int category, std::string const & name)
+		: category_(category), name_(name),
+			cpu_begin_(0), cpu_time_(0), gpu_time_(0), recording_(false), dirty_(false)
 	{
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 		gpu_timer_query_ = rf.MakeTimerQuery();
@@ -56,10 +98,12 @@ namespace KlayGE
 
 	void PerfRange::Begin()
 	{
-		if (Context::Instance().Config().perf_profiler)
+		PerfProfiler& profiler = PerfProfiler::Instance();
+		if (profiler.Enabled())
 		{
+			recording_ = true;
 			dirty_ = true;
-			cpu_timer_.restart();
+			cpu_begin_ = profiler.BeginScope();
 			if (gpu_timer_query_)
 			{
 				gpu_timer_query_->Begin();
@@ -69,13 +113,14 @@ namespace KlayGE
 
 	void PerfRange::End()
 	{
-		if (Context::Instance().Config().perf_profiler)
+		if (recording_)
 		{
-			cpu_time_ = cpu_timer_.elapsed();
+			cpu_time_ = PerfProfiler::Instance().EndScope(name_.c_str(), cpu_begin_);
 			if (gpu_timer_query_)
 			{
 				gpu_timer_query_->End();
 			}
+			recording_ = false;
 		}
 	}
 
@@ -91,6 +136,21 @@ namespace KlayGE
 		}
 	}
 
+	int PerfRange::Category() const
+	{
+		return category_;
+	}
+
+	std::string const & PerfRange::Name() const
+	{
+		return name_;
+	}
+
+	double PerfRange::CPUBegin() const
+	{
+		return cpu_begin_;
+	}
+
 	double PerfRange::CPUTime() const
 	{
 		return cpu_time_;
@@ -107,8 +167,49 @@ namespace KlayGE
 	}
 
 
+	PerfCounter::PerfCounter(PerfProfiler& profiler, std::string const & name)
+		: profiler_(profiler), name_(name)
+	{
+	}
+
+	void PerfCounter::Value(double value)
+	{
+		profiler_.Counter(name_.c_str(), value);
+	}
+
+	std::string const & PerfCounter::Name() const
+	{
+		return name_;
+	}
+
+
+	PerfScope::PerfScope(char const * name)
+		: name_(name), begin_(0)
+	{
+		PerfProfiler& profiler = PerfProfiler::Instance();
+		recording_ = profiler.Enabled();
+		if (recording_)
+		{
+			begin_ = profiler.BeginScope();
+		}
+	}
+
+	PerfScope::~PerfScope()
+	{
+		if (recording_)
+		{
+			PerfProfiler::Instance().EndScope(name_, begin_);
+		}
+	}
+
+
 	PerfProfiler::PerfProfiler()
-		: frame_id_(0)
+		: id_(profiler_id_counter.fetch_add(1, std::memory_order_relaxed)),
+			enabled_(Context::Instance().Config().perf_profiler), frame_id_(0)
+	{
+	}
+
+	PerfProfiler::~PerfProfiler()
 	{
 	}
 
@@ -141,37 +242,120 @@ namespace KlayGE
 
 	PerfRangePtr PerfProfiler::CreatePerfRange(int category, std::string const & name)
 	{
-		PerfRangePtr range = MakeSharedPtr<PerfRange>();
+		PerfRangePtr range = MakeSharedPtr<PerfRange>(category, name);
 		typedef std::remove_reference<decltype(std::get<3>(perf_ranges_[0]))>::type PerfDataType;
 		perf_ranges_.push_back(std::make_tuple(category, name, range, PerfDataType()));
 		return range;
 	}
 
+	PerfCounterPtr PerfProfiler::CreatePerfCounter(std::string const & name)
+	{
+		PerfCounterPtr counter = MakeSharedPtr<PerfCounter>(*this, name);
+
+		std::lock_guard<std::mutex> lock(threads_mutex_);
+		perf_counters_.push_back(counter);
+		return counter;
+	}
+
 	void PerfProfiler::CollectData()
 	{
-		if (Context::Instance().Config().perf_profiler)
+		bool const enabled = Context::Instance().Config().perf_profiler;
+		enabled_.store(enabled, std::memory_order_relaxed);
+		if (enabled)
 		{
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 			RenderEngine& re = rf.RenderEngineInstance();
 			re.UpdateGPUTimestampsFrequency();
 
+			uint32_t const frame_id = this->FrameID();
 			for (auto& range : perf_ranges_)
 			{
-				if (std::get<2>(range)->Dirty())
+				PerfRange& pr = *std::get<2>(range);
+				if (pr.Dirty())
 				{
-					std::get<2>(range)->CollectData();
-					std::get<3>(range).push_back(std::make_tuple(frame_id_,
-						std::get<2>(range)->CPUTime(), std::get<2>(range)->GPUTime()));
+					pr.CollectData();
+
+					auto& data = std::get<3>(range);
+					data.push_back(std::make_tuple(frame_id, pr.CPUBegin(), pr.CPUTime(), pr.GPUTime()));
+					if (data.size() > MAX_RECORDED_FRAMES)
+					{
+						data.pop_front();
+					}
 				}
 			}
 
-			++ frame_id_;
+			SceneManager& sm = Context::Instance().SceneManagerInstance();
+			this->Counter("Objects", sm.NumObjectsRendered());
+			this->Counter("Primitives", sm.NumPrimitivesRendered());
+			this->Counter("Draws", sm.NumDrawCalls());
+			this->Counter("Dispatches", sm.NumDispatchCalls());
+
+			frame_id_.fetch_add(1, std::memory_order_relaxed);
 		}
 	}
 
+	void PerfProfiler::Counter(char const * name, double value)
+	{
+		if (this->Enabled())
+		{
+			Event const ev = { name, this->Now(), value, this->FrameID(), 0, true };
+			this->RecordEvent(this->CurrentThreadEvents(), ev);
+		}
+	}
+
+	double PerfProfiler::Now() const
+	{
+		return timer_.elapsed();
+	}
+
+	double PerfProfiler::BeginScope()
+	{
+		++ this->CurrentThreadEvents().depth;
+		return this->Now();
+	}
+
+	double PerfProfiler::EndScope(char const * name, double begin)
+	{
+		double const duration = this->Now() - begin;
+
+		ThreadEvents& te = this->CurrentThreadEvents();
+		BOOST_ASSERT(te.depth > 0);
+		-- te.depth;
+
+		Event const ev = { name, begin, duration, this->FrameID(), te.depth, false };
+		this->RecordEvent(te, ev);
+
+		return duration;
+	}
+
+	PerfProfiler::ThreadEvents& PerfProfiler::CurrentThreadEvents()
+	{
+		if (tls_profiler_id != id_)
+		{
+			auto te = MakeUniquePtr<ThreadEvents>();
+			te->depth = 0;
+			te->events.resize(THREAD_EVENTS_CAPACITY);
+			te->num_events.store(0, std::memory_order_relaxed);
+
+			std::lock_guard<std::mutex> lock(threads_mutex_);
+			te->thread_index = static_cast<uint32_t>(threads_.size());
+			tls_thread_events = te.get();
+			tls_profiler_id = id_;
+			threads_.push_back(std::move(te));
+		}
+		return *static_cast<ThreadEvents*>(tls_thread_events);
+	}
+
+	void PerfProfiler::RecordEvent(ThreadEvents& te, Event const & ev)
+	{
+		uint64_t const n = te.num_events.load(std::memory_order_relaxed);
+		te.events[n & (THREAD_EVENTS_CAPACITY - 1)] = ev;
+		te.num_events.store(n + 1, std::memory_order_release);
+	}
+
 	void PerfProfiler::ExportToCSV(std::string const & file_name) const
 	{
-		if (Context::Instance().Config().perf_profiler)
+		if (this->Enabled())
 		{
 			std::ofstream ofs(file_name.c_str());
 			ofs << "Frame" << ',' << "Category" << ',' << "Name" << ','
@@ -182,10 +366,10 @@ namespace KlayGE
 				for (auto const & data : std::get<3>(range))
 				{
 					ofs << std::get<0>(data) << ',' << std::get<0>(range) << ',' << std::get<1>(range) << ','
-						<< std::get<1>(data) * 1000 << ',';
-					if (std::get<2>(data) >= 0)
+						<< std::get<2>(data) * 1000 << ',';
+					if (std::get<3>(data) >= 0)
 					{
-						ofs << std::get<2>(data) * 1000;
+						ofs << std::get<3>(data) * 1000;
 					}
 					ofs << std::endl;
 				}
@@ -194,4 +378,82 @@ namespace KlayGE
 			ofs << std::endl;
 		}
 	}
+
+	void PerfProfiler::ExportToTrace(std::string const & file_name) const
+	{
+		if (!this->Enabled())
+		{
+			return;
+		}
+
+		std::ofstream ofs(file_name.c_str());
+		ofs.setf(std::ios_base::fixed);
+		ofs.precision(3);
+
+		bool first = true;
+		auto begin_event = [&ofs, &first]()
+		{
+			ofs << (first ? "" : ",") << std::endl << "{";
+			first = false;
+		};
+
+		ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		std::lock_guard<std::mutex> lock(threads_mutex_);
+
+		// GPU ranges go to a track after all the threads
+		uint32_t const gpu_tid = static_cast<uint32_t>(threads_.size());
+		for (auto const & te : threads_)
+		{
+			begin_event();
+			ofs << "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << te->thread_index
+				<< ",\"args\":{\"name\":\"Thread " << te->thread_index << "\"}}";
+		}
+		begin_event();
+		ofs << "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << gpu_tid << ",\"args\":{\"name\":\"GPU\"}}";
+
+		for (auto const & te : threads_)
+		{
+			uint64_t const num_events = te->num_events.load(std::memory_order_acquire);
+			uint64_t const first_event = (num_events > THREAD_EVENTS_CAPACITY) ? num_events - THREAD_EVENTS_CAPACITY : 0;
+			for (uint64_t i = first_event; i < num_events; ++ i)
+			{
+				Event const & ev = te->events[i & (THREAD_EVENTS_CAPACITY - 1)];
+
+				begin_event();
+				ofs << "\"name\":";
+				WriteJsonString(ofs, ev.name);
+				if (ev.is_counter)
+				{
+					ofs << ",\"ph\":\"C\",\"ts\":" << ev.begin * 1e6 << ",\"pid\":0,\"tid\":" << te->thread_index
+						<< ",\"args\":{\"value\":" << ev.value << "}}";
+				}
+				else
+				{
+					ofs << ",\"cat\":\"CPU\",\"ph\":\"X\",\"ts\":" << ev.begin * 1e6 << ",\"dur\":" << ev.value * 1e6
+						<< ",\"pid\":0,\"tid\":" << te->thread_index
+						<< ",\"args\":{\"frame\":" << ev.frame_id << ",\"depth\":" << ev.depth << "}}";
+				}
+			}
+		}
+
+		// GPU timings have no time stamps of their own, so they are placed at the begin of the CPU ranges of the same frame
+		for (auto const & range : perf_ranges_)
+		{
+			for (auto const & data : std::get<3>(range))
+			{
+				if (std::get<3>(data) >= 0)
+				{
+					begin_event();
+					ofs << "\"name\":";
+					WriteJsonString(ofs, std::get<1>(range).c_str());
+					ofs << ",\"cat\":\"GPU\",\"ph\":\"X\",\"ts\":" << std::get<1>(data) * 1e6
+						<< ",\"dur\":" << std::get<3>(data) * 1e6 << ",\"pid\":0,\"tid\":" << gpu_tid
+						<< ",\"args\":{\"frame\":" << std::get<0>(data) << "}}";
+				}
+			}
+		}
+
+		ofs << std::endl << "]}" << std::endl;
+	}
 }
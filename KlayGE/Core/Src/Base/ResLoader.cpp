@@ -32,7 +32,11 @@
 #include <KFL/Util.hpp>
 #include <KlayGE/Extract7z.hpp>
 #include <KFL/CXX17/filesystem.hpp>
+#include <KFL/Timer.hpp>
+#include <KFL/MappedFile.hpp>
+#include <KlayGE/PerfProfiler.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -49,7 +53,6 @@
 #elif defined KLAYGE_PLATFORM_LINUX
 #elif defined KLAYGE_PLATFORM_ANDROID
 #include <android/asset_manager.h>
-#include <KFL/CustomizedStreamBuf.hpp>
 #elif defined KLAYGE_PLATFORM_DARWIN
 #include <mach-o/dyld.h>
 #elif defined KLAYGE_PLATFORM_IOS
@@ -62,26 +65,26 @@ namespace
 {
 	std::mutex singleton_mutex;
 
-#ifdef KLAYGE_PLATFORM_ANDROID
-	class AAssetStreamBuf : public KlayGE::MemStreamBuf
+#if !defined(KLAYGE_PLATFORM_ANDROID)
+	// Loose files are mapped into memory, so that loaders can parse them in place. Falls back to a file stream
+	//  if the file can't be mapped, for example if it's empty. See ResIdentifier for what happens if a mapped file
+	//  is truncated while it's in use.
+	KlayGE::ResIdentifierPtr OpenLooseFile(std::string const & name, uint64_t timestamp, std::string const & file_name)
 	{
-	public:
-		explicit AAssetStreamBuf(AAsset* asset)
-			: MemStreamBuf(AAsset_getBuffer(asset), 
-					static_cast<uint8_t const *>(AAsset_getBuffer(asset)) + AAsset_getLength(asset)),
-				asset_(asset)
+		using namespace KlayGE;
+
+		auto mapped_file = MakeSharedPtr<MappedFile>();
+		if (mapped_file->Map(file_name))
 		{
-			BOOST_ASSERT(asset_ != nullptr);
+			return MakeSharedPtr<ResIdentifier>(name, timestamp, file_name, mapped_file);
 		}
-
-		~AAssetStreamBuf()
+		else
 		{
-			AAsset_close(asset_);
+			// The static_cast is a workaround for a bug in clang/c2
+			return MakeSharedPtr<ResIdentifier>(name, timestamp,
+				MakeSharedPtr<std::ifstream>(file_name.c_str(), static_cast<std::ios_base::openmode>(std::ios_base::binary)));
 		}
-
-	private:
-		AAsset* asset_;
-	};
+	}
 #endif
 }
 
@@ -90,7 +93,7 @@ namespace KlayGE
 	std::unique_ptr<ResLoader> ResLoader::res_loader_instance_;
 
 	ResLoader::ResLoader()
-		: quit_(false)
+		: unref_sweep_cursor_(0), loading_sequence_(0), quit_(false), main_thread_stage_budget_(0)
 	{
 #if defined KLAYGE_PLATFORM_WINDOWS
 #if defined KLAYGE_PLATFORM_WINDOWS_DESKTOP
@@ -189,6 +192,10 @@ namespace KlayGE
 		local_path_ = exe_path_;
 #endif
 
+#if !(defined(KLAYGE_PLATFORM_ANDROID) || defined(KLAYGE_PLATFORM_IOS))
+		archive_cache_ = MakeUniquePtr<ArchiveCache>();
+#endif
+
 		paths_.push_back("");
 
 #if defined KLAYGE_PLATFORM_WINDOWS_STORE
@@ -218,14 +225,27 @@ namespace KlayGE
 #endif
 #endif
 
-		loading_thread_ = MakeUniquePtr<joiner<void>>(Context::Instance().ThreadPool()(
+		// Sub thread stages are mostly I/O and decoding, so they run on dedicated threads instead of the task scheduler
+		uint32_t const num_loading_threads = std::min(std::max(std::thread::hardware_concurrency() / 2, 1U), 4U);
+		for (uint32_t i = 0; i < num_loading_threads; ++ i)
+		{
+			loading_threads_.push_back(Context::Instance().ThreadPool()(
 				std::bind(&ResLoader::LoadingThreadFunc, this)));
+		}
 	}
 
 	ResLoader::~ResLoader()
 	{
-		quit_ = true;
-		(*loading_thread_)();
+		{
+			std::lock_guard<std::mutex> lock(loading_queue_mutex_);
+			quit_ = true;
+		}
+		loading_queue_cond_.notify_all();
+
+		for (auto& thread : loading_threads_)
+		{
+			thread();
+		}
 	}
 
 	ResLoader& ResLoader::Instance()
@@ -309,6 +329,11 @@ namespace KlayGE
 		if (!real_path.empty())
 		{
 			paths_.push_back(real_path);
+
+#if !(defined(KLAYGE_PLATFORM_ANDROID) || defined(KLAYGE_PLATFORM_IOS))
+			// The cache only holds names resolved against the old list of paths
+			resolved_paths_.clear();
+#endif
 		}
 	}
 
@@ -323,6 +348,20 @@ namespace KlayGE
 			if (iter != paths_.end())
 			{
 				paths_.erase(iter);
+
+#if !(defined(KLAYGE_PLATFORM_ANDROID) || defined(KLAYGE_PLATFORM_IOS))
+				for (auto rp_iter = resolved_paths_.begin(); rp_iter != resolved_paths_.end();)
+				{
+					if (rp_iter->second.path == real_path)
+					{
+						rp_iter = resolved_paths_.erase(rp_iter);
+					}
+					else
+					{
+						++ rp_iter;
+					}
+				}
+#endif
 			}
 		}
 	}
@@ -341,30 +380,36 @@ namespace KlayGE
 #else
 		{
 			std::lock_guard<std::mutex> lock(paths_mutex_);
-			for (auto const & path : paths_)
+
+			// Same as in Open, a cached location can be stale. Check it still exists before returning it.
+			for (int attempt = 0; attempt < 2; ++ attempt)
 			{
-				std::string res_name(path + name);
-#if defined KLAYGE_PLATFORM_WINDOWS
-				std::replace(res_name.begin(), res_name.end(), '\\', '/');
-#endif
+				ResolvedPath const * resolved = this->Resolve(name);
+				if (!resolved)
+				{
+					break;
+				}
 
-				if (std::filesystem::exists(std::filesystem::path(res_name)))
+				bool exists;
+				if (!resolved->in_package)
 				{
-					return res_name;
+					exists = std::filesystem::exists(std::filesystem::path(resolved->res_name));
 				}
 				else
 				{
+					std::string pkt_name;
+					uint64_t timestamp;
 					std::string password;
 					std::string internal_name;
-					ResIdentifierPtr pkt_file = LocatePkt(name, res_name, password, internal_name);
-					if (pkt_file && *pkt_file)
-					{
-						if (Find7z(pkt_file, password, internal_name) != 0xFFFFFFFF)
-						{
-							return res_name;
-						}
-					}
+					exists = this->LocatePkt(resolved->res_name, pkt_name, timestamp, password, internal_name)
+						&& archive_cache_->Contains(pkt_name, timestamp, password, internal_name);
 				}
+				if (exists)
+				{
+					return resolved->res_name;
+				}
+
+				resolved_paths_.erase(name);
 			}
 		}
 #if defined KLAYGE_PLATFORM_WINDOWS_STORE
@@ -385,9 +430,8 @@ namespace KlayGE
 		AAsset* asset = LocateFileAndroid(name);
 		if (asset != nullptr)
 		{
-			std::shared_ptr<AAssetStreamBuf> asb = MakeSharedPtr<AAssetStreamBuf>(asset);
-			std::shared_ptr<std::istream> asset_file = MakeSharedPtr<std::istream>(asb.get());
-			return MakeSharedPtr<ResIdentifier>(name, 0, asset_file, asb);
+			std::shared_ptr<AAsset> asset_holder(asset, AAsset_close);
+			return MakeSharedPtr<ResIdentifier>(name, 0, AAsset_getBuffer(asset), AAsset_getLength(asset), asset_holder);
 		}
 #elif defined(KLAYGE_PLATFORM_IOS)
 		std::string const & res_name = LocateFileIOS(name);
@@ -400,43 +444,53 @@ namespace KlayGE
 			uint64_t timestamp = std::filesystem::last_write_time(res_path);
 #endif
 
-			return MakeSharedPtr<ResIdentifier>(name, timestamp,
-				MakeSharedPtr<std::ifstream>(res_name.c_str(), std::ios_base::binary));
+			return OpenLooseFile(name, timestamp, res_name);
 		}
 #else
 		{
 			std::lock_guard<std::mutex> lock(paths_mutex_);
-			for (auto const & path : paths_)
+
+			// A cached location can be stale if the file is removed or the package is changed. In that case
+			//  resolve the name again.
+			for (int attempt = 0; attempt < 2; ++ attempt)
 			{
-				std::string res_name(path + name);
-#if defined KLAYGE_PLATFORM_WINDOWS
-				std::replace(res_name.begin(), res_name.end(), '\\', '/');
-#endif
+				ResolvedPath const * resolved = this->Resolve(name);
+				if (!resolved)
+				{
+					break;
+				}
 
-				std::filesystem::path res_path(res_name);
-				if (std::filesystem::exists(res_path))
+				std::string const res_name = resolved->res_name;
+				if (!resolved->in_package)
 				{
+					std::filesystem::path res_path(res_name);
+					if (std::filesystem::exists(res_path))
+					{
 #if defined(KLAYGE_CXX17_LIBRARY_FILESYSTEM_SUPPORT) || defined(KLAYGE_TS_LIBRARY_FILESYSTEM_SUPPORT)
-					uint64_t timestamp = std::filesystem::last_write_time(res_path).time_since_epoch().count();
+						uint64_t timestamp = std::filesystem::last_write_time(res_path).time_since_epoch().count();
 #else
-					uint64_t timestamp = std::filesystem::last_write_time(res_path);
+						uint64_t timestamp = std::filesystem::last_write_time(res_path);
 #endif
-					// The static_cast is a workaround for a bug in clang/c2
-					return MakeSharedPtr<ResIdentifier>(name, timestamp,
-						MakeSharedPtr<std::ifstream>(res_name.c_str(), static_cast<std::ios_base::openmode>(std::ios_base::binary)));
+						return OpenLooseFile(name, timestamp, res_name);
+					}
 				}
 				else
 				{
+					std::string pkt_name;
+					uint64_t timestamp;
 					std::string password;
 					std::string internal_name;
-					ResIdentifierPtr pkt_file = LocatePkt(name, res_name, password, internal_name);
-					if (pkt_file && *pkt_file)
+					if (this->LocatePkt(res_name, pkt_name, timestamp, password, internal_name))
 					{
-						std::shared_ptr<std::iostream> packet_file = MakeSharedPtr<std::stringstream>();
-						Extract7z(pkt_file, password, internal_name, packet_file);
-						return MakeSharedPtr<ResIdentifier>(name, pkt_file->Timestamp(), packet_file);
+						ResIdentifierPtr ret = archive_cache_->Open(pkt_name, timestamp, password, internal_name, name);
+						if (ret)
+						{
+							return ret;
+						}
 					}
 				}
+
+				resolved_paths_.erase(name);
 			}
 		}
 #if defined(KLAYGE_PLATFORM_WINDOWS_STORE)
@@ -474,37 +528,55 @@ namespace KlayGE
 		}
 		else
 		{
-			std::shared_ptr<volatile LoadingStatus> async_is_done;
+			std::shared_ptr<std::atomic<LoadingStatus>> async_is_done;
 			bool found = false;
 			{
 				std::lock_guard<std::mutex> lock(loading_mutex_);
 
-				for (auto const & lrq : loading_res_)
+				auto const range = loading_res_.equal_range(res_desc->Hash());
+				for (auto iter = range.first; iter != range.second; ++ iter)
 				{
-					if (lrq.first->Match(*res_desc))
+					LoadingRequest const & lrq = iter->second;
+					if (lrq.res_desc->Match(*res_desc))
 					{
-						res_desc->CopyDataFrom(*lrq.first);
-						res = lrq.first->Resource();
-						async_is_done = lrq.second;
+						res_desc->CopyDataFrom(*lrq.res_desc);
+						res = lrq.res_desc->Resource();
+						async_is_done = lrq.status;
 						found = true;
 						break;
 					}
 				}
 			}
 
+			bool run_sub_thread_stage = true;
 			if (found)
 			{
-				*async_is_done = LS_Complete;
+				// The data is shared with the pending request. Either take its sub thread stage over before a loading
+				// thread picks it up, or wait for the loading thread that has it. Never run both on the same data.
+				LoadingStatus expected = LS_Loading;
+				if (!async_is_done->compare_exchange_strong(expected, LS_SubThreadStage))
+				{
+					std::unique_lock<std::mutex> lock(loading_queue_mutex_);
+					loading_done_cond_.wait(lock, [&async_is_done]
+						{
+							return *async_is_done != LS_SubThreadStage;
+						});
+					run_sub_thread_stage = false;
+				}
 			}
 			else
 			{
 				res = res_desc->CreateResource();
 			}
 
-			if (res_desc->HasSubThreadStage())
+			if (run_sub_thread_stage && res_desc->HasSubThreadStage())
 			{
 				res_desc->SubThreadStage();
 			}
+			if (found && run_sub_thread_stage)
+			{
+				*async_is_done = LS_Complete;
+			}
 
 			res = res_desc->MainThreadStage();
 			this->AddLoadedResource(res_desc, res);
@@ -513,7 +585,7 @@ namespace KlayGE
 		return res;
 	}
 
-	std::shared_ptr<void> ResLoader::ASyncQuery(ResLoadingDescPtr const & res_desc)
+	std::shared_ptr<void> ResLoader::ASyncQuery(ResLoadingDescPtr const & res_desc, ResLoadingPriority priority)
 	{
 		this->RemoveUnrefResources();
 
@@ -536,18 +608,20 @@ namespace KlayGE
 		}
 		else
 		{
-			std::shared_ptr<volatile LoadingStatus> async_is_done;
+			std::shared_ptr<std::atomic<LoadingStatus>> async_is_done;
 			bool found = false;
 			{
 				std::lock_guard<std::mutex> lock(loading_mutex_);
 
-				for (auto const & lrq : loading_res_)
+				auto const range = loading_res_.equal_range(res_desc->Hash());
+				for (auto iter = range.first; iter != range.second; ++ iter)
 				{
-					if (lrq.first->Match(*res_desc))
+					LoadingRequest const & lrq = iter->second;
+					if (lrq.res_desc->Match(*res_desc))
 					{
-						res_desc->CopyDataFrom(*lrq.first);
-						res = lrq.first->Resource();
-						async_is_done = lrq.second;
+						res_desc->CopyDataFrom(*lrq.res_desc);
+						res = lrq.res_desc->Resource();
+						async_is_done = lrq.status;
 						found = true;
 						break;
 					}
@@ -559,7 +633,8 @@ namespace KlayGE
 				if (!res_desc->StateLess())
 				{
 					std::lock_guard<std::mutex> lock(loading_mutex_);
-					loading_res_.emplace_back(res_desc, async_is_done);
+					LoadingRequest const request = { res_desc, async_is_done, priority, loading_sequence_ ++ };
+					loading_res_.emplace(res_desc->Hash(), request);
 				}
 			}
 			else
@@ -568,13 +643,20 @@ namespace KlayGE
 				{
 					res = res_desc->CreateResource();
 
-					async_is_done = MakeSharedPtr<LoadingStatus>(LS_Loading);
+					async_is_done = MakeSharedPtr<std::atomic<LoadingStatus>>(LS_Loading);
 
+					LoadingRequest request = { res_desc, async_is_done, priority, 0 };
 					{
 						std::lock_guard<std::mutex> lock(loading_mutex_);
-						loading_res_.emplace_back(res_desc, async_is_done);
+						request.sequence = loading_sequence_ ++;
+						loading_res_.emplace(res_desc->Hash(), request);
+					}
+					{
+						std::lock_guard<std::mutex> lock(loading_queue_mutex_);
+						loading_res_queue_.push_back(request);
+						std::push_heap(loading_res_queue_.begin(), loading_res_queue_.end());
 					}
-					loading_res_queue_.push(std::make_pair(res_desc, async_is_done));
+					loading_queue_cond_.notify_one();
 				}
 				else
 				{
@@ -590,11 +672,11 @@ namespace KlayGE
 	{
 		std::lock_guard<std::mutex> lock(loaded_mutex_);
 
-		for (auto iter = loaded_res_.begin(); iter != loaded_res_.end(); ++ iter)
+		for (size_t i = 0; i < loaded_res_.size(); ++ i)
 		{
-			if (res == iter->second.lock())
+			if (res == loaded_res_[i].res.lock())
 			{
-				loaded_res_.erase(iter);
+				this->RemoveLoadedResource(i);
 				break;
 			}
 		}
@@ -604,19 +686,32 @@ namespace KlayGE
 	{
 		std::lock_guard<std::mutex> lock(loaded_mutex_);
 
+		size_t const hash = res_desc->Hash();
 		bool found = false;
-		for (auto& c_desc : loaded_res_)
+		auto const range = loaded_res_index_.equal_range(hash);
+		for (auto iter = range.first; iter != range.second; ++ iter)
 		{
-			if (c_desc.first == res_desc)
+			LoadedResource& lr = loaded_res_[iter->second];
+			if (lr.res_desc == res_desc)
 			{
-				c_desc.second = std::weak_ptr<void>(res);
+				lr.res = std::weak_ptr<void>(res);
 				found = true;
 				break;
 			}
 		}
 		if (!found)
 		{
-			loaded_res_.emplace_back(res_desc, std::weak_ptr<void>(res));
+			loaded_res_index_.emplace(hash, loaded_res_.size());
+			LoadedResource const lr = { res_desc, std::weak_ptr<void>(res), hash };
+			loaded_res_.push_back(lr);
+
+#ifndef KLAYGE_SHIP
+			if (!loaded_res_counter_)
+			{
+				loaded_res_counter_ = PerfProfiler::Instance().CreatePerfCounter("Loaded resources");
+			}
+			loaded_res_counter_->Value(static_cast<double>(loaded_res_.size()));
+#endif
 		}
 	}
 
@@ -624,13 +719,28 @@ namespace KlayGE
 	{
 		std::lock_guard<std::mutex> lock(loaded_mutex_);
 
+		size_t const hash = res_desc->Hash();
 		std::shared_ptr<void> loaded_res;
-		for (auto const & lr : loaded_res_)
+		auto range = loaded_res_index_.equal_range(hash);
+		for (auto iter = range.first; iter != range.second;)
 		{
-			if (lr.first->Match(*res_desc))
+			size_t const index = iter->second;
+			if (loaded_res_[index].res_desc->Match(*res_desc))
 			{
-				loaded_res = lr.second.lock();
-				break;
+				loaded_res = loaded_res_[index].res.lock();
+				if (loaded_res)
+				{
+					break;
+				}
+
+				// Expired entries can't be left in front of live ones with the same key
+				this->RemoveLoadedResource(index);
+				range = loaded_res_index_.equal_range(hash);
+				iter = range.first;
+			}
+			else
+			{
+				++ iter;
 			}
 		}
 		return loaded_res;
@@ -640,32 +750,90 @@ namespace KlayGE
 	{
 		std::lock_guard<std::mutex> lock(loaded_mutex_);
 
-		for (auto iter = loaded_res_.begin(); iter != loaded_res_.end();)
+		// Sweeps a bounded slice of the loaded resources per call, continuing from where the last one stopped
+		size_t const MAX_NUM_CHECKS = 64;
+		for (size_t i = 0; (i < MAX_NUM_CHECKS) && !loaded_res_.empty(); ++ i)
 		{
-			if (iter->second.lock())
+			if (unref_sweep_cursor_ >= loaded_res_.size())
 			{
-				++ iter;
+				unref_sweep_cursor_ = 0;
+			}
+
+			if (loaded_res_[unref_sweep_cursor_].res.expired())
+			{
+				// The last one is moved into the cursor, check it in the next iteration
+				this->RemoveLoadedResource(unref_sweep_cursor_);
 			}
 			else
 			{
-				iter = loaded_res_.erase(iter);
+				++ unref_sweep_cursor_;
 			}
 		}
 	}
 
+	void ResLoader::RemoveLoadedResource(size_t index)
+	{
+		BOOST_ASSERT(index < loaded_res_.size());
+
+		size_t const last = loaded_res_.size() - 1;
+		auto range = loaded_res_index_.equal_range(loaded_res_[index].hash);
+		for (auto iter = range.first; iter != range.second; ++ iter)
+		{
+			if (iter->second == index)
+			{
+				loaded_res_index_.erase(iter);
+				break;
+			}
+		}
+
+		if (index != last)
+		{
+			range = loaded_res_index_.equal_range(loaded_res_[last].hash);
+			for (auto iter = range.first; iter != range.second; ++ iter)
+			{
+				if (iter->second == last)
+				{
+					iter->second = index;
+					break;
+				}
+			}
+			loaded_res_[index] = loaded_res_[last];
+		}
+		loaded_res_.pop_back();
+	}
+
 	void ResLoader::Update()
 	{
-		std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> tmp_loading_res;
+		std::vector<LoadingRequest> tmp_loading_res;
 		{
 			std::lock_guard<std::mutex> lock(loading_mutex_);
-			tmp_loading_res = loading_res_;
+			tmp_loading_res.reserve(loading_res_.size());
+			for (auto const & lrq : loading_res_)
+			{
+				tmp_loading_res.push_back(lrq.second);
+			}
 		}
+		std::sort(tmp_loading_res.begin(), tmp_loading_res.end(),
+			[](LoadingRequest const & lhs, LoadingRequest const & rhs)
+			{
+				return rhs < lhs;
+			});
 
+		Timer timer;
+		bool any_processed = false;
 		for (auto& lrq : tmp_loading_res)
 		{
-			if (LS_Complete == *lrq.second)
+			if (LS_Complete == *lrq.status)
 			{
-				ResLoadingDescPtr const & res_desc = lrq.first;
+				// At least one main thread stage per frame, so loading always makes progress
+				if (any_processed && (main_thread_stage_budget_ > 0)
+					&& (timer.elapsed() * 1000 > main_thread_stage_budget_))
+				{
+					break;
+				}
+				any_processed = true;
+
+				ResLoadingDescPtr const & res_desc = lrq.res_desc;
 
 				std::shared_ptr<void> res;
 				std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(res_desc);
@@ -686,7 +854,7 @@ namespace KlayGE
 					this->AddLoadedResource(res_desc, res);
 				}
 
-				*lrq.second = LS_CanBeRemoved;
+				*lrq.status = LS_CanBeRemoved;
 			}
 		}
 
@@ -694,7 +862,7 @@ namespace KlayGE
 			std::lock_guard<std::mutex> lock(loading_mutex_);
 			for (auto iter = loading_res_.begin(); iter != loading_res_.end();)
 			{
-				if (LS_CanBeRemoved == *(iter->second))
+				if (LS_CanBeRemoved == *(iter->second.status))
 				{
 					iter = loading_res_.erase(iter);
 				}
@@ -708,31 +876,97 @@ namespace KlayGE
 
 	void ResLoader::LoadingThreadFunc()
 	{
-		while (!quit_)
+		for (;;)
 		{
-			std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>> res_pair;
-			while (loading_res_queue_.pop(res_pair))
+			LoadingRequest request;
 			{
-				if (LS_Loading == *res_pair.second)
+				std::unique_lock<std::mutex> lock(loading_queue_mutex_);
+				loading_queue_cond_.wait(lock, [this]
+					{
+						return quit_ || !loading_res_queue_.empty();
+					});
+				if (quit_)
 				{
-					res_pair.first->SubThreadStage();
-					*res_pair.second = LS_Complete;
+					break;
 				}
+
+				std::pop_heap(loading_res_queue_.begin(), loading_res_queue_.end());
+				request = loading_res_queue_.back();
+				loading_res_queue_.pop_back();
 			}
 
-			Sleep(10);
+			// SyncQuery could have taken the request over already
+			LoadingStatus expected = LS_Loading;
+			if (request.status->compare_exchange_strong(expected, LS_SubThreadStage))
+			{
+				request.res_desc->SubThreadStage();
+
+				{
+					std::lock_guard<std::mutex> lock(loading_queue_mutex_);
+					*request.status = LS_Complete;
+				}
+				loading_done_cond_.notify_all();
+			}
 		}
 	}
 
 
-	ResIdentifierPtr ResLoader::LocatePkt(std::string const & name, std::string const & res_name,
+#if !(defined(KLAYGE_PLATFORM_ANDROID) || defined(KLAYGE_PLATFORM_IOS))
+	ResLoader::ResolvedPath const * ResLoader::Resolve(std::string const & name)
+	{
+		auto iter = resolved_paths_.find(name);
+		if (iter != resolved_paths_.end())
+		{
+			return &iter->second;
+		}
+
+		for (auto const & path : paths_)
+		{
+			std::string res_name(path + name);
+#if defined KLAYGE_PLATFORM_WINDOWS
+			std::replace(res_name.begin(), res_name.end(), '\\', '/');
+#endif
+
+			bool found = false;
+			bool in_package = false;
+			if (std::filesystem::exists(std::filesystem::path(res_name)))
+			{
+				found = true;
+			}
+			else
+			{
+				std::string pkt_name;
+				uint64_t timestamp;
+				std::string password;
+				std::string internal_name;
+				if (this->LocatePkt(res_name, pkt_name, timestamp, password, internal_name))
+				{
+					found = archive_cache_->Contains(pkt_name, timestamp, password, internal_name);
+					in_package = true;
+				}
+			}
+
+			if (found)
+			{
+				ResolvedPath& resolved = resolved_paths_[name];
+				resolved.path = path;
+				resolved.res_name = res_name;
+				resolved.in_package = in_package;
+				return &resolved;
+			}
+		}
+
+		return nullptr;
+	}
+#endif
+
+	bool ResLoader::LocatePkt(std::string const & res_name, std::string& pkt_name, uint64_t& timestamp,
 			std::string& password, std::string& internal_name)
 	{
-		ResIdentifierPtr res;
 		std::string::size_type const pkt_offset(res_name.find("//"));
 		if (pkt_offset != std::string::npos)
 		{
-			std::string pkt_name = res_name.substr(0, pkt_offset);
+			pkt_name = res_name.substr(0, pkt_offset);
 			std::filesystem::path pkt_path(pkt_name);
 			if (std::filesystem::exists(pkt_path)
 				&& (std::filesystem::is_regular_file(pkt_path)
@@ -747,17 +981,15 @@ namespace KlayGE
 				internal_name = res_name.substr(pkt_offset + 2);
 
 #if defined(KLAYGE_CXX17_LIBRARY_FILESYSTEM_SUPPORT) || defined(KLAYGE_TS_LIBRARY_FILESYSTEM_SUPPORT)
-				uint64_t timestamp = std::filesystem::last_write_time(pkt_path).time_since_epoch().count();
+				timestamp = std::filesystem::last_write_time(pkt_path).time_since_epoch().count();
 #else
-				uint64_t timestamp = std::filesystem::last_write_time(pkt_path);
+				timestamp = std::filesystem::last_write_time(pkt_path);
 #endif
-				// The static_cast is a workaround for a bug in clang/c2
-				res = MakeSharedPtr<ResIdentifier>(name, timestamp,
-					MakeSharedPtr<std::ifstream>(pkt_name.c_str(), static_cast<std::ios_base::openmode>(std::ios_base::binary)));
+				return true;
 			}
 		}
 
-		return res;
+		return false;
 	}
 
 #if defined(KLAYGE_PLATFORM_ANDROID)
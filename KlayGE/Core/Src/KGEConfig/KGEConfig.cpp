@@ -114,6 +114,7 @@ INT_PTR CALLBACK Graphics_Tab_DlgProc(HWND hDlg, UINT uMsg, WPARAM /*wParam*/, L
 				SendMessage(hFactoryCombo, CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(TEXT("OpenGLES")));
 				FreeLibrary(mod_gles2);
 			}
+			SendMessage(hFactoryCombo, CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(TEXT("Null")));
 
 			TCHAR buf[256];
 			int n = static_cast<int>(SendMessage(hFactoryCombo, CB_GETCOUNT, 0, 0));
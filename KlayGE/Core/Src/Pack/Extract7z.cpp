@@ -37,9 +37,13 @@
 #include <CPP/Common/MyWindows.h>
 
 #include <KFL/DllLoader.hpp>
+#include <KFL/ResIdentifier.hpp>
 
 #include <string>
 #include <algorithm>
+#include <fstream>
+#include <istream>
+#include <sstream>
 
 #include <boost/assert.hpp>
 #if defined(KLAYGE_COMPILER_GCC)
@@ -147,10 +151,149 @@ namespace
 	};
 
 
-	void GetArchiveIndex(std::shared_ptr<IInArchive>& archive, uint32_t& real_index,
-								ResIdentifierPtr const & archive_is,
-								std::string const & password,
-								std::string const & extract_file_path)
+	// Some archive handlers don't know the size of an entry until it's decoded
+	uint64_t const UNKNOWN_ITEM_SIZE = ~0ULL;
+
+	HRESULT GetArchiveItemSize(std::shared_ptr<IInArchive> const & archive, uint32_t index, uint64_t& result)
+	{
+		PROPVARIANT prop;
+		prop.vt = VT_EMPTY;
+		TIF(archive->GetProperty(index, kpidSize, &prop));
+		switch (prop.vt)
+		{
+		case VT_UI8:
+			result = prop.uhVal.QuadPart;
+			return S_OK;
+
+		case VT_UI4:
+			result = prop.ulVal;
+			return S_OK;
+
+		case VT_EMPTY:
+			result = UNKNOWN_ITEM_SIZE;
+			return S_OK;
+
+		default:
+			return E_FAIL;
+		}
+	}
+
+	// Reads an entry on demand from a stream provided by the archive handler. Reads are serialized with the other
+	//  users of the archive, since they share one file.
+	class ArchiveEntryStreamBuf : public std::streambuf, boost::noncopyable
+	{
+		static size_t const BUFFER_SIZE = 64 * 1024;
+
+	public:
+		ArchiveEntryStreamBuf(std::shared_ptr<void> const & owner, std::mutex& mutex,
+				std::shared_ptr<ISequentialInStream> const & stream, uint64_t size)
+			: owner_(owner), mutex_(mutex), stream_(stream), size_(size), pos_(0), buff_(BUFFER_SIZE)
+		{
+			IInStream* tmp = nullptr;
+			if (SUCCEEDED(stream_->QueryInterface(IID_IInStream, reinterpret_cast<void**>(&tmp))))
+			{
+				seekable_stream_ = MakeCOMPtr(tmp);
+			}
+
+			this->setg(buff_.data(), buff_.data(), buff_.data());
+		}
+
+	protected:
+		virtual int_type underflow() override
+		{
+			if (this->gptr() < this->egptr())
+			{
+				return traits_type::to_int_type(*this->gptr());
+			}
+
+			UInt32 processed = 0;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (FAILED(stream_->Read(buff_.data(), static_cast<UInt32>(buff_.size()), &processed)))
+				{
+					processed = 0;
+				}
+			}
+			if (0 == processed)
+			{
+				return traits_type::eof();
+			}
+
+			pos_ += processed;
+			this->setg(buff_.data(), buff_.data(), buff_.data() + processed);
+			return traits_type::to_int_type(*this->gptr());
+		}
+
+		virtual pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which) override
+		{
+			if (!(which & std::ios_base::in))
+			{
+				return pos_type(off_type(-1));
+			}
+
+			int64_t const buffered = this->egptr() - this->eback();
+			int64_t const cur = static_cast<int64_t>(pos_) - (this->egptr() - this->gptr());
+			int64_t target;
+			switch (way)
+			{
+			case std::ios_base::beg:
+				target = off;
+				break;
+
+			case std::ios_base::cur:
+				target = cur + off;
+				break;
+
+			default:
+				target = static_cast<int64_t>(size_) + off;
+				break;
+			}
+
+			if ((target < 0) || (target > static_cast<int64_t>(size_)))
+			{
+				return pos_type(off_type(-1));
+			}
+
+			int64_t const buff_begin = static_cast<int64_t>(pos_) - buffered;
+			if ((target >= buff_begin) && (target <= static_cast<int64_t>(pos_)))
+			{
+				this->setg(this->eback(), this->eback() + (target - buff_begin), this->egptr());
+				return pos_type(target);
+			}
+
+			if (!seekable_stream_)
+			{
+				return pos_type(off_type(-1));
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (FAILED(seekable_stream_->Seek(target, 0, nullptr)))
+				{
+					return pos_type(off_type(-1));
+				}
+			}
+			pos_ = target;
+			this->setg(buff_.data(), buff_.data(), buff_.data());
+			return pos_type(target);
+		}
+
+		virtual pos_type seekpos(pos_type sp, std::ios_base::openmode which) override
+		{
+			return this->seekoff(off_type(sp), std::ios_base::beg, which);
+		}
+
+	private:
+		std::shared_ptr<void> owner_;
+		std::mutex& mutex_;
+		std::shared_ptr<ISequentialInStream> stream_;
+		std::shared_ptr<IInStream> seekable_stream_;
+		uint64_t size_;
+		uint64_t pos_;
+		std::vector<char> buff_;
+	};
+
+	void OpenArchive(std::shared_ptr<IInArchive>& archive, ResIdentifierPtr const & archive_is, std::string const & password)
 	{
 		BOOST_ASSERT(archive_is);
 
@@ -166,6 +309,38 @@ namespace
 		std::shared_ptr<IArchiveOpenCallback> ocb = MakeCOMPtr(new CArchiveOpenCallback);
 		checked_pointer_cast<CArchiveOpenCallback>(ocb)->Init(password);
 		TIF(archive->Open(file.get(), 0, ocb.get()));
+	}
+
+	bool IsArchiveItemExtractable(std::shared_ptr<IInArchive> const & archive, uint32_t index)
+	{
+		PROPVARIANT prop;
+		prop.vt = VT_EMPTY;
+		TIF(archive->GetProperty(index, kpidIsAnti, &prop));
+		if ((VT_BOOL == prop.vt) && (VARIANT_FALSE == prop.boolVal))
+		{
+			prop.vt = VT_EMPTY;
+			TIF(archive->GetProperty(index, kpidPosition, &prop));
+			if (prop.vt != VT_EMPTY)
+			{
+				if ((prop.vt != VT_UI8) || (prop.uhVal.QuadPart != 0))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	void GetArchiveIndex(std::shared_ptr<IInArchive>& archive, uint32_t& real_index,
+								ResIdentifierPtr const & archive_is,
+								std::string const & password,
+								std::string const & extract_file_path)
+	{
+		OpenArchive(archive, archive_is, password);
 
 		real_index = 0xFFFFFFFF;
 		uint32_t num_items;
@@ -188,27 +363,9 @@ namespace
 				}
 			}
 		}
-		if (real_index != 0xFFFFFFFF)
+		if ((real_index != 0xFFFFFFFF) && !IsArchiveItemExtractable(archive, real_index))
 		{
-			PROPVARIANT prop;
-			prop.vt = VT_EMPTY;
-			TIF(archive->GetProperty(real_index, kpidIsAnti, &prop));
-			if ((VT_BOOL == prop.vt) && (VARIANT_FALSE == prop.boolVal))
-			{
-				prop.vt = VT_EMPTY;
-				TIF(archive->GetProperty(real_index, kpidPosition, &prop));
-				if (prop.vt != VT_EMPTY)
-				{
-					if ((prop.vt != VT_UI8) || (prop.uhVal.QuadPart != 0))
-					{
-						real_index = 0xFFFFFFFF;
-					}
-				}
-			}
-			else
-			{
-				real_index = 0xFFFFFFFF;
-			}
+			real_index = 0xFFFFFFFF;
 		}
 	}
 }
@@ -244,4 +401,166 @@ namespace KlayGE
 			TIF(archive->Extract(&real_index, 1, false, ecb.get()));
 		}
 	}
+
+	struct ArchiveCache::Archive
+	{
+		struct Entry
+		{
+			uint32_t index;
+			uint64_t size;
+		};
+
+		std::shared_ptr<IInArchive> archive;
+		ResIdentifierPtr archive_is;
+		std::string password;
+		uint64_t timestamp;
+		// Keyed by the lower case path
+		std::unordered_map<std::string, Entry> entries;
+		// Serializes the accesses to archive and archive_is
+		std::mutex mutex;
+	};
+
+	ArchiveCache::ArchiveCache()
+	{
+	}
+
+	ArchiveCache::~ArchiveCache()
+	{
+	}
+
+	std::shared_ptr<ArchiveCache::Archive> ArchiveCache::Acquire(std::string const & archive_path, uint64_t timestamp,
+		std::string const & password)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto iter = archives_.find(archive_path);
+		if ((iter != archives_.end()) && (iter->second->timestamp == timestamp) && (iter->second->password == password))
+		{
+			return iter->second;
+		}
+
+		// The static_cast is a workaround for a bug in clang/c2
+		ResIdentifierPtr archive_is = MakeSharedPtr<ResIdentifier>(archive_path, timestamp,
+			MakeSharedPtr<std::ifstream>(archive_path.c_str(), static_cast<std::ios_base::openmode>(std::ios_base::binary)));
+		if (!*archive_is)
+		{
+			return std::shared_ptr<Archive>();
+		}
+
+		auto arc = MakeSharedPtr<Archive>();
+		arc->archive_is = archive_is;
+		arc->password = password;
+		arc->timestamp = timestamp;
+		OpenArchive(arc->archive, archive_is, password);
+
+		uint32_t num_items;
+		TIF(arc->archive->GetNumberOfItems(&num_items));
+		for (uint32_t i = 0; i < num_items; ++ i)
+		{
+			bool is_folder = true;
+			TIF(IsArchiveItemFolder(arc->archive, i, is_folder));
+			if (!is_folder && IsArchiveItemExtractable(arc->archive, i))
+			{
+				std::string file_path;
+				TIF(GetArchiveItemPath(arc->archive, i, file_path));
+				std::replace(file_path.begin(), file_path.end(), '\\', '/');
+				boost::algorithm::to_lower(file_path);
+
+				Archive::Entry entry;
+				entry.index = i;
+				TIF(GetArchiveItemSize(arc->archive, i, entry.size));
+				arc->entries.emplace(file_path, entry);
+			}
+		}
+
+		archives_[archive_path] = arc;
+		return arc;
+	}
+
+	bool ArchiveCache::Contains(std::string const & archive_path, uint64_t timestamp,
+		std::string const & password, std::string const & extract_file_path)
+	{
+		auto arc = this->Acquire(archive_path, timestamp, password);
+		if (!arc)
+		{
+			return false;
+		}
+
+		std::string path = boost::algorithm::to_lower_copy(extract_file_path);
+		std::replace(path.begin(), path.end(), '\\', '/');
+		return arc->entries.find(path) != arc->entries.end();
+	}
+
+	ResIdentifierPtr ArchiveCache::Open(std::string const & archive_path, uint64_t timestamp,
+		std::string const & password, std::string const & extract_file_path, std::string const & res_name)
+	{
+		auto arc = this->Acquire(archive_path, timestamp, password);
+		if (!arc)
+		{
+			return ResIdentifierPtr();
+		}
+
+		std::string path = boost::algorithm::to_lower_copy(extract_file_path);
+		std::replace(path.begin(), path.end(), '\\', '/');
+		auto iter = arc->entries.find(path);
+		if (iter == arc->entries.end())
+		{
+			return ResIdentifierPtr();
+		}
+		Archive::Entry const & entry = iter->second;
+
+		std::lock_guard<std::mutex> lock(arc->mutex);
+
+		if (UNKNOWN_ITEM_SIZE == entry.size)
+		{
+			// Without a size the entry can't be seeked from the end, or decoded into a fixed buffer. Decode it into
+			//  a stream that grows instead.
+			auto decoded = MakeSharedPtr<std::stringstream>(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+
+			std::shared_ptr<ISequentialOutStream> out_stream = MakeCOMPtr(new COutStream);
+			checked_pointer_cast<COutStream>(out_stream)->Attach(decoded);
+
+			std::shared_ptr<IArchiveExtractCallback> ecb = MakeCOMPtr(new CArchiveExtractCallback);
+			checked_pointer_cast<CArchiveExtractCallback>(ecb)->Init(arc->password, out_stream);
+
+			uint32_t index = entry.index;
+			TIF(arc->archive->Extract(&index, 1, false, ecb.get()));
+			return MakeSharedPtr<ResIdentifier>(res_name, arc->timestamp, decoded);
+		}
+
+		IInArchiveGetStream* get_stream_tmp = nullptr;
+		if (SUCCEEDED(arc->archive->QueryInterface(IID_IInArchiveGetStream, reinterpret_cast<void**>(&get_stream_tmp)))
+			&& get_stream_tmp)
+		{
+			std::shared_ptr<IInArchiveGetStream> get_stream = MakeCOMPtr(get_stream_tmp);
+			ISequentialInStream* entry_stream = nullptr;
+			if (SUCCEEDED(get_stream->GetStream(entry.index, &entry_stream)) && entry_stream)
+			{
+				auto entry_buf = MakeSharedPtr<ArchiveEntryStreamBuf>(arc, arc->mutex, MakeCOMPtr(entry_stream), entry.size);
+				return MakeSharedPtr<ResIdentifier>(res_name, arc->timestamp,
+					MakeSharedPtr<std::istream>(entry_buf.get()), entry_buf);
+			}
+		}
+
+		// The decoded entry is memory backed, so loaders can parse it in place
+		auto decoded = MakeSharedPtr<std::vector<uint8_t>>(static_cast<size_t>(entry.size));
+		if (entry.size > 0)
+		{
+			std::shared_ptr<ISequentialOutStream> out_stream = MakeCOMPtr(new CMemOutStream);
+			checked_pointer_cast<CMemOutStream>(out_stream)->Attach(decoded->data(), entry.size);
+
+			std::shared_ptr<IArchiveExtractCallback> ecb = MakeCOMPtr(new CArchiveExtractCallback);
+			checked_pointer_cast<CArchiveExtractCallback>(ecb)->Init(arc->password, out_stream);
+
+			uint32_t index = entry.index;
+			TIF(arc->archive->Extract(&index, 1, false, ecb.get()));
+		}
+		return MakeSharedPtr<ResIdentifier>(res_name, arc->timestamp, decoded->data(), entry.size, decoded);
+	}
+
+	void ArchiveCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		archives_.clear();
+	}
 }
@@ -33,6 +33,8 @@
 #include <KlayGE/ResLoader.hpp>
 #include <KFL/DllLoader.hpp>
 #include <KFL/Thread.hpp>
+#include <KFL/TaskScheduler.hpp>
+#include <KlayGE/Context.hpp>
 
 #include <cstring>
 
@@ -44,8 +46,6 @@ namespace
 {
 	using namespace KlayGE;
 
-	std::mutex singleton_mutex;
-
 	typedef int (MY_STD_CALL *LzmaCompressFunc)(unsigned char* dest, size_t* destLen, unsigned char const * src, size_t srcLen,
 		unsigned char* outProps, size_t* outPropsSize, /* *outPropsSize must be = 5 */
 		int level,      /* 0 <= level <= 9, default = 5 */
@@ -63,15 +63,9 @@ namespace
 	public:
 		static LZMALoader& Instance()
 		{
-			if (!instance_)
-			{
-				std::lock_guard<std::mutex> lock(singleton_mutex);
-				if (!instance_)
-				{
-					instance_ = MakeUniquePtr<LZMALoader>();
-				}
-			}
-			return *instance_;
+			// Loading threads decode concurrently. A function local static is initialized exactly once.
+			static LZMALoader ret;
+			return ret;
 		}
 
 		int LzmaCompress(unsigned char* dest, size_t* destLen, unsigned char const * src, size_t srcLen,
@@ -109,15 +103,53 @@ namespace
 #endif
 		LzmaCompressFunc lzma_compress_func_;
 		LzmaUncompressFunc lzma_uncompress_func_;
-
-		static std::unique_ptr<LZMALoader> instance_;
 	};
-	std::unique_ptr<LZMALoader> LZMALoader::instance_;
+
+	// Blocked data starts with a byte that can't be the first byte of LZMA props, followed by the block size,
+	//  the number of blocks, and the compressed size of each block.
+	uint8_t const BLOCK_MAGIC[] = { 0xFF, 'L', 'Z', 'B' };
+	uint32_t const BLOCK_HEADER_SIZE = sizeof(BLOCK_MAGIC) + sizeof(uint32_t) * 2;
+
+	void EncodeStream(std::vector<uint8_t>& output, void const * input, uint64_t len)
+	{
+		SizeT out_len = static_cast<SizeT>(std::max(len * 11 / 10, static_cast<uint64_t>(32)));
+		output.resize(LZMA_PROPS_SIZE + out_len);
+		SizeT out_props_size = LZMA_PROPS_SIZE;
+		LZMALoader::Instance().LzmaCompress(&output[LZMA_PROPS_SIZE], &out_len, static_cast<Byte const *>(input), static_cast<SizeT>(len),
+			&output[0], &out_props_size, 5, std::min<uint32_t>(static_cast<uint32_t>(len), 1UL << 24), 3, 0, 2, 32, 1);
+
+		output.resize(LZMA_PROPS_SIZE + out_len);
+	}
+
+	void DecodeStream(void* output, void const * input, uint64_t len, uint64_t original_len)
+	{
+		uint8_t const * p = static_cast<uint8_t const *>(input);
+
+		SizeT s_out_len = static_cast<SizeT>(original_len);
+
+		SizeT s_src_len = static_cast<SizeT>(len - LZMA_PROPS_SIZE);
+		int res = LZMALoader::Instance().LzmaUncompress(static_cast<Byte*>(output), &s_out_len, p + LZMA_PROPS_SIZE, &s_src_len,
+			p, LZMA_PROPS_SIZE);
+		Verify(0 == res);
+	}
+
+	uint32_t ReadBlockHeaderValue(uint8_t const * p)
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return LE2Native(value);
+	}
 }
 
 namespace KlayGE
 {
 	LZMACodec::LZMACodec()
+		: block_size_(0)
+	{
+	}
+
+	LZMACodec::LZMACodec(uint32_t block_size)
+		: block_size_(block_size)
 	{
 	}
 
@@ -155,22 +187,58 @@ namespace KlayGE
 
 	void LZMACodec::Encode(std::vector<uint8_t>& output, void const * input, uint64_t len)
 	{
-		SizeT out_len = static_cast<SizeT>(std::max(len * 11 / 10, static_cast<uint64_t>(32)));
-		output.resize(LZMA_PROPS_SIZE + out_len);
-		SizeT out_props_size = LZMA_PROPS_SIZE;
-		LZMALoader::Instance().LzmaCompress(&output[LZMA_PROPS_SIZE], &out_len, static_cast<Byte const *>(input), static_cast<SizeT>(len),
-			&output[0], &out_props_size, 5, std::min<uint32_t>(static_cast<uint32_t>(len), 1UL << 24), 3, 0, 2, 32, 1);
+		if ((0 == block_size_) || (len <= block_size_))
+		{
+			EncodeStream(output, input, len);
+			return;
+		}
 
-		output.resize(LZMA_PROPS_SIZE + out_len);
+		uint8_t const * p = static_cast<uint8_t const *>(input);
+		uint32_t const num_blocks = static_cast<uint32_t>((len + block_size_ - 1) / block_size_);
+		std::vector<std::vector<uint8_t>> blocks(num_blocks);
+		Context::Instance().TaskScheduler().parallel_for(0, num_blocks, 1,
+			[this, p, len, &blocks](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++ i)
+				{
+					uint64_t const offset = static_cast<uint64_t>(i) * block_size_;
+					EncodeStream(blocks[i], p + offset, std::min<uint64_t>(block_size_, len - offset));
+				}
+			});
+
+		size_t out_len = BLOCK_HEADER_SIZE + num_blocks * sizeof(uint32_t);
+		for (auto const & block : blocks)
+		{
+			out_len += block.size();
+		}
+		output.resize(out_len);
+
+		uint8_t* out = &output[0];
+		std::memcpy(out, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+		out += sizeof(BLOCK_MAGIC);
+		uint32_t const block_size = Native2LE(block_size_);
+		std::memcpy(out, &block_size, sizeof(block_size));
+		out += sizeof(block_size);
+		uint32_t const le_num_blocks = Native2LE(num_blocks);
+		std::memcpy(out, &le_num_blocks, sizeof(le_num_blocks));
+		out += sizeof(le_num_blocks);
+		for (auto const & block : blocks)
+		{
+			uint32_t const block_len = Native2LE(static_cast<uint32_t>(block.size()));
+			std::memcpy(out, &block_len, sizeof(block_len));
+			out += sizeof(block_len);
+		}
+		for (auto const & block : blocks)
+		{
+			std::memcpy(out, &block[0], block.size());
+			out += block.size();
+		}
 	}
 
 	uint64_t LZMACodec::Decode(std::ostream& os, ResIdentifierPtr const & is, uint64_t len, uint64_t original_len)
 	{
-		std::vector<uint8_t> in_data(static_cast<size_t>(len));
-		is->read(&in_data[0], static_cast<size_t>(len));
-
 		std::vector<uint8_t> output;
-		this->Decode(output, &in_data[0], len, original_len);
+		this->Decode(output, is, len, original_len);
 
 		os.write(reinterpret_cast<char*>(&output[0]), static_cast<std::streamsize>(output.size()));
 
@@ -189,10 +257,8 @@ namespace KlayGE
 
 	void LZMACodec::Decode(std::vector<uint8_t>& output, ResIdentifierPtr const & is, uint64_t len, uint64_t original_len)
 	{
-		std::vector<uint8_t> in_data(static_cast<size_t>(len));
-		is->read(&in_data[0], static_cast<size_t>(len));
-
-		this->Decode(output, &in_data[0], len, original_len);
+		output.resize(static_cast<size_t>(original_len));
+		this->Decode(&output[0], is, len, original_len);
 	}
 
 	void LZMACodec::Decode(std::vector<uint8_t>& output, void const * input, uint64_t len, uint64_t original_len)
@@ -201,18 +267,54 @@ namespace KlayGE
 		this->Decode(&output[0], input, len, original_len);
 	}
 
+	void LZMACodec::Decode(void* output, ResIdentifierPtr const & is, uint64_t len, uint64_t original_len)
+	{
+		void const * in_place = is->read_in_place(static_cast<size_t>(len));
+		if (in_place)
+		{
+			this->Decode(output, in_place, len, original_len);
+		}
+		else
+		{
+			std::vector<uint8_t> in_data(static_cast<size_t>(len));
+			is->read(&in_data[0], static_cast<size_t>(len));
+
+			this->Decode(output, &in_data[0], len, original_len);
+		}
+	}
+
 	void LZMACodec::Decode(void* output, void const * input, uint64_t len, uint64_t original_len)
 	{
 		uint8_t const * p = static_cast<uint8_t const *>(input);
+		if ((len < BLOCK_HEADER_SIZE) || (std::memcmp(p, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0))
+		{
+			DecodeStream(output, input, len, original_len);
+			return;
+		}
 
-		std::vector<uint8_t> in_data(static_cast<size_t>(len));
-		std::memcpy(&in_data[0], p, static_cast<std::streamsize>(in_data.size()));
+		uint32_t const block_size = ReadBlockHeaderValue(p + sizeof(BLOCK_MAGIC));
+		uint32_t const num_blocks = ReadBlockHeaderValue(p + sizeof(BLOCK_MAGIC) + sizeof(uint32_t));
+		Verify((block_size > 0) && (num_blocks == (original_len + block_size - 1) / block_size));
+		Verify(len >= BLOCK_HEADER_SIZE + num_blocks * sizeof(uint32_t));
 
-		SizeT s_out_len = static_cast<SizeT>(original_len);
+		std::vector<uint64_t> block_offsets(num_blocks + 1);
+		block_offsets[0] = BLOCK_HEADER_SIZE + num_blocks * sizeof(uint32_t);
+		for (uint32_t i = 0; i < num_blocks; ++ i)
+		{
+			block_offsets[i + 1] = block_offsets[i] + ReadBlockHeaderValue(p + BLOCK_HEADER_SIZE + i * sizeof(uint32_t));
+		}
+		Verify(block_offsets[num_blocks] <= len);
 
-		SizeT s_src_len = static_cast<SizeT>(len - LZMA_PROPS_SIZE);
-		int res = LZMALoader::Instance().LzmaUncompress(static_cast<Byte*>(output), &s_out_len, &in_data[LZMA_PROPS_SIZE], &s_src_len,
-			&in_data[0], LZMA_PROPS_SIZE);
-		Verify(0 == res);
+		uint8_t* out = static_cast<uint8_t*>(output);
+		Context::Instance().TaskScheduler().parallel_for(0, num_blocks, 1,
+			[p, out, block_size, original_len, &block_offsets](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++ i)
+				{
+					uint64_t const offset = static_cast<uint64_t>(i) * block_size;
+					DecodeStream(out + offset, p + block_offsets[i], block_offsets[i + 1] - block_offsets[i],
+						std::min<uint64_t>(block_size, original_len - offset));
+				}
+			});
 	}
 }
@@ -31,6 +31,9 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KlayGE/ResLoader.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 #include <boost/assert.hpp>
 
 #include <CPP/Common/MyWindows.h>
@@ -150,4 +153,28 @@ namespace KlayGE
 	{
 		return E_NOTIMPL;
 	}
+
+
+	//////////////////////////
+	// CMemOutStream
+
+	void CMemOutStream::Attach(void* data, uint64_t size)
+	{
+		data_ = static_cast<uint8_t*>(data);
+		size_ = size;
+		pos_ = 0;
+	}
+
+	STDMETHODIMP CMemOutStream::Write(const void *data, UInt32 size, UInt32* processedSize)
+	{
+		uint32_t const to_write = static_cast<uint32_t>(std::min<uint64_t>(size, size_ - pos_));
+		memcpy(data_ + pos_, data, to_write);
+		pos_ += to_write;
+		if (processedSize)
+		{
+			*processedSize = to_write;
+		}
+
+		return (to_write == size) ? S_OK : E_FAIL;
+	}
 }
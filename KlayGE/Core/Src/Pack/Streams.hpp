@@ -161,6 +161,65 @@ namespace KlayGE
 
 		std::shared_ptr<std::ostream> os_;
 	};
+
+	// Writes into a caller-provided memory block of a known size, without any intermediate stream
+	class CMemOutStream : boost::noncopyable, public ISequentialOutStream
+	{
+	public:
+		STDMETHOD_(ULONG, AddRef)()
+		{
+			++ ref_count_;
+			return ref_count_;
+		}
+		STDMETHOD_(ULONG, Release)()
+		{
+			-- ref_count_;
+			if (0 == ref_count_)
+			{
+				delete this;
+				return 0;
+			}
+			return ref_count_;
+		}
+
+		STDMETHOD(QueryInterface)(REFGUID iid, void** outObject)
+		{
+			if (IID_ISequentialOutStream == iid)
+			{
+				*outObject = static_cast<void*>(this);
+				this->AddRef();
+				return S_OK;
+			}
+			else
+			{
+				return E_NOINTERFACE;
+			}
+		}
+
+		CMemOutStream()
+			: ref_count_(1), data_(nullptr), size_(0), pos_(0)
+		{
+		}
+		virtual ~CMemOutStream()
+		{
+		}
+
+		void Attach(void* data, uint64_t size);
+
+		uint64_t Written() const
+		{
+			return pos_;
+		}
+
+		STDMETHOD(Write)(const void* data, UInt32 size, UInt32* processedSize);
+
+	private:
+		std::atomic<int32_t> ref_count_;
+
+		uint8_t* data_;
+		uint64_t size_;
+		uint64_t pos_;
+	};
 }
 
 #endif		// _KFL_STREAMS_HPP
@@ -31,6 +31,7 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Math.hpp>
 #include <KFL/Half.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Camera.hpp>
@@ -213,31 +214,31 @@ namespace KlayGE
 
 			effect_ = SyncLoadRenderEffect("CascadedShadow.fxml");
 
-			clear_z_bounds_tech_ = effect_->TechniqueByName("ClearZBounds");
-			reduce_z_bounds_from_depth_tech_ = effect_->TechniqueByName("ReduceZBoundsFromDepth");
-			compute_log_cascades_from_z_bounds_tech_ = effect_->TechniqueByName("ComputeLogCascadesFromZBounds");
-			clear_cascade_bounds_tech_ = effect_->TechniqueByName("ClearCascadeBounds");
-			reduce_bounds_from_depth_tech_ = effect_->TechniqueByName("ReduceBoundsFromDepth");
-			compute_custom_cascades_tech_ = effect_->TechniqueByName("ComputeCustomCascades");
-
-			interval_buff_param_ = effect_->ParameterByName("interval_buff");
-			interval_buff_uint_param_ = effect_->ParameterByName("interval_buff_uint");
-			interval_buff_read_param_ = effect_->ParameterByName("interval_buff_read");
-			scale_buff_param_ = effect_->ParameterByName("scale_buff");
-			bias_buff_param_ = effect_->ParameterByName("bias_buff");
-			cascade_min_buff_uint_param_ = effect_->ParameterByName("cascade_min_buff_uint");
-			cascade_max_buff_uint_param_ = effect_->ParameterByName("cascade_max_buff_uint");
-			cascade_min_buff_read_param_ = effect_->ParameterByName("cascade_min_buff_read");
-			cascade_max_buff_read_param_ = effect_->ParameterByName("cascade_max_buff_read");
-			depth_tex_param_ = effect_->ParameterByName("depth_tex");
-			num_cascades_param_ = effect_->ParameterByName("num_cascades");
-			inv_depth_width_height_param_ = effect_->ParameterByName("inv_depth_width_height");
-			near_far_param_ = effect_->ParameterByName("near_far");
-			upper_left_param_ = effect_->ParameterByName("upper_left");
-			xy_dir_param_ = effect_->ParameterByName("xy_dir");
-			view_to_light_view_proj_param_ = effect_->ParameterByName("view_to_light_view_proj");
-			light_space_border_param_ = effect_->ParameterByName("light_space_border");
-			max_cascade_scale_param_ = effect_->ParameterByName("max_cascade_scale");
+			clear_z_bounds_tech_ = effect_->TechniqueByName(CT_HASH("ClearZBounds"));
+			reduce_z_bounds_from_depth_tech_ = effect_->TechniqueByName(CT_HASH("ReduceZBoundsFromDepth"));
+			compute_log_cascades_from_z_bounds_tech_ = effect_->TechniqueByName(CT_HASH("ComputeLogCascadesFromZBounds"));
+			clear_cascade_bounds_tech_ = effect_->TechniqueByName(CT_HASH("ClearCascadeBounds"));
+			reduce_bounds_from_depth_tech_ = effect_->TechniqueByName(CT_HASH("ReduceBoundsFromDepth"));
+			compute_custom_cascades_tech_ = effect_->TechniqueByName(CT_HASH("ComputeCustomCascades"));
+
+			interval_buff_param_ = effect_->ParameterByName(CT_HASH("interval_buff"));
+			interval_buff_uint_param_ = effect_->ParameterByName(CT_HASH("interval_buff_uint"));
+			interval_buff_read_param_ = effect_->ParameterByName(CT_HASH("interval_buff_read"));
+			scale_buff_param_ = effect_->ParameterByName(CT_HASH("scale_buff"));
+			bias_buff_param_ = effect_->ParameterByName(CT_HASH("bias_buff"));
+			cascade_min_buff_uint_param_ = effect_->ParameterByName(CT_HASH("cascade_min_buff_uint"));
+			cascade_max_buff_uint_param_ = effect_->ParameterByName(CT_HASH("cascade_max_buff_uint"));
+			cascade_min_buff_read_param_ = effect_->ParameterByName(CT_HASH("cascade_min_buff_read"));
+			cascade_max_buff_read_param_ = effect_->ParameterByName(CT_HASH("cascade_max_buff_read"));
+			depth_tex_param_ = effect_->ParameterByName(CT_HASH("depth_tex"));
+			num_cascades_param_ = effect_->ParameterByName(CT_HASH("num_cascades"));
+			inv_depth_width_height_param_ = effect_->ParameterByName(CT_HASH("inv_depth_width_height"));
+			near_far_param_ = effect_->ParameterByName(CT_HASH("near_far"));
+			upper_left_param_ = effect_->ParameterByName(CT_HASH("upper_left"));
+			xy_dir_param_ = effect_->ParameterByName(CT_HASH("xy_dir"));
+			view_to_light_view_proj_param_ = effect_->ParameterByName(CT_HASH("view_to_light_view_proj"));
+			light_space_border_param_ = effect_->ParameterByName(CT_HASH("light_space_border"));
+			max_cascade_scale_param_ = effect_->ParameterByName(CT_HASH("max_cascade_scale"));
 		}
 		else
 		{
@@ -31,6 +31,7 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Util.hpp>
 #include <KFL/Math.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/ResLoader.hpp>
 #include <KlayGE/Renderable.hpp>
 #include <KlayGE/RenderableHelper.hpp>
@@ -324,7 +325,7 @@ namespace KlayGE
 			output_pins_.emplace_back("out_tex", TexturePtr());
 
 			auto effect = SyncLoadRenderEffect("DeferredRenderingDebug.fxml");
-			this->Technique(effect, effect->TechniqueByName("ShowPosition"));
+			this->Technique(effect, effect->TechniqueByName(CT_HASH("ShowPosition")));
 		}
 
 		void Display(DeferredRenderingLayer::DisplayType display_type)
@@ -335,43 +336,43 @@ namespace KlayGE
 				break;
 
 			case DeferredRenderingLayer::DT_Position:
-				technique_ = effect_->TechniqueByName("ShowPosition");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowPosition"));
 				break;
 
 			case DeferredRenderingLayer::DT_Normal:
-				technique_ = effect_->TechniqueByName("ShowNormal");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowNormal"));
 				break;
 
 			case DeferredRenderingLayer::DT_Depth:
-				technique_ = effect_->TechniqueByName("ShowDepth");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowDepth"));
 				break;
 
 			case DeferredRenderingLayer::DT_Diffuse:
-				technique_ = effect_->TechniqueByName("ShowDiffuse");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowDiffuse"));
 				break;
 
 			case DeferredRenderingLayer::DT_Specular:
-				technique_ = effect_->TechniqueByName("ShowSpecular");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowSpecular"));
 				break;
 
 			case DeferredRenderingLayer::DT_Shininess:
-				technique_ = effect_->TechniqueByName("ShowShininess");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowShininess"));
 				break;
 
 			case DeferredRenderingLayer::DT_Edge:
 				break;
 
 			case DeferredRenderingLayer::DT_SSVO:
-				technique_ = effect_->TechniqueByName("ShowSSVO");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowSSVO"));
 				break;
 
 #if DEFAULT_DEFERRED == TRIDITIONAL_DEFERRED
 			case DeferredRenderingLayer::DT_DiffuseLighting:
-				technique_ = effect_->TechniqueByName("ShowDiffuseLighting");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowDiffuseLighting"));
 				break;
 
 			case DeferredRenderingLayer::DT_SpecularLighting:
-				technique_ = effect_->TechniqueByName("ShowSpecularLighting");
+				technique_ = effect_->TechniqueByName(CT_HASH("ShowSpecularLighting"));
 				break;
 #endif
 
@@ -385,8 +386,8 @@ namespace KlayGE
 			PostProcess::OnRenderBegin();
 
 			Camera const & camera = Context::Instance().AppInstance().ActiveCamera();
-			*(effect_->ParameterByName("inv_proj")) = camera.InverseProjMatrix();
-			*(effect_->ParameterByName("depth_near_far_invfar")) = float3(camera.NearPlane(), camera.FarPlane(), 1 / camera.FarPlane());
+			*(effect_->ParameterByName(CT_HASH("inv_proj"))) = camera.InverseProjMatrix();
+			*(effect_->ParameterByName(CT_HASH("depth_near_far_invfar"))) = float3(camera.NearPlane(), camera.FarPlane(), 1 / camera.FarPlane());
 		}
 	};
 
@@ -542,72 +543,72 @@ namespace KlayGE
 		}
 #endif
 
-		technique_shadows_[LightSource::LT_Point][0] = dr_effect_->TechniqueByName("DeferredShadowingPointR");
-		technique_shadows_[LightSource::LT_Point][1] = dr_effect_->TechniqueByName("DeferredShadowingPointG");
-		technique_shadows_[LightSource::LT_Point][2] = dr_effect_->TechniqueByName("DeferredShadowingPointB");
-		technique_shadows_[LightSource::LT_Point][3] = dr_effect_->TechniqueByName("DeferredShadowingPointA");
-		technique_shadows_[LightSource::LT_Point][4] = dr_effect_->TechniqueByName("DeferredShadowingPoint");
-		technique_shadows_[LightSource::LT_Spot][0] = dr_effect_->TechniqueByName("DeferredShadowingSpotR");
-		technique_shadows_[LightSource::LT_Spot][1] = dr_effect_->TechniqueByName("DeferredShadowingSpotG");
-		technique_shadows_[LightSource::LT_Spot][2] = dr_effect_->TechniqueByName("DeferredShadowingSpotB");
-		technique_shadows_[LightSource::LT_Spot][3] = dr_effect_->TechniqueByName("DeferredShadowingSpotA");
-		technique_shadows_[LightSource::LT_Spot][4] = dr_effect_->TechniqueByName("DeferredShadowingSpot");
-		technique_shadows_[LightSource::LT_Sun][0] = dr_effect_->TechniqueByName("DeferredShadowingSunR");
-		technique_shadows_[LightSource::LT_Sun][1] = dr_effect_->TechniqueByName("DeferredShadowingSunG");
-		technique_shadows_[LightSource::LT_Sun][2] = dr_effect_->TechniqueByName("DeferredShadowingSunB");
-		technique_shadows_[LightSource::LT_Sun][3] = dr_effect_->TechniqueByName("DeferredShadowingSunA");
-		technique_shadows_[LightSource::LT_Sun][4] = dr_effect_->TechniqueByName("DeferredShadowingSun");
-		technique_shadows_[LightSource::LT_SphereArea][0] = dr_effect_->TechniqueByName("DeferredShadowingPointR");
-		technique_shadows_[LightSource::LT_SphereArea][1] = dr_effect_->TechniqueByName("DeferredShadowingPointG");
-		technique_shadows_[LightSource::LT_SphereArea][2] = dr_effect_->TechniqueByName("DeferredShadowingPointB");
-		technique_shadows_[LightSource::LT_SphereArea][3] = dr_effect_->TechniqueByName("DeferredShadowingPointA");
-		technique_shadows_[LightSource::LT_SphereArea][4] = dr_effect_->TechniqueByName("DeferredShadowingPoint");
-		technique_shadows_[LightSource::LT_TubeArea][0] = dr_effect_->TechniqueByName("DeferredShadowingPointR");
-		technique_shadows_[LightSource::LT_TubeArea][1] = dr_effect_->TechniqueByName("DeferredShadowingPointG");
-		technique_shadows_[LightSource::LT_TubeArea][2] = dr_effect_->TechniqueByName("DeferredShadowingPointB");
-		technique_shadows_[LightSource::LT_TubeArea][3] = dr_effect_->TechniqueByName("DeferredShadowingPointA");
-		technique_shadows_[LightSource::LT_TubeArea][4] = dr_effect_->TechniqueByName("DeferredShadowingPoint");
+		technique_shadows_[LightSource::LT_Point][0] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointR"));
+		technique_shadows_[LightSource::LT_Point][1] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointG"));
+		technique_shadows_[LightSource::LT_Point][2] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointB"));
+		technique_shadows_[LightSource::LT_Point][3] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointA"));
+		technique_shadows_[LightSource::LT_Point][4] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPoint"));
+		technique_shadows_[LightSource::LT_Spot][0] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSpotR"));
+		technique_shadows_[LightSource::LT_Spot][1] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSpotG"));
+		technique_shadows_[LightSource::LT_Spot][2] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSpotB"));
+		technique_shadows_[LightSource::LT_Spot][3] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSpotA"));
+		technique_shadows_[LightSource::LT_Spot][4] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSpot"));
+		technique_shadows_[LightSource::LT_Sun][0] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSunR"));
+		technique_shadows_[LightSource::LT_Sun][1] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSunG"));
+		technique_shadows_[LightSource::LT_Sun][2] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSunB"));
+		technique_shadows_[LightSource::LT_Sun][3] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSunA"));
+		technique_shadows_[LightSource::LT_Sun][4] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingSun"));
+		technique_shadows_[LightSource::LT_SphereArea][0] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointR"));
+		technique_shadows_[LightSource::LT_SphereArea][1] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointG"));
+		technique_shadows_[LightSource::LT_SphereArea][2] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointB"));
+		technique_shadows_[LightSource::LT_SphereArea][3] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointA"));
+		technique_shadows_[LightSource::LT_SphereArea][4] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPoint"));
+		technique_shadows_[LightSource::LT_TubeArea][0] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointR"));
+		technique_shadows_[LightSource::LT_TubeArea][1] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointG"));
+		technique_shadows_[LightSource::LT_TubeArea][2] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointB"));
+		technique_shadows_[LightSource::LT_TubeArea][3] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPointA"));
+		technique_shadows_[LightSource::LT_TubeArea][4] = dr_effect_->TechniqueByName(CT_HASH("DeferredShadowingPoint"));
 #if DEFAULT_DEFERRED == TRIDITIONAL_DEFERRED
-		technique_lights_[LightSource::LT_Ambient] = dr_effect_->TechniqueByName("DeferredRenderingAmbient");
-		technique_lights_[LightSource::LT_Directional] = dr_effect_->TechniqueByName("DeferredRenderingDirectional");
-		technique_lights_[LightSource::LT_Point] = dr_effect_->TechniqueByName("DeferredRenderingPoint");
-		technique_lights_[LightSource::LT_Spot] = dr_effect_->TechniqueByName("DeferredRenderingSpot");
-		technique_lights_[LightSource::LT_Sun] = dr_effect_->TechniqueByName("DeferredRenderingSun");
-		technique_lights_[LightSource::LT_SphereArea] = dr_effect_->TechniqueByName("DeferredRenderingSphereArea");
-		technique_lights_[LightSource::LT_TubeArea] = dr_effect_->TechniqueByName("DeferredRenderingTubeArea");
-		technique_light_depth_only_ = dr_effect_->TechniqueByName("DeferredRenderingLightDepthOnly");
-		technique_light_stencil_ = dr_effect_->TechniqueByName("DeferredRenderingLightStencil");
+		technique_lights_[LightSource::LT_Ambient] = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingAmbient"));
+		technique_lights_[LightSource::LT_Directional] = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingDirectional"));
+		technique_lights_[LightSource::LT_Point] = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingPoint"));
+		technique_lights_[LightSource::LT_Spot] = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingSpot"));
+		technique_lights_[LightSource::LT_Sun] = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingSun"));
+		technique_lights_[LightSource::LT_SphereArea] = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingSphereArea"));
+		technique_lights_[LightSource::LT_TubeArea] = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingTubeArea"));
+		technique_light_depth_only_ = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingLightDepthOnly"));
+		technique_light_stencil_ = dr_effect_->TechniqueByName(CT_HASH("DeferredRenderingLightStencil"));
 #endif
-		technique_no_lighting_ = dr_effect_->TechniqueByName("NoLightingTech");
-		technique_shading_ = dr_effect_->TechniqueByName("ShadingTech");
-		technique_merge_shadings_[0] = dr_effect_->TechniqueByName("MergeShadingTech");
-		technique_merge_shadings_[1] = dr_effect_->TechniqueByName("MergeShadingAlphaBlendTech");
-		technique_merge_depths_[0] = dr_effect_->TechniqueByName("MergeDepthTech");
-		technique_merge_depths_[1] = dr_effect_->TechniqueByName("MergeDepthAlphaBlendTech");
-		technique_copy_shading_depth_ = dr_effect_->TechniqueByName("CopyShadingDepthTech");
-		technique_copy_depth_ = dr_effect_->TechniqueByName("CopyDepthTech");
+		technique_no_lighting_ = dr_effect_->TechniqueByName(CT_HASH("NoLightingTech"));
+		technique_shading_ = dr_effect_->TechniqueByName(CT_HASH("ShadingTech"));
+		technique_merge_shadings_[0] = dr_effect_->TechniqueByName(CT_HASH("MergeShadingTech"));
+		technique_merge_shadings_[1] = dr_effect_->TechniqueByName(CT_HASH("MergeShadingAlphaBlendTech"));
+		technique_merge_depths_[0] = dr_effect_->TechniqueByName(CT_HASH("MergeDepthTech"));
+		technique_merge_depths_[1] = dr_effect_->TechniqueByName(CT_HASH("MergeDepthAlphaBlendTech"));
+		technique_copy_shading_depth_ = dr_effect_->TechniqueByName(CT_HASH("CopyShadingDepthTech"));
+		technique_copy_depth_ = dr_effect_->TechniqueByName(CT_HASH("CopyDepthTech"));
 #if DEFAULT_DEFERRED == LIGHT_INDEXED_DEFERRED
 		if (cs_tbdr_)
 		{
-			technique_tbdr_shadowing_unified_ = dr_effect_->TechniqueByName("TBDRShadowingUnified");
-			technique_tbdr_light_intersection_unified_ = dr_effect_->TechniqueByName("TBDRLightIntersection");
-			technique_tbdr_unified_ = dr_effect_->TechniqueByName("TBDRUnified");
+			technique_tbdr_shadowing_unified_ = dr_effect_->TechniqueByName(CT_HASH("TBDRShadowingUnified"));
+			technique_tbdr_light_intersection_unified_ = dr_effect_->TechniqueByName(CT_HASH("TBDRLightIntersection"));
+			technique_tbdr_unified_ = dr_effect_->TechniqueByName(CT_HASH("TBDRUnified"));
 		}
 		else
 		{
-			technique_draw_light_index_point_ = dr_effect_->TechniqueByName("DrawLightIndexPoint");
-			technique_draw_light_index_spot_ = dr_effect_->TechniqueByName("DrawLightIndexSpot");
-			technique_lidr_ambient_ = dr_effect_->TechniqueByName("LIDRAmbient");
-			technique_lidr_sun_ = dr_effect_->TechniqueByName("LIDRSun");
-			technique_lidr_directional_ = dr_effect_->TechniqueByName("LIDRDirectional");
-			technique_lidr_point_shadow_ = dr_effect_->TechniqueByName("LIDRPointShadow");
-			technique_lidr_point_no_shadow_ = dr_effect_->TechniqueByName("LIDRPointNoShadow");
-			technique_lidr_spot_shadow_ = dr_effect_->TechniqueByName("LIDRSpotShadow");
-			technique_lidr_spot_no_shadow_ = dr_effect_->TechniqueByName("LIDRSpotNoShadow");
-			technique_lidr_sphere_area_shadow_ = dr_effect_->TechniqueByName("LIDRSphereAreaShadow");
-			technique_lidr_sphere_area_no_shadow_ = dr_effect_->TechniqueByName("LIDRSphereAreaNoShadow");
-			technique_lidr_tube_area_shadow_ = dr_effect_->TechniqueByName("LIDRTubeAreaShadow");
-			technique_lidr_tube_area_no_shadow_ = dr_effect_->TechniqueByName("LIDRTubeAreaNoShadow");
+			technique_draw_light_index_point_ = dr_effect_->TechniqueByName(CT_HASH("DrawLightIndexPoint"));
+			technique_draw_light_index_spot_ = dr_effect_->TechniqueByName(CT_HASH("DrawLightIndexSpot"));
+			technique_lidr_ambient_ = dr_effect_->TechniqueByName(CT_HASH("LIDRAmbient"));
+			technique_lidr_sun_ = dr_effect_->TechniqueByName(CT_HASH("LIDRSun"));
+			technique_lidr_directional_ = dr_effect_->TechniqueByName(CT_HASH("LIDRDirectional"));
+			technique_lidr_point_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRPointShadow"));
+			technique_lidr_point_no_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRPointNoShadow"));
+			technique_lidr_spot_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRSpotShadow"));
+			technique_lidr_spot_no_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRSpotNoShadow"));
+			technique_lidr_sphere_area_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRSphereAreaShadow"));
+			technique_lidr_sphere_area_no_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRSphereAreaNoShadow"));
+			technique_lidr_tube_area_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRTubeAreaShadow"));
+			technique_lidr_tube_area_no_shadow_ = dr_effect_->TechniqueByName(CT_HASH("LIDRTubeAreaNoShadow"));
 		}
 #endif
 
@@ -660,8 +661,8 @@ namespace KlayGE
 		auto effect_x = SyncLoadRenderEffect("SSVO.fxml");
 		auto effect_y = effect_x->Clone();
 		ssvo_blur_pp_ = MakeSharedPtr<BlurPostProcess<SeparableBilateralFilterPostProcess>>(8, 1.0f,
-			effect_x, effect_x->TechniqueByName("SSVOBlurX"),
-			effect_y, effect_y->TechniqueByName("SSVOBlurY"));
+			effect_x, effect_x->TechniqueByName(CT_HASH("SSVOBlurX")),
+			effect_y, effect_y->TechniqueByName(CT_HASH("SSVOBlurY")));
 		ssr_pp_ = MakeSharedPtr<SSRPostProcess>();
 		taa_pp_ = SyncLoadPostProcess("TAA.ppml", "taa");
 
@@ -708,101 +709,101 @@ namespace KlayGE
 		depth_to_linear_pp_ = SyncLoadPostProcess("Depth.ppml", "DepthToLinear");
 		depth_mipmap_pp_ = SyncLoadPostProcess("Depth.ppml", "DepthMipmapBilinear");
 
-		g_buffer_tex_param_ = dr_effect_->ParameterByName("g_buffer_tex");
-		g_buffer_1_tex_param_ = dr_effect_->ParameterByName("g_buffer_1_tex");
-		depth_tex_param_ = dr_effect_->ParameterByName("depth_tex");
+		g_buffer_tex_param_ = dr_effect_->ParameterByName(CT_HASH("g_buffer_tex"));
+		g_buffer_1_tex_param_ = dr_effect_->ParameterByName(CT_HASH("g_buffer_1_tex"));
+		depth_tex_param_ = dr_effect_->ParameterByName(CT_HASH("depth_tex"));
 #if DEFAULT_DEFERRED == TRIDITIONAL_DEFERRED
-		lighting_tex_param_ = dr_effect_->ParameterByName("lighting_tex");
+		lighting_tex_param_ = dr_effect_->ParameterByName(CT_HASH("lighting_tex"));
 #endif
-		shading_tex_param_ = dr_effect_->ParameterByName("shading_tex");
-		light_attrib_param_ = dr_effect_->ParameterByName("light_attrib");
-		light_radius_extend_param_ = dr_effect_->ParameterByName("light_radius_extend");
-		light_color_param_ = dr_effect_->ParameterByName("light_color");
-		light_falloff_range_param_ = dr_effect_->ParameterByName("light_falloff_range");
-		light_view_proj_param_ = dr_effect_->ParameterByName("light_view_proj");
-		light_volume_mv_param_ = dr_effect_->ParameterByName("light_volume_mv");
-		light_volume_mvp_param_ = dr_effect_->ParameterByName("light_volume_mvp");
-		view_to_light_model_param_ = dr_effect_->ParameterByName("view_to_light_model");
-		light_pos_es_param_ = dr_effect_->ParameterByName("light_pos_es");
-		light_dir_es_param_ = dr_effect_->ParameterByName("light_dir_es");
-		projective_map_2d_tex_param_ = dr_effect_->ParameterByName("projective_map_2d_tex");
-		projective_map_cube_tex_param_ = dr_effect_->ParameterByName("projective_map_cube_tex");
-		filtered_sm_2d_tex_param_ = dr_effect_->ParameterByName("filtered_sm_2d_tex");
-		filtered_sm_2d_tex_array_param_ = dr_effect_->ParameterByName("filtered_sm_2d_tex_array");
-		filtered_sm_2d_light_index_param_ = dr_effect_->ParameterByName("filtered_sm_2d_light_index");
-		filtered_sm_cube_tex_param_ = dr_effect_->ParameterByName("filtered_sm_cube_tex");
-		inv_width_height_param_ = dr_effect_->ParameterByName("inv_width_height");
-		shadowing_tex_param_ = dr_effect_->ParameterByName("shadowing_tex");
-		projective_shadowing_tex_param_ = dr_effect_->ParameterByName("projective_shadowing_tex");
-		shadowing_channel_param_ = dr_effect_->ParameterByName("shadowing_channel");
-		esm_scale_factor_param_ = dr_effect_->ParameterByName("esm_scale_factor");
-		near_q_param_ = dr_effect_->ParameterByName("near_q");
-		cascade_intervals_param_ = dr_effect_->ParameterByName("cascade_intervals");
-		cascade_scale_bias_param_ = dr_effect_->ParameterByName("cascade_scale_bias");
-		num_cascades_param_ = dr_effect_->ParameterByName("num_cascades");
-		view_z_to_light_view_param_ = dr_effect_->ParameterByName("view_z_to_light_view");
+		shading_tex_param_ = dr_effect_->ParameterByName(CT_HASH("shading_tex"));
+		light_attrib_param_ = dr_effect_->ParameterByName(CT_HASH("light_attrib"));
+		light_radius_extend_param_ = dr_effect_->ParameterByName(CT_HASH("light_radius_extend"));
+		light_color_param_ = dr_effect_->ParameterByName(CT_HASH("light_color"));
+		light_falloff_range_param_ = dr_effect_->ParameterByName(CT_HASH("light_falloff_range"));
+		light_view_proj_param_ = dr_effect_->ParameterByName(CT_HASH("light_view_proj"));
+		light_volume_mv_param_ = dr_effect_->ParameterByName(CT_HASH("light_volume_mv"));
+		light_volume_mvp_param_ = dr_effect_->ParameterByName(CT_HASH("light_volume_mvp"));
+		view_to_light_model_param_ = dr_effect_->ParameterByName(CT_HASH("view_to_light_model"));
+		light_pos_es_param_ = dr_effect_->ParameterByName(CT_HASH("light_pos_es"));
+		light_dir_es_param_ = dr_effect_->ParameterByName(CT_HASH("light_dir_es"));
+		projective_map_2d_tex_param_ = dr_effect_->ParameterByName(CT_HASH("projective_map_2d_tex"));
+		projective_map_cube_tex_param_ = dr_effect_->ParameterByName(CT_HASH("projective_map_cube_tex"));
+		filtered_sm_2d_tex_param_ = dr_effect_->ParameterByName(CT_HASH("filtered_sm_2d_tex"));
+		filtered_sm_2d_tex_array_param_ = dr_effect_->ParameterByName(CT_HASH("filtered_sm_2d_tex_array"));
+		filtered_sm_2d_light_index_param_ = dr_effect_->ParameterByName(CT_HASH("filtered_sm_2d_light_index"));
+		filtered_sm_cube_tex_param_ = dr_effect_->ParameterByName(CT_HASH("filtered_sm_cube_tex"));
+		inv_width_height_param_ = dr_effect_->ParameterByName(CT_HASH("inv_width_height"));
+		shadowing_tex_param_ = dr_effect_->ParameterByName(CT_HASH("shadowing_tex"));
+		projective_shadowing_tex_param_ = dr_effect_->ParameterByName(CT_HASH("projective_shadowing_tex"));
+		shadowing_channel_param_ = dr_effect_->ParameterByName(CT_HASH("shadowing_channel"));
+		esm_scale_factor_param_ = dr_effect_->ParameterByName(CT_HASH("esm_scale_factor"));
+		near_q_param_ = dr_effect_->ParameterByName(CT_HASH("near_q"));
+		cascade_intervals_param_ = dr_effect_->ParameterByName(CT_HASH("cascade_intervals"));
+		cascade_scale_bias_param_ = dr_effect_->ParameterByName(CT_HASH("cascade_scale_bias"));
+		num_cascades_param_ = dr_effect_->ParameterByName(CT_HASH("num_cascades"));
+		view_z_to_light_view_param_ = dr_effect_->ParameterByName(CT_HASH("view_z_to_light_view"));
 		if (tex_array_support_)
 		{
-			filtered_csm_texs_param_[0] = dr_effect_->ParameterByName("filtered_csm_tex_array");
+			filtered_csm_texs_param_[0] = dr_effect_->ParameterByName(CT_HASH("filtered_csm_tex_array"));
 		}
 		else
 		{
-			filtered_csm_texs_param_[0] = dr_effect_->ParameterByName("filtered_csm_0_tex");
-			filtered_csm_texs_param_[1] = dr_effect_->ParameterByName("filtered_csm_1_tex");
-			filtered_csm_texs_param_[2] = dr_effect_->ParameterByName("filtered_csm_2_tex");
-			filtered_csm_texs_param_[3] = dr_effect_->ParameterByName("filtered_csm_3_tex");
+			filtered_csm_texs_param_[0] = dr_effect_->ParameterByName(CT_HASH("filtered_csm_0_tex"));
+			filtered_csm_texs_param_[1] = dr_effect_->ParameterByName(CT_HASH("filtered_csm_1_tex"));
+			filtered_csm_texs_param_[2] = dr_effect_->ParameterByName(CT_HASH("filtered_csm_2_tex"));
+			filtered_csm_texs_param_[3] = dr_effect_->ParameterByName(CT_HASH("filtered_csm_3_tex"));
 		}
-		skylight_diff_spec_mip_param_ = dr_effect_->ParameterByName("skylight_diff_spec_mip");
-		inv_view_param_ = dr_effect_->ParameterByName("inv_view");
-		skylight_y_cube_tex_param_ = dr_effect_->ParameterByName("skylight_y_cube_tex");
-		skylight_c_cube_tex_param_ = dr_effect_->ParameterByName("skylight_c_cube_tex");
+		skylight_diff_spec_mip_param_ = dr_effect_->ParameterByName(CT_HASH("skylight_diff_spec_mip"));
+		inv_view_param_ = dr_effect_->ParameterByName(CT_HASH("inv_view"));
+		skylight_y_cube_tex_param_ = dr_effect_->ParameterByName(CT_HASH("skylight_y_cube_tex"));
+		skylight_c_cube_tex_param_ = dr_effect_->ParameterByName(CT_HASH("skylight_c_cube_tex"));
 #if DEFAULT_DEFERRED == LIGHT_INDEXED_DEFERRED
-		min_max_depth_tex_param_ = dr_effect_->ParameterByName("min_max_depth_tex");
-		lights_color_param_ = dr_effect_->ParameterByName("lights_color");
-		lights_pos_es_param_ = dr_effect_->ParameterByName("lights_pos_es");
-		lights_dir_es_param_ = dr_effect_->ParameterByName("lights_dir_es");
-		lights_falloff_range_param_ = dr_effect_->ParameterByName("lights_falloff_range");
-		lights_attrib_param_ = dr_effect_->ParameterByName("lights_attrib");
-		lights_radius_extend_param_ = dr_effect_->ParameterByName("lights_radius_extend");
-		lights_aabb_min_param_ = dr_effect_->ParameterByName("lights_aabb_min");
-		lights_aabb_max_param_ = dr_effect_->ParameterByName("lights_aabb_max");
-		tile_scale_param_ = dr_effect_->ParameterByName("tile_scale");
-		camera_proj_01_param_ = dr_effect_->ParameterByName("camera_proj_01");
+		min_max_depth_tex_param_ = dr_effect_->ParameterByName(CT_HASH("min_max_depth_tex"));
+		lights_color_param_ = dr_effect_->ParameterByName(CT_HASH("lights_color"));
+		lights_pos_es_param_ = dr_effect_->ParameterByName(CT_HASH("lights_pos_es"));
+		lights_dir_es_param_ = dr_effect_->ParameterByName(CT_HASH("lights_dir_es"));
+		lights_falloff_range_param_ = dr_effect_->ParameterByName(CT_HASH("lights_falloff_range"));
+		lights_attrib_param_ = dr_effect_->ParameterByName(CT_HASH("lights_attrib"));
+		lights_radius_extend_param_ = dr_effect_->ParameterByName(CT_HASH("lights_radius_extend"));
+		lights_aabb_min_param_ = dr_effect_->ParameterByName(CT_HASH("lights_aabb_min"));
+		lights_aabb_max_param_ = dr_effect_->ParameterByName(CT_HASH("lights_aabb_max"));
+		tile_scale_param_ = dr_effect_->ParameterByName(CT_HASH("tile_scale"));
+		camera_proj_01_param_ = dr_effect_->ParameterByName(CT_HASH("camera_proj_01"));
 
 		if (cs_tbdr_)
 		{
-			technique_depth_to_tiled_min_max_ = dr_effect_->TechniqueByName("DepthToTiledMinMax");
-			technique_tbdr_lighting_mask_ = dr_effect_->TechniqueByName("TBDRLightingMask");
-
-			near_q_far_param_ = dr_effect_->ParameterByName("near_q_far");
-			width_height_param_ = dr_effect_->ParameterByName("width_height");
-			depth_to_tiled_depth_in_tex_param_ = dr_effect_->ParameterByName("depth_in_tex");
-			depth_to_tiled_min_max_depth_rw_tex_param_ = dr_effect_->ParameterByName("min_max_depth_rw_tex");
-			linear_depth_rw_tex_param_ = dr_effect_->ParameterByName("linear_depth_rw_tex");
-			upper_left_param_ = dr_effect_->ParameterByName("upper_left");
-			x_dir_param_ = dr_effect_->ParameterByName("x_dir");
-			y_dir_param_ = dr_effect_->ParameterByName("y_dir");
-			read_no_lighting_param_ = dr_effect_->ParameterByName("read_no_lighting");
-			lighting_mask_tex_param_ = dr_effect_->ParameterByName("lighting_mask_tex");
-			shading_in_tex_param_ = dr_effect_->ParameterByName("shading_in_tex");
-			shading_rw_tex_param_ = dr_effect_->ParameterByName("shading_rw_tex");
-			lights_type_param_ = dr_effect_->ParameterByName("lights_type");
-			lights_start_in_tex_param_ = dr_effect_->ParameterByName("lights_start_in_tex");
-			lights_start_rw_tex_param_ = dr_effect_->ParameterByName("lights_start_rw_tex");
-			intersected_light_indices_in_tex_param_ = dr_effect_->ParameterByName("intersected_light_indices_in_tex");
-			intersected_light_indices_rw_tex_param_ = dr_effect_->ParameterByName("intersected_light_indices_rw_tex");
-
-			projective_shadowing_rw_tex_param_ = dr_effect_->ParameterByName("projective_shadowing_rw_tex");
-			shadowing_rw_tex_param_ = dr_effect_->ParameterByName("shadowing_rw_tex");
-			lights_view_proj_param_ = dr_effect_->ParameterByName("lights_view_proj");
-			filtered_sms_2d_light_index_param_ = dr_effect_->ParameterByName("filtered_sms_2d_light_index");
-			esms_scale_factor_param_ = dr_effect_->ParameterByName("esms_scale_factor");
+			technique_depth_to_tiled_min_max_ = dr_effect_->TechniqueByName(CT_HASH("DepthToTiledMinMax"));
+			technique_tbdr_lighting_mask_ = dr_effect_->TechniqueByName(CT_HASH("TBDRLightingMask"));
+
+			near_q_far_param_ = dr_effect_->ParameterByName(CT_HASH("near_q_far"));
+			width_height_param_ = dr_effect_->ParameterByName(CT_HASH("width_height"));
+			depth_to_tiled_depth_in_tex_param_ = dr_effect_->ParameterByName(CT_HASH("depth_in_tex"));
+			depth_to_tiled_min_max_depth_rw_tex_param_ = dr_effect_->ParameterByName(CT_HASH("min_max_depth_rw_tex"));
+			linear_depth_rw_tex_param_ = dr_effect_->ParameterByName(CT_HASH("linear_depth_rw_tex"));
+			upper_left_param_ = dr_effect_->ParameterByName(CT_HASH("upper_left"));
+			x_dir_param_ = dr_effect_->ParameterByName(CT_HASH("x_dir"));
+			y_dir_param_ = dr_effect_->ParameterByName(CT_HASH("y_dir"));
+			read_no_lighting_param_ = dr_effect_->ParameterByName(CT_HASH("read_no_lighting"));
+			lighting_mask_tex_param_ = dr_effect_->ParameterByName(CT_HASH("lighting_mask_tex"));
+			shading_in_tex_param_ = dr_effect_->ParameterByName(CT_HASH("shading_in_tex"));
+			shading_rw_tex_param_ = dr_effect_->ParameterByName(CT_HASH("shading_rw_tex"));
+			lights_type_param_ = dr_effect_->ParameterByName(CT_HASH("lights_type"));
+			lights_start_in_tex_param_ = dr_effect_->ParameterByName(CT_HASH("lights_start_in_tex"));
+			lights_start_rw_tex_param_ = dr_effect_->ParameterByName(CT_HASH("lights_start_rw_tex"));
+			intersected_light_indices_in_tex_param_ = dr_effect_->ParameterByName(CT_HASH("intersected_light_indices_in_tex"));
+			intersected_light_indices_rw_tex_param_ = dr_effect_->ParameterByName(CT_HASH("intersected_light_indices_rw_tex"));
+
+			projective_shadowing_rw_tex_param_ = dr_effect_->ParameterByName(CT_HASH("projective_shadowing_rw_tex"));
+			shadowing_rw_tex_param_ = dr_effect_->ParameterByName(CT_HASH("shadowing_rw_tex"));
+			lights_view_proj_param_ = dr_effect_->ParameterByName(CT_HASH("lights_view_proj"));
+			filtered_sms_2d_light_index_param_ = dr_effect_->ParameterByName(CT_HASH("filtered_sms_2d_light_index"));
+			esms_scale_factor_param_ = dr_effect_->ParameterByName(CT_HASH("esms_scale_factor"));
 
 			copy_pp_ = SyncLoadPostProcess("Copy.ppml", "copy");
 		}
 		else
 		{
-			light_index_tex_param_ = dr_effect_->ParameterByName("light_index_tex");
+			light_index_tex_param_ = dr_effect_->ParameterByName(CT_HASH("light_index_tex"));
 		}
 
 		depth_to_min_max_pp_ = SyncLoadPostProcess("Depth.ppml", "DepthToMinMax");
@@ -1260,6 +1261,7 @@ namespace KlayGE
 			this->BuildVisibleSceneObjList(has_opaque_objs, has_transparency_back_objs, has_transparency_front_objs);
 
 			this->BuildPassScanList(has_opaque_objs, has_transparency_back_objs, has_transparency_front_objs);
+			this->CullPassViews();
 
 			num_objects_rendered_ = 0;
 			num_renderables_rendered_ = 0;
@@ -1455,6 +1457,18 @@ namespace KlayGE
 				auto const & light = *lights_[org_no];
 				this->PrepareLightCamera(pvp, light, index_in_pass, pass_type);
 
+				if ((LightSource::LT_Sun == light.Type()) && (0 == index_in_pass))
+				{
+					// The crop matrices are ready after the opaque G-buffer, so the cascades are culled together here
+					std::vector<SceneManager::CullingView> views(pvp.num_cascades);
+					for (uint32_t i = 0; i < pvp.num_cascades; ++ i)
+					{
+						views[i].camera = light.SMCamera(0).get();
+						views[i].cascade_index = static_cast<int32_t>(i);
+					}
+					scene_mgr.CullViews(views.data(), static_cast<uint32_t>(views.size()));
+				}
+
 				if (index_in_pass > 0)
 				{
 					this->PostGenerateShadowMap(pvp, org_no, index_in_pass);
@@ -2029,13 +2043,77 @@ namespace KlayGE
 #endif
 	}
 
-	void DeferredRenderingLayer::CheckLightVisible(uint32_t vp_index, uint32_t light_index)
+	void DeferredRenderingLayer::CullPassViews()
 	{
-		SceneManager& scene_mgr = Context::Instance().SceneManagerInstance();
+		// Cameras of the viewports and of the shadow maps are culled in one walk of the scene. The cascades are culled
+		//  later, since their crop matrices depend on the G-buffer.
+		std::vector<SceneManager::CullingView> views;
+		for (auto const & pvp : viewports_)
+		{
+			if (pvp.attrib & VPAM_Enabled)
+			{
+				SceneManager::CullingView view;
+				view.camera = pvp.frame_buffer->GetViewport()->camera.get();
+				view.cascade_index = -1;
+				views.push_back(view);
+			}
+		}
+		for (auto const code : pass_scaned_)
+		{
+			uint32_t vp_index;
+			PassType pass_type;
+			int32_t org_no, index_in_pass;
+			bool is_profile;
+			this->DecomposePassScanCode(vp_index, pass_type, org_no, index_in_pass, is_profile, code);
+			if (is_profile || (GetPassCategory(pass_type) != PC_ShadowMap))
+			{
+				continue;
+			}
+
+			auto const & light = *lights_[org_no];
+			Camera const * sm_camera = nullptr;
+			switch (light.Type())
+			{
+			case LightSource::LT_Spot:
+				if (0 == index_in_pass)
+				{
+					sm_camera = light.SMCamera(0).get();
+				}
+				break;
+
+			case LightSource::LT_Point:
+			case LightSource::LT_SphereArea:
+			case LightSource::LT_TubeArea:
+				if (index_in_pass < 6)
+				{
+					sm_camera = light.SMCamera(index_in_pass).get();
+				}
+				break;
+
+			default:
+				break;
+			}
 
+			if (sm_camera)
+			{
+				SceneManager::CullingView view;
+				view.camera = sm_camera;
+				view.cascade_index = -1;
+				views.push_back(view);
+			}
+		}
+
+		Context::Instance().SceneManagerInstance().CullViews(views.data(), static_cast<uint32_t>(views.size()));
+	}
+
+	void DeferredRenderingLayer::CheckLightVisible(uint32_t vp_index, uint32_t light_index)
+	{
 		PerViewport& pvp = viewports_[vp_index];
 		auto const & light = *lights_[light_index];
 
+		// Tested against the frustum of this viewport, the scene manager's one belongs to the last flushed camera
+		Frustum const & frustum = pvp.frame_buffer->GetViewport()->camera->ViewFrustum();
+
 		float light_scale = std::min(light.Range() * 0.01f, 1.0f) * light_scale_;
 		switch (light.Type())
 		{
@@ -2045,7 +2123,7 @@ namespace KlayGE
 				float const scale = light.CosOuterInner().w();
 				float4x4 mat = MathLib::scaling(scale * light_scale, scale * light_scale, light_scale);
 				float4x4 light_model = mat * inv_light_view;
-				pvp.light_visibles[light_index] = (scene_mgr.AABBVisible(MathLib::transform_aabb(cone_aabb_, light_model)) != BO_No);
+				pvp.light_visibles[light_index] = (frustum.Intersect(MathLib::transform_aabb(cone_aabb_, light_model)) != BO_No);
 			}
 			break;
 
@@ -2056,7 +2134,7 @@ namespace KlayGE
 				float3 const & p = light.Position();
 				float4x4 light_model = MathLib::scaling(light_scale, light_scale, light_scale)
 					* MathLib::translation(p);
-				pvp.light_visibles[light_index] = (scene_mgr.AABBVisible(MathLib::transform_aabb(box_aabb_, light_model)) != BO_No);
+				pvp.light_visibles[light_index] = (frustum.Intersect(MathLib::transform_aabb(box_aabb_, light_model)) != BO_No);
 			}
 			break;
 
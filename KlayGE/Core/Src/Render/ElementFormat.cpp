@@ -36,6 +36,467 @@
 
 #include <KFL/Math.hpp>
 #include <KFL/Half.hpp>
+#include <KFL/CpuInfo.hpp>
+
+#include <array>
+#include <cstring>
+
+#if defined(KLAYGE_SSE2_SUPPORT)
+	#include <emmintrin.h>
+	#include <immintrin.h>
+
+	#if defined(KLAYGE_COMPILER_GCC) || defined(KLAYGE_COMPILER_CLANG)
+		#define KLAYGE_F16C_FUNC __attribute__((target("f16c")))
+	#else
+		#define KLAYGE_F16C_FUNC
+	#endif
+#endif
+
+namespace
+{
+	using namespace KlayGE;
+
+	std::array<float, 256> const & SRGBToLinearTable()
+	{
+		static std::array<float, 256> const table = []
+			{
+				std::array<float, 256> ret;
+				for (size_t i = 0; i < ret.size(); ++ i)
+				{
+					ret[i] = MathLib::srgb_to_linear(i / 255.0f);
+				}
+				return ret;
+			}();
+		return table;
+	}
+
+#if defined(KLAYGE_SSE2_SUPPORT)
+	bool HasF16C()
+	{
+		static bool const f16c = CPUInfo().IsFeatureSupport(CPUInfo::CF_F16C);
+		return f16c;
+	}
+
+	// Converts 4 integers in [0, 255] per texel to floats. Divides instead of multiplying by the reciprocal, so the results
+	//  are the same as the scalar code.
+	__m128 UNorm8ToFloat(__m128i v)
+	{
+		return _mm_div_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(255.0f));
+	}
+
+	__m128i FloatToUNorm(__m128 v, float scale)
+	{
+		__m128 const s = _mm_set1_ps(scale);
+		v = _mm_add_ps(_mm_mul_ps(v, s), _mm_set1_ps(0.5f));
+		v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), s);
+		return _mm_cvttps_epi32(v);
+	}
+
+	// 4 texels of ABGR8 or ARGB8 per iteration
+	uint32_t BGRA8ToABGR32F(uint8_t const * input, uint32_t num_elems, Color* output, bool swap_rb)
+	{
+		__m128i const zero = _mm_setzero_si128();
+		uint32_t i = 0;
+		for (; i + 4 <= num_elems; i += 4, input += 16, output += 4)
+		{
+			__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(input));
+			__m128i const lo = _mm_unpacklo_epi8(v, zero);
+			__m128i const hi = _mm_unpackhi_epi8(v, zero);
+			__m128 c[4] =
+			{
+				UNorm8ToFloat(_mm_unpacklo_epi16(lo, zero)),
+				UNorm8ToFloat(_mm_unpackhi_epi16(lo, zero)),
+				UNorm8ToFloat(_mm_unpacklo_epi16(hi, zero)),
+				UNorm8ToFloat(_mm_unpackhi_epi16(hi, zero))
+			};
+			for (int j = 0; j < 4; ++ j)
+			{
+				if (swap_rb)
+				{
+					c[j] = _mm_shuffle_ps(c[j], c[j], _MM_SHUFFLE(3, 0, 1, 2));
+				}
+				_mm_storeu_ps(&output[j].r(), c[j]);
+			}
+		}
+		return i;
+	}
+
+	// 4 texels of R8 or GR8 per iteration. The channels are converted together, then paired with B = 0 and A = 1.
+	uint32_t R8ToABGR32F(uint8_t const * input, uint32_t num_elems, Color* output, uint32_t num_channels)
+	{
+		__m128i const zero = _mm_setzero_si128();
+		__m128 const zero_one = _mm_set_ps(1, 0, 1, 0);
+		uint32_t i = 0;
+		if (1 == num_channels)
+		{
+			for (; i + 4 <= num_elems; i += 4, input += 4, output += 4)
+			{
+				int packed;
+				std::memcpy(&packed, input, sizeof(packed));
+				__m128i const v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+				__m128 const r = UNorm8ToFloat(_mm_unpacklo_epi16(v, zero));
+				// R0 0 R1 0 and R2 0 R3 0
+				__m128 const r01 = _mm_unpacklo_ps(r, _mm_setzero_ps());
+				__m128 const r23 = _mm_unpackhi_ps(r, _mm_setzero_ps());
+				_mm_storeu_ps(&output[0].r(), _mm_movelh_ps(r01, zero_one));
+				_mm_storeu_ps(&output[1].r(), _mm_movehl_ps(zero_one, r01));
+				_mm_storeu_ps(&output[2].r(), _mm_movelh_ps(r23, zero_one));
+				_mm_storeu_ps(&output[3].r(), _mm_movehl_ps(zero_one, r23));
+			}
+		}
+		else
+		{
+			BOOST_ASSERT(2 == num_channels);
+			for (; i + 4 <= num_elems; i += 4, input += 8, output += 4)
+			{
+				__m128i const v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(input)), zero);
+				// R0 G0 R1 G1 and R2 G2 R3 G3
+				__m128 const rg01 = UNorm8ToFloat(_mm_unpacklo_epi16(v, zero));
+				__m128 const rg23 = UNorm8ToFloat(_mm_unpackhi_epi16(v, zero));
+				_mm_storeu_ps(&output[0].r(), _mm_movelh_ps(rg01, zero_one));
+				_mm_storeu_ps(&output[1].r(), _mm_movehl_ps(zero_one, rg01));
+				_mm_storeu_ps(&output[2].r(), _mm_movelh_ps(rg23, zero_one));
+				_mm_storeu_ps(&output[3].r(), _mm_movehl_ps(zero_one, rg23));
+			}
+		}
+		return i;
+	}
+
+	uint32_t A2BGR10ToABGR32F(uint8_t const * input, uint32_t num_elems, Color* output)
+	{
+		__m128i const mask = _mm_set1_epi32(0x3FF);
+		__m128 const max_10 = _mm_set1_ps(1023.0f);
+		uint32_t i = 0;
+		for (; i + 4 <= num_elems; i += 4, input += 16, output += 4)
+		{
+			__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(input));
+			__m128 r = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mask)), max_10);
+			__m128 g = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 10), mask)), max_10);
+			__m128 b = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 20), mask)), max_10);
+			__m128 a = _mm_div_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v, 30)), _mm_set1_ps(3.0f));
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+			_mm_storeu_ps(&output[0].r(), r);
+			_mm_storeu_ps(&output[1].r(), g);
+			_mm_storeu_ps(&output[2].r(), b);
+			_mm_storeu_ps(&output[3].r(), a);
+		}
+		return i;
+	}
+
+	// Expands 4 unsigned floats with 5 bits of exponent and mantissa_bits bits of mantissa
+	__m128 SmallFloatToFloat(__m128i v, int mantissa_bits)
+	{
+		__m128i const mantissa_mask = _mm_set1_epi32((1 << mantissa_bits) - 1);
+		__m128i const exp_mask = _mm_set1_epi32(0x1F << mantissa_bits);
+		__m128i const exp = _mm_and_si128(v, exp_mask);
+		__m128i const shift = _mm_cvtsi32_si128(23 - mantissa_bits);
+
+		// Normalized: rebias the exponent from 15 to 127
+		__m128i const normalized = _mm_add_epi32(_mm_sll_epi32(v, shift), _mm_set1_epi32(112 << 23));
+		// INF and NAN
+		__m128i const inf_nan = _mm_or_si128(_mm_set1_epi32(0x7F800000),
+			_mm_sll_epi32(_mm_and_si128(v, mantissa_mask), shift));
+		// Denormalized: mantissa * 2^(-14 - mantissa_bits)
+		__m128 const denormalized = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mantissa_mask)),
+			_mm_set1_ps(1.0f / (16384.0f * (1 << mantissa_bits))));
+
+		__m128i const is_inf_nan = _mm_cmpeq_epi32(exp, exp_mask);
+		__m128 const is_denormalized = _mm_castsi128_ps(_mm_cmpeq_epi32(exp, _mm_setzero_si128()));
+		__m128i const normal_or_inf = _mm_or_si128(_mm_and_si128(is_inf_nan, inf_nan),
+			_mm_andnot_si128(is_inf_nan, normalized));
+		return _mm_or_ps(_mm_and_ps(is_denormalized, denormalized),
+			_mm_andnot_ps(is_denormalized, _mm_castsi128_ps(normal_or_inf)));
+	}
+
+	uint32_t B10G11R11FToABGR32F(uint8_t const * input, uint32_t num_elems, Color* output)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= num_elems; i += 4, input += 16, output += 4)
+		{
+			__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(input));
+			__m128 r = SmallFloatToFloat(_mm_and_si128(v, _mm_set1_epi32(0x7FF)), 6);
+			__m128 g = SmallFloatToFloat(_mm_and_si128(_mm_srli_epi32(v, 11), _mm_set1_epi32(0x7FF)), 6);
+			__m128 b = SmallFloatToFloat(_mm_srli_epi32(v, 22), 5);
+			__m128 a = _mm_set1_ps(1.0f);
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+			_mm_storeu_ps(&output[0].r(), r);
+			_mm_storeu_ps(&output[1].r(), g);
+			_mm_storeu_ps(&output[2].r(), b);
+			_mm_storeu_ps(&output[3].r(), a);
+		}
+		return i;
+	}
+
+	KLAYGE_F16C_FUNC uint32_t Half4ToABGR32F(uint8_t const * input, uint32_t num_elems, Color* output, uint32_t num_channels)
+	{
+		__m128 const zero_one = _mm_set_ps(1, 0, 1, 0);
+		uint32_t i = 0;
+		switch (num_channels)
+		{
+		case 1:
+			for (; i + 4 <= num_elems; i += 4, input += 8, output += 4)
+			{
+				__m128 const v = _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(input)));
+				__m128 const zzzo = _mm_set_ps(1, 0, 0, 0);
+				_mm_storeu_ps(&output[0].r(), _mm_move_ss(zzzo, v));
+				_mm_storeu_ps(&output[1].r(), _mm_move_ss(zzzo, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+				_mm_storeu_ps(&output[2].r(), _mm_move_ss(zzzo, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+				_mm_storeu_ps(&output[3].r(), _mm_move_ss(zzzo, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+			}
+			break;
+
+		case 2:
+			for (; i + 2 <= num_elems; i += 2, input += 8, output += 2)
+			{
+				__m128 const v = _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(input)));
+				_mm_storeu_ps(&output[0].r(), _mm_shuffle_ps(v, zero_one, _MM_SHUFFLE(1, 0, 1, 0)));
+				_mm_storeu_ps(&output[1].r(), _mm_shuffle_ps(v, zero_one, _MM_SHUFFLE(1, 0, 3, 2)));
+			}
+			break;
+
+		default:
+			BOOST_ASSERT(4 == num_channels);
+			for (; i < num_elems; ++ i, input += 8, ++ output)
+			{
+				_mm_storeu_ps(&output->r(), _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(input))));
+			}
+			break;
+		}
+		return i;
+	}
+
+	// Returns the number of texels converted. The rest is left to the scalar code.
+	uint32_t ConvertToABGR32FSIMD(ElementFormat fmt, uint8_t const * input, uint32_t num_elems, Color* output)
+	{
+		switch (fmt)
+		{
+		case EF_ABGR8:
+			return BGRA8ToABGR32F(input, num_elems, output, false);
+
+		case EF_ARGB8:
+			return BGRA8ToABGR32F(input, num_elems, output, true);
+
+		case EF_R8:
+			return R8ToABGR32F(input, num_elems, output, 1);
+
+		case EF_GR8:
+			return R8ToABGR32F(input, num_elems, output, 2);
+
+		case EF_A2BGR10:
+			return A2BGR10ToABGR32F(input, num_elems, output);
+
+		case EF_B10G11R11F:
+			return B10G11R11FToABGR32F(input, num_elems, output);
+
+		case EF_R16F:
+			return HasF16C() ? Half4ToABGR32F(input, num_elems, output, 1) : 0;
+
+		case EF_GR16F:
+			return HasF16C() ? Half4ToABGR32F(input, num_elems, output, 2) : 0;
+
+		case EF_ABGR16F:
+			return HasF16C() ? Half4ToABGR32F(input, num_elems, output, 4) : 0;
+
+		default:
+			return 0;
+		}
+	}
+
+	uint32_t ABGR32FToBGRA8(Color const * input, uint32_t num_elems, uint8_t* output, bool swap_rb)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= num_elems; i += 4, input += 4, output += 16)
+		{
+			__m128i c[4];
+			for (int j = 0; j < 4; ++ j)
+			{
+				__m128 v = _mm_loadu_ps(&input[j].r());
+				if (swap_rb)
+				{
+					v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+				}
+				c[j] = FloatToUNorm(v, 255.0f);
+			}
+			__m128i const v = _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]), _mm_packs_epi32(c[2], c[3]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output), v);
+		}
+		return i;
+	}
+
+	uint32_t ABGR32FToR8(Color const * input, uint32_t num_elems, uint8_t* output)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= num_elems; i += 4, input += 4, output += 4)
+		{
+			__m128 r = _mm_loadu_ps(&input[0].r());
+			__m128 g = _mm_loadu_ps(&input[1].r());
+			__m128 b = _mm_loadu_ps(&input[2].r());
+			__m128 a = _mm_loadu_ps(&input[3].r());
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+			__m128i const v = FloatToUNorm(r, 255.0f);
+			__m128i const zero = _mm_setzero_si128();
+			int const packed = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(v, zero), zero));
+			std::memcpy(output, &packed, sizeof(packed));
+		}
+		return i;
+	}
+
+	uint32_t ABGR32FToGR8(Color const * input, uint32_t num_elems, uint8_t* output)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= num_elems; i += 4, input += 4, output += 8)
+		{
+			__m128i c[4];
+			for (int j = 0; j < 4; ++ j)
+			{
+				c[j] = FloatToUNorm(_mm_loadu_ps(&input[j].r()), 255.0f);
+			}
+			// RGBA RGBA in 16-bit, then RG RG of both texels in the low half
+			__m128i const c01 = _mm_shuffle_epi32(_mm_packs_epi32(c[0], c[1]), _MM_SHUFFLE(3, 1, 2, 0));
+			__m128i const c23 = _mm_shuffle_epi32(_mm_packs_epi32(c[2], c[3]), _MM_SHUFFLE(3, 1, 2, 0));
+			__m128i const v = _mm_packus_epi16(_mm_unpacklo_epi64(c01, c23), _mm_setzero_si128());
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(output), v);
+		}
+		return i;
+	}
+
+	uint32_t ABGR32FToA2BGR10(Color const * input, uint32_t num_elems, uint8_t* output)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= num_elems; i += 4, input += 4, output += 16)
+		{
+			__m128 r = _mm_loadu_ps(&input[0].r());
+			__m128 g = _mm_loadu_ps(&input[1].r());
+			__m128 b = _mm_loadu_ps(&input[2].r());
+			__m128 a = _mm_loadu_ps(&input[3].r());
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+			__m128i v = FloatToUNorm(r, 1023.0f);
+			v = _mm_or_si128(v, _mm_slli_epi32(FloatToUNorm(g, 1023.0f), 10));
+			v = _mm_or_si128(v, _mm_slli_epi32(FloatToUNorm(b, 1023.0f), 20));
+			v = _mm_or_si128(v, _mm_slli_epi32(FloatToUNorm(a, 3.0f), 30));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output), v);
+		}
+		return i;
+	}
+
+	// F16C rounds to nearest even, the scalar half rounds ties away from zero. They differ by 1 ulp on ties only.
+	KLAYGE_F16C_FUNC uint32_t ABGR32FToHalf4(Color const * input, uint32_t num_elems, uint8_t* output, uint32_t num_channels)
+	{
+		uint32_t i = 0;
+		switch (num_channels)
+		{
+		case 1:
+			for (; i + 4 <= num_elems; i += 4, input += 4, output += 8)
+			{
+				__m128 r = _mm_loadu_ps(&input[0].r());
+				__m128 g = _mm_loadu_ps(&input[1].r());
+				__m128 b = _mm_loadu_ps(&input[2].r());
+				__m128 a = _mm_loadu_ps(&input[3].r());
+				_MM_TRANSPOSE4_PS(r, g, b, a);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(output), _mm_cvtps_ph(r, _MM_FROUND_TO_NEAREST_INT));
+			}
+			break;
+
+		case 2:
+			for (; i + 2 <= num_elems; i += 2, input += 2, output += 8)
+			{
+				__m128 const v = _mm_movelh_ps(_mm_loadu_ps(&input[0].r()), _mm_loadu_ps(&input[1].r()));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(output), _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+			}
+			break;
+
+		default:
+			BOOST_ASSERT(4 == num_channels);
+			for (; i < num_elems; ++ i, ++ input, output += 8)
+			{
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(output),
+					_mm_cvtps_ph(_mm_loadu_ps(&input->r()), _MM_FROUND_TO_NEAREST_INT));
+			}
+			break;
+		}
+		return i;
+	}
+
+	uint32_t ConvertFromABGR32FSIMD(ElementFormat fmt, Color const * input, uint32_t num_elems, uint8_t* output)
+	{
+		switch (fmt)
+		{
+		case EF_ABGR8:
+			return ABGR32FToBGRA8(input, num_elems, output, false);
+
+		case EF_ARGB8:
+			return ABGR32FToBGRA8(input, num_elems, output, true);
+
+		case EF_R8:
+			return ABGR32FToR8(input, num_elems, output);
+
+		case EF_GR8:
+			return ABGR32FToGR8(input, num_elems, output);
+
+		case EF_A2BGR10:
+			return ABGR32FToA2BGR10(input, num_elems, output);
+
+		case EF_R16F:
+			return HasF16C() ? ABGR32FToHalf4(input, num_elems, output, 1) : 0;
+
+		case EF_GR16F:
+			return HasF16C() ? ABGR32FToHalf4(input, num_elems, output, 2) : 0;
+
+		case EF_ABGR16F:
+			return HasF16C() ? ABGR32FToHalf4(input, num_elems, output, 4) : 0;
+
+		default:
+			return 0;
+		}
+	}
+#endif
+
+	// Byte offsets of R, G, B and A in the 8-bit unorm formats that can be converted to each other without going through
+	//  floats. -1 means the channel doesn't exist.
+	bool UNorm8Layout(ElementFormat fmt, int (&offsets)[4], bool& srgb)
+	{
+		srgb = (EF_ABGR8_SRGB == fmt) || (EF_ARGB8_SRGB == fmt);
+		switch (fmt)
+		{
+		case EF_R8:
+			offsets[0] = 0;
+			offsets[1] = offsets[2] = offsets[3] = -1;
+			return true;
+
+		case EF_GR8:
+			offsets[0] = 0;
+			offsets[1] = 1;
+			offsets[2] = offsets[3] = -1;
+			return true;
+
+		case EF_BGR8:
+			offsets[0] = 0;
+			offsets[1] = 1;
+			offsets[2] = 2;
+			offsets[3] = -1;
+			return true;
+
+		case EF_ABGR8:
+		case EF_ABGR8_SRGB:
+			offsets[0] = 0;
+			offsets[1] = 1;
+			offsets[2] = 2;
+			offsets[3] = 3;
+			return true;
+
+		case EF_ARGB8:
+		case EF_ARGB8_SRGB:
+			offsets[0] = 2;
+			offsets[1] = 1;
+			offsets[2] = 0;
+			offsets[3] = 3;
+			return true;
+
+		default:
+			return false;
+		}
+	}
+}
 
 namespace KlayGE
 {
@@ -44,6 +505,13 @@ namespace KlayGE
 		uint8_t const * p = static_cast<uint8_t const *>(input);
 		uint32_t const elem_size = NumFormatBytes(fmt);
 
+#if defined(KLAYGE_SSE2_SUPPORT)
+		uint32_t const num_simd_elems = ConvertToABGR32FSIMD(fmt, p, num_elems, output);
+		p += num_simd_elems * elem_size;
+		output += num_simd_elems;
+		num_elems -= num_simd_elems;
+#endif
+
 		switch (fmt)
 		{
 		case EF_A8:
@@ -575,7 +1043,7 @@ namespace KlayGE
 
 					if (0x1F == exponent) // INF or NAN
 					{
-						result[0].i = 0x7F800000 | (mantissa << 17);
+						result[j].i = 0x7F800000 | (mantissa << 17);
 					}
 					else
 					{
@@ -609,12 +1077,12 @@ namespace KlayGE
 				}
 
 				// Z Channel (5-bit mantissa)
-				mantissa = (s >> 22) & 0x3F;
+				mantissa = (s >> 22) & 0x1F;
 				exponent = (s >> 27) & 0x1F;
 
 				if (0x1F == exponent) // INF or NAN
 				{
-					result[2].i = 0x7F800000 | (mantissa << 17);
+					result[2].i = 0x7F800000 | (mantissa << 18);
 				}
 				else
 				{
@@ -720,22 +1188,22 @@ namespace KlayGE
 
 
 		case EF_ARGB8_SRGB:
-			for (uint32_t i = 0; i < num_elems; ++ i, p += elem_size, ++ output)
 			{
-				*output = Color(MathLib::srgb_to_linear(p[2] / 255.0f),
-					MathLib::srgb_to_linear(p[1] / 255.0f),
-					MathLib::srgb_to_linear(p[0] / 255.0f),
-					MathLib::srgb_to_linear(p[3] / 255.0f));
+				std::array<float, 256> const & srgb_to_linear = SRGBToLinearTable();
+				for (uint32_t i = 0; i < num_elems; ++ i, p += elem_size, ++ output)
+				{
+					*output = Color(srgb_to_linear[p[2]], srgb_to_linear[p[1]], srgb_to_linear[p[0]], p[3] / 255.0f);
+				}
 			}
 			break;
 
 		case EF_ABGR8_SRGB:
-			for (uint32_t i = 0; i < num_elems; ++ i, p += elem_size, ++ output)
 			{
-				*output = Color(MathLib::srgb_to_linear(p[0] / 255.0f),
-					MathLib::srgb_to_linear(p[1] / 255.0f),
-					MathLib::srgb_to_linear(p[2] / 255.0f),
-					MathLib::srgb_to_linear(p[3] / 255.0f));
+				std::array<float, 256> const & srgb_to_linear = SRGBToLinearTable();
+				for (uint32_t i = 0; i < num_elems; ++ i, p += elem_size, ++ output)
+				{
+					*output = Color(srgb_to_linear[p[0]], srgb_to_linear[p[1]], srgb_to_linear[p[2]], p[3] / 255.0f);
+				}
 			}
 			break;
 
@@ -750,6 +1218,13 @@ namespace KlayGE
 		uint8_t* p = static_cast<uint8_t*>(output);
 		uint32_t const elem_size = NumFormatBytes(fmt);
 
+#if defined(KLAYGE_SSE2_SUPPORT)
+		uint32_t const num_simd_elems = ConvertFromABGR32FSIMD(fmt, input, num_elems, p);
+		p += num_simd_elems * elem_size;
+		input += num_simd_elems;
+		num_elems -= num_simd_elems;
+#endif
+
 		switch (fmt)
 		{
 		case EF_A8:
@@ -1517,7 +1992,7 @@ namespace KlayGE
 				p[0] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->b()) * 255.0f + 0.5f), 0, 255));
 				p[1] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->g()) * 255.0f + 0.5f), 0, 255));
 				p[2] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->r()) * 255.0f + 0.5f), 0, 255));
-				p[3] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->a()) * 255.0f + 0.5f), 0, 255));
+				p[3] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(input->a() * 255.0f + 0.5f), 0, 255));
 			}
 			break;
 
@@ -1527,7 +2002,7 @@ namespace KlayGE
 				p[0] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->r()) * 255.0f + 0.5f), 0, 255));
 				p[1] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->g()) * 255.0f + 0.5f), 0, 255));
 				p[2] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->b()) * 255.0f + 0.5f), 0, 255));
-				p[3] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(MathLib::linear_to_srgb(input->a()) * 255.0f + 0.5f), 0, 255));
+				p[3] = static_cast<uint8_t>(MathLib::clamp(static_cast<int>(input->a() * 255.0f + 0.5f), 0, 255));
 			}
 			break;
 
@@ -1536,4 +2011,71 @@ namespace KlayGE
 			break;
 		}
 	}
+
+	void ConvertFormat(ElementFormat src_fmt, void const * input, uint32_t num_elems, ElementFormat dst_fmt, void* output)
+	{
+		if (src_fmt == dst_fmt)
+		{
+			std::memcpy(output, input, num_elems * NumFormatBytes(src_fmt));
+			return;
+		}
+
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+		uint8_t* dst = static_cast<uint8_t*>(output);
+
+		int src_offsets[4];
+		int dst_offsets[4];
+		bool src_srgb;
+		bool dst_srgb;
+		if (UNorm8Layout(src_fmt, src_offsets, src_srgb) && UNorm8Layout(dst_fmt, dst_offsets, dst_srgb)
+			&& (src_srgb == dst_srgb))
+		{
+			uint32_t const src_elem_size = NumFormatBytes(src_fmt);
+			uint32_t const dst_elem_size = NumFormatBytes(dst_fmt);
+
+			uint32_t i = 0;
+#if defined(KLAYGE_SSE2_SUPPORT)
+			if ((4 == src_elem_size) && (4 == dst_elem_size))
+			{
+				// Only ABGR8 <-> ARGB8 gets here, swaps R and B
+				__m128i const ga_mask = _mm_set1_epi32(0xFF00FF00);
+				__m128i const low_mask = _mm_set1_epi32(0xFF);
+				for (; i + 4 <= num_elems; i += 4, src += 16, dst += 16)
+				{
+					__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+					__m128i const rb = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 16), low_mask),
+						_mm_slli_epi32(_mm_and_si128(v, low_mask), 16));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(_mm_and_si128(v, ga_mask), rb));
+				}
+			}
+#endif
+
+			uint8_t const fill[] = { 0, 0, 0, 255 };
+			for (; i < num_elems; ++ i, src += src_elem_size, dst += dst_elem_size)
+			{
+				for (int c = 0; c < 4; ++ c)
+				{
+					if (dst_offsets[c] >= 0)
+					{
+						dst[dst_offsets[c]] = (src_offsets[c] >= 0) ? src[src_offsets[c]] : fill[c];
+					}
+				}
+			}
+		}
+		else
+		{
+			uint32_t const src_elem_size = NumFormatBytes(src_fmt);
+			uint32_t const dst_elem_size = NumFormatBytes(dst_fmt);
+
+			// Goes through floats in pieces that stay in the cache
+			std::array<Color, 256> colors;
+			uint32_t const num_colors = static_cast<uint32_t>(colors.size());
+			for (uint32_t i = 0; i < num_elems; i += num_colors)
+			{
+				uint32_t const n = std::min(num_elems - i, num_colors);
+				ConvertToABGR32F(src_fmt, src + i * src_elem_size, n, colors.data());
+				ConvertFromABGR32F(dst_fmt, colors.data(), n, dst + i * dst_elem_size);
+			}
+		}
+	}
 }
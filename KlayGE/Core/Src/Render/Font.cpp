@@ -98,11 +98,11 @@ namespace KlayGE
 			char_free_list_.emplace_back(0, size * size / kfont_char_size / kfont_char_size);
 
 			effect_ = SyncLoadRenderEffect("Font.fxml");
-			*(effect_->ParameterByName("distance_tex")) = dist_texture_;
-			*(effect_->ParameterByName("distance_base_scale")) = float2(kfont_loader_->DistBase() / 32768.0f * 32 + 1, (kfont_loader_->DistScale() / 32768.0f + 1.0f) * 32);
+			*(effect_->ParameterByName(CT_HASH("distance_tex"))) = dist_texture_;
+			*(effect_->ParameterByName(CT_HASH("distance_base_scale"))) = float2(kfont_loader_->DistBase() / 32768.0f * 32 + 1, (kfont_loader_->DistScale() / 32768.0f + 1.0f) * 32);
 
-			half_width_height_ep_ = effect_->ParameterByName("half_width_height");
-			mvp_ep_ = effect_->ParameterByName("mvp");
+			half_width_height_ep_ = effect_->ParameterByName(CT_HASH("half_width_height"));
+			mvp_ep_ = effect_->ParameterByName(CT_HASH("mvp"));
 
 			uint32_t const INDEX_PER_CHAR = restart_ ? 5 : 6;
 			uint32_t const INIT_NUM_CHAR = 1024;
@@ -122,11 +122,11 @@ namespace KlayGE
 		{
 			if (three_dim_)
 			{
-				return effect_->TechniqueByName("Font3DTec");
+				return effect_->TechniqueByName(CT_HASH("Font3DTec"));
 			}
 			else
 			{
-				return effect_->TechniqueByName("Font2DTec");
+				return effect_->TechniqueByName(CT_HASH("Font2DTec"));
 			}
 		}
 
@@ -778,6 +778,14 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, font_desc_.res_name.begin(), font_desc_.res_name.end());
+			HashCombine(seed, font_desc_.flag);
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const
 		{
 			if (this->Type() == rhs.Type())
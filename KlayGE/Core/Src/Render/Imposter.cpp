@@ -120,6 +120,13 @@ namespace KlayGE
 			return true;
 		}
 
+		size_t Hash() const
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, imposter_desc_.res_name.begin(), imposter_desc_.res_name.end());
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const
 		{
 			if (this->Type() == rhs.Type())
@@ -20,6 +20,7 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include <KlayGE/KlayGE.hpp>
+#include <KFL/ThrowErr.hpp>
 #include <KFL/Math.hpp>
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
@@ -33,11 +34,13 @@
 #include <KlayGE/Light.hpp>
 #include <KlayGE/RenderMaterial.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/TaskScheduler.hpp>
 
 #include <algorithm>
 #include <fstream>
-#include <sstream>
 #include <cstring>
+#include <limits>
+#include <mutex>
 
 #include <MeshMLLib/MeshMLLib.hpp>
 
@@ -47,7 +50,158 @@ namespace
 {
 	using namespace KlayGE;
 
-	uint32_t const MODEL_BIN_VERSION = 13;
+	uint32_t const MODEL_BIN_VERSION = 14;
+
+	uint32_t const MODEL_BIN_CHUNK_COMPRESSED = 1UL << 0;
+
+	// An entry in the chunk table of a .model_bin. Chunks are compressed independently, so they can be decoded in
+	//  parallel, or skipped until they're needed.
+	struct ModelBinChunk
+	{
+		uint32_t id;
+		uint32_t flags;
+		uint64_t offset;
+		uint64_t original_len;
+		uint64_t len;
+	};
+
+	// Returns the stored bytes of a chunk. A memory backed file is referenced in place.
+	uint8_t const * ReadModelBinChunk(ResIdentifierPtr const & res, ModelBinChunk const & chunk, std::vector<uint8_t>& buff)
+	{
+		res->seekg(static_cast<int64_t>(chunk.offset), std::ios_base::beg);
+		void const * in_place = res->read_in_place(static_cast<size_t>(chunk.len));
+		if (in_place)
+		{
+			return static_cast<uint8_t const *>(in_place);
+		}
+
+		buff.resize(static_cast<size_t>(chunk.len));
+		res->seekg(static_cast<int64_t>(chunk.offset), std::ios_base::beg);
+		res->read(buff.data(), buff.size());
+		return buff.data();
+	}
+
+	// A corrupt chunk table would make the loader read past the end of the file, or allocate a huge buffer
+	void CheckModelBinChunk(ModelBinChunk const & chunk, uint64_t file_size)
+	{
+		if ((chunk.offset > file_size) || (chunk.len > file_size - chunk.offset)
+			|| (chunk.original_len > std::numeric_limits<size_t>::max())
+			|| (!(chunk.flags & MODEL_BIN_CHUNK_COMPRESSED) && (chunk.original_len > chunk.len)))
+		{
+			THR(std::errc::illegal_byte_sequence);
+		}
+	}
+
+	void DecodeModelBinChunk(ModelBinChunk const & chunk, uint8_t const * input, void* output)
+	{
+		if (chunk.original_len == 0)
+		{
+			return;
+		}
+
+		if (chunk.flags & MODEL_BIN_CHUNK_COMPRESSED)
+		{
+			LZMACodec lzma;
+			lzma.Decode(output, input, chunk.len, chunk.original_len);
+		}
+		else
+		{
+			std::memcpy(output, input, static_cast<size_t>(chunk.original_len));
+		}
+	}
+
+	std::shared_ptr<KeyFramesType> ReadKeyFrames(ResIdentifierPtr const & decoded, uint32_t num_kfs, uint32_t num_joints)
+	{
+		auto kfs = MakeSharedPtr<KeyFramesType>(num_joints);
+		for (uint32_t kf_index = 0; kf_index < num_kfs; ++ kf_index)
+		{
+			uint32_t joint_index = kf_index;
+
+			uint32_t num_kf;
+			decoded->read(&num_kf, sizeof(num_kf));
+			num_kf = LE2Native(num_kf);
+
+			KeyFrames kf;
+			kf.frame_id.resize(num_kf);
+			kf.bind_real.resize(num_kf);
+			kf.bind_dual.resize(num_kf);
+			kf.bind_scale.resize(num_kf);
+			for (uint32_t k_index = 0; k_index < num_kf; ++ k_index)
+			{
+				decoded->read(&kf.frame_id[k_index], sizeof(kf.frame_id[k_index]));
+				kf.frame_id[k_index] = LE2Native(kf.frame_id[k_index]);
+				decoded->read(&kf.bind_real[k_index], sizeof(kf.bind_real[k_index]));
+				kf.bind_real[k_index][0] = LE2Native(kf.bind_real[k_index][0]);
+				kf.bind_real[k_index][1] = LE2Native(kf.bind_real[k_index][1]);
+				kf.bind_real[k_index][2] = LE2Native(kf.bind_real[k_index][2]);
+				kf.bind_real[k_index][3] = LE2Native(kf.bind_real[k_index][3]);
+				decoded->read(&kf.bind_dual[k_index], sizeof(kf.bind_dual[k_index]));
+				kf.bind_dual[k_index][0] = LE2Native(kf.bind_dual[k_index][0]);
+				kf.bind_dual[k_index][1] = LE2Native(kf.bind_dual[k_index][1]);
+				kf.bind_dual[k_index][2] = LE2Native(kf.bind_dual[k_index][2]);
+				kf.bind_dual[k_index][3] = LE2Native(kf.bind_dual[k_index][3]);
+
+				float flip = MathLib::sgn(kf.bind_real[k_index].w());
+
+				kf.bind_scale[k_index] = MathLib::length(kf.bind_real[k_index]);
+				kf.bind_real[k_index] /= kf.bind_scale[k_index];
+
+				kf.bind_scale[k_index] *= flip;
+			}
+
+			if (joint_index < num_joints)
+			{
+				(*kfs)[joint_index] = kf;
+			}
+		}
+
+		return kfs;
+	}
+
+	// Decodes the key frame chunk on the first call. Copies share the decoded key frames, so clones of a model don't
+	//  decode the chunk again.
+	class KeyFramesChunkLoader
+	{
+	public:
+		KeyFramesChunkLoader(ResIdentifierPtr const & res, ModelBinChunk const & chunk, uint32_t num_kfs, uint32_t num_joints)
+			: state_(MakeSharedPtr<State>())
+		{
+			state_->res = res;
+			state_->chunk = chunk;
+			state_->num_kfs = num_kfs;
+			state_->num_joints = num_joints;
+		}
+
+		std::shared_ptr<KeyFramesType> operator()() const
+		{
+			std::lock_guard<std::mutex> lock(state_->mutex);
+			if (!state_->kfs)
+			{
+				std::vector<uint8_t> buff;
+				uint8_t const * input = ReadModelBinChunk(state_->res, state_->chunk, buff);
+				auto decoded_data = MakeSharedPtr<std::vector<uint8_t>>(static_cast<size_t>(state_->chunk.original_len));
+				DecodeModelBinChunk(state_->chunk, input, decoded_data->data());
+
+				ResIdentifierPtr decoded = MakeSharedPtr<ResIdentifier>(state_->res->ResName(), state_->res->Timestamp(),
+					decoded_data->data(), decoded_data->size(), decoded_data);
+				state_->kfs = ReadKeyFrames(decoded, state_->num_kfs, state_->num_joints);
+				state_->res.reset();
+			}
+			return state_->kfs;
+		}
+
+	private:
+		struct State
+		{
+			std::mutex mutex;
+			ResIdentifierPtr res;
+			ModelBinChunk chunk;
+			uint32_t num_kfs;
+			uint32_t num_joints;
+			std::shared_ptr<KeyFramesType> kfs;
+		};
+		std::shared_ptr<State> state_;
+	};
 
 	class RenderModelLoadingDesc : public ResLoadingDesc
 	{
@@ -78,7 +232,7 @@ namespace
 				std::vector<uint32_t> mesh_start_indices;
 				std::vector<Joint> joints;
 				std::shared_ptr<AnimationActionsType> actions;
-				std::shared_ptr<KeyFramesType> kfs;
+				std::function<std::shared_ptr<KeyFramesType>()> kfs_loader;
 				uint32_t num_frames;
 				uint32_t frame_rate;
 				std::vector<std::shared_ptr<AABBKeyFrames>> frame_pos_bbs;
@@ -128,7 +282,7 @@ namespace
 				model_desc_.model_data->pos_bbs, model_desc_.model_data->tc_bbs,
 				model_desc_.model_data->mesh_num_vertices, model_desc_.model_data->mesh_base_vertices,
 				model_desc_.model_data->mesh_num_indices, model_desc_.model_data->mesh_start_indices, 
-				model_desc_.model_data->joints, model_desc_.model_data->actions, model_desc_.model_data->kfs,
+				model_desc_.model_data->joints, model_desc_.model_data->actions, model_desc_.model_data->kfs_loader,
 				model_desc_.model_data->num_frames, model_desc_.model_data->frame_rate,
 				model_desc_.model_data->frame_pos_bbs);
 
@@ -173,6 +327,14 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, model_desc_.res_name.begin(), model_desc_.res_name.end());
+			HashCombine(seed, model_desc_.access_hint);
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const
 		{
 			if (this->Type() == rhs.Type())
@@ -250,7 +412,14 @@ namespace
 						joints[i] = rhs_skinned_model->GetJoint(i);
 					}
 					skinned_model->AssignJoints(joints.begin(), joints.end());
-					skinned_model->AttachKeyFrames(rhs_skinned_model->GetKeyFrames());
+					if (rhs_skinned_model->GetKeyFramesLoader())
+					{
+						skinned_model->AttachKeyFramesLoader(rhs_skinned_model->GetKeyFramesLoader());
+					}
+					else
+					{
+						skinned_model->AttachKeyFrames(rhs_skinned_model->GetKeyFrames());
+					}
 
 					skinned_model->NumFrames(rhs_skinned_model->NumFrames());
 					skinned_model->FrameRate(rhs_skinned_model->FrameRate());
@@ -329,14 +498,14 @@ namespace
 				mesh->StartIndexLocation(model_desc_.model_data->mesh_start_indices[mesh_index]);
 			}
 
-			if (model_desc_.model_data->kfs && !model_desc_.model_data->kfs->empty())
+			if (model_desc_.model_data->kfs_loader)
 			{
 				if (!model_desc_.model_data->joints.empty())
 				{
 					SkinnedModelPtr skinned_model = checked_pointer_cast<SkinnedModel>(model);
 
 					skinned_model->AssignJoints(model_desc_.model_data->joints.begin(), model_desc_.model_data->joints.end());
-					skinned_model->AttachKeyFrames(model_desc_.model_data->kfs);
+					skinned_model->AttachKeyFramesLoader(model_desc_.model_data->kfs_loader);
 
 					skinned_model->NumFrames(model_desc_.model_data->num_frames);
 					skinned_model->FrameRate(model_desc_.model_data->frame_rate);
@@ -652,12 +821,22 @@ namespace KlayGE
 	{
 	}
 	
+	std::shared_ptr<KeyFramesType> const & SkinnedModel::GetKeyFrames()
+	{
+		if (!key_frames_ && key_frames_loader_)
+		{
+			key_frames_ = key_frames_loader_();
+		}
+		return key_frames_;
+	}
+	
 	void SkinnedModel::BuildBones(float frame)
 	{
+		KeyFramesType const & key_frames = *this->GetKeyFrames();
 		for (size_t i = 0; i < joints_.size(); ++ i)
 		{
 			Joint& joint = joints_[i];
-			KeyFrames const & kf = (*key_frames_)[i];
+			KeyFrames const & kf = key_frames[i];
 
 			std::pair<std::pair<Quaternion, Quaternion>, float> key_dq = kf.Frame(frame);
 
@@ -979,7 +1158,7 @@ namespace KlayGE
 		std::vector<uint32_t>& mesh_num_vertices, std::vector<uint32_t>& mesh_base_vertices,
 		std::vector<uint32_t>& mesh_num_indices, std::vector<uint32_t>& mesh_base_indices,
 		std::vector<Joint>& joints, std::shared_ptr<AnimationActionsType>& actions,
-		std::shared_ptr<KeyFramesType>& kfs, uint32_t& num_frames, uint32_t& frame_rate,
+		std::function<std::shared_ptr<KeyFramesType>()>& kfs_loader, uint32_t& num_frames, uint32_t& frame_rate,
 		std::vector<std::shared_ptr<AABBKeyFrames>>& frame_pos_bbs)
 	{
 		ResIdentifierPtr lzma_file;
@@ -1019,177 +1198,212 @@ namespace KlayGE
 		ver = LE2Native(ver);
 		BOOST_ASSERT(MODEL_BIN_VERSION == ver);
 
-		std::shared_ptr<std::stringstream> ss = MakeSharedPtr<std::stringstream>();
-
-		uint64_t original_len, len;
-		lzma_file->read(&original_len, sizeof(original_len));
-		original_len = LE2Native(original_len);
-		lzma_file->read(&len, sizeof(len));
-		len = LE2Native(len);
-
-		LZMACodec lzma;
-		lzma.Decode(*ss, lzma_file, len, original_len);
-
-		ResIdentifierPtr decoded = MakeSharedPtr<ResIdentifier>(lzma_file->ResName(), lzma_file->Timestamp(), ss);
-
 		uint32_t num_mtls;
-		decoded->read(&num_mtls, sizeof(num_mtls));
+		lzma_file->read(&num_mtls, sizeof(num_mtls));
 		num_mtls = LE2Native(num_mtls);
 		uint32_t num_meshes;
-		decoded->read(&num_meshes, sizeof(num_meshes));
+		lzma_file->read(&num_meshes, sizeof(num_meshes));
 		num_meshes = LE2Native(num_meshes);
 		uint32_t num_joints;
-		decoded->read(&num_joints, sizeof(num_joints));
+		lzma_file->read(&num_joints, sizeof(num_joints));
 		num_joints = LE2Native(num_joints);
 		uint32_t num_kfs;
-		decoded->read(&num_kfs, sizeof(num_kfs));
+		lzma_file->read(&num_kfs, sizeof(num_kfs));
 		num_kfs = LE2Native(num_kfs);
 		uint32_t num_actions;
-		decoded->read(&num_actions, sizeof(num_actions));
+		lzma_file->read(&num_actions, sizeof(num_actions));
 		num_actions = LE2Native(num_actions);
+		lzma_file->read(&num_frames, sizeof(num_frames));
+		num_frames = LE2Native(num_frames);
+		lzma_file->read(&frame_rate, sizeof(frame_rate));
+		frame_rate = LE2Native(frame_rate);
 
-		mtls.resize(num_mtls);
-		for (uint32_t mtl_index = 0; mtl_index < num_mtls; ++ mtl_index)
-		{
-			RenderMaterialPtr mtl = MakeSharedPtr<RenderMaterial>();
-			mtls[mtl_index] = mtl;
-
-			mtl->name = ReadShortString(decoded);
-
-			decoded->read(&mtl->albedo, sizeof(mtl->albedo));
-			mtl->albedo.x() = LE2Native(mtl->albedo.x());
-			mtl->albedo.y() = LE2Native(mtl->albedo.y());
-			mtl->albedo.z() = LE2Native(mtl->albedo.z());
-			mtl->albedo.w() = LE2Native(mtl->albedo.w());
+		uint32_t num_chunks;
+		lzma_file->read(&num_chunks, sizeof(num_chunks));
+		num_chunks = LE2Native(num_chunks);
 
-			decoded->read(&mtl->metalness, sizeof(float));
-			mtl->metalness = LE2Native(mtl->metalness);
-
-			decoded->read(&mtl->glossiness, sizeof(float));
-			mtl->glossiness = LE2Native(mtl->glossiness);
-
-			decoded->read(&mtl->emissive, sizeof(mtl->emissive));
-			mtl->emissive.x() = LE2Native(mtl->emissive.x());
-			mtl->emissive.y() = LE2Native(mtl->emissive.y());
-			mtl->emissive.z() = LE2Native(mtl->emissive.z());
-
-			uint8_t transparent;
-			decoded->read(&transparent, sizeof(transparent));
-			mtl->transparent = transparent ? true : false;
+		int64_t const table_pos = lzma_file->tellg();
+		lzma_file->seekg(0, std::ios_base::end);
+		int64_t const file_size = lzma_file->tellg();
+		lzma_file->seekg(table_pos, std::ios_base::beg);
+		if (!*lzma_file || (table_pos < 0) || (file_size < table_pos)
+			|| (num_chunks > static_cast<uint64_t>(file_size - table_pos) / (sizeof(uint32_t) * 2 + sizeof(uint64_t) * 3)))
+		{
+			THR(std::errc::illegal_byte_sequence);
+		}
 
-			uint8_t alpha_test;
-			decoded->read(&alpha_test, sizeof(uint8_t));
-			mtl->alpha_test = alpha_test / 255.0f;
+		std::vector<ModelBinChunk> chunks(num_chunks);
+		for (auto& chunk : chunks)
+		{
+			lzma_file->read(&chunk.id, sizeof(chunk.id));
+			chunk.id = LE2Native(chunk.id);
+			lzma_file->read(&chunk.flags, sizeof(chunk.flags));
+			chunk.flags = LE2Native(chunk.flags);
+			lzma_file->read(&chunk.offset, sizeof(chunk.offset));
+			chunk.offset = LE2Native(chunk.offset);
+			lzma_file->read(&chunk.original_len, sizeof(chunk.original_len));
+			chunk.original_len = LE2Native(chunk.original_len);
+			lzma_file->read(&chunk.len, sizeof(chunk.len));
+			chunk.len = LE2Native(chunk.len);
 
-			uint8_t sss;
-			decoded->read(&sss, sizeof(sss));
-			mtl->sss = sss ? true : false;
+			CheckModelBinChunk(chunk, static_cast<uint64_t>(file_size));
+		}
 
-			for (size_t i = 0; i < RenderMaterial::TS_NumTextureSlots; ++ i)
+		// Vertex streams and indices are decoded straight into the buffers for uploading. The other chunks are decoded
+		//  into memory and parsed afterwards. Key frames are left to kfs_loader.
+		uint32_t num_vertex_streams = 0;
+		for (auto const & chunk : chunks)
+		{
+			if (chunk.id == MakeFourCC<'V', 'T', 'X', 'S'>::value)
 			{
-				mtl->tex_names[i] = ReadShortString(decoded);
+				++ num_vertex_streams;
 			}
-			if (!mtl->tex_names[RenderMaterial::TS_Height].empty())
+		}
+		merged_buff.resize(num_vertex_streams);
+
+		std::vector<std::shared_ptr<std::vector<uint8_t>>> decoded_data(chunks.size());
+		std::vector<void*> outputs(chunks.size(), nullptr);
+		int32_t kf_chunk_index = -1;
+		uint32_t vertex_stream_index = 0;
+		for (size_t i = 0; i < chunks.size(); ++ i)
+		{
+			size_t const original_len = static_cast<size_t>(chunks[i].original_len);
+			switch (chunks[i].id)
 			{
-				float height_offset;
-				decoded->read(&height_offset, sizeof(height_offset));
-				mtl->height_offset_scale.x() = LE2Native(height_offset);
-				float height_scale;
-				decoded->read(&height_scale, sizeof(height_scale));
-				mtl->height_offset_scale.y() = LE2Native(height_scale);
+			case MakeFourCC<'V', 'T', 'X', 'S'>::value:
+				merged_buff[vertex_stream_index].resize(original_len);
+				outputs[i] = merged_buff[vertex_stream_index].data();
+				++ vertex_stream_index;
+				break;
+
+			case MakeFourCC<'I', 'N', 'D', 'X'>::value:
+				merged_indices.resize(original_len);
+				outputs[i] = merged_indices.data();
+				break;
+
+			case MakeFourCC<'K', 'E', 'Y', 'F'>::value:
+				kf_chunk_index = static_cast<int32_t>(i);
+				break;
+
+			default:
+				decoded_data[i] = MakeSharedPtr<std::vector<uint8_t>>(original_len);
+				outputs[i] = decoded_data[i]->data();
+				break;
 			}
+		}
 
-			uint8_t detail_mode;
-			decoded->read(&detail_mode, sizeof(detail_mode));
-			mtl->detail_mode = static_cast<RenderMaterial::SurfaceDetailMode>(detail_mode);
-			if (mtl->detail_mode != RenderMaterial::SDM_Parallax)
+		{
+			std::vector<std::vector<uint8_t>> raw_buffs(chunks.size());
+			std::vector<uint8_t const *> raw_data(chunks.size(), nullptr);
+			for (size_t i = 0; i < chunks.size(); ++ i)
 			{
-				float tess_factor;
-				decoded->read(&tess_factor, sizeof(tess_factor));
-				mtl->tess_factors.x() = LE2Native(tess_factor);
-				decoded->read(&tess_factor, sizeof(tess_factor));
-				mtl->tess_factors.y() = LE2Native(tess_factor);
-				decoded->read(&tess_factor, sizeof(tess_factor));
-				mtl->tess_factors.z() = LE2Native(tess_factor);
-				decoded->read(&tess_factor, sizeof(tess_factor));
-				mtl->tess_factors.w() = LE2Native(tess_factor);
+				if (outputs[i] != nullptr)
+				{
+					raw_data[i] = ReadModelBinChunk(lzma_file, chunks[i], raw_buffs[i]);
+				}
 			}
-			else
+
+			Context::Instance().TaskScheduler().parallel_for(0, num_chunks, 1,
+				[&chunks, &raw_data, &outputs](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; ++ i)
+					{
+						if (outputs[i] != nullptr)
+						{
+							DecodeModelBinChunk(chunks[i], raw_data[i], outputs[i]);
+						}
+					}
+				});
+		}
+
+		auto chunk_res = [&lzma_file, &chunks, &decoded_data](uint32_t id)
+		{
+			for (size_t i = 0; i < chunks.size(); ++ i)
 			{
-				mtl->tess_factors = float4(5, 5, 1, 9);
+				if (chunks[i].id == id)
+				{
+					return MakeSharedPtr<ResIdentifier>(lzma_file->ResName(), lzma_file->Timestamp(),
+						decoded_data[i]->data(), decoded_data[i]->size(), decoded_data[i]);
+				}
 			}
-		}
+			return ResIdentifierPtr();
+		};
 
-		uint32_t num_merged_ves;
-		decoded->read(&num_merged_ves, sizeof(num_merged_ves));
-		num_merged_ves = LE2Native(num_merged_ves);
-		merged_ves.resize(num_merged_ves);
-		for (size_t i = 0; i < merged_ves.size(); ++ i)
+		mtls.resize(num_mtls);
+		if (num_mtls > 0)
 		{
-			decoded->read(&merged_ves[i], sizeof(merged_ves[i]));
+			ResIdentifierPtr decoded = chunk_res(MakeFourCC<'M', 'T', 'L', 'S'>::value);
+			for (uint32_t mtl_index = 0; mtl_index < num_mtls; ++ mtl_index)
+			{
+				RenderMaterialPtr mtl = MakeSharedPtr<RenderMaterial>();
+				mtls[mtl_index] = mtl;
 
-			merged_ves[i].usage = LE2Native(merged_ves[i].usage);
-			merged_ves[i].format = LE2Native(merged_ves[i].format);
-		}
+				mtl->name = ReadShortString(decoded);
 
-		uint32_t all_num_vertices;
-		uint32_t all_num_indices;
-		decoded->read(&all_num_vertices, sizeof(all_num_vertices));
-		all_num_vertices = LE2Native(all_num_vertices);
-		decoded->read(&all_num_indices, sizeof(all_num_indices));
-		all_num_indices = LE2Native(all_num_indices);
-		decoded->read(&all_is_index_16_bit, sizeof(all_is_index_16_bit));
+				decoded->read(&mtl->albedo, sizeof(mtl->albedo));
+				mtl->albedo.x() = LE2Native(mtl->albedo.x());
+				mtl->albedo.y() = LE2Native(mtl->albedo.y());
+				mtl->albedo.z() = LE2Native(mtl->albedo.z());
+				mtl->albedo.w() = LE2Native(mtl->albedo.w());
 
-		int const index_elem_size = all_is_index_16_bit ? 2 : 4;
+				decoded->read(&mtl->metalness, sizeof(float));
+				mtl->metalness = LE2Native(mtl->metalness);
 
-		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
-		merged_buff.resize(merged_ves.size());
-		for (size_t i = 0; i < merged_buff.size(); ++ i)
-		{
-			merged_buff[i].resize(all_num_vertices * merged_ves[i].element_size());
-			decoded->read(&merged_buff[i][0], merged_buff[i].size() * sizeof(merged_buff[i][0]));
+				decoded->read(&mtl->glossiness, sizeof(float));
+				mtl->glossiness = LE2Native(mtl->glossiness);
 
-			if ((EF_A2BGR10 == merged_ves[i].format) && !rf.RenderEngineInstance().DeviceCaps().vertex_format_support(EF_A2BGR10))
-			{
-				merged_ves[i].format = EF_ARGB8;
+				decoded->read(&mtl->emissive, sizeof(mtl->emissive));
+				mtl->emissive.x() = LE2Native(mtl->emissive.x());
+				mtl->emissive.y() = LE2Native(mtl->emissive.y());
+				mtl->emissive.z() = LE2Native(mtl->emissive.z());
+
+				uint8_t transparent;
+				decoded->read(&transparent, sizeof(transparent));
+				mtl->transparent = transparent ? true : false;
 
-				uint32_t* p = reinterpret_cast<uint32_t*>(&merged_buff[i][0]);
-				for (uint32_t j = 0; j < all_num_vertices; ++ j)
+				uint8_t alpha_test;
+				decoded->read(&alpha_test, sizeof(uint8_t));
+				mtl->alpha_test = alpha_test / 255.0f;
+
+				uint8_t sss;
+				decoded->read(&sss, sizeof(sss));
+				mtl->sss = sss ? true : false;
+
+				for (size_t i = 0; i < RenderMaterial::TS_NumTextureSlots; ++ i)
 				{
-					float x = ((p[j] >>  0) & 0x3FF) / 1023.0f;
-					float y = ((p[j] >> 10) & 0x3FF) / 1023.0f;
-					float z = ((p[j] >> 20) & 0x3FF) / 1023.0f;
-					float w = ((p[j] >> 30) & 0x3) / 3.0f;
-
-					p[j] = (MathLib::clamp<uint32_t>(static_cast<uint32_t>(x * 255), 0, 255) << 16)
-						| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(y * 255), 0, 255) << 8)
-						| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(z * 255), 0, 255) << 0)
-						| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(w * 255), 0, 255) << 24);
+					mtl->tex_names[i] = ReadShortString(decoded);
+				}
+				if (!mtl->tex_names[RenderMaterial::TS_Height].empty())
+				{
+					float height_offset;
+					decoded->read(&height_offset, sizeof(height_offset));
+					mtl->height_offset_scale.x() = LE2Native(height_offset);
+					float height_scale;
+					decoded->read(&height_scale, sizeof(height_scale));
+					mtl->height_offset_scale.y() = LE2Native(height_scale);
 				}
-			}
-			if ((EF_ARGB8 == merged_ves[i].format) && !rf.RenderEngineInstance().DeviceCaps().vertex_format_support(EF_ARGB8))
-			{
-				BOOST_ASSERT(rf.RenderEngineInstance().DeviceCaps().vertex_format_support(EF_ABGR8));
-
-				merged_ves[i].format = EF_ABGR8;
 
-				uint32_t* p = reinterpret_cast<uint32_t*>(&merged_buff[i][0]);
-				for (uint32_t j = 0; j < all_num_vertices; ++ j)
+				uint8_t detail_mode;
+				decoded->read(&detail_mode, sizeof(detail_mode));
+				mtl->detail_mode = static_cast<RenderMaterial::SurfaceDetailMode>(detail_mode);
+				if (mtl->detail_mode != RenderMaterial::SDM_Parallax)
+				{
+					float tess_factor;
+					decoded->read(&tess_factor, sizeof(tess_factor));
+					mtl->tess_factors.x() = LE2Native(tess_factor);
+					decoded->read(&tess_factor, sizeof(tess_factor));
+					mtl->tess_factors.y() = LE2Native(tess_factor);
+					decoded->read(&tess_factor, sizeof(tess_factor));
+					mtl->tess_factors.z() = LE2Native(tess_factor);
+					decoded->read(&tess_factor, sizeof(tess_factor));
+					mtl->tess_factors.w() = LE2Native(tess_factor);
+				}
+				else
 				{
-					float x = ((p[j] >> 16) & 0xFF) / 255.0f;
-					float y = ((p[j] >>  8) & 0xFF) / 255.0f;
-					float z = ((p[j] >>  0) & 0xFF) / 255.0f;
-					float w = ((p[j] >> 24) & 0xFF) / 255.0f;
-
-					p[j] = (MathLib::clamp<uint32_t>(static_cast<uint32_t>(x * 255), 0, 255) << 0)
-						| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(y * 255), 0, 255) << 8)
-						| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(z * 255), 0, 255) << 16)
-						| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(w * 255), 0, 255) << 24);
+					mtl->tess_factors = float4(5, 5, 1, 9);
 				}
 			}
 		}
-		merged_indices.resize(all_num_indices * index_elem_size);
-		decoded->read(&merged_indices[0], merged_indices.size() * sizeof(merged_indices[0]));
 
 		mesh_names.resize(num_meshes);
 		mtl_ids.resize(num_meshes);
@@ -1199,197 +1413,253 @@ namespace KlayGE
 		mesh_base_vertices.resize(num_meshes);
 		mesh_num_indices.resize(num_meshes);
 		mesh_base_indices.resize(num_meshes);
-		for (uint32_t mesh_index = 0; mesh_index < num_meshes; ++ mesh_index)
-		{
-			mesh_names[mesh_index] = ReadShortString(decoded);
-
-			decoded->read(&mtl_ids[mesh_index], sizeof(mtl_ids[mesh_index]));
-			mtl_ids[mesh_index] = LE2Native(mtl_ids[mesh_index]);
-
-			float3 min_bb, max_bb;
-			decoded->read(&min_bb, sizeof(min_bb));
-			min_bb.x() = LE2Native(min_bb.x());
-			min_bb.y() = LE2Native(min_bb.y());
-			min_bb.z() = LE2Native(min_bb.z());
-			decoded->read(&max_bb, sizeof(max_bb));
-			max_bb.x() = LE2Native(max_bb.x());
-			max_bb.y() = LE2Native(max_bb.y());
-			max_bb.z() = LE2Native(max_bb.z());
-			pos_bbs[mesh_index] = AABBox(min_bb, max_bb);
-
-			decoded->read(&min_bb[0], sizeof(min_bb[0]));
-			decoded->read(&min_bb[1], sizeof(min_bb[1]));
-			min_bb.x() = LE2Native(min_bb.x());
-			min_bb.y() = LE2Native(min_bb.y());
-			min_bb.z() = 0;
-			decoded->read(&max_bb[0], sizeof(max_bb[0]));
-			decoded->read(&max_bb[1], sizeof(max_bb[1]));
-			max_bb.x() = LE2Native(max_bb.x());
-			max_bb.y() = LE2Native(max_bb.y());
-			max_bb.z() = 0;
-			tc_bbs[mesh_index] = AABBox(min_bb, max_bb);
-
-			decoded->read(&mesh_num_vertices[mesh_index], sizeof(mesh_num_vertices[mesh_index]));
-			mesh_num_vertices[mesh_index] = LE2Native(mesh_num_vertices[mesh_index]);
-			decoded->read(&mesh_base_vertices[mesh_index], sizeof(mesh_base_vertices[mesh_index]));
-			mesh_base_vertices[mesh_index] = LE2Native(mesh_base_vertices[mesh_index]);
-			decoded->read(&mesh_num_indices[mesh_index], sizeof(mesh_num_indices[mesh_index]));
-			mesh_num_indices[mesh_index] = LE2Native(mesh_num_indices[mesh_index]);
-			decoded->read(&mesh_base_indices[mesh_index], sizeof(mesh_base_indices[mesh_index]));
-			mesh_base_indices[mesh_index] = LE2Native(mesh_base_indices[mesh_index]);
-		}
-
-		joints.resize(num_joints);
-		for (uint32_t joint_index = 0; joint_index < num_joints; ++ joint_index)
+		if (num_meshes > 0)
 		{
-			Joint& joint = joints[joint_index];
+			ResIdentifierPtr decoded = chunk_res(MakeFourCC<'M', 'E', 'S', 'H'>::value);
 
-			joint.name = ReadShortString(decoded);
-			decoded->read(&joint.parent, sizeof(joint.parent));
-			joint.parent = LE2Native(joint.parent);
+			uint32_t num_merged_ves;
+			decoded->read(&num_merged_ves, sizeof(num_merged_ves));
+			num_merged_ves = LE2Native(num_merged_ves);
+			merged_ves.resize(num_merged_ves);
+			for (size_t i = 0; i < merged_ves.size(); ++ i)
+			{
+				decoded->read(&merged_ves[i], sizeof(merged_ves[i]));
 
-			decoded->read(&joint.bind_real, sizeof(joint.bind_real));
-			joint.bind_real[0] = LE2Native(joint.bind_real[0]);
-			joint.bind_real[1] = LE2Native(joint.bind_real[1]);
-			joint.bind_real[2] = LE2Native(joint.bind_real[2]);
-			joint.bind_real[3] = LE2Native(joint.bind_real[3]);
-			decoded->read(&joint.bind_dual, sizeof(joint.bind_dual));
-			joint.bind_dual[0] = LE2Native(joint.bind_dual[0]);
-			joint.bind_dual[1] = LE2Native(joint.bind_dual[1]);
-			joint.bind_dual[2] = LE2Native(joint.bind_dual[2]);
-			joint.bind_dual[3] = LE2Native(joint.bind_dual[3]);
+				merged_ves[i].usage = LE2Native(merged_ves[i].usage);
+				merged_ves[i].format = LE2Native(merged_ves[i].format);
+			}
 
-			float flip = MathLib::sgn(joint.bind_real.w());
+			uint32_t all_num_vertices;
+			uint32_t all_num_indices;
+			decoded->read(&all_num_vertices, sizeof(all_num_vertices));
+			all_num_vertices = LE2Native(all_num_vertices);
+			decoded->read(&all_num_indices, sizeof(all_num_indices));
+			all_num_indices = LE2Native(all_num_indices);
+			decoded->read(&all_is_index_16_bit, sizeof(all_is_index_16_bit));
 
-			joint.bind_scale = MathLib::length(joint.bind_real);
-			joint.inverse_origin_scale = 1 / joint.bind_scale;
-			joint.bind_real *= joint.inverse_origin_scale;
+			BOOST_ASSERT(merged_buff.size() == merged_ves.size());
+			BOOST_ASSERT(merged_indices.size() == all_num_indices * (all_is_index_16_bit ? 2U : 4U));
+			KFL_UNUSED(all_num_indices);
 
-			if (flip > 0)
-			{
-				std::pair<Quaternion, Quaternion> inv = MathLib::inverse(joint.bind_real, joint.bind_dual);
-				joint.inverse_origin_real = inv.first;
-				joint.inverse_origin_dual = inv.second;
-			}
-			else
+			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+			for (size_t i = 0; i < merged_buff.size(); ++ i)
 			{
-				float4x4 tmp_mat = MathLib::scaling(joint.bind_scale, joint.bind_scale, flip * joint.bind_scale)
-					* MathLib::to_matrix(joint.bind_real)
-					* MathLib::translation(MathLib::udq_to_trans(joint.bind_real, joint.bind_dual));
-				tmp_mat = MathLib::inverse(tmp_mat);
-				tmp_mat(2, 0) = -tmp_mat(2, 0);
-				tmp_mat(2, 1) = -tmp_mat(2, 1);
-				tmp_mat(2, 2) = -tmp_mat(2, 2);
+				BOOST_ASSERT(merged_buff[i].size() == all_num_vertices * merged_ves[i].element_size());
 
-				float3 scale;
-				Quaternion rot;
-				float3 trans;
-				MathLib::decompose(scale, rot, trans, tmp_mat);
+				if ((EF_A2BGR10 == merged_ves[i].format) && !rf.RenderEngineInstance().DeviceCaps().vertex_format_support(EF_A2BGR10))
+				{
+					merged_ves[i].format = EF_ARGB8;
+
+					uint32_t* p = reinterpret_cast<uint32_t*>(&merged_buff[i][0]);
+					for (uint32_t j = 0; j < all_num_vertices; ++ j)
+					{
+						float x = ((p[j] >>  0) & 0x3FF) / 1023.0f;
+						float y = ((p[j] >> 10) & 0x3FF) / 1023.0f;
+						float z = ((p[j] >> 20) & 0x3FF) / 1023.0f;
+						float w = ((p[j] >> 30) & 0x3) / 3.0f;
+
+						p[j] = (MathLib::clamp<uint32_t>(static_cast<uint32_t>(x * 255), 0, 255) << 16)
+							| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(y * 255), 0, 255) << 8)
+							| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(z * 255), 0, 255) << 0)
+							| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(w * 255), 0, 255) << 24);
+					}
+				}
+				if ((EF_ARGB8 == merged_ves[i].format) && !rf.RenderEngineInstance().DeviceCaps().vertex_format_support(EF_ARGB8))
+				{
+					BOOST_ASSERT(rf.RenderEngineInstance().DeviceCaps().vertex_format_support(EF_ABGR8));
+
+					merged_ves[i].format = EF_ABGR8;
 
-				joint.inverse_origin_real = rot;
-				joint.inverse_origin_dual = MathLib::quat_trans_to_udq(rot, trans);
-				joint.inverse_origin_scale = -scale.x();
+					uint32_t* p = reinterpret_cast<uint32_t*>(&merged_buff[i][0]);
+					for (uint32_t j = 0; j < all_num_vertices; ++ j)
+					{
+						float x = ((p[j] >> 16) & 0xFF) / 255.0f;
+						float y = ((p[j] >>  8) & 0xFF) / 255.0f;
+						float z = ((p[j] >>  0) & 0xFF) / 255.0f;
+						float w = ((p[j] >> 24) & 0xFF) / 255.0f;
+
+						p[j] = (MathLib::clamp<uint32_t>(static_cast<uint32_t>(x * 255), 0, 255) << 0)
+							| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(y * 255), 0, 255) << 8)
+							| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(z * 255), 0, 255) << 16)
+							| (MathLib::clamp<uint32_t>(static_cast<uint32_t>(w * 255), 0, 255) << 24);
+					}
+				}
+			}
+
+			for (uint32_t mesh_index = 0; mesh_index < num_meshes; ++ mesh_index)
+			{
+				mesh_names[mesh_index] = ReadShortString(decoded);
+
+				decoded->read(&mtl_ids[mesh_index], sizeof(mtl_ids[mesh_index]));
+				mtl_ids[mesh_index] = LE2Native(mtl_ids[mesh_index]);
+
+				float3 min_bb, max_bb;
+				decoded->read(&min_bb, sizeof(min_bb));
+				min_bb.x() = LE2Native(min_bb.x());
+				min_bb.y() = LE2Native(min_bb.y());
+				min_bb.z() = LE2Native(min_bb.z());
+				decoded->read(&max_bb, sizeof(max_bb));
+				max_bb.x() = LE2Native(max_bb.x());
+				max_bb.y() = LE2Native(max_bb.y());
+				max_bb.z() = LE2Native(max_bb.z());
+				pos_bbs[mesh_index] = AABBox(min_bb, max_bb);
+
+				decoded->read(&min_bb[0], sizeof(min_bb[0]));
+				decoded->read(&min_bb[1], sizeof(min_bb[1]));
+				min_bb.x() = LE2Native(min_bb.x());
+				min_bb.y() = LE2Native(min_bb.y());
+				min_bb.z() = 0;
+				decoded->read(&max_bb[0], sizeof(max_bb[0]));
+				decoded->read(&max_bb[1], sizeof(max_bb[1]));
+				max_bb.x() = LE2Native(max_bb.x());
+				max_bb.y() = LE2Native(max_bb.y());
+				max_bb.z() = 0;
+				tc_bbs[mesh_index] = AABBox(min_bb, max_bb);
+
+				decoded->read(&mesh_num_vertices[mesh_index], sizeof(mesh_num_vertices[mesh_index]));
+				mesh_num_vertices[mesh_index] = LE2Native(mesh_num_vertices[mesh_index]);
+				decoded->read(&mesh_base_vertices[mesh_index], sizeof(mesh_base_vertices[mesh_index]));
+				mesh_base_vertices[mesh_index] = LE2Native(mesh_base_vertices[mesh_index]);
+				decoded->read(&mesh_num_indices[mesh_index], sizeof(mesh_num_indices[mesh_index]));
+				mesh_num_indices[mesh_index] = LE2Native(mesh_num_indices[mesh_index]);
+				decoded->read(&mesh_base_indices[mesh_index], sizeof(mesh_base_indices[mesh_index]));
+				mesh_base_indices[mesh_index] = LE2Native(mesh_base_indices[mesh_index]);
 			}
-			
-			joint.bind_scale *= flip;
 		}
 
-		if (num_kfs > 0)
+		joints.resize(num_joints);
+		if (num_joints > 0)
 		{
-			decoded->read(&num_frames, sizeof(num_frames));
-			num_frames = LE2Native(num_frames);
-			decoded->read(&frame_rate, sizeof(frame_rate));
-			frame_rate = LE2Native(frame_rate);
-
-			kfs = MakeSharedPtr<KeyFramesType>(joints.size());
-			for (uint32_t kf_index = 0; kf_index < num_kfs; ++ kf_index)
+			ResIdentifierPtr decoded = chunk_res(MakeFourCC<'B', 'O', 'N', 'E'>::value);
+			for (uint32_t joint_index = 0; joint_index < num_joints; ++ joint_index)
 			{
-				uint32_t joint_index = kf_index;
-
-				uint32_t num_kf;
-				decoded->read(&num_kf, sizeof(num_kf));
-				num_kf = LE2Native(num_kf);
-
-				KeyFrames kf;
-				kf.frame_id.resize(num_kf);
-				kf.bind_real.resize(num_kf);
-				kf.bind_dual.resize(num_kf);
-				kf.bind_scale.resize(num_kf);
-				for (uint32_t k_index = 0; k_index < num_kf; ++ k_index)
+				Joint& joint = joints[joint_index];
+
+				joint.name = ReadShortString(decoded);
+				decoded->read(&joint.parent, sizeof(joint.parent));
+				joint.parent = LE2Native(joint.parent);
+
+				decoded->read(&joint.bind_real, sizeof(joint.bind_real));
+				joint.bind_real[0] = LE2Native(joint.bind_real[0]);
+				joint.bind_real[1] = LE2Native(joint.bind_real[1]);
+				joint.bind_real[2] = LE2Native(joint.bind_real[2]);
+				joint.bind_real[3] = LE2Native(joint.bind_real[3]);
+				decoded->read(&joint.bind_dual, sizeof(joint.bind_dual));
+				joint.bind_dual[0] = LE2Native(joint.bind_dual[0]);
+				joint.bind_dual[1] = LE2Native(joint.bind_dual[1]);
+				joint.bind_dual[2] = LE2Native(joint.bind_dual[2]);
+				joint.bind_dual[3] = LE2Native(joint.bind_dual[3]);
+
+				float flip = MathLib::sgn(joint.bind_real.w());
+
+				joint.bind_scale = MathLib::length(joint.bind_real);
+				joint.inverse_origin_scale = 1 / joint.bind_scale;
+				joint.bind_real *= joint.inverse_origin_scale;
+
+				if (flip > 0)
 				{
-					decoded->read(&kf.frame_id[k_index], sizeof(kf.frame_id[k_index]));
-					kf.frame_id[k_index] = LE2Native(kf.frame_id[k_index]);
-					decoded->read(&kf.bind_real[k_index], sizeof(kf.bind_real[k_index]));
-					kf.bind_real[k_index][0] = LE2Native(kf.bind_real[k_index][0]);
-					kf.bind_real[k_index][1] = LE2Native(kf.bind_real[k_index][1]);
-					kf.bind_real[k_index][2] = LE2Native(kf.bind_real[k_index][2]);
-					kf.bind_real[k_index][3] = LE2Native(kf.bind_real[k_index][3]);
-					decoded->read(&kf.bind_dual[k_index], sizeof(kf.bind_dual[k_index]));
-					kf.bind_dual[k_index][0] = LE2Native(kf.bind_dual[k_index][0]);
-					kf.bind_dual[k_index][1] = LE2Native(kf.bind_dual[k_index][1]);
-					kf.bind_dual[k_index][2] = LE2Native(kf.bind_dual[k_index][2]);
-					kf.bind_dual[k_index][3] = LE2Native(kf.bind_dual[k_index][3]);
-
-					float flip = MathLib::sgn(kf.bind_real[k_index].w());
-
-					kf.bind_scale[k_index] = MathLib::length(kf.bind_real[k_index]);
-					kf.bind_real[k_index] /= kf.bind_scale[k_index];
-
-					kf.bind_scale[k_index] *= flip;
+					std::pair<Quaternion, Quaternion> inv = MathLib::inverse(joint.bind_real, joint.bind_dual);
+					joint.inverse_origin_real = inv.first;
+					joint.inverse_origin_dual = inv.second;
 				}
-
-				if (joint_index < num_joints)
+				else
 				{
-					(*kfs)[joint_index] = kf;
+					float4x4 tmp_mat = MathLib::scaling(joint.bind_scale, joint.bind_scale, flip * joint.bind_scale)
+						* MathLib::to_matrix(joint.bind_real)
+						* MathLib::translation(MathLib::udq_to_trans(joint.bind_real, joint.bind_dual));
+					tmp_mat = MathLib::inverse(tmp_mat);
+					tmp_mat(2, 0) = -tmp_mat(2, 0);
+					tmp_mat(2, 1) = -tmp_mat(2, 1);
+					tmp_mat(2, 2) = -tmp_mat(2, 2);
+
+					float3 scale;
+					Quaternion rot;
+					float3 trans;
+					MathLib::decompose(scale, rot, trans, tmp_mat);
+
+					joint.inverse_origin_real = rot;
+					joint.inverse_origin_dual = MathLib::quat_trans_to_udq(rot, trans);
+					joint.inverse_origin_scale = -scale.x();
 				}
+			
+				joint.bind_scale *= flip;
 			}
+		}
+
+		if (num_kfs > 0)
+		{
+			BOOST_ASSERT(kf_chunk_index >= 0);
+			kfs_loader = KeyFramesChunkLoader(lzma_file, chunks[kf_chunk_index], num_kfs, num_joints);
 
 			frame_pos_bbs.resize(num_meshes);
-			for (uint32_t mesh_index = 0; mesh_index < num_meshes; ++ mesh_index)
 			{
-				uint32_t num_bb_kf;
-				decoded->read(&num_bb_kf, sizeof(num_bb_kf));
-				num_bb_kf = LE2Native(num_bb_kf);
+				ResIdentifierPtr decoded = chunk_res(MakeFourCC<'B', 'B', 'K', 'F'>::value);
+				for (uint32_t mesh_index = 0; mesh_index < num_meshes; ++ mesh_index)
+				{
+					uint32_t num_bb_kf;
+					decoded->read(&num_bb_kf, sizeof(num_bb_kf));
+					num_bb_kf = LE2Native(num_bb_kf);
 
-				frame_pos_bbs[mesh_index] = MakeSharedPtr<AABBKeyFrames>();
-				frame_pos_bbs[mesh_index]->frame_id.resize(num_bb_kf);
-				frame_pos_bbs[mesh_index]->bb.resize(num_bb_kf);
+					frame_pos_bbs[mesh_index] = MakeSharedPtr<AABBKeyFrames>();
+					frame_pos_bbs[mesh_index]->frame_id.resize(num_bb_kf);
+					frame_pos_bbs[mesh_index]->bb.resize(num_bb_kf);
 
-				for (uint32_t bb_k_index = 0; bb_k_index < num_bb_kf; ++ bb_k_index)
-				{
-					decoded->read(&frame_pos_bbs[mesh_index]->frame_id[bb_k_index], sizeof(frame_pos_bbs[mesh_index]->frame_id[bb_k_index]));
-					frame_pos_bbs[mesh_index]->frame_id[bb_k_index] = LE2Native(frame_pos_bbs[mesh_index]->frame_id[bb_k_index]);
-
-					float3 bb_min, bb_max;
-					decoded->read(&bb_min, sizeof(bb_min));
-					bb_min[0] = LE2Native(bb_min[0]);
-					bb_min[1] = LE2Native(bb_min[1]);
-					bb_min[2] = LE2Native(bb_min[2]);
-					decoded->read(&bb_max, sizeof(bb_max));
-					bb_max[0] = LE2Native(bb_max[0]);
-					bb_max[1] = LE2Native(bb_max[1]);
-					bb_max[2] = LE2Native(bb_max[2]);
-					frame_pos_bbs[mesh_index]->bb[bb_k_index] = AABBox(bb_min, bb_max);
+					for (uint32_t bb_k_index = 0; bb_k_index < num_bb_kf; ++ bb_k_index)
+					{
+						decoded->read(&frame_pos_bbs[mesh_index]->frame_id[bb_k_index], sizeof(frame_pos_bbs[mesh_index]->frame_id[bb_k_index]));
+						frame_pos_bbs[mesh_index]->frame_id[bb_k_index] = LE2Native(frame_pos_bbs[mesh_index]->frame_id[bb_k_index]);
+
+						float3 bb_min, bb_max;
+						decoded->read(&bb_min, sizeof(bb_min));
+						bb_min[0] = LE2Native(bb_min[0]);
+						bb_min[1] = LE2Native(bb_min[1]);
+						bb_min[2] = LE2Native(bb_min[2]);
+						decoded->read(&bb_max, sizeof(bb_max));
+						bb_max[0] = LE2Native(bb_max[0]);
+						bb_max[1] = LE2Native(bb_max[1]);
+						bb_max[2] = LE2Native(bb_max[2]);
+						frame_pos_bbs[mesh_index]->bb[bb_k_index] = AABBox(bb_min, bb_max);
+					}
 				}
 			}
 			
 			if (num_actions > 0)
 			{
+				ResIdentifierPtr decoded = chunk_res(MakeFourCC<'A', 'C', 'T', 'N'>::value);
+
 				actions = MakeSharedPtr<AnimationActionsType>(num_actions);
 				for (uint32_t action_index = 0; action_index < num_actions; ++ action_index)
 				{
-					AnimationAction action;
+					AnimationAction& action = (*actions)[action_index];
 					action.name = ReadShortString(decoded);
 					decoded->read(&action.start_frame, sizeof(action.start_frame));
 					action.start_frame = LE2Native(action.start_frame);
 					decoded->read(&action.end_frame, sizeof(action.end_frame));
 					action.end_frame = LE2Native(action.end_frame);
-					actions->push_back(action);
 				}
 			}
 		}
 	}
 
+	void LoadModel(std::string const & meshml_name, std::vector<RenderMaterialPtr>& mtls,
+		std::vector<vertex_element>& merged_ves, char& all_is_index_16_bit,
+		std::vector<std::vector<uint8_t>>& merged_buff, std::vector<uint8_t>& merged_indices,
+		std::vector<std::string>& mesh_names, std::vector<int32_t>& mtl_ids,
+		std::vector<AABBox>& pos_bbs, std::vector<AABBox>& tc_bbs,
+		std::vector<uint32_t>& mesh_num_vertices, std::vector<uint32_t>& mesh_base_vertices,
+		std::vector<uint32_t>& mesh_num_indices, std::vector<uint32_t>& mesh_base_indices,
+		std::vector<Joint>& joints, std::shared_ptr<AnimationActionsType>& actions,
+		std::shared_ptr<KeyFramesType>& kfs, uint32_t& num_frames, uint32_t& frame_rate,
+		std::vector<std::shared_ptr<AABBKeyFrames>>& frame_pos_bbs)
+	{
+		std::function<std::shared_ptr<KeyFramesType>()> kfs_loader;
+		LoadModel(meshml_name, mtls, merged_ves, all_is_index_16_bit, merged_buff, merged_indices,
+			mesh_names, mtl_ids, pos_bbs, tc_bbs, mesh_num_vertices, mesh_base_vertices,
+			mesh_num_indices, mesh_base_indices, joints, actions, kfs_loader, num_frames, frame_rate,
+			frame_pos_bbs);
+		kfs = kfs_loader ? kfs_loader() : std::shared_ptr<KeyFramesType>();
+	}
+
 	RenderModelPtr SyncLoadModel(std::string const & meshml_name, uint32_t access_hint,
 		std::function<RenderModelPtr(std::wstring const &)> CreateModelFactoryFunc,
 		std::function<StaticMeshPtr(RenderModelPtr const &, std::wstring const &)> CreateMeshFactoryFunc)
@@ -368,6 +368,13 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, ps_desc_.res_name.begin(), ps_desc_.res_name.end());
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const
 		{
 			if (this->Type() == rhs.Type())
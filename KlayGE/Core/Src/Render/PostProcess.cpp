@@ -198,6 +198,14 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, pp_desc_.res_name.begin(), pp_desc_.res_name.end());
+			HashRange(seed, pp_desc_.pp_name.begin(), pp_desc_.pp_name.end());
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const
 		{
 			if (this->Type() == rhs.Type())
@@ -322,7 +330,7 @@ namespace KlayGE
 
 			if (volumetric_)
 			{
-				pp_mvp_param_ = effect_->ParameterByName("pp_mvp");
+				pp_mvp_param_ = effect_->ParameterByName(CT_HASH("pp_mvp"));
 			}
 			else
 			{
@@ -364,8 +372,8 @@ namespace KlayGE
 				params_[i].second = effect_->ParameterByName(params_[i].first);
 			}
 
-			width_height_ep_ = effect_->ParameterByName("width_height");
-			inv_width_height_ep_ = effect_->ParameterByName("inv_width_height");
+			width_height_ep_ = effect_->ParameterByName(CT_HASH("width_height"));
+			inv_width_height_ep_ = effect_->ParameterByName(CT_HASH("inv_width_height"));
 		}
 	}
 
@@ -1294,9 +1302,9 @@ namespace KlayGE
 		}
 		this->Technique(ei, te);
 
-		src_tex_size_ep_ = effect_->ParameterByName("src_tex_size");
-		color_weight_ep_ = effect_->ParameterByName("color_weight");
-		tex_coord_offset_ep_ = effect_->ParameterByName("tex_coord_offset");
+		src_tex_size_ep_ = effect_->ParameterByName(CT_HASH("src_tex_size"));
+		color_weight_ep_ = effect_->ParameterByName(CT_HASH("color_weight"));
+		tex_coord_offset_ep_ = effect_->ParameterByName(CT_HASH("tex_coord_offset"));
 	}
 
 	SeparableBoxFilterPostProcess::~SeparableBoxFilterPostProcess()
@@ -1379,9 +1387,9 @@ namespace KlayGE
 		}
 		this->Technique(ei, te);
 
-		src_tex_size_ep_ = effect_->ParameterByName("src_tex_size");
-		color_weight_ep_ = effect_->ParameterByName("color_weight");
-		tex_coord_offset_ep_ = effect_->ParameterByName("tex_coord_offset");
+		src_tex_size_ep_ = effect_->ParameterByName(CT_HASH("src_tex_size"));
+		color_weight_ep_ = effect_->ParameterByName(CT_HASH("color_weight"));
+		tex_coord_offset_ep_ = effect_->ParameterByName(CT_HASH("tex_coord_offset"));
 	}
 
 	SeparableGaussianFilterPostProcess::~SeparableGaussianFilterPostProcess()
@@ -1496,11 +1504,11 @@ namespace KlayGE
 		}
 		this->Technique(ei, te);
 
-		kernel_radius_ep_ = effect_->ParameterByName("kernel_radius");
-		src_tex_size_ep_ = effect_->ParameterByName("src_tex_size");
-		init_g_ep_ = effect_->ParameterByName("init_g");
-		blur_factor_ep_ = effect_->ParameterByName("blur_factor");
-		sharpness_factor_ep_ = effect_->ParameterByName("sharpness_factor");
+		kernel_radius_ep_ = effect_->ParameterByName(CT_HASH("kernel_radius"));
+		src_tex_size_ep_ = effect_->ParameterByName(CT_HASH("src_tex_size"));
+		init_g_ep_ = effect_->ParameterByName(CT_HASH("init_g"));
+		blur_factor_ep_ = effect_->ParameterByName(CT_HASH("blur_factor"));
+		sharpness_factor_ep_ = effect_->ParameterByName(CT_HASH("sharpness_factor"));
 	}
 
 	SeparableBilateralFilterPostProcess::~SeparableBilateralFilterPostProcess()
@@ -1563,8 +1571,8 @@ namespace KlayGE
 		auto effect = SyncLoadRenderEffect("Blur.fxml");
 		this->Technique(effect, effect->TechniqueByName(x_dir ? (linear_depth ? "LogBlurX" : "LogBlurXNLD") : "LogBlurY"));
 
-		color_weight_ep_ = effect_->ParameterByName("color_weight");
-		tex_coord_offset_ep_ = effect_->ParameterByName("tex_coord_offset");
+		color_weight_ep_ = effect_->ParameterByName(CT_HASH("color_weight"));
+		tex_coord_offset_ep_ = effect_->ParameterByName(CT_HASH("tex_coord_offset"));
 	}
 
 	SeparableLogGaussianFilterPostProcess::~SeparableLogGaussianFilterPostProcess()
@@ -2709,6 +2709,13 @@ namespace KlayGE
 			return false;
 		}
 
+		size_t Hash() const
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, effect_desc_.res_name.begin(), effect_desc_.res_name.end());
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const
 		{
 			if (this->Type() == rhs.Type())
@@ -2771,6 +2778,74 @@ namespace KlayGE
 #endif
 
 
+	HashIndexTable::HashIndexTable()
+		: num_indices_(0)
+	{
+	}
+
+	void HashIndexTable::Build(std::vector<size_t> const & hashes)
+	{
+		num_indices_ = static_cast<uint32_t>(hashes.size());
+
+		// At most half full, so the probing always ends at an empty slot
+		size_t num_slots = 2;
+		while (num_slots < hashes.size() * 2)
+		{
+			num_slots *= 2;
+		}
+		std::pair<size_t, uint32_t> empty_slot;
+		empty_slot.first = 0;
+		empty_slot.second = InvalidIndex;
+		slots_.assign(num_slots, empty_slot);
+
+		size_t const mask = num_slots - 1;
+		for (uint32_t i = 0; i < num_indices_; ++ i)
+		{
+			size_t const hash = hashes[i];
+			for (size_t slot = (hash ^ (hash >> 16)) & mask; ; slot = (slot + 1) & mask)
+			{
+				if (InvalidIndex == slots_[slot].second)
+				{
+					slots_[slot].first = hash;
+					slots_[slot].second = i;
+					break;
+				}
+				if (hash == slots_[slot].first)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	void HashIndexTable::Clear()
+	{
+		slots_.clear();
+		num_indices_ = 0;
+	}
+
+	uint32_t HashIndexTable::Find(size_t hash) const
+	{
+		if (slots_.empty())
+		{
+			return InvalidIndex;
+		}
+
+		size_t const mask = slots_.size() - 1;
+		for (size_t slot = (hash ^ (hash >> 16)) & mask; ; slot = (slot + 1) & mask)
+		{
+			if (InvalidIndex == slots_[slot].second)
+			{
+				return InvalidIndex;
+			}
+			if (hash == slots_[slot].first)
+			{
+				return slots_[slot].second;
+			}
+		}
+	}
+
+
 	void RenderEffect::Load(std::string const & name)
 	{
 		effect_template_ = MakeSharedPtr<RenderEffectTemplate>();
@@ -2816,7 +2891,19 @@ namespace KlayGE
 
 	RenderEffectParameter* RenderEffect::ParameterByName(std::string const & name) const
 	{
-		size_t const name_hash = HashRange(name.begin(), name.end());
+		return this->ParameterByName(HashRange(name.begin(), name.end()));
+	}
+
+	RenderEffectParameter* RenderEffect::ParameterByName(size_t name_hash) const
+	{
+		HashIndexTable const & table = effect_template_->param_name_table_;
+		if (table.NumIndices() == params_.size())
+		{
+			uint32_t const index = table.Find(name_hash);
+			return (index != HashIndexTable::InvalidIndex) ? params_[index].get() : nullptr;
+		}
+
+		// The tables are not built yet while loading
 		for (auto const & param : params_)
 		{
 			if (name_hash == param->NameHash())
@@ -2829,7 +2916,18 @@ namespace KlayGE
 
 	RenderEffectParameter* RenderEffect::ParameterBySemantic(std::string const & semantic) const
 	{
-		size_t const semantic_hash = HashRange(semantic.begin(), semantic.end());
+		return this->ParameterBySemantic(HashRange(semantic.begin(), semantic.end()));
+	}
+
+	RenderEffectParameter* RenderEffect::ParameterBySemantic(size_t semantic_hash) const
+	{
+		HashIndexTable const & table = effect_template_->param_semantic_table_;
+		if (table.NumIndices() == params_.size())
+		{
+			uint32_t const index = table.Find(semantic_hash);
+			return (index != HashIndexTable::InvalidIndex) ? params_[index].get() : nullptr;
+		}
+
 		for (auto const & param : params_)
 		{
 			if (semantic_hash == param->SemanticHash())
@@ -2842,7 +2940,18 @@ namespace KlayGE
 
 	RenderEffectConstantBuffer* RenderEffect::CBufferByName(std::string const & name) const
 	{
-		size_t const name_hash = HashRange(name.begin(), name.end());
+		return this->CBufferByName(HashRange(name.begin(), name.end()));
+	}
+
+	RenderEffectConstantBuffer* RenderEffect::CBufferByName(size_t name_hash) const
+	{
+		HashIndexTable const & table = effect_template_->cbuffer_name_table_;
+		if (table.NumIndices() == cbuffers_.size())
+		{
+			uint32_t const index = table.Find(name_hash);
+			return (index != HashIndexTable::InvalidIndex) ? cbuffers_[index].get() : nullptr;
+		}
+
 		for (auto const & cbuffer : cbuffers_)
 		{
 			if (name_hash == cbuffer->NameHash())
@@ -2863,6 +2972,11 @@ namespace KlayGE
 		return effect_template_->TechniqueByName(name);
 	}
 
+	RenderTechnique* RenderEffect::TechniqueByName(size_t name_hash) const
+	{
+		return effect_template_->TechniqueByName(name_hash);
+	}
+
 	RenderTechnique* RenderEffect::TechniqueByIndex(uint32_t n) const
 	{
 		return effect_template_->TechniqueByIndex(n);
@@ -3193,6 +3307,37 @@ namespace KlayGE
 			this->StreamOut(ofs, effect);
 #endif
 		}
+
+		this->BuildLookupTables(effect);
+	}
+
+	void RenderEffectTemplate::BuildLookupTables(RenderEffect const & effect)
+	{
+		std::vector<size_t> hashes(techniques_.size());
+		for (size_t i = 0; i < techniques_.size(); ++ i)
+		{
+			hashes[i] = techniques_[i]->NameHash();
+		}
+		tech_name_table_.Build(hashes);
+
+		hashes.resize(effect.params_.size());
+		for (size_t i = 0; i < effect.params_.size(); ++ i)
+		{
+			hashes[i] = effect.params_[i]->NameHash();
+		}
+		param_name_table_.Build(hashes);
+		for (size_t i = 0; i < effect.params_.size(); ++ i)
+		{
+			hashes[i] = effect.params_[i]->SemanticHash();
+		}
+		param_semantic_table_.Build(hashes);
+
+		hashes.resize(effect.cbuffers_.size());
+		for (size_t i = 0; i < effect.cbuffers_.size(); ++ i)
+		{
+			hashes[i] = effect.cbuffers_[i]->NameHash();
+		}
+		cbuffer_name_table_.Build(hashes);
 	}
 
 	bool RenderEffectTemplate::StreamIn(ResIdentifierPtr const & source, RenderEffect& effect)
@@ -3458,7 +3603,17 @@ namespace KlayGE
 
 	RenderTechnique* RenderEffectTemplate::TechniqueByName(std::string const & name) const
 	{
-		size_t const name_hash = HashRange(name.begin(), name.end());
+		return this->TechniqueByName(HashRange(name.begin(), name.end()));
+	}
+
+	RenderTechnique* RenderEffectTemplate::TechniqueByName(size_t name_hash) const
+	{
+		if (tech_name_table_.NumIndices() == techniques_.size())
+		{
+			uint32_t const index = tech_name_table_.Find(name_hash);
+			return (index != HashIndexTable::InvalidIndex) ? techniques_[index].get() : nullptr;
+		}
+
 		for (auto const & tech : techniques_)
 		{
 			if (name_hash == tech->NameHash())
@@ -4846,6 +5001,13 @@ namespace KlayGE
 	}
 
 
+	RenderEffectConstantBuffer::RenderEffectConstantBuffer()
+		: dirty_begin_(0), dirty_end_(0xFFFFFFFF)
+	{
+		RenderEngine const & re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
+		partial_update_ = re.DeviceCaps().partial_cbuffer_update_support;
+	}
+
 #if KLAYGE_IS_DEV_PLATFORM
 	void RenderEffectConstantBuffer::Load(std::string const & name)
 	{
@@ -4928,16 +5090,29 @@ namespace KlayGE
 			}
 		}
 
-		dirty_ = true;
+		this->Dirty(true);
 	}
 
 	void RenderEffectConstantBuffer::Update()
 	{
-		if (dirty_)
+		if (dirty_begin_ < dirty_end_)
 		{
-			hw_buff_->UpdateSubresource(0, static_cast<uint32_t>(buff_.size()), &buff_[0]);
+			uint32_t const size = static_cast<uint32_t>(buff_.size());
+
+			if (partial_update_)
+			{
+				uint32_t const end = std::min(dirty_end_, size);
+				if (dirty_begin_ < end)
+				{
+					hw_buff_->UpdateSubresource(dirty_begin_, end - dirty_begin_, &buff_[dirty_begin_]);
+				}
+			}
+			else
+			{
+				hw_buff_->UpdateSubresource(0, size, &buff_[0]);
+			}
 
-			dirty_ = false;
+			this->Dirty(false);
 		}
 	}
 
@@ -5746,7 +5921,8 @@ namespace KlayGE
 				target[i] = MathLib::transpose(value[i]);
 			}
 
-			data_.cbuff_desc.cbuff->Dirty(true);
+			data_.cbuff_desc.cbuff->DirtyRange(data_.cbuff_desc.offset,
+				static_cast<uint32_t>(value.size() * sizeof(float4x4)));
 		}
 		else
 		{
@@ -18,6 +18,7 @@
 
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Math.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/SceneManager.hpp>
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderEngine.hpp>
@@ -332,34 +333,34 @@ namespace KlayGE
 
 		this->UpdateTechniques();
 
-		mvp_param_ = deferred_effect_->ParameterByName("mvp");
-		model_view_param_ = deferred_effect_->ParameterByName("model_view");
-		forward_vec_param_ = deferred_effect_->ParameterByName("forward_vec");
-		frame_size_param_ = deferred_effect_->ParameterByName("frame_size");
-		height_offset_scale_param_ = deferred_effect_->ParameterByName("height_offset_scale");
-		tess_factors_param_ = deferred_effect_->ParameterByName("tess_factors");
-		pos_center_param_ = deferred_effect_->ParameterByName("pos_center");
-		pos_extent_param_ = deferred_effect_->ParameterByName("pos_extent");
-		tc_center_param_ = deferred_effect_->ParameterByName("tc_center");
-		tc_extent_param_ = deferred_effect_->ParameterByName("tc_extent");
-		albedo_map_enabled_param_ = deferred_effect_->ParameterByName("albedo_map_enabled");
-		albedo_tex_param_ = deferred_effect_->ParameterByName("albedo_tex");
-		albedo_clr_param_ = deferred_effect_->ParameterByName("albedo_clr");
-		metalness_clr_param_ = deferred_effect_->ParameterByName("metalness_clr");
-		metalness_tex_param_ = deferred_effect_->ParameterByName("metalness_tex");
-		glossiness_clr_param_ = deferred_effect_->ParameterByName("glossiness_clr");
-		glossiness_tex_param_ = deferred_effect_->ParameterByName("glossiness_tex");
-		emissive_tex_param_ = deferred_effect_->ParameterByName("emissive_tex");
-		emissive_clr_param_ = deferred_effect_->ParameterByName("emissive_clr");
-		normal_map_enabled_param_ = deferred_effect_->ParameterByName("normal_map_enabled");
-		normal_tex_param_ = deferred_effect_->ParameterByName("normal_tex");
-		height_map_parallax_enabled_param_ = deferred_effect_->ParameterByName("height_map_parallax_enabled");
-		height_map_tess_enabled_param_ = deferred_effect_->ParameterByName("height_map_tess_enabled");
-		height_tex_param_ = deferred_effect_->ParameterByName("height_tex");
-		opaque_depth_tex_param_ = deferred_effect_->ParameterByName("opaque_depth_tex");
+		mvp_param_ = deferred_effect_->ParameterByName(CT_HASH("mvp"));
+		model_view_param_ = deferred_effect_->ParameterByName(CT_HASH("model_view"));
+		forward_vec_param_ = deferred_effect_->ParameterByName(CT_HASH("forward_vec"));
+		frame_size_param_ = deferred_effect_->ParameterByName(CT_HASH("frame_size"));
+		height_offset_scale_param_ = deferred_effect_->ParameterByName(CT_HASH("height_offset_scale"));
+		tess_factors_param_ = deferred_effect_->ParameterByName(CT_HASH("tess_factors"));
+		pos_center_param_ = deferred_effect_->ParameterByName(CT_HASH("pos_center"));
+		pos_extent_param_ = deferred_effect_->ParameterByName(CT_HASH("pos_extent"));
+		tc_center_param_ = deferred_effect_->ParameterByName(CT_HASH("tc_center"));
+		tc_extent_param_ = deferred_effect_->ParameterByName(CT_HASH("tc_extent"));
+		albedo_map_enabled_param_ = deferred_effect_->ParameterByName(CT_HASH("albedo_map_enabled"));
+		albedo_tex_param_ = deferred_effect_->ParameterByName(CT_HASH("albedo_tex"));
+		albedo_clr_param_ = deferred_effect_->ParameterByName(CT_HASH("albedo_clr"));
+		metalness_clr_param_ = deferred_effect_->ParameterByName(CT_HASH("metalness_clr"));
+		metalness_tex_param_ = deferred_effect_->ParameterByName(CT_HASH("metalness_tex"));
+		glossiness_clr_param_ = deferred_effect_->ParameterByName(CT_HASH("glossiness_clr"));
+		glossiness_tex_param_ = deferred_effect_->ParameterByName(CT_HASH("glossiness_tex"));
+		emissive_tex_param_ = deferred_effect_->ParameterByName(CT_HASH("emissive_tex"));
+		emissive_clr_param_ = deferred_effect_->ParameterByName(CT_HASH("emissive_clr"));
+		normal_map_enabled_param_ = deferred_effect_->ParameterByName(CT_HASH("normal_map_enabled"));
+		normal_tex_param_ = deferred_effect_->ParameterByName(CT_HASH("normal_tex"));
+		height_map_parallax_enabled_param_ = deferred_effect_->ParameterByName(CT_HASH("height_map_parallax_enabled"));
+		height_map_tess_enabled_param_ = deferred_effect_->ParameterByName(CT_HASH("height_map_tess_enabled"));
+		height_tex_param_ = deferred_effect_->ParameterByName(CT_HASH("height_tex"));
+		opaque_depth_tex_param_ = deferred_effect_->ParameterByName(CT_HASH("opaque_depth_tex"));
 		reflection_tex_param_ = nullptr;
-		alpha_test_threshold_param_ = deferred_effect_->ParameterByName("alpha_test_threshold");
-		select_mode_object_id_param_ = deferred_effect_->ParameterByName("object_id");
+		alpha_test_threshold_param_ = deferred_effect_->ParameterByName(CT_HASH("alpha_test_threshold"));
+		select_mode_object_id_param_ = deferred_effect_->ParameterByName(CT_HASH("object_id"));
 	}
 
 	void Renderable::UpdateTechniques()
@@ -384,29 +385,29 @@ namespace KlayGE
 			{
 				if (sss)
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("SSSGBufferAlphaTestMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGBufferAlphaTestMRTTech"));
 				}
 				else
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferAlphaTestMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferAlphaTestMRTTech"));
 				}
 			}
 			else
 			{
 				if (sss)
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("SSSGBufferMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGBufferMRTTech"));
 				}
 				else
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferMRTTech"));
 				}
 			}
-			gbuffer_alpha_blend_back_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferAlphaBlendBackMRTTech");
-			gbuffer_alpha_blend_front_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferAlphaBlendFrontMRTTech");
-			special_shading_tech_ = deferred_effect_->TechniqueByName("SpecialShadingTech");
-			special_shading_alpha_blend_back_tech_ = deferred_effect_->TechniqueByName("SpecialShadingAlphaBlendBackTech");
-			special_shading_alpha_blend_front_tech_ = deferred_effect_->TechniqueByName("SpecialShadingAlphaBlendFrontTech");
+			gbuffer_alpha_blend_back_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferAlphaBlendBackMRTTech"));
+			gbuffer_alpha_blend_front_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferAlphaBlendFrontMRTTech"));
+			special_shading_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingTech"));
+			special_shading_alpha_blend_back_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingAlphaBlendBackTech"));
+			special_shading_alpha_blend_front_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingAlphaBlendFrontTech"));
 			break;
 		
 		case RenderMaterial::SDM_FlatTessellation:
@@ -414,29 +415,29 @@ namespace KlayGE
 			{
 				if (sss)
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("SSSGBufferFlatTessAlphaTestMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGBufferFlatTessAlphaTestMRTTech"));
 				}
 				else
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferFlatTessAlphaTestMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferFlatTessAlphaTestMRTTech"));
 				}
 			}
 			else
 			{
 				if (sss)
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("SSSGBufferFlatTessMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGBufferFlatTessMRTTech"));
 				}
 				else
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferFlatTessMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferFlatTessMRTTech"));
 				}
 			}
-			gbuffer_alpha_blend_back_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferFlatTessAlphaBlendBackMRTTech");
-			gbuffer_alpha_blend_front_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferFlatTessAlphaBlendFrontMRTTech");
-			special_shading_tech_ = deferred_effect_->TechniqueByName("SpecialShadingFlatTessTech");
-			special_shading_alpha_blend_back_tech_ = deferred_effect_->TechniqueByName("SpecialShadingFlatTessAlphaBlendBackTech");
-			special_shading_alpha_blend_front_tech_ = deferred_effect_->TechniqueByName("SpecialShadingFlatTessAlphaBlendFrontTech");
+			gbuffer_alpha_blend_back_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferFlatTessAlphaBlendBackMRTTech"));
+			gbuffer_alpha_blend_front_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferFlatTessAlphaBlendFrontMRTTech"));
+			special_shading_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingFlatTessTech"));
+			special_shading_alpha_blend_back_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingFlatTessAlphaBlendBackTech"));
+			special_shading_alpha_blend_front_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingFlatTessAlphaBlendFrontTech"));
 			break;
 
 		case RenderMaterial::SDM_SmoothTessellation:
@@ -444,29 +445,29 @@ namespace KlayGE
 			{
 				if (sss)
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("SSSGBufferSmoothTessAlphaTestMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGBufferSmoothTessAlphaTestMRTTech"));
 				}
 				else
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferSmoothTessAlphaTestMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferSmoothTessAlphaTestMRTTech"));
 				}
 			}
 			else
 			{
 				if (sss)
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("SSSGBufferSmoothTessMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGBufferSmoothTessMRTTech"));
 				}
 				else
 				{
-					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferSmoothTessMRTTech");
+					gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferSmoothTessMRTTech"));
 				}
 			}
-			gbuffer_alpha_blend_back_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferSmoothTessAlphaBlendBackMRTTech");
-			gbuffer_alpha_blend_front_mrt_tech_ = deferred_effect_->TechniqueByName("GBufferSmoothTessAlphaBlendFrontMRTTech");
-			special_shading_tech_ = deferred_effect_->TechniqueByName("SpecialShadingSmoothTessTech");
-			special_shading_alpha_blend_back_tech_ = deferred_effect_->TechniqueByName("SpecialShadingSmoothTessAlphaBlendBackTech");
-			special_shading_alpha_blend_front_tech_ = deferred_effect_->TechniqueByName("SpecialShadingSmoothTessAlphaBlendFrontTech");
+			gbuffer_alpha_blend_back_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferSmoothTessAlphaBlendBackMRTTech"));
+			gbuffer_alpha_blend_front_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GBufferSmoothTessAlphaBlendFrontMRTTech"));
+			special_shading_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingSmoothTessTech"));
+			special_shading_alpha_blend_back_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingSmoothTessAlphaBlendBackTech"));
+			special_shading_alpha_blend_front_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SpecialShadingSmoothTessAlphaBlendFrontTech"));
 			break;
 
 		default:
@@ -476,34 +477,34 @@ namespace KlayGE
 
 		if (this->AlphaTest())
 		{
-			gen_rsm_tech_ = deferred_effect_->TechniqueByName("GenReflectiveShadowMapAlphaTestTech");
+			gen_rsm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GenReflectiveShadowMapAlphaTestTech"));
 			if (sss)
 			{
-				gen_sm_tech_ = deferred_effect_->TechniqueByName("SSSGenShadowMapAlphaTestTech");
-				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName("SSSGenCascadedShadowMapAlphaTestTech");
+				gen_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGenShadowMapAlphaTestTech"));
+				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGenCascadedShadowMapAlphaTestTech"));
 			}
 			else
 			{
-				gen_sm_tech_ = deferred_effect_->TechniqueByName("GenShadowMapAlphaTestTech");
-				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName("GenCascadedShadowMapAlphaTestTech");
+				gen_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GenShadowMapAlphaTestTech"));
+				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GenCascadedShadowMapAlphaTestTech"));
 			}
 		}
 		else
 		{
-			gen_rsm_tech_ = deferred_effect_->TechniqueByName("GenReflectiveShadowMapTech");
+			gen_rsm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GenReflectiveShadowMapTech"));
 			if (sss)
 			{
-				gen_sm_tech_ = deferred_effect_->TechniqueByName("SSSGenShadowMapTech");
-				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName("SSSGenCascadedShadowMapTech");
+				gen_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGenShadowMapTech"));
+				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SSSGenCascadedShadowMapTech"));
 			}
 			else
 			{
-				gen_sm_tech_ = deferred_effect_->TechniqueByName("GenShadowMapTech");
-				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName("GenCascadedShadowMapTech");
+				gen_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GenShadowMapTech"));
+				gen_cascaded_sm_tech_ = deferred_effect_->TechniqueByName(CT_HASH("GenCascadedShadowMapTech"));
 			}
 		}
 
-		select_mode_tech_ = deferred_effect_->TechniqueByName("SelectModeTech");
+		select_mode_tech_ = deferred_effect_->TechniqueByName(CT_HASH("SelectModeTech"));
 	}
 
 	RenderTechnique* Renderable::PassTech(PassType type) const
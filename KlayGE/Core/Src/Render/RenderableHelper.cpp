@@ -28,6 +28,7 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Math.hpp>
 #include <KFL/Util.hpp>
+#include <KFL/Hash.hpp>
 #include <KlayGE/GraphicsBuffer.hpp>
 #include <KlayGE/RenderEffect.hpp>
 #include <KlayGE/Context.hpp>
@@ -110,10 +111,10 @@ namespace KlayGE
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
 		effect_ = SyncLoadRenderEffect("RenderableHelper.fxml");
-		technique_ = simple_forward_tech_ = effect_->TechniqueByName("PointTec");
-		v0_ep_ = effect_->ParameterByName("v0");
-		color_ep_ = effect_->ParameterByName("color");
-		mvp_param_ = effect_->ParameterByName("mvp");
+		technique_ = simple_forward_tech_ = effect_->TechniqueByName(CT_HASH("PointTec"));
+		v0_ep_ = effect_->ParameterByName(CT_HASH("v0"));
+		color_ep_ = effect_->ParameterByName(CT_HASH("color"));
+		mvp_param_ = effect_->ParameterByName(CT_HASH("mvp"));
 
 		rl_ = rf.MakeRenderLayout();
 		rl_->TopologyType(RenderLayout::TT_PointList);
@@ -124,8 +125,8 @@ namespace KlayGE
 
 		tc_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 
-		*(effect_->ParameterByName("pos_center")) = float3(0, 0, 0);
-		*(effect_->ParameterByName("pos_extent")) = float3(1, 1, 1);
+		*(effect_->ParameterByName(CT_HASH("pos_center"))) = float3(0, 0, 0);
+		*(effect_->ParameterByName(CT_HASH("pos_extent"))) = float3(1, 1, 1);
 
 		effect_attrs_ |= EA_SimpleForward;
 	}
@@ -174,11 +175,11 @@ namespace KlayGE
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
 		effect_ = SyncLoadRenderEffect("RenderableHelper.fxml");
-		technique_ = simple_forward_tech_ = effect_->TechniqueByName("LineTec");
-		v0_ep_ = effect_->ParameterByName("v0");
-		v1_ep_ = effect_->ParameterByName("v1");
-		color_ep_ = effect_->ParameterByName("color");
-		mvp_param_ = effect_->ParameterByName("mvp");
+		technique_ = simple_forward_tech_ = effect_->TechniqueByName(CT_HASH("LineTec"));
+		v0_ep_ = effect_->ParameterByName(CT_HASH("v0"));
+		v1_ep_ = effect_->ParameterByName(CT_HASH("v1"));
+		color_ep_ = effect_->ParameterByName(CT_HASH("color"));
+		mvp_param_ = effect_->ParameterByName(CT_HASH("mvp"));
 
 		float vertices[] =
 		{
@@ -193,8 +194,8 @@ namespace KlayGE
 
 		tc_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 
-		*(effect_->ParameterByName("pos_center")) = float3(0, 0, 0);
-		*(effect_->ParameterByName("pos_extent")) = float3(1, 1, 1);
+		*(effect_->ParameterByName(CT_HASH("pos_center"))) = float3(0, 0, 0);
+		*(effect_->ParameterByName(CT_HASH("pos_extent"))) = float3(1, 1, 1);
 
 		effect_attrs_ |= EA_SimpleForward;
 	}
@@ -244,12 +245,12 @@ namespace KlayGE
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
 		effect_ = SyncLoadRenderEffect("RenderableHelper.fxml");
-		technique_ = simple_forward_tech_ = effect_->TechniqueByName("LineTec");
-		v0_ep_ = effect_->ParameterByName("v0");
-		v1_ep_ = effect_->ParameterByName("v1");
-		v2_ep_ = effect_->ParameterByName("v2");
-		color_ep_ = effect_->ParameterByName("color");
-		mvp_param_ = effect_->ParameterByName("mvp");
+		technique_ = simple_forward_tech_ = effect_->TechniqueByName(CT_HASH("LineTec"));
+		v0_ep_ = effect_->ParameterByName(CT_HASH("v0"));
+		v1_ep_ = effect_->ParameterByName(CT_HASH("v1"));
+		v2_ep_ = effect_->ParameterByName(CT_HASH("v2"));
+		color_ep_ = effect_->ParameterByName(CT_HASH("color"));
+		mvp_param_ = effect_->ParameterByName(CT_HASH("mvp"));
 
 		float vertices[] =
 		{
@@ -264,8 +265,8 @@ namespace KlayGE
 
 		tc_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 
-		*(effect_->ParameterByName("pos_center")) = float3(0, 0, 0);
-		*(effect_->ParameterByName("pos_extent")) = float3(1, 1, 1);
+		*(effect_->ParameterByName(CT_HASH("pos_center"))) = float3(0, 0, 0);
+		*(effect_->ParameterByName(CT_HASH("pos_extent"))) = float3(1, 1, 1);
 
 		effect_attrs_ |= EA_SimpleForward;
 	}
@@ -316,17 +317,17 @@ namespace KlayGE
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
 		effect_ = SyncLoadRenderEffect("RenderableHelper.fxml");
-		technique_ = simple_forward_tech_ = effect_->TechniqueByName("LineTec");
-		v0_ep_ = effect_->ParameterByName("v0");
-		v1_ep_ = effect_->ParameterByName("v1");
-		v2_ep_ = effect_->ParameterByName("v2");
-		v3_ep_ = effect_->ParameterByName("v3");
-		v4_ep_ = effect_->ParameterByName("v4");
-		v5_ep_ = effect_->ParameterByName("v5");
-		v6_ep_ = effect_->ParameterByName("v6");
-		v7_ep_ = effect_->ParameterByName("v7");
-		color_ep_ = effect_->ParameterByName("color");
-		mvp_param_ = effect_->ParameterByName("mvp");
+		technique_ = simple_forward_tech_ = effect_->TechniqueByName(CT_HASH("LineTec"));
+		v0_ep_ = effect_->ParameterByName(CT_HASH("v0"));
+		v1_ep_ = effect_->ParameterByName(CT_HASH("v1"));
+		v2_ep_ = effect_->ParameterByName(CT_HASH("v2"));
+		v3_ep_ = effect_->ParameterByName(CT_HASH("v3"));
+		v4_ep_ = effect_->ParameterByName(CT_HASH("v4"));
+		v5_ep_ = effect_->ParameterByName(CT_HASH("v5"));
+		v6_ep_ = effect_->ParameterByName(CT_HASH("v6"));
+		v7_ep_ = effect_->ParameterByName(CT_HASH("v7"));
+		color_ep_ = effect_->ParameterByName(CT_HASH("color"));
+		mvp_param_ = effect_->ParameterByName(CT_HASH("mvp"));
 
 		float vertices[] =
 		{
@@ -354,8 +355,8 @@ namespace KlayGE
 
 		tc_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 
-		*(effect_->ParameterByName("pos_center")) = float3(0, 0, 0);
-		*(effect_->ParameterByName("pos_extent")) = float3(1, 1, 1);
+		*(effect_->ParameterByName(CT_HASH("pos_center"))) = float3(0, 0, 0);
+		*(effect_->ParameterByName(CT_HASH("pos_extent"))) = float3(1, 1, 1);
 
 		effect_attrs_ |= EA_SimpleForward;
 	}
@@ -406,17 +407,17 @@ namespace KlayGE
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
 		effect_ = SyncLoadRenderEffect("RenderableHelper.fxml");
-		technique_ = simple_forward_tech_ = effect_->TechniqueByName("LineTec");
-		v0_ep_ = effect_->ParameterByName("v0");
-		v1_ep_ = effect_->ParameterByName("v1");
-		v2_ep_ = effect_->ParameterByName("v2");
-		v3_ep_ = effect_->ParameterByName("v3");
-		v4_ep_ = effect_->ParameterByName("v4");
-		v5_ep_ = effect_->ParameterByName("v5");
-		v6_ep_ = effect_->ParameterByName("v6");
-		v7_ep_ = effect_->ParameterByName("v7");
-		color_ep_ = effect_->ParameterByName("color");
-		mvp_param_ = effect_->ParameterByName("mvp");
+		technique_ = simple_forward_tech_ = effect_->TechniqueByName(CT_HASH("LineTec"));
+		v0_ep_ = effect_->ParameterByName(CT_HASH("v0"));
+		v1_ep_ = effect_->ParameterByName(CT_HASH("v1"));
+		v2_ep_ = effect_->ParameterByName(CT_HASH("v2"));
+		v3_ep_ = effect_->ParameterByName(CT_HASH("v3"));
+		v4_ep_ = effect_->ParameterByName(CT_HASH("v4"));
+		v5_ep_ = effect_->ParameterByName(CT_HASH("v5"));
+		v6_ep_ = effect_->ParameterByName(CT_HASH("v6"));
+		v7_ep_ = effect_->ParameterByName(CT_HASH("v7"));
+		color_ep_ = effect_->ParameterByName(CT_HASH("color"));
+		mvp_param_ = effect_->ParameterByName(CT_HASH("mvp"));
 
 		float vertices[] =
 		{
@@ -441,8 +442,8 @@ namespace KlayGE
 
 		tc_aabb_ = AABBox(float3(0, 0, 0), float3(0, 0, 0));
 
-		*(effect_->ParameterByName("pos_center")) = float3(0, 0, 0);
-		*(effect_->ParameterByName("pos_extent")) = float3(1, 1, 1);
+		*(effect_->ParameterByName(CT_HASH("pos_center"))) = float3(0, 0, 0);
+		*(effect_->ParameterByName(CT_HASH("pos_extent"))) = float3(1, 1, 1);
 
 		effect_attrs_ |= EA_SimpleForward;
 	}
@@ -559,7 +560,7 @@ namespace KlayGE
 	{
 		this->BindDeferredEffect(SyncLoadRenderEffect("Decal.fxml"));
 
-		gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName("DecalGBufferAlphaTestMRTTech");
+		gbuffer_mrt_tech_ = deferred_effect_->TechniqueByName(CT_HASH("DecalGBufferAlphaTestMRTTech"));
 		technique_ = gbuffer_mrt_tech_;
 
 		pos_aabb_ = AABBox(float3(-1, -1, -1), float3(1, 1, 1));
@@ -594,8 +595,8 @@ namespace KlayGE
 		model_mat_ = float4x4::Identity();
 		effect_attrs_ |= EA_AlphaTest;
 
-		inv_mv_ep_ = effect_->ParameterByName("inv_mv");
-		g_buffer_rt0_tex_param_ = effect_->ParameterByName("g_buffer_rt0_tex");
+		inv_mv_ep_ = effect_->ParameterByName(CT_HASH("inv_mv"));
+		g_buffer_rt0_tex_param_ = effect_->ParameterByName(CT_HASH("g_buffer_rt0_tex"));
 
 		textures_[RenderMaterial::TS_Normal] = normal_tex;
 		textures_[RenderMaterial::TS_Albedo] = albedo_tex;
@@ -293,6 +293,29 @@ namespace KlayGE
 	{
 	}
 
+	bool ShaderObject::StreamIn(ResIdentifierPtr const & res, ShaderType type, RenderEffect const & effect,
+		std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids)
+	{
+		uint32_t len;
+		res->read(&len, sizeof(len));
+		len = LE2Native(len);
+
+		// The native shader block of a memory backed kfx is parsed in place
+		uint8_t const * native_shader_block = static_cast<uint8_t const *>(res->read_in_place(len));
+		std::vector<uint8_t> native_shader_block_buff;
+		if (!native_shader_block)
+		{
+			native_shader_block_buff.resize(len);
+			if (len > 0)
+			{
+				res->read(&native_shader_block_buff[0], len * sizeof(native_shader_block_buff[0]));
+			}
+			native_shader_block = native_shader_block_buff.data();
+		}
+
+		return this->AttachNativeShader(type, effect, shader_desc_ids, native_shader_block, len);
+	}
+
 #if KLAYGE_IS_DEV_PLATFORM
 	std::vector<uint8_t> ShaderObject::CompileToDXBC(ShaderType type, RenderEffect const & effect,
 			RenderTechnique const & tech, RenderPass const & pass,
@@ -32,7 +32,9 @@
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Texture.hpp>
+#include <KFL/TaskScheduler.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <cstring>
 
@@ -40,6 +42,20 @@
 
 namespace KlayGE
 {
+	void TexCompression::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		uint32_t const in_block_size = block_width_ * block_height_ * NumFormatBytes(decoded_fmt_);
+
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+		for (uint32_t i = 0; i < num_blocks; ++ i)
+		{
+			this->EncodeBlock(dst, src, method);
+			dst += block_bytes_;
+			src += in_block_size;
+		}
+	}
+
 	void TexCompression::EncodeMem(uint32_t width, uint32_t height,
 		void* output, uint32_t out_row_pitch, uint32_t out_slice_pitch,
 		void const * input, uint32_t in_row_pitch, uint32_t in_slice_pitch,
@@ -48,38 +64,63 @@ namespace KlayGE
 		KFL_UNUSED(out_slice_pitch);
 		KFL_UNUSED(in_slice_pitch);
 
+		uint32_t const num_blocks_x = (width + block_width_ - 1) / block_width_;
+		uint32_t const num_blocks_y = (height + block_height_ - 1) / block_height_;
+
+		auto encode_rows = [&](uint32_t row_begin, uint32_t row_end)
+		{
+			this->EncodeBlockRows(width, height, row_begin, row_end, output, out_row_pitch, input, in_row_pitch, method);
+		};
+		if (thread_safe_encoding_ && (num_blocks_y > 1))
+		{
+			// Around 64 blocks per task at least
+			uint32_t const grain_size = std::max(64 / std::max(num_blocks_x, 1U), 1U);
+			Context::Instance().TaskScheduler().parallel_for(0, num_blocks_y, grain_size, encode_rows);
+		}
+		else
+		{
+			encode_rows(0, num_blocks_y);
+		}
+	}
+
+	void TexCompression::EncodeBlockRows(uint32_t width, uint32_t height, uint32_t row_begin, uint32_t row_end,
+		void* output, uint32_t out_row_pitch, void const * input, uint32_t in_row_pitch,
+		TexCompressionMethod method)
+	{
 		uint32_t const elem_size = NumFormatBytes(decoded_fmt_);
+		uint32_t const block_row_bytes = block_width_ * elem_size;
+		uint32_t const in_block_size = block_height_ * block_row_bytes;
+		uint32_t const num_blocks_x = (width + block_width_ - 1) / block_width_;
 
 		uint8_t const * src = static_cast<uint8_t const *>(input);
 
-		std::vector<uint8_t> uncompressed(block_width_ * block_height_ * elem_size);
-		for (uint32_t y_base = 0; y_base < height; y_base += block_height_)
+		// A whole row of blocks is gathered, and encoded in one call. Texels out of the image are 0.
+		std::vector<uint8_t> uncompressed(num_blocks_x * in_block_size);
+		for (uint32_t by = row_begin; by < row_end; ++ by)
 		{
-			uint8_t* dst = static_cast<uint8_t*>(output) + (y_base / block_height_) * out_row_pitch;
-
-			for (uint32_t x_base = 0; x_base < width; x_base += block_width_)
+			uint32_t const y_base = by * block_height_;
+			for (uint32_t bx = 0; bx < num_blocks_x; ++ bx)
 			{
+				uint32_t const x_base = bx * block_width_;
+				uint32_t const copy_bytes = std::min(block_width_, width - x_base) * elem_size;
+
+				uint8_t* block = &uncompressed[bx * in_block_size];
 				for (uint32_t y = 0; y < block_height_; ++ y)
 				{
-					for (uint32_t x = 0; x < block_width_; ++ x)
+					uint8_t* block_row = block + y * block_row_bytes;
+					if (y_base + y < height)
+					{
+						memcpy(block_row, &src[(y_base + y) * in_row_pitch + x_base * elem_size], copy_bytes);
+						memset(block_row + copy_bytes, 0, block_row_bytes - copy_bytes);
+					}
+					else
 					{
-						if ((x_base + x < width) && (y_base + y < height))
-						{
-							memcpy(&uncompressed[(y * block_width_ + x) * elem_size],
-								&src[(y_base + y) * in_row_pitch + (x_base + x) * elem_size],
-								elem_size);
-						}
-						else
-						{
-							memset(&uncompressed[(y * block_width_ + x) * elem_size],
-								0, elem_size);
-						}
+						memset(block_row, 0, block_row_bytes);
 					}
 				}
-
-				this->EncodeBlock(dst, &uncompressed[0], method);
-				dst += block_bytes_;
 			}
+
+			this->EncodeBlocks(static_cast<uint8_t*>(output) + by * out_row_pitch, &uncompressed[0], num_blocks_x, method);
 		}
 	}
 
@@ -879,6 +879,247 @@ namespace
 			break;
 		}
 	}
+
+	uint32_t const BC4_BATCH_LANES = 8;
+
+	// Encodes up to BC4_BATCH_LANES BC4 blocks side by side, with exactly the same integer math as
+	//  TexCompressionBC4::EncodeBlock. The texels are transposed, so every step runs over the same texel of all the
+	//  blocks, and compiles to SIMD instructions. Blocks of the input are 16 bytes each, blocks of the output are
+	//  out_stride bytes apart.
+	void EncodeBC4Lanes(uint8_t* output, uint32_t out_stride, uint8_t const * input, uint32_t num_lanes)
+	{
+		BOOST_ASSERT(num_lanes <= BC4_BATCH_LANES);
+
+		int32_t texels[16][BC4_BATCH_LANES];
+		for (uint32_t lane = 0; lane < num_lanes; ++ lane)
+		{
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				texels[i][lane] = input[lane * 16 + i];
+			}
+		}
+
+		int32_t min[BC4_BATCH_LANES];
+		int32_t max[BC4_BATCH_LANES];
+		for (uint32_t lane = 0; lane < num_lanes; ++ lane)
+		{
+			min[lane] = max[lane] = texels[0][lane];
+		}
+		for (uint32_t i = 1; i < 16; ++ i)
+		{
+			for (uint32_t lane = 0; lane < num_lanes; ++ lane)
+			{
+				min[lane] = std::min(min[lane], texels[i][lane]);
+				max[lane] = std::max(max[lane], texels[i][lane]);
+			}
+		}
+
+		int32_t dist[BC4_BATCH_LANES];
+		int32_t bias[BC4_BATCH_LANES];
+		for (uint32_t lane = 0; lane < num_lanes; ++ lane)
+		{
+			dist[lane] = max[lane] - min[lane];
+			bias[lane] = min[lane] * 7 - (dist[lane] >> 1);
+		}
+
+		uint64_t indices[BC4_BATCH_LANES] = { 0 };
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			for (uint32_t lane = 0; lane < num_lanes; ++ lane)
+			{
+				int32_t const dist4 = dist[lane] * 4;
+				int32_t const dist2 = dist[lane] * 2;
+				int32_t a = texels[i][lane] * 7 - bias[lane];
+				int32_t ind, t;
+
+				t = (dist4 - a) >> 31;  ind = t & 4; a -= dist4 & t;
+				t = (dist2 - a) >> 31;  ind += t & 2; a -= dist2 & t;
+				t = (dist[lane] - a) >> 31;   ind += t & 1;
+
+				ind = -ind & 7;
+				ind ^= (2 > ind);
+
+				indices[lane] |= static_cast<uint64_t>(ind) << (i * 3);
+			}
+		}
+
+		for (uint32_t lane = 0; lane < num_lanes; ++ lane)
+		{
+			BC4Block& bc4 = *reinterpret_cast<BC4Block*>(output + lane * out_stride);
+			bc4.alpha_0 = static_cast<uint8_t>(max[lane]);
+			bc4.alpha_1 = static_cast<uint8_t>(min[lane]);
+			for (uint32_t i = 0; i < 6; ++ i)
+			{
+				bc4.bitmap[i] = static_cast<uint8_t>(indices[lane] >> (i * 8));
+			}
+		}
+	}
+
+	uint32_t const BC6_NUM_SHAPES = 32;
+
+	// Half bits as an integer, in the domain FinishUnquantize outputs. Infinities and NaNs go to the largest finite value.
+	int F16ToBC6Int(uint16_t bits, bool signed_fmt)
+	{
+		int const mag = std::min(bits & 0x7FFF, 0x7BFF);
+		if (bits & 0x8000)
+		{
+			return signed_fmt ? -mag : 0;
+		}
+		else
+		{
+			return mag;
+		}
+	}
+
+	// The smallest value FinishUnquantize maps back to comp. Interpolation is linear in this domain.
+	int BC6IntToUnquantized(int comp, bool signed_fmt)
+	{
+		if (signed_fmt)
+		{
+			return (comp < 0) ? -((-comp * 32 + 30) / 31) : (comp * 32 + 30) / 31;
+		}
+		else
+		{
+			return (comp * 64 + 30) / 31;
+		}
+	}
+
+	void BC6QuantizedRange(uint8_t prec, bool signed_fmt, int& lo, int& hi)
+	{
+		if (signed_fmt)
+		{
+			hi = (prec >= 16) ? 0x7FFF : (1 << (prec - 1)) - 1;
+			lo = -hi;
+		}
+		else
+		{
+			hi = (1 << prec) - 1;
+			lo = 0;
+		}
+	}
+
+	uint8_t ChannelPrec(ARGBColor32 const & prec, uint32_t ch)
+	{
+		// x, y, z are r, g, b
+		return prec[ARGBColor32::RChannel - ch];
+	}
+
+	uint32_t AnchorOffset(uint32_t partitions, uint32_t shape, uint32_t region)
+	{
+		return (partitions > 1) ? (FIX_UP_TABLE[partitions - 2][shape] >> (region * 4)) & 0xF : 0;
+	}
+
+	// Fits a line through the texels of a region with the principal axis, in the unquantized domain. The first end is
+	//  the one closer to the anchor texel, so its index is more likely to fit in the shortened anchor index.
+	void FitBC6Region(int3 const * texels, uint32_t partitions, uint32_t shape, uint32_t region,
+		std::pair<float3, float3>& end_pts)
+	{
+		float3 mean(0, 0, 0);
+		float3 min_clr(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+		float3 max_clr(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+		uint32_t num = 0;
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			if (GetPartition(partitions, shape, i) == region)
+			{
+				float3 const p(static_cast<float>(texels[i].x()), static_cast<float>(texels[i].y()),
+					static_cast<float>(texels[i].z()));
+				mean += p;
+				min_clr = MathLib::minimize(min_clr, p);
+				max_clr = MathLib::maximize(max_clr, p);
+				++ num;
+			}
+		}
+		BOOST_ASSERT(num > 0);
+		mean /= static_cast<float>(num);
+
+		float cov[6] = { 0, 0, 0, 0, 0, 0 };
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			if (GetPartition(partitions, shape, i) == region)
+			{
+				float3 const d = float3(static_cast<float>(texels[i].x()), static_cast<float>(texels[i].y()),
+					static_cast<float>(texels[i].z())) - mean;
+				cov[0] += d.x() * d.x();
+				cov[1] += d.x() * d.y();
+				cov[2] += d.x() * d.z();
+				cov[3] += d.y() * d.y();
+				cov[4] += d.y() * d.z();
+				cov[5] += d.z() * d.z();
+			}
+		}
+
+		// Power iteration, starting from the diagonal of the bounding box
+		float3 axis = max_clr - min_clr;
+		for (int iter = 0; iter < 8; ++ iter)
+		{
+			float3 const next(cov[0] * axis.x() + cov[1] * axis.y() + cov[2] * axis.z(),
+				cov[1] * axis.x() + cov[3] * axis.y() + cov[4] * axis.z(),
+				cov[2] * axis.x() + cov[4] * axis.y() + cov[5] * axis.z());
+			float const len = MathLib::length(next);
+			if (len < 1e-6f)
+			{
+				break;
+			}
+			axis = next / len;
+		}
+		float const axis_len = MathLib::length(axis);
+		if (axis_len < 1e-6f)
+		{
+			end_pts.first = end_pts.second = mean;
+			return;
+		}
+		axis /= axis_len;
+
+		float t_min = std::numeric_limits<float>::max();
+		float t_max = -std::numeric_limits<float>::max();
+		float t_anchor = 0;
+		uint32_t const anchor = AnchorOffset(partitions, shape, region);
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			if (GetPartition(partitions, shape, i) == region)
+			{
+				float const t = MathLib::dot(float3(static_cast<float>(texels[i].x()), static_cast<float>(texels[i].y()),
+					static_cast<float>(texels[i].z())) - mean, axis);
+				t_min = std::min(t_min, t);
+				t_max = std::max(t_max, t);
+				if (i == anchor)
+				{
+					t_anchor = t;
+				}
+			}
+		}
+
+		end_pts.first = mean + axis * t_min;
+		end_pts.second = mean + axis * t_max;
+		if (t_anchor - t_min > t_max - t_anchor)
+		{
+			std::swap(end_pts.first, end_pts.second);
+		}
+	}
+
+	// Error of snapping the texels onto 8 evenly spaced points of the fitted lines. Used for ranking the shapes.
+	float EstimateBC6ShapeError(int3 const * texels, uint32_t shape, std::pair<float3, float3> const * end_pts)
+	{
+		float error = 0;
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			std::pair<float3, float3> const & ep = end_pts[GetPartition(2, shape, i)];
+			float3 const p(static_cast<float>(texels[i].x()), static_cast<float>(texels[i].y()),
+				static_cast<float>(texels[i].z()));
+			float3 const dir = ep.second - ep.first;
+			float const len_sq = MathLib::dot(dir, dir);
+			float t = 0;
+			if (len_sq > 0)
+			{
+				t = MathLib::clamp(MathLib::dot(p - ep.first, dir) / len_sq, 0.0f, 1.0f);
+				t = MathLib::round(t * 7) / 7;
+			}
+			float3 const d = ep.first + dir * t - p;
+			error += MathLib::dot(d, d);
+		}
+		return error;
+	}
 }
 
 namespace KlayGE
@@ -897,6 +1138,7 @@ namespace KlayGE
 		block_depth_ = 1;
 		block_bytes_ = NumFormatBytes(EF_BC1) * 4;
 		decoded_fmt_ = EF_ARGB8;
+		thread_safe_encoding_ = true;
 
 		if (!lut_inited_)
 		{
@@ -1440,6 +1682,7 @@ namespace KlayGE
 		block_depth_ = 1;
 		block_bytes_ = NumFormatBytes(EF_BC2) * 4;
 		decoded_fmt_ = EF_ARGB8;
+		thread_safe_encoding_ = true;
 	}
 
 	void TexCompressionBC2::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
@@ -1494,6 +1737,7 @@ namespace KlayGE
 		block_depth_ = 1;
 		block_bytes_ = NumFormatBytes(EF_BC3) * 4;
 		decoded_fmt_ = EF_ARGB8;
+		thread_safe_encoding_ = true;
 	}
 
 	void TexCompressionBC3::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
@@ -1517,6 +1761,36 @@ namespace KlayGE
 		bc4_codec_.EncodeBlock(&bc3.alpha, &alpha[0], method);
 	}
 
+	void TexCompressionBC3::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		BC3Block* bc3 = static_cast<BC3Block*>(output);
+		ARGBColor32 const * argb = static_cast<ARGBColor32 const *>(input);
+
+		std::array<uint8_t, 16 * BC4_BATCH_LANES> alpha;
+		std::array<ARGBColor32, 16> xrgb;
+		for (uint32_t base = 0; base < num_blocks; base += BC4_BATCH_LANES)
+		{
+			uint32_t const num_lanes = std::min(num_blocks - base, BC4_BATCH_LANES);
+			for (uint32_t lane = 0; lane < num_lanes; ++ lane)
+			{
+				ARGBColor32 const * block_argb = argb + (base + lane) * 16;
+				for (size_t i = 0; i < xrgb.size(); ++ i)
+				{
+					xrgb[i] = block_argb[i];
+					xrgb[i].a() = 255;
+					alpha[lane * 16 + i] = static_cast<uint8_t>(block_argb[i].a());
+				}
+
+				bc1_codec_.EncodeBC1Internal(bc3[base + lane].bc1, &xrgb[0], false, method);
+			}
+
+			EncodeBC4Lanes(reinterpret_cast<uint8_t*>(&bc3[base].alpha), sizeof(BC3Block), &alpha[0], num_lanes);
+		}
+	}
+
 	void TexCompressionBC3::DecodeBlock(void* output, void const * input)
 	{
 		BOOST_ASSERT(output);
@@ -1543,6 +1817,7 @@ namespace KlayGE
 		block_depth_ = 1;
 		block_bytes_ = NumFormatBytes(EF_BC4) * 4;
 		decoded_fmt_ = EF_R8;
+		thread_safe_encoding_ = true;
 	}
 
 	// Alpha block compression (this is easy for a change)
@@ -1603,6 +1878,22 @@ namespace KlayGE
 		}
 	}
 
+	void TexCompressionBC4::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		KFL_UNUSED(method);
+
+		uint8_t* bc4 = static_cast<uint8_t*>(output);
+		uint8_t const * r = static_cast<uint8_t const *>(input);
+		for (uint32_t base = 0; base < num_blocks; base += BC4_BATCH_LANES)
+		{
+			EncodeBC4Lanes(bc4 + base * sizeof(BC4Block), sizeof(BC4Block), r + base * 16,
+				std::min(num_blocks - base, BC4_BATCH_LANES));
+		}
+	}
+
 	void TexCompressionBC4::DecodeBlock(void* output, void const * input)
 	{
 		BOOST_ASSERT(output);
@@ -1652,6 +1943,7 @@ namespace KlayGE
 		block_depth_ = 1;
 		block_bytes_ = NumFormatBytes(EF_BC5) * 4;
 		decoded_fmt_ = EF_GR8;
+		thread_safe_encoding_ = true;
 	}
 
 	void TexCompressionBC5::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
@@ -1674,6 +1966,33 @@ namespace KlayGE
 		bc4_codec_.EncodeBlock(&bc5.green, &g[0], method);
 	}
 
+	void TexCompressionBC5::EncodeBlocks(void* output, void const * input, uint32_t num_blocks, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		KFL_UNUSED(method);
+
+		BC5Block* bc5 = static_cast<BC5Block*>(output);
+		uint16_t const * gr = static_cast<uint16_t const *>(input);
+
+		std::array<uint8_t, 16 * BC4_BATCH_LANES> r;
+		std::array<uint8_t, 16 * BC4_BATCH_LANES> g;
+		for (uint32_t base = 0; base < num_blocks; base += BC4_BATCH_LANES)
+		{
+			uint32_t const num_lanes = std::min(num_blocks - base, BC4_BATCH_LANES);
+			for (uint32_t i = 0; i < num_lanes * 16; ++ i)
+			{
+				uint16_t const texel = gr[base * 16 + i];
+				r[i] = texel & 0xFF;
+				g[i] = texel >> 8;
+			}
+
+			EncodeBC4Lanes(reinterpret_cast<uint8_t*>(&bc5[base].red), sizeof(BC5Block), &r[0], num_lanes);
+			EncodeBC4Lanes(reinterpret_cast<uint8_t*>(&bc5[base].green), sizeof(BC5Block), &g[0], num_lanes);
+		}
+	}
+
 	void TexCompressionBC5::DecodeBlock(void* output, void const * input)
 	{
 		BOOST_ASSERT(output);
@@ -1959,11 +2278,113 @@ namespace KlayGE
 
 	void TexCompressionBC6U::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
-		KFL_UNUSED(output);
-		KFL_UNUSED(input);
-		KFL_UNUSED(method);
+		this->EncodeBC6Internal(output, input, method, false);
+	}
+
+	void TexCompressionBC6U::EncodeBC6Internal(void* output, void const * input, TexCompressionMethod method, bool signed_fmt)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		uint16_t const * abgr = static_cast<uint16_t const *>(input);
+
+		int3 texels[16];
+		int3 unq_texels[16];
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			for (uint32_t ch = 0; ch < 3; ++ ch)
+			{
+				texels[i][ch] = F16ToBC6Int(abgr[i * 4 + ch], signed_fmt);
+				unq_texels[i][ch] = BC6IntToUnquantized(texels[i][ch], signed_fmt);
+			}
+		}
+
+		uint32_t const num_modes = sizeof(mode_info_) / sizeof(mode_info_[0]);
+		std::array<CompressParams, num_modes> mode_best;
+		for (auto& params : mode_best)
+		{
+			params.error = std::numeric_limits<uint64_t>::max();
+		}
+
+		std::pair<float3, float3> end_pts[BC6_MAX_REGIONS];
+		FitBC6Region(unq_texels, 1, 0, 0, end_pts[0]);
+		for (uint32_t mode_index = 0; mode_index < num_modes; ++ mode_index)
+		{
+			if (1 == mode_info_[mode_index].partitions)
+			{
+				this->TryMode(mode_index, 0, end_pts, texels, signed_fmt, mode_best[mode_index]);
+			}
+		}
+
+		// Rank the shapes by the error of the fitted lines, and only try the modes on the most promising ones
+		std::array<std::array<std::pair<float3, float3>, BC6_MAX_REGIONS>, BC6_NUM_SHAPES> shape_end_pts;
+		std::array<std::pair<float, uint32_t>, BC6_NUM_SHAPES> shape_errors;
+		for (uint32_t shape = 0; shape < BC6_NUM_SHAPES; ++ shape)
+		{
+			for (uint32_t region = 0; region < BC6_MAX_REGIONS; ++ region)
+			{
+				FitBC6Region(unq_texels, 2, shape, region, shape_end_pts[shape][region]);
+			}
+			shape_errors[shape] = std::make_pair(EstimateBC6ShapeError(unq_texels, shape, &shape_end_pts[shape][0]), shape);
+		}
+
+		uint32_t num_shapes;
+		switch (method)
+		{
+		case TCM_Speed:
+			num_shapes = 1;
+			break;
+
+		case TCM_Balanced:
+			num_shapes = 4;
+			break;
+
+		default:
+			num_shapes = BC6_NUM_SHAPES;
+			break;
+		}
+		std::partial_sort(shape_errors.begin(), shape_errors.begin() + num_shapes, shape_errors.end());
+
+		for (uint32_t i = 0; i < num_shapes; ++ i)
+		{
+			uint32_t const shape = shape_errors[i].second;
+			for (uint32_t mode_index = 0; mode_index < num_modes; ++ mode_index)
+			{
+				if (2 == mode_info_[mode_index].partitions)
+				{
+					this->TryMode(mode_index, shape, &shape_end_pts[shape][0], texels, signed_fmt, mode_best[mode_index]);
+				}
+			}
+		}
+
+		uint32_t best_mode = 0;
+		for (uint32_t mode_index = 1; mode_index < num_modes; ++ mode_index)
+		{
+			if (mode_best[mode_index].error < mode_best[best_mode].error)
+			{
+				best_mode = mode_index;
+			}
+		}
+
+		// Balanced only refines the winner. Quality refines the best candidate of every mode, since a mode with coarser
+		//  initial end points can overtake it.
+		if (TCM_Balanced == method)
+		{
+			this->RefineEndpoints(mode_best[best_mode], texels, signed_fmt);
+		}
+		else if (TCM_Quality == method)
+		{
+			for (uint32_t mode_index = 0; mode_index < num_modes; ++ mode_index)
+			{
+				this->RefineEndpoints(mode_best[mode_index], texels, signed_fmt);
+				if (mode_best[mode_index].error < mode_best[best_mode].error)
+				{
+					best_mode = mode_index;
+				}
+			}
+		}
 
-		// TODO
+		this->PackBC6Block(output, mode_best[best_mode]);
 	}
 
 	void TexCompressionBC6U::DecodeBlock(void* output, void const * input)
@@ -2130,6 +2551,51 @@ namespace KlayGE
 		}
 	}
 
+	int TexCompressionBC6U::Quantize(int comp, uint8_t bits_per_comp, bool signed_fmt)
+	{
+		int lo, hi;
+		BC6QuantizedRange(bits_per_comp, signed_fmt, lo, hi);
+
+		int q;
+		if (signed_fmt)
+		{
+			if (bits_per_comp >= 16)
+			{
+				q = comp;
+			}
+			else
+			{
+				q = (comp < 0) ? -(-comp >> (16 - bits_per_comp)) : comp >> (16 - bits_per_comp);
+			}
+		}
+		else
+		{
+			if (bits_per_comp >= 15)
+			{
+				q = comp;
+			}
+			else
+			{
+				q = comp >> (16 - bits_per_comp);
+			}
+		}
+
+		// Unquantize rounds, so one of the neighbors can be closer
+		int best_q = MathLib::clamp(q, lo, hi);
+		int best_diff = std::abs(this->Unquantize(best_q, bits_per_comp, signed_fmt) - comp);
+		for (int c = std::max(q - 1, lo); c <= std::min(q + 1, hi); ++ c)
+		{
+			int const diff = std::abs(this->Unquantize(c, bits_per_comp, signed_fmt) - comp);
+			if (diff < best_diff)
+			{
+				best_diff = diff;
+				best_q = c;
+			}
+		}
+
+		return best_q;
+	}
+
 	int TexCompressionBC6U::Unquantize(int comp, uint8_t bits_per_comp, bool signed_fmt)
 	{
 		int unq = 0;
@@ -2202,6 +2668,271 @@ namespace KlayGE
 		}
 	}
 
+	void TexCompressionBC6U::TryMode(uint32_t mode_index, uint32_t shape, std::pair<float3, float3> const * fitted_end_pts,
+		int3 const * texels, bool signed_fmt, CompressParams& best)
+	{
+		ModeInfo const & info = mode_info_[mode_index];
+
+		int const unq_lo = signed_fmt ? -0x7FFF : 0;
+		int const unq_hi = signed_fmt ? 0x7FFF : 0xFFFF;
+
+		CompressParams params;
+		params.mode_index = mode_index;
+		params.shape = shape;
+		for (uint32_t p = 0; p < info.partitions; ++ p)
+		{
+			for (uint32_t ch = 0; ch < 3; ++ ch)
+			{
+				uint8_t const prec = ChannelPrec(info.rgba_prec[0][0], ch);
+				params.end_pts[p].first[ch] = this->Quantize(MathLib::clamp(static_cast<int>(MathLib::round(fitted_end_pts[p].first[ch])),
+					unq_lo, unq_hi), prec, signed_fmt);
+				params.end_pts[p].second[ch] = this->Quantize(MathLib::clamp(static_cast<int>(MathLib::round(fitted_end_pts[p].second[ch])),
+					unq_lo, unq_hi), prec, signed_fmt);
+			}
+		}
+		for (uint32_t p = info.partitions; p < BC6_MAX_REGIONS; ++ p)
+		{
+			params.end_pts[p].first = params.end_pts[p].second = int3(0, 0, 0);
+		}
+
+		if (info.transformed)
+		{
+			this->ClampEndpointsToDeltas(params);
+		}
+
+		this->AssignIndices(params, texels, signed_fmt);
+		if (params.error < best.error)
+		{
+			best = params;
+		}
+	}
+
+	void TexCompressionBC6U::ClampEndpointsToDeltas(CompressParams& params) const
+	{
+		ModeInfo const & info = mode_info_[params.mode_index];
+		BOOST_ASSERT(info.transformed);
+
+		int3 const & base = params.end_pts[0].first;
+		int3* deltas[] = { &params.end_pts[0].second, &params.end_pts[1].first, &params.end_pts[1].second };
+		ARGBColor32 const * delta_precs[] = { &info.rgba_prec[0][1], &info.rgba_prec[1][0], &info.rgba_prec[1][1] };
+		uint32_t const num_deltas = info.partitions * 2 - 1;
+		for (uint32_t i = 0; i < num_deltas; ++ i)
+		{
+			for (uint32_t ch = 0; ch < 3; ++ ch)
+			{
+				uint8_t const prec = ChannelPrec(*delta_precs[i], ch);
+				int const delta = MathLib::clamp((*deltas[i])[ch] - base[ch], -(1 << (prec - 1)), (1 << (prec - 1)) - 1);
+				(*deltas[i])[ch] = base[ch] + delta;
+			}
+		}
+	}
+
+	bool TexCompressionBC6U::EndpointsFitDeltas(CompressParams const & params) const
+	{
+		ModeInfo const & info = mode_info_[params.mode_index];
+		if (!info.transformed)
+		{
+			return true;
+		}
+
+		int3 const & base = params.end_pts[0].first;
+		int3 const * deltas[] = { &params.end_pts[0].second, &params.end_pts[1].first, &params.end_pts[1].second };
+		ARGBColor32 const * delta_precs[] = { &info.rgba_prec[0][1], &info.rgba_prec[1][0], &info.rgba_prec[1][1] };
+		uint32_t const num_deltas = info.partitions * 2 - 1;
+		for (uint32_t i = 0; i < num_deltas; ++ i)
+		{
+			for (uint32_t ch = 0; ch < 3; ++ ch)
+			{
+				uint8_t const prec = ChannelPrec(*delta_precs[i], ch);
+				int const delta = (*deltas[i])[ch] - base[ch];
+				if ((delta < -(1 << (prec - 1))) || (delta > (1 << (prec - 1)) - 1))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	uint64_t TexCompressionBC6U::AssignIndices(CompressParams& params, int3 const * texels, bool signed_fmt)
+	{
+		ModeInfo const & info = mode_info_[params.mode_index];
+		uint32_t const num_indices = 1U << info.index_prec;
+		int const * weights = BC67_PREC_WEIGHTS[1 + (1 == info.partitions)];
+
+		int3 palette[BC6_MAX_REGIONS][BC6_MAX_INDICES];
+		for (uint32_t p = 0; p < info.partitions; ++ p)
+		{
+			int3 unq_first, unq_second;
+			for (uint32_t ch = 0; ch < 3; ++ ch)
+			{
+				uint8_t const prec = ChannelPrec(info.rgba_prec[0][0], ch);
+				unq_first[ch] = this->Unquantize(params.end_pts[p].first[ch], prec, signed_fmt);
+				unq_second[ch] = this->Unquantize(params.end_pts[p].second[ch], prec, signed_fmt);
+			}
+			for (uint32_t j = 0; j < num_indices; ++ j)
+			{
+				for (uint32_t ch = 0; ch < 3; ++ ch)
+				{
+					palette[p][j][ch] = this->FinishUnquantize((unq_first[ch] * (BC6_WEIGHT_MAX - weights[j])
+						+ unq_second[ch] * weights[j] + BC6_WEIGHT_ROUND) >> BC6_WEIGHT_SHIFT, signed_fmt);
+				}
+			}
+		}
+
+		auto closest = [&palette, texels](uint32_t region, uint32_t texel, uint32_t max_index, uint64_t& err)
+		{
+			uint8_t index = 0;
+			err = std::numeric_limits<uint64_t>::max();
+			for (uint32_t j = 0; j < max_index; ++ j)
+			{
+				int3 const d = palette[region][j] - texels[texel];
+				uint64_t const e = static_cast<int64_t>(d.x()) * d.x() + static_cast<int64_t>(d.y()) * d.y()
+					+ static_cast<int64_t>(d.z()) * d.z();
+				if (e < err)
+				{
+					err = e;
+					index = static_cast<uint8_t>(j);
+				}
+			}
+			return index;
+		};
+
+		uint64_t texel_errors[16];
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			params.indices[i] = closest(GetPartition(info.partitions, params.shape, i), i, num_indices, texel_errors[i]);
+		}
+
+		// The MSB of an anchor index is implicitly 0. Swapping the end points of a region gives the same palette in reverse
+		//  order, as long as the deltas still fit. Otherwise the anchor texel has to use the first half of the palette.
+		for (uint32_t p = 0; p < info.partitions; ++ p)
+		{
+			uint32_t const anchor = AnchorOffset(info.partitions, params.shape, p);
+			if (params.indices[anchor] >= num_indices / 2)
+			{
+				std::swap(params.end_pts[p].first, params.end_pts[p].second);
+				if (this->EndpointsFitDeltas(params))
+				{
+					for (uint32_t i = 0; i < 16; ++ i)
+					{
+						if (GetPartition(info.partitions, params.shape, i) == p)
+						{
+							params.indices[i] = static_cast<uint8_t>(num_indices - 1 - params.indices[i]);
+						}
+					}
+				}
+				else
+				{
+					std::swap(params.end_pts[p].first, params.end_pts[p].second);
+					params.indices[anchor] = closest(p, anchor, num_indices / 2, texel_errors[anchor]);
+				}
+			}
+		}
+
+		params.error = 0;
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			params.error += texel_errors[i];
+		}
+		return params.error;
+	}
+
+	void TexCompressionBC6U::RefineEndpoints(CompressParams& params, int3 const * texels, bool signed_fmt)
+	{
+		ModeInfo const & info = mode_info_[params.mode_index];
+
+		for (int pass = 0; (pass < 4) && (params.error > 0); ++ pass)
+		{
+			bool improved = false;
+			for (uint32_t p = 0; p < info.partitions; ++ p)
+			{
+				for (uint32_t e = 0; e < 2; ++ e)
+				{
+					for (uint32_t ch = 0; ch < 3; ++ ch)
+					{
+						int lo, hi;
+						BC6QuantizedRange(ChannelPrec(info.rgba_prec[0][0], ch), signed_fmt, lo, hi);
+
+						for (int step = -1; step <= 1; step += 2)
+						{
+							CompressParams trial = params;
+							int& comp = e ? trial.end_pts[p].second[ch] : trial.end_pts[p].first[ch];
+							comp += step;
+							if ((comp < lo) || (comp > hi) || !this->EndpointsFitDeltas(trial))
+							{
+								continue;
+							}
+
+							if (this->AssignIndices(trial, texels, signed_fmt) < params.error)
+							{
+								params = trial;
+								improved = true;
+							}
+						}
+					}
+				}
+			}
+
+			if (!improved)
+			{
+				break;
+			}
+		}
+	}
+
+	void TexCompressionBC6U::PackBC6Block(void* output, CompressParams const & params) const
+	{
+		ModeInfo const & info = mode_info_[params.mode_index];
+		ModeDescriptor const * desc = mode_desc_[params.mode_index];
+
+		int fields[BZ + 1];
+		memset(fields, 0, sizeof(fields));
+		fields[M] = info.mode;
+		fields[D] = params.shape;
+
+		std::pair<int3, int3> end_pts[BC6_MAX_REGIONS];
+		for (uint32_t p = 0; p < BC6_MAX_REGIONS; ++ p)
+		{
+			end_pts[p] = params.end_pts[p];
+		}
+		if (info.transformed)
+		{
+			end_pts[0].second -= params.end_pts[0].first;
+			end_pts[1].first -= params.end_pts[0].first;
+			end_pts[1].second -= params.end_pts[0].first;
+		}
+		ModeField const w_fields[] = { RW, GW, BW };
+		ModeField const x_fields[] = { RX, GX, BX };
+		ModeField const y_fields[] = { RY, GY, BY };
+		ModeField const z_fields[] = { RZ, GZ, BZ };
+		for (uint32_t ch = 0; ch < 3; ++ ch)
+		{
+			fields[w_fields[ch]] = end_pts[0].first[ch];
+			fields[x_fields[ch]] = end_pts[0].second[ch];
+			fields[y_fields[ch]] = end_pts[1].first[ch];
+			fields[z_fields[ch]] = end_pts[1].second[ch];
+		}
+
+		memset(output, 0, block_bytes_);
+
+		size_t start_bit = 0;
+		size_t const header_bits = info.partitions > 1 ? 82 : 65;
+		while (start_bit < header_bits)
+		{
+			ModeDescriptor const & d = desc[start_bit];
+			uint8_t const val = (NA == d.field) ? 0 : (static_cast<uint32_t>(fields[d.field]) >> d.bit) & 1;
+			WriteBit(output, start_bit, val);
+		}
+
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			size_t const num_bits = IsFixUpOffset(info.partitions, params.shape, i) ? info.index_prec - 1 : info.index_prec;
+			WriteBits(output, start_bit, num_bits, params.indices[i]);
+		}
+		BOOST_ASSERT(128 == start_bit);
+	}
+
 
 	TexCompressionBC6S::TexCompressionBC6S()
 	{
@@ -2213,11 +2944,7 @@ namespace KlayGE
 
 	void TexCompressionBC6S::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
-		KFL_UNUSED(output);
-		KFL_UNUSED(input);
-		KFL_UNUSED(method);
-
-		// TODO
+		bc6u_codec_.EncodeBC6Internal(output, input, method, true);
 	}
 
 	void TexCompressionBC6S::DecodeBlock(void* output, void const * input)
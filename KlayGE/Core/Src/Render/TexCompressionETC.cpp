@@ -502,6 +502,578 @@ namespace
 
 		return cur_ind;
 	}
+
+	int const etc2_distance_table[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+	int const eac_modifier_table[16][8] =
+	{
+		{ -3, -6, -9, -15, 2, 5, 8, 14 },
+		{ -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5, -8, -13, 1, 4, 7, 12 },
+		{ -2, -4, -6, -13, 1, 3, 5, 12 },
+		{ -3, -6, -8, -12, 2, 5, 7, 11 },
+		{ -3, -7, -9, -11, 2, 6, 8, 10 },
+		{ -4, -7, -8, -11, 3, 6, 7, 10 },
+		{ -3, -5, -8, -11, 2, 4, 7, 10 },
+		{ -2, -6, -8, -10, 1, 5, 7, 9 },
+		{ -2, -5, -8, -10, 1, 4, 7, 9 },
+		{ -2, -4, -8, -10, 1, 3, 7, 9 },
+		{ -2, -5, -7, -10, 1, 4, 6, 9 },
+		{ -3, -4, -7, -10, 2, 3, 6, 9 },
+		{ -1, -2, -3, -10, 0, 1, 2, 9 },
+		{ -4, -6, -8, -9, 3, 5, 7, 8 },
+		{ -3, -5, -7, -9, 2, 4, 6, 8 }
+	};
+
+	uint32_t SquaredError(ARGBColor32 const & lhs, int r, int g, int b)
+	{
+		return MathLib::sqr(lhs.r() - r) + MathLib::sqr(lhs.g() - g) + MathLib::sqr(lhs.b() - b);
+	}
+
+	// Bits of the 5-bit base and 3-bit delta that ETC2 checks for overflow, when a byte holds |f f f a1 a0 f b1 b0|.
+	//  Sets the free bits f to make base + delta fall out of [0, 31].
+	uint8_t ETC2OverflowByte(uint32_t a, uint32_t b)
+	{
+		BOOST_ASSERT((a < 4) && (b < 4));
+		if (a + b < 4)
+		{
+			// base = a, delta = b - 4
+			return static_cast<uint8_t>((a << 3) | 0x4 | b);
+		}
+		else
+		{
+			// base = 28 + a, delta = b
+			return static_cast<uint8_t>(0xE0 | (a << 3) | b);
+		}
+	}
+
+	// The opposite, for a byte holding |f base3 base2 base1 base0 delta2 delta1 delta0|
+	uint8_t ETC2NoOverflowByte(uint8_t byte)
+	{
+		BOOST_ASSERT(!(byte & 0x80));
+		int const delta = byte & 0x7;
+		return ((byte >> 3) - (delta & 0x4) + (delta & 0x3) < 0) ? static_cast<uint8_t>(byte | 0x80) : byte;
+	}
+
+	// The selectors of T, H and ETC1 modes are stored column by column, with the bytes of msb and lsb swapped
+	void ETC2PackSelectors(uint16_t& msb, uint16_t& lsb, uint8_t const * indices)
+	{
+		msb = 0;
+		lsb = 0;
+		for (int y = 0; y < 4; ++ y)
+		{
+			for (int x = 0; x < 4; ++ x)
+			{
+				int const bit_index = (x * 4 + y) ^ 0x8;
+				msb |= static_cast<uint16_t>(((indices[y * 4 + x] >> 1) & 0x1) << bit_index);
+				lsb |= static_cast<uint16_t>((indices[y * 4 + x] & 0x1) << bit_index);
+			}
+		}
+	}
+
+	void ETC2THPaintColors(int3 (&paint)[4], int3 const & c1, int3 const & c2, uint32_t dist_index, bool h_mode)
+	{
+		int const d = etc2_distance_table[dist_index];
+		for (int ch = 0; ch < 3; ++ ch)
+		{
+			int const b1 = Extend4To8Bits(c1[ch]);
+			int const b2 = Extend4To8Bits(c2[ch]);
+			if (h_mode)
+			{
+				paint[0][ch] = std::min(b1 + d, 255);
+				paint[1][ch] = std::max(b1 - d, 0);
+			}
+			else
+			{
+				paint[0][ch] = b1;
+				paint[1][ch] = std::min(b2 + d, 255);
+			}
+			paint[2][ch] = h_mode ? std::min(b2 + d, 255) : b2;
+			paint[3][ch] = std::max(b2 - d, 0);
+		}
+	}
+
+	// H mode stores the lowest bit of the distance index in the order of the base colors
+	uint32_t ETC2HModeOrdering(int3 const & c1, int3 const & c2)
+	{
+		uint32_t const packed1 = (Extend4To8Bits(c1.x()) << 16) | (Extend4To8Bits(c1.y()) << 8) | Extend4To8Bits(c1.z());
+		uint32_t const packed2 = (Extend4To8Bits(c2.x()) << 16) | (Extend4To8Bits(c2.y()) << 8) | Extend4To8Bits(c2.z());
+		return packed1 >= packed2;
+	}
+
+	// Transparent texels take index 2. The others can't use it if there is any transparent texel in the block.
+	uint64_t ETC2THError(ARGBColor32 const * argb, bool const * transparent, int3 const & c1, int3 const & c2,
+		uint32_t dist_index, bool h_mode, uint8_t* indices, uint64_t max_err)
+	{
+		int3 paint[4];
+		ETC2THPaintColors(paint, c1, c2, dist_index, h_mode);
+
+		uint64_t err = 0;
+		for (uint32_t i = 0; (i < 16) && (err < max_err); ++ i)
+		{
+			if (transparent && transparent[i])
+			{
+				indices[i] = 2;
+				continue;
+			}
+
+			uint32_t best_err = std::numeric_limits<uint32_t>::max();
+			for (uint32_t j = 0; j < 4; ++ j)
+			{
+				if (transparent && (2 == j))
+				{
+					continue;
+				}
+
+				uint32_t const e = SquaredError(argb[i], paint[j].x(), paint[j].y(), paint[j].z());
+				if (e < best_err)
+				{
+					best_err = e;
+					indices[i] = static_cast<uint8_t>(j);
+				}
+			}
+			err += best_err;
+		}
+		return err;
+	}
+
+	// Finds the best distance for a pair of base colors. H mode can swap the base colors to get the right ordering.
+	uint64_t ETC2THSearchDistance(ARGBColor32 const * argb, bool const * transparent, int3 (&base)[2], bool h_mode,
+		uint32_t& best_dist, uint8_t* best_indices)
+	{
+		uint64_t best_err = std::numeric_limits<uint64_t>::max();
+		bool best_swap = false;
+		uint8_t indices[16];
+		for (uint32_t swap = 0; swap < (h_mode ? 2U : 1U); ++ swap)
+		{
+			int3 const & c1 = base[swap];
+			int3 const & c2 = base[!swap];
+			uint32_t const ordering = h_mode ? ETC2HModeOrdering(c1, c2) : 0;
+			for (uint32_t dist = 0; dist < 8; ++ dist)
+			{
+				if (h_mode && ((dist & 1) != ordering))
+				{
+					continue;
+				}
+
+				uint64_t const err = ETC2THError(argb, transparent, c1, c2, dist, h_mode, indices, best_err);
+				if (err < best_err)
+				{
+					best_err = err;
+					best_dist = dist;
+					best_swap = (swap != 0);
+					memcpy(best_indices, indices, sizeof(indices));
+				}
+			}
+		}
+		if (best_swap)
+		{
+			std::swap(base[0], base[1]);
+		}
+		return best_err;
+	}
+
+	// Splits the opaque texels into 2 clusters with k-means, starting from a cut along the principal axis.
+	//  Returns false if there is no opaque texel.
+	bool ETC2SplitColors(ARGBColor32 const * argb, bool const * transparent, float3 (&centers)[2])
+	{
+		float3 points[16];
+		uint32_t num = 0;
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			if (!transparent || !transparent[i])
+			{
+				points[num] = float3(argb[i].r(), argb[i].g(), argb[i].b());
+				++ num;
+			}
+		}
+		if (0 == num)
+		{
+			return false;
+		}
+
+		float3 mean(0, 0, 0);
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			mean += points[i];
+		}
+		mean /= static_cast<float>(num);
+
+		float cov[6] = { 0, 0, 0, 0, 0, 0 };
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			float3 const d = points[i] - mean;
+			cov[0] += d.x() * d.x();
+			cov[1] += d.x() * d.y();
+			cov[2] += d.x() * d.z();
+			cov[3] += d.y() * d.y();
+			cov[4] += d.y() * d.z();
+			cov[5] += d.z() * d.z();
+		}
+		// Power iteration, starting from the row of the covariance matrix with the largest norm. A fixed start vector
+		//  could be orthogonal to the principal axis.
+		float3 const rows[] =
+		{
+			float3(cov[0], cov[1], cov[2]),
+			float3(cov[1], cov[3], cov[4]),
+			float3(cov[2], cov[4], cov[5])
+		};
+		float3 axis = rows[0];
+		for (uint32_t i = 1; i < 3; ++ i)
+		{
+			if (MathLib::length_sq(rows[i]) > MathLib::length_sq(axis))
+			{
+				axis = rows[i];
+			}
+		}
+		for (int iter = 0; iter < 8; ++ iter)
+		{
+			float3 const next(cov[0] * axis.x() + cov[1] * axis.y() + cov[2] * axis.z(),
+				cov[1] * axis.x() + cov[3] * axis.y() + cov[4] * axis.z(),
+				cov[2] * axis.x() + cov[4] * axis.y() + cov[5] * axis.z());
+			float const len = MathLib::length(next);
+			if (len < 1e-6f)
+			{
+				break;
+			}
+			axis = next / len;
+		}
+
+		uint32_t cluster[16];
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			cluster[i] = MathLib::dot(points[i] - mean, axis) > 0;
+		}
+
+		centers[0] = centers[1] = mean;
+		for (int iter = 0; iter < 4; ++ iter)
+		{
+			float3 sums[2] = { float3(0, 0, 0), float3(0, 0, 0) };
+			uint32_t counts[2] = { 0, 0 };
+			for (uint32_t i = 0; i < num; ++ i)
+			{
+				sums[cluster[i]] += points[i];
+				++ counts[cluster[i]];
+			}
+			for (uint32_t c = 0; c < 2; ++ c)
+			{
+				if (counts[c] > 0)
+				{
+					centers[c] = sums[c] / static_cast<float>(counts[c]);
+				}
+			}
+			if ((0 == counts[0]) || (0 == counts[1]))
+			{
+				centers[0] = centers[1] = mean;
+				break;
+			}
+
+			bool changed = false;
+			for (uint32_t i = 0; i < num; ++ i)
+			{
+				uint32_t const c = MathLib::length_sq(points[i] - centers[1]) < MathLib::length_sq(points[i] - centers[0]);
+				changed |= (c != cluster[i]);
+				cluster[i] = c;
+			}
+			if (!changed)
+			{
+				break;
+			}
+		}
+
+		return true;
+	}
+
+	int3 ETC2Quantize4(float3 const & clr)
+	{
+		return int3(MathLib::clamp(static_cast<int>(clr.x() * 15 / 255 + 0.5f), 0, 15),
+			MathLib::clamp(static_cast<int>(clr.y() * 15 / 255 + 0.5f), 0, 15),
+			MathLib::clamp(static_cast<int>(clr.z() * 15 / 255 + 0.5f), 0, 15));
+	}
+
+	// Differential mode of punch-through formats with the opaque bit cleared. Pixel index 0 is the base color, 1 and 3 add
+	//  and subtract the large modifier, and 2 is transparent. Finds the best table for a sub block.
+	uint64_t ETC2PunchthroughSubBlockError(ARGBColor32 const * argb, bool const * transparent, bool flip, uint32_t sub,
+		int3 const & base, uint32_t& best_cw, uint8_t* indices)
+	{
+		int3 const clr(Extend5To8Bits(base.x()), Extend5To8Bits(base.y()), Extend5To8Bits(base.z()));
+
+		uint64_t best_err = std::numeric_limits<uint64_t>::max();
+		for (uint32_t cw = 0; (cw < 8) && (best_err > 0); ++ cw)
+		{
+			int const modifier = TexCompressionETC1::GetModifier(cw, 3);
+			int3 paint[4];
+			for (int ch = 0; ch < 3; ++ ch)
+			{
+				paint[0][ch] = clr[ch];
+				paint[1][ch] = std::min(clr[ch] + modifier, 255);
+				paint[3][ch] = std::max(clr[ch] - modifier, 0);
+			}
+
+			uint8_t trial_indices[16];
+			uint64_t err = 0;
+			for (int y = 0; (y < 4) && (err < best_err); ++ y)
+			{
+				for (int x = 0; x < 4; ++ x)
+				{
+					if (static_cast<uint32_t>((flip ? y : x) >> 1) != sub)
+					{
+						continue;
+					}
+
+					uint32_t const i = y * 4 + x;
+					if (transparent[i])
+					{
+						trial_indices[i] = 2;
+						continue;
+					}
+
+					uint32_t best_texel_err = std::numeric_limits<uint32_t>::max();
+					for (uint32_t j = 0; j < 4; ++ j)
+					{
+						if (j != 2)
+						{
+							uint32_t const e = SquaredError(argb[i], paint[j].x(), paint[j].y(), paint[j].z());
+							if (e < best_texel_err)
+							{
+								best_texel_err = e;
+								trial_indices[i] = static_cast<uint8_t>(j);
+							}
+						}
+					}
+					err += best_texel_err;
+				}
+			}
+
+			if (err < best_err)
+			{
+				best_err = err;
+				best_cw = cw;
+				for (int y = 0; y < 4; ++ y)
+				{
+					for (int x = 0; x < 4; ++ x)
+					{
+						if (static_cast<uint32_t>((flip ? y : x) >> 1) == sub)
+						{
+							indices[y * 4 + x] = trial_indices[y * 4 + x];
+						}
+					}
+				}
+			}
+		}
+		return best_err;
+	}
+
+	// The base colors are 5 bits, and the second one is stored as a 3-bit delta of the first one
+	uint64_t ETC2PunchthroughDiffError(ARGBColor32 const * argb, bool const * transparent, bool flip,
+		int3 const (&base)[2], uint32_t (&cw)[2], uint8_t* indices)
+	{
+		for (int ch = 0; ch < 3; ++ ch)
+		{
+			int const delta = base[1][ch] - base[0][ch];
+			if ((base[0][ch] < 0) || (base[0][ch] > 31) || (base[1][ch] < 0) || (base[1][ch] > 31)
+				|| (delta < -4) || (delta > 3))
+			{
+				return std::numeric_limits<uint64_t>::max();
+			}
+		}
+
+		return ETC2PunchthroughSubBlockError(argb, transparent, flip, 0, base[0], cw[0], indices)
+			+ ETC2PunchthroughSubBlockError(argb, transparent, flip, 1, base[1], cw[1], indices);
+	}
+
+	// Planar colors, with O, H, V in 6:7:6 bits
+	uint64_t ETC2PlanarError(ARGBColor32 const * argb, int3 const * ohv)
+	{
+		int3 o, h, v;
+		for (int ch = 0; ch < 3; ++ ch)
+		{
+			if (1 == ch)
+			{
+				o[ch] = Extend7To8Bits(ohv[0][ch]);
+				h[ch] = Extend7To8Bits(ohv[1][ch]);
+				v[ch] = Extend7To8Bits(ohv[2][ch]);
+			}
+			else
+			{
+				o[ch] = Extend6To8Bits(ohv[0][ch]);
+				h[ch] = Extend6To8Bits(ohv[1][ch]);
+				v[ch] = Extend6To8Bits(ohv[2][ch]);
+			}
+		}
+
+		uint64_t err = 0;
+		for (int y = 0; y < 4; ++ y)
+		{
+			for (int x = 0; x < 4; ++ x)
+			{
+				int3 clr;
+				for (int ch = 0; ch < 3; ++ ch)
+				{
+					clr[ch] = MathLib::clamp((x * (h[ch] - o[ch]) + y * (v[ch] - o[ch]) + 4 * o[ch] + 2) >> 2, 0, 255);
+				}
+				err += SquaredError(argb[y * 4 + x], clr.x(), clr.y(), clr.z());
+			}
+		}
+		return err;
+	}
+
+	enum EACFormat
+	{
+		EACF_Alpha8,
+		EACF_Unsigned11,
+		EACF_Signed11
+	};
+
+	int EACDecodeValue(EACFormat fmt, int base, int multiplier, int modifier)
+	{
+		switch (fmt)
+		{
+		case EACF_Alpha8:
+			return MathLib::clamp(base + modifier * multiplier, 0, 255);
+
+		case EACF_Unsigned11:
+			return MathLib::clamp(base * 8 + 4 + (multiplier ? modifier * multiplier * 8 : modifier), 0, 2047);
+
+		default:
+			BOOST_ASSERT(EACF_Signed11 == fmt);
+			return MathLib::clamp(std::max(base, -127) * 8 + (multiplier ? modifier * multiplier * 8 : modifier), -1023, 1023);
+		}
+	}
+
+	// values are in the range of the format, in row major order. The block is 8 bytes, with the indices in column major order.
+	uint64_t EncodeEACBlock(uint8_t* output, int const * values, EACFormat fmt, TexCompressionMethod method)
+	{
+		int min_value = values[0];
+		int max_value = values[0];
+		for (uint32_t i = 1; i < 16; ++ i)
+		{
+			min_value = std::min(min_value, values[i]);
+			max_value = std::max(max_value, values[i]);
+		}
+
+		int const scale = (EACF_Alpha8 == fmt) ? 1 : 8;
+		int const min_base = (EACF_Signed11 == fmt) ? -127 : 0;
+		int const max_base = (EACF_Signed11 == fmt) ? 127 : 255;
+		int const min_multiplier = (EACF_Alpha8 == fmt) ? 1 : 0;
+
+		int base_window;
+		int multiplier_window;
+		switch (method)
+		{
+		case TCM_Speed:
+			base_window = 1;
+			multiplier_window = 0;
+			break;
+
+		case TCM_Balanced:
+			base_window = 2;
+			multiplier_window = 1;
+			break;
+
+		default:
+			base_window = 4;
+			multiplier_window = 2;
+			break;
+		}
+
+		uint64_t best_err = std::numeric_limits<uint64_t>::max();
+		int best_base = 0;
+		int best_multiplier = 0;
+		int best_table = 0;
+		uint8_t best_indices[16] = { 0 };
+		for (int table = 0; (table < 16) && (best_err > 0); ++ table)
+		{
+			int const mod_min = eac_modifier_table[table][3];
+			int const mod_max = eac_modifier_table[table][7];
+			int const multiplier0 = MathLib::clamp(static_cast<int>((max_value - min_value)
+				/ static_cast<float>((mod_max - mod_min) * scale) + 0.5f), min_multiplier, 15);
+			for (int multiplier = std::max(multiplier0 - multiplier_window, min_multiplier);
+				multiplier <= std::min(multiplier0 + multiplier_window, 15); ++ multiplier)
+			{
+				// Centers the range of the modifiers on the range of the values
+				float const step = multiplier ? static_cast<float>(multiplier * scale) : 1.0f;
+				float center = (min_value + max_value) / 2.0f - (mod_min + mod_max) / 2.0f * step;
+				if (EACF_Unsigned11 == fmt)
+				{
+					center -= 4;
+				}
+				int const base0 = static_cast<int>(MathLib::round(center / scale));
+				for (int base = std::max(base0 - base_window, min_base); base <= std::min(base0 + base_window, max_base); ++ base)
+				{
+					int palette[8];
+					for (int j = 0; j < 8; ++ j)
+					{
+						palette[j] = EACDecodeValue(fmt, base, multiplier, eac_modifier_table[table][j]);
+					}
+
+					uint8_t indices[16];
+					uint64_t err = 0;
+					for (uint32_t i = 0; (i < 16) && (err < best_err); ++ i)
+					{
+						uint32_t best_e = std::numeric_limits<uint32_t>::max();
+						for (int j = 0; j < 8; ++ j)
+						{
+							uint32_t const e = MathLib::sqr(values[i] - palette[j]);
+							if (e < best_e)
+							{
+								best_e = e;
+								indices[i] = static_cast<uint8_t>(j);
+							}
+						}
+						err += best_e;
+					}
+
+					if (err < best_err)
+					{
+						best_err = err;
+						best_base = base;
+						best_multiplier = multiplier;
+						best_table = table;
+						memcpy(best_indices, indices, sizeof(indices));
+					}
+				}
+			}
+		}
+
+		output[0] = static_cast<uint8_t>(best_base);
+		output[1] = static_cast<uint8_t>((best_multiplier << 4) | best_table);
+		uint64_t bits = 0;
+		for (int y = 0; y < 4; ++ y)
+		{
+			for (int x = 0; x < 4; ++ x)
+			{
+				bits |= static_cast<uint64_t>(best_indices[y * 4 + x]) << (45 - (x * 4 + y) * 3);
+			}
+		}
+		for (int i = 0; i < 6; ++ i)
+		{
+			output[2 + i] = static_cast<uint8_t>(bits >> (40 - i * 8));
+		}
+
+		return best_err;
+	}
+
+	void DecodeEACBlock(int* values, uint8_t const * input, EACFormat fmt)
+	{
+		int const base = (EACF_Signed11 == fmt) ? static_cast<int8_t>(input[0]) : input[0];
+		int const multiplier = input[1] >> 4;
+		int const table = input[1] & 0xF;
+		uint64_t bits = 0;
+		for (int i = 0; i < 6; ++ i)
+		{
+			bits = (bits << 8) | input[2 + i];
+		}
+
+		for (int y = 0; y < 4; ++ y)
+		{
+			for (int x = 0; x < 4; ++ x)
+			{
+				int const index = (bits >> (45 - (x * 4 + y) * 3)) & 0x7;
+				values[y * 4 + x] = EACDecodeValue(fmt, base, multiplier, eac_modifier_table[table][index]);
+			}
+		}
+	}
 }
 
 namespace KlayGE
@@ -717,10 +1289,11 @@ namespace KlayGE
 		BOOST_ASSERT(output);
 		BOOST_ASSERT(input);
 
-		this->EncodeETC1BlockInternal(*static_cast<ETC1Block*>(output), static_cast<ARGBColor32 const *>(input), method);
+		this->EncodeETC1BlockInternal(*static_cast<ETC1Block*>(output), static_cast<ARGBColor32 const *>(input), method, false);
 	}
 
-	uint64_t TexCompressionETC1::EncodeETC1BlockInternal(ETC1Block& dst_block, ARGBColor32 const * argb, TexCompressionMethod method)
+	uint64_t TexCompressionETC1::EncodeETC1BlockInternal(ETC1Block& dst_block, ARGBColor32 const * argb, TexCompressionMethod method,
+		bool diff_only)
 	{
 		BOOST_ASSERT(argb);
 
@@ -736,7 +1309,11 @@ namespace KlayGE
 		}
 		if (uniform_block)
 		{
-			return 16 * this->PackETC1UniformBlock(dst_block, argb);
+			uint64_t const err = 16 * this->PackETC1UniformBlock(dst_block, argb);
+			if (!diff_only || (dst_block.cw_diff_flip & 0x2))
+			{
+				return err;
+			}
 		}
 
 		uint64_t best_err = std::numeric_limits<uint64_t>::max();
@@ -754,7 +1331,7 @@ namespace KlayGE
 
 		for (uint32_t flip = 0; flip < 2; ++ flip)
 		{
-			for (uint32_t use_color4 = 0; use_color4 < 2; ++ use_color4)
+			for (uint32_t use_color4 = 0; use_color4 < (diff_only ? 1U : 2U); ++ use_color4)
 			{
 				uint64_t trial_err = 0;
 
@@ -892,6 +1469,12 @@ namespace KlayGE
 			} // use_color4
 		} // flip
 
+		if (std::numeric_limits<uint64_t>::max() == best_err)
+		{
+			// Only when diff_only, the second sub block can't be reached from the first one
+			return best_err;
+		}
+
 		int dr = best_results[1].block_color_unscaled_.r() - best_results[0].block_color_unscaled_.r();
 		int dg = best_results[1].block_color_unscaled_.g() - best_results[0].block_color_unscaled_.g();
 		int db = best_results[1].block_color_unscaled_.b() - best_results[0].block_color_unscaled_.b();
@@ -1092,7 +1675,8 @@ namespace KlayGE
 				int modifier;
 				if (alpha)
 				{
-					modifier = (mod & 0x1) ? GetModifier(cw, mod) : 0;
+					// Punch-through keeps only the large modifiers. Pixel index 0 is the base color, and 2 is transparent.
+					modifier = ((0 == mod) || (3 == mod)) ? GetModifier(cw, mod) : 0;
 				}
 				else
 				{
@@ -1249,19 +1833,20 @@ namespace KlayGE
 		memset(&block.msb, (etc1_selector & 2) ? 0xFF : 0, 2);
 		memset(&block.lsb, (etc1_selector & 1) ? 0xFF : 0, 2);
 
+		// The block stores r, g, b, while the channels of ARGBColor32 are indexed b, g, r
 		uint8_t* bytes = &block.r;
 		uint32_t const best_packed_c0 = (best_x >> 8) & 255;
 		if (diff)
 		{
-			bytes[best_i] = static_cast<uint8_t>(best_packed_c0 << 3);
-			bytes[next_comp[best_i + 0]] = static_cast<uint8_t>(best_packed_c1 << 3);
-			bytes[next_comp[best_i + 1]] = static_cast<uint8_t>(best_packed_c2 << 3);
+			bytes[2 - best_i] = static_cast<uint8_t>(best_packed_c0 << 3);
+			bytes[2 - next_comp[best_i + 0]] = static_cast<uint8_t>(best_packed_c1 << 3);
+			bytes[2 - next_comp[best_i + 1]] = static_cast<uint8_t>(best_packed_c2 << 3);
 		}
 		else
 		{
-			bytes[best_i] = static_cast<uint8_t>(best_packed_c0 | (best_packed_c0 << 4));
-			bytes[next_comp[best_i + 0]] = static_cast<uint8_t>(best_packed_c1 | (best_packed_c1 << 4));
-			bytes[next_comp[best_i + 1]] = static_cast<uint8_t>(best_packed_c2 | (best_packed_c2 << 4));
+			bytes[2 - best_i] = static_cast<uint8_t>(best_packed_c0 | (best_packed_c0 << 4));
+			bytes[2 - next_comp[best_i + 0]] = static_cast<uint8_t>(best_packed_c1 | (best_packed_c1 << 4));
+			bytes[2 - next_comp[best_i + 1]] = static_cast<uint8_t>(best_packed_c2 | (best_packed_c2 << 4));
 		}
 
 		return best_err;
@@ -1782,122 +2367,511 @@ namespace KlayGE
 			ARGBColor32 const * src_pixels = params_->src_pixels_;
 			if (sorted_luma_ptr_[N - 1] * 2 < block_inten_midpoints[0])
 			{
-				if (block_inten[0] > sorted_luma_ptr_[N - 1])
+				if (block_inten[0] > sorted_luma_ptr_[N - 1])
+				{
+					uint32_t const min_err = MathLib::abs(static_cast<int>(block_inten[0] - sorted_luma_ptr_[N - 1]));
+					if (min_err >= trial_solution.error_)
+					{
+						continue;
+					}
+				}
+
+				memset(&temp_selectors_[0], 0, N);
+
+				for (uint32_t c = 0; c < N; ++ c)
+				{
+					total_err += MathLib::sqr(block_colors[0].r() - src_pixels[c].r())
+						+ MathLib::sqr(block_colors[0].g() - src_pixels[c].g())
+						+ MathLib::sqr(block_colors[0].b() - src_pixels[c].b());
+				}
+			}
+			else if (sorted_luma_ptr_[0] * 2 >= block_inten_midpoints[2])
+			{
+				if (sorted_luma_ptr_[0] > block_inten[3])
+				{
+					uint32_t const min_err = MathLib::abs(static_cast<int>(sorted_luma_ptr_[0] - block_inten[3]));
+					if (min_err >= trial_solution.error_)
+					{
+						continue;
+					}
+				}
+
+				memset(&temp_selectors_[0], 3, N);
+
+				for (uint32_t c = 0; c < N; ++ c)
+				{
+					total_err += MathLib::sqr(block_colors[3].r() - src_pixels[c].r())
+						+ MathLib::sqr(block_colors[3].g() - src_pixels[c].g())
+						+ MathLib::sqr(block_colors[3].b() - src_pixels[c].b());
+				}
+			}
+			else
+			{
+				uint32_t cur_selector = 0;
+				for (uint32_t c = 0; c < N; ++ c)
+				{
+					uint32_t const y = sorted_luma_ptr_[c];
+					while (y * 2 >= block_inten_midpoints[cur_selector])
+					{
+						++ cur_selector;
+						if (cur_selector > 2)
+						{
+							while (c < N)
+							{
+								uint32_t const sorted_pixel_index = sorted_luma_indices_[c];
+								temp_selectors_[sorted_pixel_index] = 3;
+								total_err += MathLib::sqr(block_colors[3].r() - src_pixels[sorted_pixel_index].r())
+									+ MathLib::sqr(block_colors[3].g() - src_pixels[sorted_pixel_index].g())
+									+ MathLib::sqr(block_colors[3].b() - src_pixels[sorted_pixel_index].b());
+								++ c;
+							}
+							break;
+						}
+					}
+
+					if (c < N)
+					{
+						uint32_t const sorted_pixel_index = sorted_luma_indices_[c];
+						temp_selectors_[sorted_pixel_index] = static_cast<uint8_t>(cur_selector);
+						total_err += MathLib::sqr(block_colors[cur_selector].r() - src_pixels[sorted_pixel_index].r())
+							+ MathLib::sqr(block_colors[cur_selector].g() - src_pixels[sorted_pixel_index].g())
+							+ MathLib::sqr(block_colors[cur_selector].b() - src_pixels[sorted_pixel_index].b());
+					}
+				}
+			}
+
+			if (total_err < trial_solution.error_)
+			{
+				trial_solution.error_ = total_err;
+				trial_solution.coords_.inten_table_ = inten_table;
+				memcpy(trial_solution.selectors_, temp_selectors_, N);
+				trial_solution.valid_ = true;
+				if (!total_err)
+				{
+					break;
+				}
+			}
+		}
+		trial_solution.coords_.unscaled_color_ = coords.unscaled_color_;
+		trial_solution.coords_.color4_ = params_->use_color4_;
+
+		bool success = false;
+		if (trial_solution.error_ < best_solution.error_)
+		{
+			best_solution = trial_solution;
+			success = true;
+		}
+
+		return success;
+	}
+
+
+	TexCompressionETC2RGB8::TexCompressionETC2RGB8()
+	{
+		block_width_ = block_height_ = 4;
+		block_depth_ = 1;
+		block_bytes_ = NumFormatBytes(EF_ETC2_BGR8) * 4;
+		decoded_fmt_ = EF_ARGB8;
+
+		etc1_codec_ = MakeSharedPtr<TexCompressionETC1>();
+	}
+
+	void TexCompressionETC2RGB8::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		this->EncodeETC2BlockInternal(*static_cast<ETC2Block*>(output), static_cast<ARGBColor32 const *>(input), method, false);
+	}
+
+	uint64_t TexCompressionETC2RGB8::EncodeETC2BlockInternal(ETC2Block& output, ARGBColor32 const * argb,
+		TexCompressionMethod method, bool punchthrough)
+	{
+		bool transparent[16];
+		bool any_transparent = false;
+		if (punchthrough)
+		{
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				transparent[i] = (argb[i].a() < 128);
+				any_transparent |= transparent[i];
+			}
+		}
+
+		ETC2Block trial;
+		uint64_t err;
+		if (any_transparent)
+		{
+			// Transparent texels need the opaque bit cleared, which is possible in differential, T and H modes, but not in
+			//  planar mode
+			err = this->EncodeETCDifferentialPunchthroughInternal(output.etc1, argb, transparent, method);
+			for (uint32_t h_mode = 0; (h_mode < 2) && (err > 0); ++ h_mode)
+			{
+				uint64_t const trial_err = this->EncodeETCTHModeInternal(trial, argb, transparent, method, h_mode != 0);
+				if (trial_err < err)
+				{
+					output = trial;
+					err = trial_err;
+				}
+			}
+		}
+		else
+		{
+			err = etc1_codec_->EncodeETC1BlockInternal(output.etc1, argb, method, punchthrough);
+
+			uint64_t trial_err = this->EncodeETCPlanarModeInternal(trial.etc2_planar_mode, argb, method);
+			if (trial_err < err)
+			{
+				output = trial;
+				err = trial_err;
+			}
+
+			if (method != TCM_Speed)
+			{
+				for (uint32_t h_mode = 0; (h_mode < 2) && (err > 0); ++ h_mode)
+				{
+					trial_err = this->EncodeETCTHModeInternal(trial, argb, nullptr, method, h_mode != 0);
+					if (trial_err < err)
+					{
+						output = trial;
+						err = trial_err;
+					}
+				}
+			}
+		}
+
+		return err;
+	}
+
+	uint64_t TexCompressionETC2RGB8::EncodeETCTHModeInternal(ETC2Block& output, ARGBColor32 const * argb,
+		bool const * transparent, TexCompressionMethod method, bool h_mode)
+	{
+		int3 base[2];
+		uint32_t dist;
+		uint8_t indices[16];
+		uint64_t err;
+
+		float3 centers[2];
+		if (ETC2SplitColors(argb, transparent, centers))
+		{
+			base[0] = ETC2Quantize4(centers[0]);
+			base[1] = ETC2Quantize4(centers[1]);
+			err = ETC2THSearchDistance(argb, transparent, base, h_mode, dist, indices);
+			if (!h_mode)
+			{
+				// The first base color of T mode is used alone, so the order matters
+				int3 trial[2] = { base[1], base[0] };
+				uint32_t trial_dist;
+				uint8_t trial_indices[16];
+				uint64_t const trial_err = ETC2THSearchDistance(argb, transparent, trial, h_mode, trial_dist, trial_indices);
+				if (trial_err < err)
+				{
+					base[0] = trial[0];
+					base[1] = trial[1];
+					dist = trial_dist;
+					memcpy(indices, trial_indices, sizeof(indices));
+					err = trial_err;
+				}
+			}
+
+			uint32_t const num_passes = (TCM_Speed == method) ? 0 : ((TCM_Balanced == method) ? 1 : 4);
+			for (uint32_t pass = 0; (pass < num_passes) && (err > 0); ++ pass)
+			{
+				bool improved = false;
+				for (uint32_t c = 0; c < 2; ++ c)
 				{
-					uint32_t const min_err = MathLib::abs(static_cast<int>(block_inten[0] - sorted_luma_ptr_[N - 1]));
-					if (min_err >= trial_solution.error_)
+					for (uint32_t ch = 0; ch < 3; ++ ch)
 					{
-						continue;
+						for (int step = -1; step <= 1; step += 2)
+						{
+							int const value = base[c][ch] + step;
+							if ((value < 0) || (value > 15))
+							{
+								continue;
+							}
+
+							int3 trial[2] = { base[0], base[1] };
+							trial[c][ch] = value;
+							uint32_t trial_dist;
+							uint8_t trial_indices[16];
+							uint64_t const trial_err = ETC2THSearchDistance(argb, transparent, trial, h_mode,
+								trial_dist, trial_indices);
+							if (trial_err < err)
+							{
+								base[0] = trial[0];
+								base[1] = trial[1];
+								dist = trial_dist;
+								memcpy(indices, trial_indices, sizeof(indices));
+								err = trial_err;
+								improved = true;
+							}
+						}
 					}
 				}
-
-				memset(&temp_selectors_[0], 0, N);
-
-				for (uint32_t c = 0; c < N; ++ c)
+				if (!improved)
 				{
-					total_err += MathLib::sqr(block_colors[0].r() - src_pixels[c].r())
-						+ MathLib::sqr(block_colors[0].g() - src_pixels[c].g())
-						+ MathLib::sqr(block_colors[0].b() - src_pixels[c].b());
+					break;
 				}
 			}
-			else if (sorted_luma_ptr_[0] * 2 >= block_inten_midpoints[2])
+		}
+		else
+		{
+			// All texels are transparent. H mode needs an odd distance index for equal base colors.
+			base[0] = base[1] = int3(0, 0, 0);
+			dist = h_mode ? 1 : 0;
+			memset(indices, 2, sizeof(indices));
+			err = 0;
+		}
+
+		// In T and H modes, the diff bit is the opaque bit of punch-through formats
+		uint32_t const opaque = transparent ? 0 : 0x2;
+		if (h_mode)
+		{
+			ETC2HModeBlock& h = output.etc2_h_mode;
+			h.r1_g1 = ETC2NoOverflowByte(static_cast<uint8_t>((base[0].x() << 3) | (base[0].y() >> 1)));
+			h.g1_b1 = ETC2OverflowByte(((base[0].y() & 0x1) << 1) | (base[0].z() >> 3), (base[0].z() >> 1) & 0x3);
+			h.b1_r2_g2 = static_cast<uint8_t>(((base[0].z() & 0x1) << 7) | (base[1].x() << 3) | (base[1].y() >> 1));
+			h.g2_b2_d = static_cast<uint8_t>(((base[1].y() & 0x1) << 7) | (base[1].z() << 3) | ((dist >> 2) << 2)
+				| opaque | ((dist >> 1) & 0x1));
+			ETC2PackSelectors(h.msb, h.lsb, indices);
+		}
+		else
+		{
+			ETC2TModeBlock& t = output.etc2_t_mode;
+			t.r1 = ETC2OverflowByte(base[0].x() >> 2, base[0].x() & 0x3);
+			t.g1_b1 = static_cast<uint8_t>((base[0].y() << 4) | base[0].z());
+			t.r2_g2 = static_cast<uint8_t>((base[1].x() << 4) | base[1].y());
+			t.b2_d = static_cast<uint8_t>((base[1].z() << 4) | ((dist >> 1) << 2) | opaque | (dist & 0x1));
+			ETC2PackSelectors(t.msb, t.lsb, indices);
+		}
+
+		return err;
+	}
+
+	uint64_t TexCompressionETC2RGB8::EncodeETCDifferentialPunchthroughInternal(ETC1Block& output, ARGBColor32 const * argb,
+		bool const * transparent, TexCompressionMethod method)
+	{
+		uint64_t best_err = std::numeric_limits<uint64_t>::max();
+		bool best_flip = false;
+		int3 best_base[2];
+		uint32_t best_cw[2];
+		uint8_t best_indices[16];
+		for (uint32_t flip = 0; (flip < 2) && (best_err > 0); ++ flip)
+		{
+			// The average of the opaque texels in each sub block
+			int3 sub_base[2];
+			bool has_opaque[2];
+			for (uint32_t sub = 0; sub < 2; ++ sub)
 			{
-				if (sorted_luma_ptr_[0] > block_inten[3])
+				float3 sum(0, 0, 0);
+				uint32_t num = 0;
+				for (int y = 0; y < 4; ++ y)
 				{
-					uint32_t const min_err = MathLib::abs(static_cast<int>(sorted_luma_ptr_[0] - block_inten[3]));
-					if (min_err >= trial_solution.error_)
+					for (int x = 0; x < 4; ++ x)
 					{
-						continue;
+						uint32_t const i = y * 4 + x;
+						if ((static_cast<uint32_t>((flip ? y : x) >> 1) == sub) && !transparent[i])
+						{
+							sum += float3(argb[i].r(), argb[i].g(), argb[i].b());
+							++ num;
+						}
 					}
 				}
+				has_opaque[sub] = (num > 0);
+				if (has_opaque[sub])
+				{
+					sum /= static_cast<float>(num);
+					sub_base[sub] = int3(MathLib::clamp(static_cast<int>(sum.x() * 31 / 255 + 0.5f), 0, 31),
+						MathLib::clamp(static_cast<int>(sum.y() * 31 / 255 + 0.5f), 0, 31),
+						MathLib::clamp(static_cast<int>(sum.z() * 31 / 255 + 0.5f), 0, 31));
+				}
+			}
+			if (!has_opaque[0])
+			{
+				sub_base[0] = has_opaque[1] ? sub_base[1] : int3(0, 0, 0);
+			}
+			if (!has_opaque[1])
+			{
+				sub_base[1] = sub_base[0];
+			}
 
-				memset(&temp_selectors_[0], 3, N);
+			// Out of the delta range, one base color has to move towards the other one
+			int3 base[2];
+			uint32_t cw[2];
+			uint8_t indices[16];
+			uint64_t err = std::numeric_limits<uint64_t>::max();
+			for (uint32_t fixed = 0; fixed < 2; ++ fixed)
+			{
+				int3 trial[2];
+				trial[fixed] = sub_base[fixed];
+				for (int ch = 0; ch < 3; ++ ch)
+				{
+					trial[!fixed][ch] = fixed ? MathLib::clamp(sub_base[0][ch], sub_base[1][ch] - 3, sub_base[1][ch] + 4)
+						: MathLib::clamp(sub_base[1][ch], sub_base[0][ch] - 4, sub_base[0][ch] + 3);
+				}
 
-				for (uint32_t c = 0; c < N; ++ c)
+				uint32_t trial_cw[2];
+				uint8_t trial_indices[16];
+				uint64_t const trial_err = ETC2PunchthroughDiffError(argb, transparent, flip != 0, trial, trial_cw,
+					trial_indices);
+				if (trial_err < err)
 				{
-					total_err += MathLib::sqr(block_colors[3].r() - src_pixels[c].r())
-						+ MathLib::sqr(block_colors[3].g() - src_pixels[c].g())
-						+ MathLib::sqr(block_colors[3].b() - src_pixels[c].b());
+					base[0] = trial[0];
+					base[1] = trial[1];
+					cw[0] = trial_cw[0];
+					cw[1] = trial_cw[1];
+					memcpy(indices, trial_indices, sizeof(indices));
+					err = trial_err;
 				}
 			}
-			else
+
+			uint32_t const num_passes = (TCM_Speed == method) ? 0 : ((TCM_Balanced == method) ? 1 : 4);
+			for (uint32_t pass = 0; (pass < num_passes) && (err > 0); ++ pass)
 			{
-				uint32_t cur_selector = 0;
-				for (uint32_t c = 0; c < N; ++ c)
+				bool improved = false;
+				for (uint32_t c = 0; c < 2; ++ c)
 				{
-					uint32_t const y = sorted_luma_ptr_[c];
-					while (y * 2 >= block_inten_midpoints[cur_selector])
+					for (uint32_t ch = 0; ch < 3; ++ ch)
 					{
-						++ cur_selector;
-						if (cur_selector > 2)
+						for (int step = -1; step <= 1; step += 2)
 						{
-							while (c < N)
+							int3 trial[2] = { base[0], base[1] };
+							trial[c][ch] += step;
+							uint32_t trial_cw[2];
+							uint8_t trial_indices[16];
+							uint64_t const trial_err = ETC2PunchthroughDiffError(argb, transparent, flip != 0, trial,
+								trial_cw, trial_indices);
+							if (trial_err < err)
 							{
-								uint32_t const sorted_pixel_index = sorted_luma_indices_[c];
-								temp_selectors_[sorted_pixel_index] = 3;
-								total_err += MathLib::sqr(block_colors[3].r() - src_pixels[sorted_pixel_index].r())
-									+ MathLib::sqr(block_colors[3].g() - src_pixels[sorted_pixel_index].g())
-									+ MathLib::sqr(block_colors[3].b() - src_pixels[sorted_pixel_index].b());
-								++ c;
+								base[0] = trial[0];
+								base[1] = trial[1];
+								cw[0] = trial_cw[0];
+								cw[1] = trial_cw[1];
+								memcpy(indices, trial_indices, sizeof(indices));
+								err = trial_err;
+								improved = true;
 							}
-							break;
 						}
 					}
-
-					if (c < N)
-					{
-						uint32_t const sorted_pixel_index = sorted_luma_indices_[c];
-						temp_selectors_[sorted_pixel_index] = static_cast<uint8_t>(cur_selector);
-						total_err += MathLib::sqr(block_colors[cur_selector].r() - src_pixels[sorted_pixel_index].r())
-							+ MathLib::sqr(block_colors[cur_selector].g() - src_pixels[sorted_pixel_index].g())
-							+ MathLib::sqr(block_colors[cur_selector].b() - src_pixels[sorted_pixel_index].b());
-					}
 				}
-			}
-
-			if (total_err < trial_solution.error_)
-			{
-				trial_solution.error_ = total_err;
-				trial_solution.coords_.inten_table_ = inten_table;
-				memcpy(trial_solution.selectors_, temp_selectors_, N);
-				trial_solution.valid_ = true;
-				if (!total_err)
+				if (!improved)
 				{
 					break;
 				}
 			}
-		}
-		trial_solution.coords_.unscaled_color_ = coords.unscaled_color_;
-		trial_solution.coords_.color4_ = params_->use_color4_;
 
-		bool success = false;
-		if (trial_solution.error_ < best_solution.error_)
-		{
-			best_solution = trial_solution;
-			success = true;
+			if (err < best_err)
+			{
+				best_err = err;
+				best_flip = (flip != 0);
+				best_base[0] = base[0];
+				best_base[1] = base[1];
+				best_cw[0] = cw[0];
+				best_cw[1] = cw[1];
+				memcpy(best_indices, indices, sizeof(indices));
+			}
 		}
 
-		return success;
-	}
+		int3 const delta = best_base[1] - best_base[0];
+		output.r = static_cast<uint8_t>((best_base[0].x() << 3) | (delta.x() & 0x7));
+		output.g = static_cast<uint8_t>((best_base[0].y() << 3) | (delta.y() & 0x7));
+		output.b = static_cast<uint8_t>((best_base[0].z() << 3) | (delta.z() & 0x7));
+		// The diff bit is the opaque bit, left cleared
+		output.cw_diff_flip = static_cast<uint8_t>((best_cw[0] << 5) | (best_cw[1] << 2) | (best_flip ? 1 : 0));
+		ETC2PackSelectors(output.msb, output.lsb, best_indices);
 
+		return best_err;
+	}
 
-	TexCompressionETC2RGB8::TexCompressionETC2RGB8()
+	uint64_t TexCompressionETC2RGB8::EncodeETCPlanarModeInternal(ETC2PlanarModeBlock& output, ARGBColor32 const * argb,
+		TexCompressionMethod method)
 	{
-		block_width_ = block_height_ = 4;
-		block_depth_ = 1;
-		block_bytes_ = NumFormatBytes(EF_ETC2_BGR8) * 4;
-		decoded_fmt_ = EF_ARGB8;
+		// Least squares fit of a plane to each channel, p = o + x * (h - o) / 4 + y * (v - o) / 4
+		int3 ohv[3];
+		for (uint32_t ch = 0; ch < 3; ++ ch)
+		{
+			float sum = 0;
+			float sum_x = 0;
+			float sum_y = 0;
+			for (int y = 0; y < 4; ++ y)
+			{
+				for (int x = 0; x < 4; ++ x)
+				{
+					ARGBColor32 const & clr = argb[y * 4 + x];
+					float const p = (0 == ch) ? clr.r() : ((1 == ch) ? clr.g() : clr.b());
+					sum += p;
+					sum_x += (x - 1.5f) * p;
+					sum_y += (y - 1.5f) * p;
+				}
+			}
 
-		etc1_codec_ = MakeSharedPtr<TexCompressionETC1>();
-	}
+			float const dx = sum_x / 20;
+			float const dy = sum_y / 20;
+			float const o = sum / 16 - 1.5f * (dx + dy);
+			float const values[] = { o, o + 4 * dx, o + 4 * dy };
+			int const max_value = (1 == ch) ? 127 : 63;
+			for (uint32_t i = 0; i < 3; ++ i)
+			{
+				ohv[i][ch] = MathLib::clamp(static_cast<int>(values[i] * max_value / 255 + 0.5f), 0, max_value);
+			}
+		}
 
-	void TexCompressionETC2RGB8::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
-	{
-		KFL_UNUSED(output);
-		KFL_UNUSED(input);
-		KFL_UNUSED(method);
+		uint64_t err = ETC2PlanarError(argb, ohv);
+
+		uint32_t const num_passes = (TCM_Speed == method) ? 0 : ((TCM_Balanced == method) ? 1 : 4);
+		for (uint32_t pass = 0; (pass < num_passes) && (err > 0); ++ pass)
+		{
+			bool improved = false;
+			for (uint32_t i = 0; i < 3; ++ i)
+			{
+				for (uint32_t ch = 0; ch < 3; ++ ch)
+				{
+					int const max_value = (1 == ch) ? 127 : 63;
+					for (int step = -1; step <= 1; step += 2)
+					{
+						int const value = ohv[i][ch] + step;
+						if ((value < 0) || (value > max_value))
+						{
+							continue;
+						}
+
+						int3 trial[3] = { ohv[0], ohv[1], ohv[2] };
+						trial[i][ch] = value;
+						uint64_t const trial_err = ETC2PlanarError(argb, trial);
+						if (trial_err < err)
+						{
+							ohv[i] = trial[i];
+							err = trial_err;
+							improved = true;
+						}
+					}
+				}
+			}
+			if (!improved)
+			{
+				break;
+			}
+		}
 
-		// TODO
+		int const ro = ohv[0].x();
+		int const go = ohv[0].y();
+		int const bo = ohv[0].z();
+		int const rh = ohv[1].x();
+		int const gh = ohv[1].y();
+		int const bh = ohv[1].z();
+		int const rv = ohv[2].x();
+		int const gv = ohv[2].y();
+		int const bv = ohv[2].z();
+		output.ro_go = ETC2NoOverflowByte(static_cast<uint8_t>((ro << 1) | (go >> 6)));
+		output.go_bo = ETC2NoOverflowByte(static_cast<uint8_t>(((go & 0x3F) << 1) | (bo >> 5)));
+		output.bo = ETC2OverflowByte((bo >> 3) & 0x3, (bo >> 1) & 0x3);
+		output.bo_rh = static_cast<uint8_t>(((bo & 0x1) << 7) | ((rh >> 1) << 2) | 0x2 | (rh & 0x1));
+		output.gh_bh = static_cast<uint8_t>((gh << 1) | (bh >> 5));
+		output.bh_rv = static_cast<uint8_t>(((bh & 0x1F) << 3) | (rv >> 3));
+		output.rv_gv = static_cast<uint8_t>(((rv & 0x7) << 5) | (gv >> 2));
+		output.gv_bv = static_cast<uint8_t>(((gv & 0x3) << 6) | bv);
+
+		return err;
 	}
 
 	void TexCompressionETC2RGB8::DecodeBlock(void* output, void const * input)
@@ -2117,11 +3091,11 @@ namespace KlayGE
 
 	void TexCompressionETC2RGB8A1::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
-		KFL_UNUSED(output);
-		KFL_UNUSED(input);
-		KFL_UNUSED(method);
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
 
-		// TODO
+		etc2_rgb8_codec_->EncodeETC2BlockInternal(*static_cast<ETC2Block*>(output), static_cast<ARGBColor32 const *>(input),
+			method, true);
 	}
 
 	void TexCompressionETC2RGB8A1::DecodeBlock(void* output, void const * input)
@@ -2157,4 +3131,197 @@ namespace KlayGE
 			etc1_codec_->DecodeETCDifferentialModeInternal(argb, etc2.etc1, !op);
 		}
 	}
+
+
+	TexCompressionETC2RGBA8::TexCompressionETC2RGBA8()
+	{
+		block_width_ = block_height_ = 4;
+		block_depth_ = 1;
+		block_bytes_ = NumFormatBytes(EF_ETC2_ABGR8) * 4;
+		decoded_fmt_ = EF_ARGB8;
+
+		etc2_rgb8_codec_ = MakeSharedPtr<TexCompressionETC2RGB8>();
+	}
+
+	void TexCompressionETC2RGBA8::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		ARGBColor32 const * argb = static_cast<ARGBColor32 const *>(input);
+
+		int alpha[16];
+		ARGBColor32 rgb[16];
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			alpha[i] = argb[i].a();
+			rgb[i] = argb[i];
+			rgb[i].a() = 255;
+		}
+
+		EncodeEACBlock(dst, alpha, EACF_Alpha8, method);
+		etc2_rgb8_codec_->EncodeETC2BlockInternal(*reinterpret_cast<ETC2Block*>(dst + 8), rgb, method, false);
+	}
+
+	void TexCompressionETC2RGBA8::DecodeBlock(void* output, void const * input)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		ARGBColor32* argb = static_cast<ARGBColor32*>(output);
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+
+		etc2_rgb8_codec_->DecodeBlock(argb, src + 8);
+
+		int alpha[16];
+		DecodeEACBlock(alpha, src, EACF_Alpha8);
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			argb[i].a() = static_cast<uint8_t>(alpha[i]);
+		}
+	}
+
+
+	TexCompressionETC2R11::TexCompressionETC2R11()
+	{
+		block_width_ = block_height_ = 4;
+		block_depth_ = 1;
+		block_bytes_ = NumFormatBytes(EF_ETC2_R11) * 4;
+		decoded_fmt_ = EF_R8;
+		thread_safe_encoding_ = true;
+	}
+
+	void TexCompressionETC2R11::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
+	{
+		this->EncodeR11Internal(output, input, 1, method, false);
+	}
+
+	void TexCompressionETC2R11::DecodeBlock(void* output, void const * input)
+	{
+		this->DecodeR11Internal(output, 1, input, false);
+	}
+
+	void TexCompressionETC2R11::EncodeR11Internal(void* output, void const * input, uint32_t stride, TexCompressionMethod method,
+		bool signed_fmt)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+
+		int values[16];
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			if (signed_fmt)
+			{
+				int const v = std::max(static_cast<int>(static_cast<int8_t>(src[i * stride])), -127);
+				values[i] = (v * 1023 + ((v >= 0) ? 63 : -63)) / 127;
+			}
+			else
+			{
+				values[i] = (src[i * stride] * 2047 + 127) / 255;
+			}
+		}
+
+		EncodeEACBlock(static_cast<uint8_t*>(output), values, signed_fmt ? EACF_Signed11 : EACF_Unsigned11, method);
+	}
+
+	void TexCompressionETC2R11::DecodeR11Internal(void* output, uint32_t stride, void const * input, bool signed_fmt)
+	{
+		BOOST_ASSERT(output);
+		BOOST_ASSERT(input);
+
+		uint8_t* dst = static_cast<uint8_t*>(output);
+
+		int values[16];
+		DecodeEACBlock(values, static_cast<uint8_t const *>(input), signed_fmt ? EACF_Signed11 : EACF_Unsigned11);
+		for (uint32_t i = 0; i < 16; ++ i)
+		{
+			if (signed_fmt)
+			{
+				dst[i * stride] = static_cast<uint8_t>((values[i] * 127 + ((values[i] >= 0) ? 511 : -511)) / 1023);
+			}
+			else
+			{
+				dst[i * stride] = static_cast<uint8_t>((values[i] * 255 + 1023) / 2047);
+			}
+		}
+	}
+
+
+	TexCompressionETC2SignedR11::TexCompressionETC2SignedR11()
+	{
+		block_width_ = block_height_ = 4;
+		block_depth_ = 1;
+		block_bytes_ = NumFormatBytes(EF_SIGNED_ETC2_R11) * 4;
+		decoded_fmt_ = EF_SIGNED_R8;
+		thread_safe_encoding_ = true;
+	}
+
+	void TexCompressionETC2SignedR11::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
+	{
+		r11_codec_.EncodeR11Internal(output, input, 1, method, true);
+	}
+
+	void TexCompressionETC2SignedR11::DecodeBlock(void* output, void const * input)
+	{
+		r11_codec_.DecodeR11Internal(output, 1, input, true);
+	}
+
+
+	TexCompressionETC2RG11::TexCompressionETC2RG11()
+	{
+		block_width_ = block_height_ = 4;
+		block_depth_ = 1;
+		block_bytes_ = NumFormatBytes(EF_ETC2_GR11) * 4;
+		decoded_fmt_ = EF_GR8;
+		thread_safe_encoding_ = true;
+	}
+
+	void TexCompressionETC2RG11::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
+	{
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+
+		r11_codec_.EncodeR11Internal(dst + 0, src + 0, 2, method, false);
+		r11_codec_.EncodeR11Internal(dst + 8, src + 1, 2, method, false);
+	}
+
+	void TexCompressionETC2RG11::DecodeBlock(void* output, void const * input)
+	{
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+
+		r11_codec_.DecodeR11Internal(dst + 0, 2, src + 0, false);
+		r11_codec_.DecodeR11Internal(dst + 1, 2, src + 8, false);
+	}
+
+
+	TexCompressionETC2SignedRG11::TexCompressionETC2SignedRG11()
+	{
+		block_width_ = block_height_ = 4;
+		block_depth_ = 1;
+		block_bytes_ = NumFormatBytes(EF_SIGNED_ETC2_GR11) * 4;
+		decoded_fmt_ = EF_SIGNED_GR8;
+		thread_safe_encoding_ = true;
+	}
+
+	void TexCompressionETC2SignedRG11::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
+	{
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+
+		r11_codec_.EncodeR11Internal(dst + 0, src + 0, 2, method, true);
+		r11_codec_.EncodeR11Internal(dst + 8, src + 1, 2, method, true);
+	}
+
+	void TexCompressionETC2SignedRG11::DecodeBlock(void* output, void const * input)
+	{
+		uint8_t* dst = static_cast<uint8_t*>(output);
+		uint8_t const * src = static_cast<uint8_t const *>(input);
+
+		r11_codec_.DecodeR11Internal(dst + 0, 2, src + 0, true);
+		r11_codec_.DecodeR11Internal(dst + 1, 2, src + 8, true);
+	}
 }
@@ -39,7 +39,10 @@
 #include <KlayGE/TexCompressionETC.hpp>
 #include <KFL/Half.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/SIMDMath.hpp>
+#include <KFL/TaskScheduler.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <system_error>
@@ -879,20 +882,23 @@ namespace
 
 		case EF_ETC2_ABGR8:
 		case EF_ETC2_ABGR8_SRGB:
-			// TODO
-			BOOST_ASSERT(false);
+			codec = MakeUniquePtr<TexCompressionETC2RGBA8>();
 			break;
 
 		case EF_ETC2_R11:
+			codec = MakeUniquePtr<TexCompressionETC2R11>();
+			break;
+
 		case EF_SIGNED_ETC2_R11:
-			// TODO
-			BOOST_ASSERT(false);
+			codec = MakeUniquePtr<TexCompressionETC2SignedR11>();
 			break;
 
 		case EF_ETC2_GR11:
+			codec = MakeUniquePtr<TexCompressionETC2RG11>();
+			break;
+
 		case EF_SIGNED_ETC2_GR11:
-			// TODO
-			BOOST_ASSERT(false);
+			codec = MakeUniquePtr<TexCompressionETC2SignedRG11>();
 			break;
 
 		default:
@@ -944,15 +950,16 @@ namespace
 		case EF_SIGNED_BC1:
 		case EF_SIGNED_BC2:
 		case EF_SIGNED_BC3:
-		case EF_SIGNED_ETC2_R11:
 			dst_format = EF_SIGNED_ABGR8;
 			break;
 
 		case EF_SIGNED_BC4:
+		case EF_SIGNED_ETC2_R11:
 			dst_format = EF_SIGNED_R8;
 			break;
 
 		case EF_SIGNED_BC5:
+		case EF_SIGNED_ETC2_GR11:
 			dst_format = EF_SIGNED_GR8;
 			break;
 
@@ -1041,20 +1048,23 @@ namespace
 
 		case EF_ETC2_ABGR8:
 		case EF_ETC2_ABGR8_SRGB:
-			// TODO
-			BOOST_ASSERT(false);
+			codec = MakeUniquePtr<TexCompressionETC2RGBA8>();
 			break;
 
 		case EF_ETC2_R11:
+			codec = MakeUniquePtr<TexCompressionETC2R11>();
+			break;
+
 		case EF_SIGNED_ETC2_R11:
-			// TODO
-			BOOST_ASSERT(false);
+			codec = MakeUniquePtr<TexCompressionETC2SignedR11>();
 			break;
 
 		case EF_ETC2_GR11:
+			codec = MakeUniquePtr<TexCompressionETC2RG11>();
+			break;
+
 		case EF_SIGNED_ETC2_GR11:
-			// TODO
-			BOOST_ASSERT(false);
+			codec = MakeUniquePtr<TexCompressionETC2SignedRG11>();
 			break;
 
 		default:
@@ -1079,6 +1089,197 @@ namespace
 	}
 
 
+	// Reads the subresources of a DDS. The image data is contiguous in the file, in the same order as the subresources.
+	//  With in_place, the subresources of a memory backed resource point into its memory, and data_block stays empty.
+	void LoadDDSData(ResIdentifierPtr const & tex_res, Texture::TextureType& type,
+		uint32_t& width, uint32_t& height, uint32_t& depth, uint32_t& num_mipmaps, uint32_t& array_size,
+		ElementFormat& format, std::vector<ElementInitData>& init_data, std::vector<uint8_t>& data_block, bool in_place)
+	{
+		uint32_t row_pitch, slice_pitch;
+		GetImageInfo(tex_res, type, width, height, depth, num_mipmaps, array_size, format,
+			row_pitch, slice_pitch);
+
+		uint32_t const fmt_size = NumFormatBytes(format);
+		bool padding = false;
+		if (!IsCompressedFormat(format))
+		{
+			if (row_pitch != width * fmt_size)
+			{
+				BOOST_ASSERT(row_pitch == ((width + 3) & ~3) * fmt_size);
+				padding = true;
+			}
+		}
+
+		std::vector<size_t> base;
+		size_t data_size = 0;
+		switch (type)
+		{
+		case Texture::TT_1D:
+			{
+				init_data.resize(array_size * num_mipmaps);
+				base.resize(array_size * num_mipmaps);
+				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
+				{
+					uint32_t the_width = width;
+					for (uint32_t level = 0; level < num_mipmaps; ++ level)
+					{
+						size_t const index = array_index * num_mipmaps + level;
+						uint32_t image_size;
+						if (IsCompressedFormat(format))
+						{
+							uint32_t const block_size = NumFormatBytes(format) * 4;
+							image_size = ((the_width + 3) / 4) * block_size;
+						}
+						else
+						{
+							image_size = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
+						}
+
+						base[index] = data_size;
+						data_size += image_size;
+						init_data[index].row_pitch = image_size;
+						init_data[index].slice_pitch = image_size;
+
+						the_width = std::max<uint32_t>(the_width / 2, 1);
+					}
+				}
+			}
+			break;
+
+		case Texture::TT_2D:
+			{
+				init_data.resize(array_size * num_mipmaps);
+				base.resize(array_size * num_mipmaps);
+				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
+				{
+					uint32_t the_width = width;
+					uint32_t the_height = height;
+					for (uint32_t level = 0; level < num_mipmaps; ++ level)
+					{
+						size_t const index = array_index * num_mipmaps + level;
+						if (IsCompressedFormat(format))
+						{
+							uint32_t const block_size = NumFormatBytes(format) * 4;
+							uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
+
+							base[index] = data_size;
+							data_size += image_size;
+							init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
+							init_data[index].slice_pitch = image_size;
+						}
+						else
+						{
+							init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
+							init_data[index].slice_pitch = init_data[index].row_pitch * the_height;
+							base[index] = data_size;
+							data_size += init_data[index].slice_pitch;
+						}
+
+						the_width = std::max<uint32_t>(the_width / 2, 1);
+						the_height = std::max<uint32_t>(the_height / 2, 1);
+					}
+				}
+			}
+			break;
+
+		case Texture::TT_3D:
+			{
+				init_data.resize(array_size * num_mipmaps);
+				base.resize(array_size * num_mipmaps);
+				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
+				{
+					uint32_t the_width = width;
+					uint32_t the_height = height;
+					uint32_t the_depth = depth;
+					for (uint32_t level = 0; level < num_mipmaps; ++ level)
+					{
+						size_t const index = array_index * num_mipmaps + level;
+						if (IsCompressedFormat(format))
+						{
+							uint32_t const block_size = NumFormatBytes(format) * 4;
+							uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * the_depth * block_size;
+
+							base[index] = data_size;
+							data_size += image_size;
+							init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
+							init_data[index].slice_pitch = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
+						}
+						else
+						{
+							init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
+							init_data[index].slice_pitch = init_data[index].row_pitch * the_height;
+							base[index] = data_size;
+							data_size += init_data[index].slice_pitch * the_depth;
+						}
+
+						the_width = std::max<uint32_t>(the_width / 2, 1);
+						the_height = std::max<uint32_t>(the_height / 2, 1);
+						the_depth = std::max<uint32_t>(the_depth / 2, 1);
+					}
+				}
+			}
+			break;
+
+		case Texture::TT_Cube:
+			{
+				init_data.resize(array_size * 6 * num_mipmaps);
+				base.resize(array_size * 6 * num_mipmaps);
+				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
+				{
+					for (uint32_t face = Texture::CF_Positive_X; face <= Texture::CF_Negative_Z; ++ face)
+					{
+						uint32_t the_width = width;
+						uint32_t the_height = height;
+						for (uint32_t level = 0; level < num_mipmaps; ++ level)
+						{
+							size_t const index = (array_index * 6 + face - Texture::CF_Positive_X) * num_mipmaps + level;
+							if (IsCompressedFormat(format))
+							{
+								uint32_t const block_size = NumFormatBytes(format) * 4;
+								uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
+
+								base[index] = data_size;
+								data_size += image_size;
+								init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
+								init_data[index].slice_pitch = image_size;
+							}
+							else
+							{
+								init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
+								init_data[index].slice_pitch = init_data[index].row_pitch * the_width;
+								base[index] = data_size;
+								data_size += init_data[index].slice_pitch;
+							}
+
+							the_width = std::max<uint32_t>(the_width / 2, 1);
+							the_height = std::max<uint32_t>(the_height / 2, 1);
+						}
+					}
+				}
+			}
+			break;
+		}
+
+		uint8_t const * data = nullptr;
+		if (in_place)
+		{
+			data = static_cast<uint8_t const *>(tex_res->read_in_place(data_size));
+		}
+		if (!data)
+		{
+			data_block.resize(data_size);
+			tex_res->read(data_block.data(), data_size);
+			BOOST_ASSERT(tex_res->gcount() == static_cast<int64_t>(data_size));
+			data = data_block.data();
+		}
+
+		for (size_t i = 0; i < base.size(); ++ i)
+		{
+			init_data[i].data = data + base[i];
+		}
+	}
+
+
 	class TextureLoadingDesc : public ResLoadingDesc
 	{
 	private:
@@ -1096,6 +1297,8 @@ namespace
 				ElementFormat format;
 				std::vector<ElementInitData> init_data;
 				std::vector<uint8_t> data_block;
+				// Keeps the resource alive when init_data points into its memory instead of data_block
+				ResIdentifierPtr res;
 			};
 			std::shared_ptr<TexData> tex_data;
 
@@ -1258,6 +1461,14 @@ namespace
 			return true;
 		}
 
+		size_t Hash() const
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, tex_desc_.res_name.begin(), tex_desc_.res_name.end());
+			HashCombine(seed, tex_desc_.access_hint);
+			return seed;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const
 		{
 			if (this->Type() == rhs.Type())
@@ -1295,13 +1506,33 @@ namespace
 		{
 			TexDesc::TexData& tex_data = *tex_desc_.tex_data;
 
-			LoadTexture(tex_desc_.res_name, tex_data.type,
+			ResIdentifierPtr tex_res = ResLoader::Instance().Open(tex_desc_.res_name);
+			LoadDDSData(tex_res, tex_data.type,
 				tex_data.width, tex_data.height, tex_data.depth,
 				tex_data.num_mipmaps, tex_data.array_size, tex_data.format,
-				tex_data.init_data, tex_data.data_block);
+				tex_data.init_data, tex_data.data_block, true);
 
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 			RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
+
+			if (tex_data.data_block.empty() && !tex_data.init_data.empty())
+			{
+				if (caps.texture_format_support(tex_data.format))
+				{
+					tex_data.res = tex_res;
+				}
+				else
+				{
+					// The format conversions below modify the data, so it's copied out of the read-only resource memory
+					uint8_t const * begin = static_cast<uint8_t const *>(tex_data.init_data[0].data);
+					uint8_t const * end = static_cast<uint8_t const *>(tex_res->data()) + tex_res->tellg();
+					tex_data.data_block.assign(begin, end);
+					for (auto& init_data : tex_data.init_data)
+					{
+						init_data.data = tex_data.data_block.data() + (static_cast<uint8_t const *>(init_data.data) - begin);
+					}
+				}
+			}
 			if ((Texture::TT_3D == tex_data.type) && (caps.max_texture_depth < tex_data.depth))
 			{
 				tex_data.type = Texture::TT_2D;
@@ -1554,10 +1785,328 @@ namespace
 			return texture;
 		}
 
-	private:
-		TexDesc tex_desc_;
-		std::mutex main_thread_stage_mutex_;
-	};
+	private:
+		TexDesc tex_desc_;
+		std::mutex main_thread_stage_mutex_;
+	};
+
+	// Resampling weights along one axis. Destination texel i is the weighted sum of count[i] consecutive source texels from
+	//  first[i], with the weights starting at weight_offset[i]. Taps out of the source are clamped to the edge.
+	struct ResampleAxis
+	{
+		std::vector<uint32_t> first;
+		std::vector<uint32_t> count;
+		std::vector<uint32_t> weight_offset;
+		std::vector<float> weights;
+	};
+
+	float Sinc(float x)
+	{
+		if (MathLib::abs(x) < 1e-4f)
+		{
+			return 1;
+		}
+		else
+		{
+			float const px = PI * x;
+			return sin(px) / px;
+		}
+	}
+
+	// Zeroth order modified Bessel function of the first kind
+	float BesselI0(float x)
+	{
+		float sum = 1;
+		float term = 1;
+		float const half_x_sq = x * x / 4;
+		for (int k = 1; k < 32; ++ k)
+		{
+			term *= half_x_sq / (k * k);
+			sum += term;
+			if (term < sum * 1e-7f)
+			{
+				break;
+			}
+		}
+		return sum;
+	}
+
+	float FilterSupport(TexResizeFilter filter)
+	{
+		switch (filter)
+		{
+		case TRF_Box:
+			return 0.5f;
+
+		case TRF_Kaiser:
+		case TRF_Lanczos3:
+			return 3;
+
+		default:
+			return 1;
+		}
+	}
+
+	// x is in source texels, relative to the center of the destination texel
+	float FilterWeight(TexResizeFilter filter, float x)
+	{
+		float const abs_x = MathLib::abs(x);
+		switch (filter)
+		{
+		case TRF_Box:
+			return (abs_x < 0.5f) ? 1.0f : ((abs_x == 0.5f) ? 0.5f : 0.0f);
+
+		case TRF_Kaiser:
+			{
+				float const ALPHA = 4;
+				float const WIDTH = 3;
+				if (abs_x >= WIDTH)
+				{
+					return 0;
+				}
+				float const t = x / WIDTH;
+				return Sinc(x) * BesselI0(ALPHA * sqrt(1 - t * t)) / BesselI0(ALPHA);
+			}
+
+		case TRF_Lanczos3:
+			return (abs_x < 3) ? Sinc(x) * Sinc(x / 3) : 0.0f;
+
+		default:
+			return std::max(1 - abs_x, 0.0f);
+		}
+	}
+
+	void BuildResampleAxis(ResampleAxis& axis, uint32_t src_size, uint32_t dst_size, TexResizeFilter filter)
+	{
+		axis.first.resize(dst_size);
+		axis.count.resize(dst_size);
+		axis.weight_offset.resize(dst_size);
+		axis.weights.clear();
+
+		float const ratio = static_cast<float>(src_size) / dst_size;
+		switch (filter)
+		{
+		case TRF_Point:
+			for (uint32_t i = 0; i < dst_size; ++ i)
+			{
+				axis.first[i] = std::min(static_cast<uint32_t>((i + 0.5f) * ratio), src_size - 1);
+				axis.count[i] = 1;
+				axis.weight_offset[i] = static_cast<uint32_t>(axis.weights.size());
+				axis.weights.push_back(1);
+			}
+			break;
+
+		case TRF_Bilinear:
+			for (uint32_t i = 0; i < dst_size; ++ i)
+			{
+				float const f = i * ratio;
+				uint32_t const s0 = std::min(static_cast<uint32_t>(f), src_size - 1);
+				axis.first[i] = s0;
+				axis.weight_offset[i] = static_cast<uint32_t>(axis.weights.size());
+				if (s0 + 1 < src_size)
+				{
+					float const w = f - s0;
+					axis.count[i] = 2;
+					axis.weights.push_back(1 - w);
+					axis.weights.push_back(w);
+				}
+				else
+				{
+					axis.count[i] = 1;
+					axis.weights.push_back(1);
+				}
+			}
+			break;
+
+		default:
+			{
+				float const scale = std::max(ratio, 1.0f);
+				float const support = FilterSupport(filter) * scale;
+				std::vector<float> taps;
+				for (uint32_t i = 0; i < dst_size; ++ i)
+				{
+					float const center = (i + 0.5f) * ratio;
+					int const begin = static_cast<int>(floor(center - support));
+					int const end = static_cast<int>(ceil(center + support));
+					int const lo = MathLib::clamp(begin, 0, static_cast<int>(src_size - 1));
+					int const hi = MathLib::clamp(end, 0, static_cast<int>(src_size - 1));
+
+					taps.assign(hi - lo + 1, 0.0f);
+					float sum = 0;
+					for (int j = begin; j <= end; ++ j)
+					{
+						float const w = FilterWeight(filter, (j + 0.5f - center) / scale);
+						taps[MathLib::clamp(j, lo, hi) - lo] += w;
+						sum += w;
+					}
+
+					// Skips the zero weights on both ends
+					int first = 0;
+					int last = static_cast<int>(taps.size()) - 1;
+					while ((first < last) && (0 == taps[first]))
+					{
+						++ first;
+					}
+					while ((last > first) && (0 == taps[last]))
+					{
+						-- last;
+					}
+
+					axis.first[i] = lo + first;
+					axis.weight_offset[i] = static_cast<uint32_t>(axis.weights.size());
+					if (MathLib::abs(sum) > 1e-6f)
+					{
+						axis.count[i] = last - first + 1;
+						for (int j = first; j <= last; ++ j)
+						{
+							axis.weights.push_back(taps[j] / sum);
+						}
+					}
+					else
+					{
+						axis.first[i] = std::min(static_cast<uint32_t>(center), src_size - 1);
+						axis.count[i] = 1;
+						axis.weights.push_back(1);
+					}
+				}
+			}
+			break;
+		}
+	}
+
+	// Rows of about this many texels are processed by one task
+	uint32_t const RESAMPLE_TEXELS_PER_TASK = 16 * 1024;
+
+	uint32_t ResampleGrainSize(uint32_t row_length)
+	{
+		return std::max(RESAMPLE_TEXELS_PER_TASK / std::max(row_length, 1U), 1U);
+	}
+
+	// Separable resampling of colors in linear space. Each axis that changes size is filtered in its own pass, and every pass runs
+	//  on tiles of rows in parallel. The horizontal pass sums 4D vectors, the others accumulate whole rows with SIMD.
+	void ResampleColors(std::vector<Color>& dst, uint32_t dst_width, uint32_t dst_height, uint32_t dst_depth,
+		std::vector<Color> const & src, uint32_t src_width, uint32_t src_height, uint32_t src_depth,
+		TexResizeFilter filter)
+	{
+		task_scheduler& scheduler = Context::Instance().TaskScheduler();
+
+		std::vector<Color> tmp_x;
+		std::vector<Color> tmp_y;
+		Color const * cur = src.data();
+
+		if (dst_width != src_width)
+		{
+			ResampleAxis axis;
+			BuildResampleAxis(axis, src_width, dst_width, filter);
+
+			uint32_t const num_rows = src_height * src_depth;
+			tmp_x.resize(dst_width * num_rows);
+			scheduler.parallel_for(0, num_rows, ResampleGrainSize(dst_width), [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t row = begin; row < end; ++ row)
+					{
+						Color const * src_row = cur + row * src_width;
+						Color* dst_row = &tmp_x[row * dst_width];
+						for (uint32_t x = 0; x < dst_width; ++ x)
+						{
+							SIMDMathLib::WeightedSumVector4(&dst_row[x].r(), &src_row[axis.first[x]].r(),
+								&axis.weights[axis.weight_offset[x]], axis.count[x]);
+						}
+					}
+				});
+			cur = tmp_x.data();
+		}
+
+		// The vertical and depth passes are the same, with rows of dst_width texels, and planes of rows
+		auto resample_rows = [&scheduler, dst_width, filter](std::vector<Color>& out, Color const * in,
+			uint32_t num_planes, uint32_t in_rows_per_plane, uint32_t out_rows_per_plane, uint32_t row_stride,
+			uint32_t src_size, uint32_t dst_size)
+		{
+			ResampleAxis axis;
+			BuildResampleAxis(axis, src_size, dst_size, filter);
+
+			out.assign(dst_width * num_planes * out_rows_per_plane, Color(0, 0, 0, 0));
+			scheduler.parallel_for(0, num_planes * out_rows_per_plane, ResampleGrainSize(dst_width),
+				[&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t out_row = begin; out_row < end; ++ out_row)
+					{
+						uint32_t const plane = out_row / out_rows_per_plane;
+						uint32_t const i = out_row % out_rows_per_plane;
+						Color const * in_plane = in + plane * in_rows_per_plane * dst_width;
+						float* dst_row = &out[out_row * dst_width].r();
+						for (uint32_t k = 0; k < axis.count[i]; ++ k)
+						{
+							SIMDMathLib::MultiplyAddArray(dst_row, &in_plane[(axis.first[i] + k) * row_stride].r(),
+								axis.weights[axis.weight_offset[i] + k], dst_width * 4);
+						}
+					}
+				});
+		};
+
+		if (dst_height != src_height)
+		{
+			// Planes are slices, rows are y
+			resample_rows(tmp_y, cur, src_depth, src_height, dst_height, dst_width, src_height, dst_height);
+			cur = tmp_y.data();
+		}
+
+		if (dst_depth != src_depth)
+		{
+			// Planes are y, rows are slices
+			std::vector<Color> tmp_z;
+			resample_rows(tmp_z, cur, dst_height, 1, dst_depth, dst_height * dst_width, src_depth, dst_depth);
+
+			// Back to slices of rows
+			dst.resize(dst_width * dst_height * dst_depth);
+			for (uint32_t y = 0; y < dst_height; ++ y)
+			{
+				for (uint32_t z = 0; z < dst_depth; ++ z)
+				{
+					std::copy_n(&tmp_z[(y * dst_depth + z) * dst_width], dst_width, &dst[(z * dst_height + y) * dst_width]);
+				}
+			}
+		}
+		else if (cur == src.data())
+		{
+			dst = src;
+		}
+		else
+		{
+			dst.swap((cur == tmp_x.data()) ? tmp_x : tmp_y);
+		}
+	}
+
+	void ConvertToColors(std::vector<Color>& colors, ElementFormat format, uint8_t const * data, uint32_t row_pitch,
+		uint32_t slice_pitch, uint32_t width, uint32_t height, uint32_t depth)
+	{
+		colors.resize(width * height * depth);
+		Context::Instance().TaskScheduler().parallel_for(0, height * depth, ResampleGrainSize(width),
+			[&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t row = begin; row < end; ++ row)
+				{
+					uint32_t const z = row / height;
+					uint32_t const y = row % height;
+					ConvertToABGR32F(format, data + z * slice_pitch + y * row_pitch, width, &colors[row * width]);
+				}
+			});
+	}
+
+	void ConvertFromColors(uint8_t* data, uint32_t row_pitch, uint32_t slice_pitch, ElementFormat format,
+		std::vector<Color> const & colors, uint32_t width, uint32_t height, uint32_t depth)
+	{
+		Context::Instance().TaskScheduler().parallel_for(0, height * depth, ResampleGrainSize(width),
+			[&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t row = begin; row < end; ++ row)
+				{
+					uint32_t const z = row / height;
+					uint32_t const y = row % height;
+					ConvertFromABGR32F(format, &colors[row * width], width, data + z * slice_pitch + y * row_pitch);
+				}
+			});
+	}
 }
 
 namespace KlayGE
@@ -1994,195 +2543,8 @@ namespace KlayGE
 		uint32_t& width, uint32_t& height, uint32_t& depth, uint32_t& num_mipmaps, uint32_t& array_size,
 		ElementFormat& format, std::vector<ElementInitData>& init_data, std::vector<uint8_t>& data_block)
 	{
-		uint32_t row_pitch, slice_pitch;
-		GetImageInfo(tex_res, type, width, height, depth, num_mipmaps, array_size, format,
-			row_pitch, slice_pitch);
-
-		uint32_t const fmt_size = NumFormatBytes(format);
-		bool padding = false;
-		if (!IsCompressedFormat(format))
-		{
-			if (row_pitch != width * fmt_size)
-			{
-				BOOST_ASSERT(row_pitch == ((width + 3) & ~3) * fmt_size);
-				padding = true;
-			}
-		}
-
-		std::vector<size_t> base;
-		switch (type)
-		{
-		case Texture::TT_1D:
-			{
-				init_data.resize(array_size * num_mipmaps);
-				base.resize(array_size * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					uint32_t the_width = width;
-					for (uint32_t level = 0; level < num_mipmaps; ++ level)
-					{
-						size_t const index = array_index * num_mipmaps + level;
-						uint32_t image_size;
-						if (IsCompressedFormat(format))
-						{
-							uint32_t const block_size = NumFormatBytes(format) * 4;
-							image_size = ((the_width + 3) / 4) * block_size;
-						}
-						else
-						{
-							image_size = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-						}
-
-						base[index] = data_block.size();
-						data_block.resize(base[index] + image_size);
-						init_data[index].row_pitch = image_size;
-						init_data[index].slice_pitch = image_size;
-
-						tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-						BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-
-						the_width = std::max<uint32_t>(the_width / 2, 1);
-					}
-				}
-			}
-			break;
-
-		case Texture::TT_2D:
-			{
-				init_data.resize(array_size * num_mipmaps);
-				base.resize(array_size * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					uint32_t the_width = width;
-					uint32_t the_height = height;
-					for (uint32_t level = 0; level < num_mipmaps; ++ level)
-					{
-						size_t const index = array_index * num_mipmaps + level;
-						if (IsCompressedFormat(format))
-						{
-							uint32_t const block_size = NumFormatBytes(format) * 4;
-							uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
-
-							base[index] = data_block.size();
-							data_block.resize(base[index] + image_size);
-							init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
-							init_data[index].slice_pitch = image_size;
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-						}
-						else
-						{
-							init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-							init_data[index].slice_pitch = init_data[index].row_pitch * the_height;
-							base[index] = data_block.size();
-							data_block.resize(base[index] + init_data[index].slice_pitch);
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(init_data[index].slice_pitch));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(init_data[index].slice_pitch));
-						}
-
-						the_width = std::max<uint32_t>(the_width / 2, 1);
-						the_height = std::max<uint32_t>(the_height / 2, 1);
-					}
-				}
-			}
-			break;
-
-		case Texture::TT_3D:
-			{
-				init_data.resize(array_size * num_mipmaps);
-				base.resize(array_size * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					uint32_t the_width = width;
-					uint32_t the_height = height;
-					uint32_t the_depth = depth;
-					for (uint32_t level = 0; level < num_mipmaps; ++ level)
-					{
-						size_t const index = array_index * num_mipmaps + level;
-						if (IsCompressedFormat(format))
-						{
-							uint32_t const block_size = NumFormatBytes(format) * 4;
-							uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * the_depth * block_size;
-
-							base[index] = data_block.size();
-							data_block.resize(base[index] + image_size);
-							init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
-							init_data[index].slice_pitch = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-						}
-						else
-						{
-							init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-							init_data[index].slice_pitch = init_data[index].row_pitch * the_height;
-							base[index] = data_block.size();
-							data_block.resize(base[index] + init_data[index].slice_pitch * the_depth);
-
-							tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(init_data[index].slice_pitch * the_depth));
-							BOOST_ASSERT(tex_res->gcount() == static_cast<int>(init_data[index].slice_pitch * the_depth));
-						}
-
-						the_width = std::max<uint32_t>(the_width / 2, 1);
-						the_height = std::max<uint32_t>(the_height / 2, 1);
-						the_depth = std::max<uint32_t>(the_depth / 2, 1);
-					}
-				}
-			}
-			break;
-
-		case Texture::TT_Cube:
-			{
-				init_data.resize(array_size * 6 * num_mipmaps);
-				base.resize(array_size * 6 * num_mipmaps);
-				for (uint32_t array_index = 0; array_index < array_size; ++ array_index)
-				{
-					for (uint32_t face = Texture::CF_Positive_X; face <= Texture::CF_Negative_Z; ++ face)
-					{
-						uint32_t the_width = width;
-						uint32_t the_height = height;
-						for (uint32_t level = 0; level < num_mipmaps; ++ level)
-						{
-							size_t const index = (array_index * 6 + face - Texture::CF_Positive_X) * num_mipmaps + level;
-							if (IsCompressedFormat(format))
-							{
-								uint32_t const block_size = NumFormatBytes(format) * 4;
-								uint32_t image_size = ((the_width + 3) / 4) * ((the_height + 3) / 4) * block_size;
-
-								base[index] = data_block.size();
-								data_block.resize(base[index] + image_size);
-								init_data[index].row_pitch = (the_width + 3) / 4 * block_size;
-								init_data[index].slice_pitch = image_size;
-
-								tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(image_size));
-								BOOST_ASSERT(tex_res->gcount() == static_cast<int>(image_size));
-							}
-							else
-							{
-								init_data[index].row_pitch = (padding ? ((the_width + 3) & ~3) : the_width) * fmt_size;
-								init_data[index].slice_pitch = init_data[index].row_pitch * the_width;
-								base[index] = data_block.size();
-								data_block.resize(base[index] + init_data[index].slice_pitch);
-
-								tex_res->read(&data_block[base[index]], static_cast<std::streamsize>(init_data[index].slice_pitch));
-								BOOST_ASSERT(tex_res->gcount() == static_cast<int>(init_data[index].slice_pitch));
-							}
-
-							the_width = std::max<uint32_t>(the_width / 2, 1);
-							the_height = std::max<uint32_t>(the_height / 2, 1);
-						}
-					}
-				}
-			}
-			break;
-		}
-
-		for (size_t i = 0; i < base.size(); ++ i)
-		{
-			init_data[i].data = &data_block[base[i]];
-		}
+		LoadDDSData(tex_res, type, width, height, depth, num_mipmaps, array_size, format,
+			init_data, data_block, false);
 	}
 
 	TexturePtr SyncLoadTexture(std::string const & tex_name, uint32_t access_hint)
@@ -3324,6 +3686,17 @@ namespace KlayGE
 		void const * src_data, uint32_t src_row_pitch, uint32_t src_slice_pitch, ElementFormat src_format,
 		uint32_t src_width, uint32_t src_height, uint32_t src_depth,
 		bool linear)
+	{
+		ResizeTexture(dst_data, dst_row_pitch, dst_slice_pitch, dst_format, dst_width, dst_height, dst_depth,
+			src_data, src_row_pitch, src_slice_pitch, src_format, src_width, src_height, src_depth,
+			linear ? TRF_Bilinear : TRF_Point);
+	}
+
+	void ResizeTexture(void* dst_data, uint32_t dst_row_pitch, uint32_t dst_slice_pitch, ElementFormat dst_format,
+		uint32_t dst_width, uint32_t dst_height, uint32_t dst_depth,
+		void const * src_data, uint32_t src_row_pitch, uint32_t src_slice_pitch, ElementFormat src_format,
+		uint32_t src_width, uint32_t src_height, uint32_t src_depth,
+		TexResizeFilter filter)
 	{
 		std::vector<uint8_t> src_cpu_data_block;
 		void* src_cpu_data;
@@ -3386,6 +3759,7 @@ namespace KlayGE
 				break;
 
 			case EF_SIGNED_BC5:
+			case EF_SIGNED_ETC2_GR11:
 				dst_cpu_format = EF_SIGNED_GR8;
 				break;
 
@@ -3412,7 +3786,7 @@ namespace KlayGE
 				break;
 			}
 
-			dst_cpu_row_pitch = dst_width * NumFormatBytes(src_cpu_format);
+			dst_cpu_row_pitch = dst_width * NumFormatBytes(dst_cpu_format);
 			dst_cpu_slice_pitch = dst_cpu_row_pitch * dst_height;
 			dst_cpu_data_block.resize(dst_depth * dst_cpu_slice_pitch);
 			dst_cpu_data = &dst_cpu_data_block[0];
@@ -3430,7 +3804,7 @@ namespace KlayGE
 		uint32_t const src_elem_size = NumFormatBytes(src_cpu_format);
 		uint32_t const dst_elem_size = NumFormatBytes(dst_cpu_format);
 
-		if (!linear && (src_cpu_format == dst_cpu_format))
+		if ((TRF_Point == filter) && (src_cpu_format == dst_cpu_format))
 		{
 			for (uint32_t z = 0; z < dst_depth; ++ z)
 			{
@@ -3461,96 +3835,158 @@ namespace KlayGE
 				}
 			}
 		}
-		else
+		else if ((src_width == dst_width) && (src_height == dst_height) && (src_depth == dst_depth))
 		{
-			std::vector<Color> src_32f(src_width * src_height * src_depth);
-			{
-				for (uint32_t z = 0; z < src_depth; ++ z)
+			Context::Instance().TaskScheduler().parallel_for(0, dst_height * dst_depth, ResampleGrainSize(dst_width),
+				[&](uint32_t begin, uint32_t end)
 				{
-					for (uint32_t y = 0; y < src_height; ++ y)
+					for (uint32_t row = begin; row < end; ++ row)
 					{
-						ConvertToABGR32F(src_cpu_format, src_ptr + z * src_cpu_slice_pitch + y * src_cpu_row_pitch,
-							src_width, &src_32f[(z * src_height + y) * src_width]);
+						uint32_t const z = row / dst_height;
+						uint32_t const y = row % dst_height;
+						ConvertFormat(src_cpu_format, src_ptr + z * src_cpu_slice_pitch + y * src_cpu_row_pitch, dst_width,
+							dst_cpu_format, dst_ptr + z * dst_cpu_slice_pitch + y * dst_cpu_row_pitch);
 					}
-				}
-			}
+				});
+		}
+		else
+		{
+			std::vector<Color> src_32f;
+			ConvertToColors(src_32f, src_cpu_format, src_ptr, src_cpu_row_pitch, src_cpu_slice_pitch,
+				src_width, src_height, src_depth);
+
+			std::vector<Color> dst_32f;
+			ResampleColors(dst_32f, dst_width, dst_height, dst_depth, src_32f, src_width, src_height, src_depth, filter);
+
+			ConvertFromColors(dst_ptr, dst_cpu_row_pitch, dst_cpu_slice_pitch, dst_cpu_format, dst_32f,
+				dst_width, dst_height, dst_depth);
+		}
+
+		if (IsCompressedFormat(dst_format))
+		{
+			EncodeTexture(dst_data, dst_row_pitch, dst_slice_pitch, dst_format,
+				dst_cpu_data, dst_cpu_row_pitch, dst_cpu_slice_pitch, dst_cpu_format,
+				dst_width, dst_height, dst_depth);
+		}
+	}
+
+
+	void BuildMipChain(std::vector<ElementInitData>& mip_data, std::vector<uint8_t>& data_block,
+		ElementFormat format, uint32_t width, uint32_t height, uint32_t depth, uint32_t num_mipmaps,
+		void const * src_data, uint32_t src_row_pitch, uint32_t src_slice_pitch,
+		TexResizeFilter filter)
+	{
+		BOOST_ASSERT(num_mipmaps > 0);
+
+		bool const compressed = IsCompressedFormat(format);
 
-			std::vector<Color> dst_32f(dst_width * dst_height * dst_depth);
-			if (linear)
+		std::vector<size_t> offsets(num_mipmaps);
+		mip_data.resize(num_mipmaps);
+		size_t total_size = 0;
+		{
+			uint32_t the_width = width;
+			uint32_t the_height = height;
+			uint32_t the_depth = depth;
+			for (uint32_t level = 0; level < num_mipmaps; ++ level)
 			{
-				for (uint32_t z = 0; z < dst_depth; ++ z)
+				if (compressed)
 				{
-					float fz = static_cast<float>(z) / dst_depth * src_depth;
-					uint32_t sz0 = static_cast<uint32_t>(fz);
-					uint32_t sz1 = MathLib::clamp<uint32_t>(sz0 + 1, 0, src_depth - 1);
-					float weight_z = fz - sz0;
-							
-					for (uint32_t y = 0; y < dst_height; ++ y)
-					{
-						float fy = static_cast<float>(y) / dst_height * src_height;
-						uint32_t sy0 = static_cast<uint32_t>(fy);
-						uint32_t sy1 = MathLib::clamp<uint32_t>(sy0 + 1, 0, src_height - 1);
-						float weight_y = fy - sy0;
-							
-						for (uint32_t x = 0; x < dst_width; ++ x)
-						{
-							float fx = static_cast<float>(x) / dst_width * src_width;
-							uint32_t sx0 = static_cast<uint32_t>(fx);
-							uint32_t sx1 = MathLib::clamp<uint32_t>(sx0 + 1, 0, src_width - 1);
-							float weight_x = fx - sx0;
-							Color clr_x00 = MathLib::lerp(src_32f[(sz0 * src_height + sy0) * src_width + sx0],
-								src_32f[(sz0 * src_height + sy0) * src_width + sx1], weight_x);
-							Color clr_x01 = MathLib::lerp(src_32f[(sz0 * src_height + sy1) * src_width + sx0],
-								src_32f[(sz0 * src_height + sy1) * src_width + sx1], weight_x);
-							Color clr_y0 = MathLib::lerp(clr_x00, clr_x01, weight_y);
-							Color clr_x10 = MathLib::lerp(src_32f[(sz1 * src_height + sy0) * src_width + sx0],
-								src_32f[(sz1 * src_height + sy0) * src_width + sx1], weight_x);
-							Color clr_x11 = MathLib::lerp(src_32f[(sz1 * src_height + sy1) * src_width + sx0],
-								src_32f[(sz1 * src_height + sy1) * src_width + sx1], weight_x);
-							Color clr_y1 = MathLib::lerp(clr_x10, clr_x11, weight_y);
-							dst_32f[(z * dst_height + y) * dst_width + x] = MathLib::lerp(clr_y0, clr_y1, weight_z);
-						}
-					}
+					uint32_t const block_size = NumFormatBytes(format) * 4;
+					mip_data[level].row_pitch = (the_width + 3) / 4 * block_size;
+					mip_data[level].slice_pitch = (the_height + 3) / 4 * mip_data[level].row_pitch;
 				}
-			}
-			else
-			{
-				for (uint32_t z = 0; z < dst_depth; ++ z)
+				else
 				{
-					float fz = static_cast<float>(z + 0.5f) / dst_depth * src_depth;
-					uint32_t sz = std::min(static_cast<uint32_t>(fz), src_depth - 1);
-
-					for (uint32_t y = 0; y < dst_height; ++ y)
-					{
-						float fy = static_cast<float>(y + 0.5f) / dst_height * src_height;
-						uint32_t sy = std::min(static_cast<uint32_t>(fy), src_height - 1);
-
-						for (uint32_t x = 0; x < dst_width; ++ x)
-						{
-							float fx = static_cast<float>(x + 0.5f) / dst_width * src_width;
-							uint32_t sx = std::min(static_cast<uint32_t>(fx), src_width - 1);
-							dst_32f[(z * dst_height + y) * dst_width + x] = src_32f[(sz * src_height + sy) * src_width + sx];
-						}
-					}
+					mip_data[level].row_pitch = the_width * NumFormatBytes(format);
+					mip_data[level].slice_pitch = the_height * mip_data[level].row_pitch;
 				}
+				offsets[level] = total_size;
+				total_size += mip_data[level].slice_pitch * the_depth;
+
+				the_width = std::max(the_width / 2, 1U);
+				the_height = std::max(the_height / 2, 1U);
+				the_depth = std::max(the_depth / 2, 1U);
 			}
+		}
+		data_block.resize(total_size);
+		for (uint32_t level = 0; level < num_mipmaps; ++ level)
+		{
+			mip_data[level].data = &data_block[offsets[level]];
+		}
 
+		{
+			uint32_t const num_rows = compressed ? (height + 3) / 4 : height;
+			uint8_t const * src = static_cast<uint8_t const *>(src_data);
+			uint8_t* dst = &data_block[0];
+			for (uint32_t z = 0; z < depth; ++ z)
 			{
-				for (uint32_t z = 0; z < dst_depth; ++ z)
+				for (uint32_t y = 0; y < num_rows; ++ y)
 				{
-					for (uint32_t y = 0; y < dst_height; ++ y)
-					{
-						ConvertFromABGR32F(dst_cpu_format, &dst_32f[(z * dst_height + y) * dst_width], dst_width, dst_ptr + z * dst_cpu_slice_pitch + y * dst_cpu_row_pitch);
-					}
+					std::memcpy(dst + z * mip_data[0].slice_pitch + y * mip_data[0].row_pitch,
+						src + z * src_slice_pitch + y * src_row_pitch, mip_data[0].row_pitch);
 				}
 			}
 		}
 
-		if (IsCompressedFormat(dst_format))
+		if (num_mipmaps > 1)
 		{
-			EncodeTexture(dst_data, dst_row_pitch, dst_slice_pitch, dst_format,
-				dst_cpu_data, dst_cpu_row_pitch, dst_cpu_slice_pitch, dst_cpu_format,
-				dst_width, dst_height, dst_depth);
+			std::vector<uint8_t> cpu_data_block;
+			uint8_t const * cpu_data;
+			uint32_t cpu_row_pitch;
+			uint32_t cpu_slice_pitch;
+			ElementFormat cpu_format;
+			if (compressed)
+			{
+				DecodeTexture(cpu_data_block, cpu_row_pitch, cpu_slice_pitch, cpu_format,
+					mip_data[0].data, mip_data[0].row_pitch, mip_data[0].slice_pitch, format, width, height, depth);
+				cpu_data = &cpu_data_block[0];
+			}
+			else
+			{
+				cpu_data = static_cast<uint8_t const *>(mip_data[0].data);
+				cpu_row_pitch = mip_data[0].row_pitch;
+				cpu_slice_pitch = mip_data[0].slice_pitch;
+				cpu_format = format;
+			}
+
+			std::vector<Color> src_32f;
+			ConvertToColors(src_32f, cpu_format, cpu_data, cpu_row_pitch, cpu_slice_pitch, width, height, depth);
+
+			std::vector<Color> dst_32f;
+			uint32_t src_width = width;
+			uint32_t src_height = height;
+			uint32_t src_depth = depth;
+			for (uint32_t level = 1; level < num_mipmaps; ++ level)
+			{
+				uint32_t const dst_width = std::max(src_width / 2, 1U);
+				uint32_t const dst_height = std::max(src_height / 2, 1U);
+				uint32_t const dst_depth = std::max(src_depth / 2, 1U);
+
+				ResampleColors(dst_32f, dst_width, dst_height, dst_depth, src_32f, src_width, src_height, src_depth, filter);
+
+				uint8_t* dst = &data_block[offsets[level]];
+				if (compressed)
+				{
+					uint32_t const dst_cpu_row_pitch = dst_width * NumFormatBytes(cpu_format);
+					uint32_t const dst_cpu_slice_pitch = dst_cpu_row_pitch * dst_height;
+					cpu_data_block.resize(dst_cpu_slice_pitch * dst_depth);
+					ConvertFromColors(&cpu_data_block[0], dst_cpu_row_pitch, dst_cpu_slice_pitch, cpu_format, dst_32f,
+						dst_width, dst_height, dst_depth);
+					EncodeTexture(dst, mip_data[level].row_pitch, mip_data[level].slice_pitch, format,
+						&cpu_data_block[0], dst_cpu_row_pitch, dst_cpu_slice_pitch, cpu_format,
+						dst_width, dst_height, dst_depth);
+				}
+				else
+				{
+					ConvertFromColors(dst, mip_data[level].row_pitch, mip_data[level].slice_pitch, format, dst_32f,
+						dst_width, dst_height, dst_depth);
+				}
+
+				src_32f.swap(dst_32f);
+				src_width = dst_width;
+				src_height = dst_height;
+				src_depth = dst_depth;
+			}
 		}
 	}
 
@@ -53,13 +53,71 @@
 #include <KlayGE/InputFactory.hpp>
 #include <KlayGE/FrameBuffer.hpp>
 #include <KlayGE/DeferredRenderingLayer.hpp>
+#include <KlayGE/PerfProfiler.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/SIMDMath.hpp>
+#include <KFL/TaskScheduler.hpp>
 
 #include <map>
 #include <algorithm>
+#include <cstring>
 
 #include <KlayGE/SceneManager.hpp>
 
+namespace
+{
+	// Stable LSD radix sort of 64-bit keys along with their values, 8 bits per pass. The histograms of all passes are
+	//  built in one go, and a pass is skipped if all the keys have the same byte in it.
+	void RadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values,
+		std::vector<uint64_t>& tmp_keys, std::vector<uint32_t>& tmp_values)
+	{
+		size_t const num = keys.size();
+		if (num <= 1)
+		{
+			return;
+		}
+
+		tmp_keys.resize(num);
+		tmp_values.resize(num);
+
+		uint32_t counts[8][256] = {};
+		for (auto key : keys)
+		{
+			for (int pass = 0; pass < 8; ++ pass)
+			{
+				++ counts[pass][(key >> (pass * 8)) & 0xFF];
+			}
+		}
+
+		for (int pass = 0; pass < 8; ++ pass)
+		{
+			uint32_t const shift = pass * 8;
+			if (counts[pass][(keys[0] >> shift) & 0xFF] == num)
+			{
+				continue;
+			}
+
+			uint32_t offsets[256];
+			uint32_t sum = 0;
+			for (int i = 0; i < 256; ++ i)
+			{
+				offsets[i] = sum;
+				sum += counts[pass][i];
+			}
+
+			for (size_t i = 0; i < num; ++ i)
+			{
+				uint32_t const dst = offsets[(keys[i] >> shift) & 0xFF] ++;
+				tmp_keys[dst] = keys[i];
+				tmp_values[dst] = values[i];
+			}
+
+			keys.swap(tmp_keys);
+			values.swap(tmp_values);
+		}
+	}
+}
+
 namespace KlayGE
 {
 	// 캯
@@ -71,7 +129,7 @@ namespace KlayGE
 			num_objects_rendered_(0), num_renderables_rendered_(0),
 			num_primitives_rendered_(0), num_vertices_rendered_(0),
 			num_draw_calls_(0), num_dispatch_calls_(0),
-			quit_(false), deferred_mode_(false)
+			quit_(false), sub_thread_update_ready_(false), deferred_mode_(false)
 	{
 	}
 
@@ -80,7 +138,10 @@ namespace KlayGE
 	SceneManager::~SceneManager()
 	{
 		quit_ = true;
-		(*update_thread_)();
+		if (update_thread_)
+		{
+			(*update_thread_)();
+		}
 
 		this->ClearLight();
 		this->ClearCamera();
@@ -109,71 +170,247 @@ namespace KlayGE
 
 	// ü
 	/////////////////////////////////////////////////////////////////////////////////
-	void SceneManager::ClipScene()
+	void SceneManager::CullViews(CullingView const * views, uint32_t num_views)
 	{
-		App3DFramework& app = Context::Instance().AppInstance();
-		Camera& camera = app.ActiveCamera();
+		std::lock_guard<std::mutex> lock(update_mutex_);
+		this->CullViewsLocked(views, num_views);
+	}
+
+	void SceneManager::CullViewsLocked(CullingView const * views, uint32_t num_views)
+	{
+		size_t const visible_seed = this->VisibleSeed();
+
+		clip_views_.clear();
+		for (uint32_t i = 0; i < num_views; ++ i)
+		{
+			ClipView clip_view = this->MakeClipView(views[i], visible_seed);
+			if ((visible_bits_map_.find(clip_view.key) != visible_bits_map_.end())
+				|| std::any_of(clip_views_.begin(), clip_views_.end(),
+					[&clip_view](ClipView const & cv)
+					{
+						return cv.key == clip_view.key;
+					}))
+			{
+				continue;
+			}
+
+			clip_views_.push_back(std::move(clip_view));
+			if (clip_views_.size() == MAX_CLIP_VIEWS)
+			{
+				this->ClipAndCacheViews();
+				clip_views_.clear();
+			}
+		}
+		if (!clip_views_.empty())
+		{
+			this->ClipAndCacheViews();
+		}
+	}
+
+	size_t SceneManager::VisibleSeed() const
+	{
+		std::vector<uint32_t> visible_list((scene_objs_.size() + 31) / 32, 0);
+		for (size_t i = 0; i < scene_objs_.size(); ++ i)
+		{
+			if (scene_objs_[i]->Visible())
+			{
+				visible_list[i / 32] |= (1UL << (i & 31));
+			}
+		}
+		size_t seed = 0;
+		HashRange(seed, visible_list.begin(), visible_list.end());
+		return seed;
+	}
+
+	SceneManager::ClipView SceneManager::MakeClipView(CullingView const & view, size_t visible_seed) const
+	{
+		Camera const & camera = *view.camera;
+
+		ClipView ret;
+		ret.camera = &camera;
+		ret.cascade_index = view.cascade_index;
+		ret.omni_directional = camera.OmniDirectionalMode();
+		ret.view_proj = camera.ViewProjMatrix();
+		ret.frustum = camera.ViewFrustum();
 
-		float4x4 view_proj = camera.ViewProjMatrix();
 		auto drl = Context::Instance().DeferredRenderingLayerInstance();
-		if (drl)
+		if (drl && (view.cascade_index >= 0))
 		{
-			int32_t cas_index = drl->CurrCascadeIndex();
-			if (cas_index >= 0)
+			float4x4 const & crop = drl->GetCascadedShadowLayer()->CascadeCropMatrix(view.cascade_index);
+			ret.view_proj *= crop;
+
+			// Only the sides are cropped. Casters between the light and the cascade still cast shadows on it.
+			float4x4 const crop_view_proj = camera.ViewProjMatrixWOAdjust() * crop;
+			ret.frustum.ClipMatrix(crop_view_proj, MathLib::inverse(crop_view_proj));
+			ret.frustum.FrustumPlane(4, camera.ViewFrustum().FrustumPlane(4));
+			ret.frustum.FrustumPlane(5, camera.ViewFrustum().FrustumPlane(5));
+		}
+
+		size_t seed = visible_seed;
+		HashCombine(seed, ret.omni_directional);
+		HashCombine(seed, &camera);
+		HashCombine(seed, view.cascade_index);
+		HashRange(seed, &ret.view_proj(0, 0), &ret.view_proj(0, 0) + 16);
+		ret.key = seed;
+
+		return ret;
+	}
+
+	void SceneManager::ClipAndCacheViews()
+	{
+		this->ClipScene(clip_views_);
+
+		uint32_t const num_objs = static_cast<uint32_t>(scene_objs_.size());
+		for (auto const & view : clip_views_)
+		{
+			std::vector<uint32_t> visible_bits((num_objs + 31) / 32, 0);
+			for (uint32_t i = 0; i < num_objs; ++ i)
 			{
-				view_proj *= drl->GetCascadedShadowLayer()->CascadeCropMatrix(cas_index);
+				if (view.marks[i] != BO_No)
+				{
+					visible_bits[i / 32] |= (1UL << (i & 31));
+				}
 			}
+			visible_bits_map_.emplace(view.key, std::move(visible_bits));
 		}
+	}
 
+	void SceneManager::ClipScene(std::vector<ClipView>& views)
+	{
+		// Matrices are updated in order, since the renderables can be shared by several objects
 		for (auto const & obj : scene_objs_)
 		{
 			auto so = obj.get();
-			BoundOverlap visible;
-			uint32_t const attr = so->Attrib();
-			if (so->Visible())
+			if (so->Visible() && (so->Attrib() & SceneObject::SOA_Moveable))
 			{
-				visible = this->VisibleTestFromParent(so, camera.ForwardVec(), camera.EyePos(), view_proj);
-				if (BO_Partial == visible)
+				so->UpdateAbsModelMatrix();
+			}
+		}
+
+		// The bounds are packed once for all the views. The parts of the test that don't depend on the parent run on
+		//  all threads.
+		uint32_t const num_objs = static_cast<uint32_t>(scene_objs_.size());
+		uint32_t const num_views = static_cast<uint32_t>(views.size());
+		culling_soa_.Resize(num_objs, num_views);
+		Context::Instance().TaskScheduler().parallel_for(0, num_objs, 256,
+			[this, &views, num_objs, num_views](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++ i)
 				{
-					if (attr & SceneObject::SOA_Moveable)
+					auto so = scene_objs_[i].get();
+					uint32_t const attr = so->Visible() ? so->Attrib() : 0;
+					culling_soa_.attribs[i] = attr;
+					if (attr & SceneObject::SOA_Cullable)
 					{
-						so->UpdateAbsModelMatrix();
+						AABBox const & aabb = so->PosBoundWS();
+						float3 const center = aabb.Center();
+						float3 const extent = aabb.HalfSize();
+						culling_soa_.center_x[i] = center.x();
+						culling_soa_.center_y[i] = center.y();
+						culling_soa_.center_z[i] = center.z();
+						culling_soa_.extent_x[i] = extent.x();
+						culling_soa_.extent_y[i] = extent.y();
+						culling_soa_.extent_z[i] = extent.z();
 					}
+					else
+					{
+						culling_soa_.center_x[i] = culling_soa_.center_y[i] = culling_soa_.center_z[i] = 0;
+						culling_soa_.extent_x[i] = culling_soa_.extent_y[i] = culling_soa_.extent_z[i] = 0;
+					}
+				}
 
-					if (attr & SceneObject::SOA_Cullable)
+				for (uint32_t v = 0; v < num_views; ++ v)
+				{
+					ClipView const & view = views[v];
+					float3 const view_dir = view.camera->ForwardVec();
+					float3 const eye_pos = view.camera->EyePos();
+					uint8_t* large_enough = &culling_soa_.large_enough[v * num_objs];
+					for (uint32_t i = begin; i < end; ++ i)
 					{
-						if (small_obj_threshold_ > 0)
+						if (culling_soa_.attribs[i] & SceneObject::SOA_Cullable)
 						{
-							visible = ((MathLib::ortho_area(camera.ForwardVec(), so->PosBoundWS()) > small_obj_threshold_)
-								&& (MathLib::perspective_area(camera.EyePos(), view_proj, so->PosBoundWS()) > small_obj_threshold_))
-								? BO_Yes : BO_No;
+							AABBox const & aabb = scene_objs_[i]->PosBoundWS();
+							large_enough[i] = (small_obj_threshold_ <= 0)
+								|| ((MathLib::ortho_area(view_dir, aabb) > small_obj_threshold_)
+									&& (MathLib::perspective_area(eye_pos, view.view_proj, aabb) > small_obj_threshold_));
 						}
 						else
 						{
-							visible = BO_Yes;
+							large_enough[i] = true;
 						}
 					}
+
+					if (!view.omni_directional)
+					{
+						SIMDMathLib::IntersectAABBFrustum(&culling_soa_.overlaps[v * num_objs + begin],
+							&culling_soa_.center_x[begin], &culling_soa_.center_y[begin], &culling_soa_.center_z[begin],
+							&culling_soa_.extent_x[begin], &culling_soa_.extent_y[begin], &culling_soa_.extent_z[begin],
+							end - begin, view.frustum);
+					}
+				}
+			});
+
+		// Parents are ahead of their children, so the marks are resolved in order, view by view
+		for (uint32_t v = 0; v < num_views; ++ v)
+		{
+			ClipView& view = views[v];
+			view.marks.resize(num_objs);
+			bool const frustum_test = !view.omni_directional;
+			uint8_t const * large_enoughs = &culling_soa_.large_enough[v * num_objs];
+			BoundOverlap const * overlaps = &culling_soa_.overlaps[v * num_objs];
+			for (uint32_t i = 0; i < num_objs; ++ i)
+			{
+				auto so = scene_objs_[i].get();
+				BoundOverlap visible;
+				if (so->Visible())
+				{
+					uint32_t const attr = culling_soa_.attribs[i];
+					bool const cullable = (attr & SceneObject::SOA_Cullable) != 0;
+					bool const large_enough = large_enoughs[i] != 0;
+
+					if (so->Parent())
+					{
+						BoundOverlap const parent_bo = so->Parent()->VisibleMark();
+						visible = ((BO_No == parent_bo) || (cullable && !large_enough)) ? BO_No : parent_bo;
+					}
 					else
 					{
-						visible = BO_Yes;
+						visible = BO_Partial;
 					}
 
-					if (!camera.OmniDirectionalMode() && (attr & SceneObject::SOA_Cullable)
-						&& (BO_Yes == visible))
+					if (BO_Partial == visible)
 					{
-						visible = this->AABBVisible(so->PosBoundWS());
+						visible = (cullable && !large_enough) ? BO_No : BO_Yes;
+						if (frustum_test && cullable && (BO_Yes == visible))
+						{
+							visible = overlaps[i];
+						}
 					}
 				}
-			}
-			else
-			{
-				visible = BO_No;
-			}
+				else
+				{
+					visible = BO_No;
+				}
 
-			so->VisibleMark(visible);
+				so->VisibleMark(visible);
+				view.marks[i] = visible;
+			}
 		}
 	}
 
+	void SceneManager::CullingSoA::Resize(uint32_t num, uint32_t num_views)
+	{
+		attribs.resize(num);
+		center_x.resize(num);
+		center_y.resize(num);
+		center_z.resize(num);
+		extent_x.resize(num);
+		extent_y.resize(num);
+		extent_z.resize(num);
+		large_enough.resize(num * num_views);
+		overlaps.resize(num * num_views);
+	}
+
 	void SceneManager::AddCamera(CameraPtr const & camera)
 	{
 		cameras_.push_back(camera);
@@ -357,20 +594,7 @@ namespace KlayGE
 			{
 				RenderTechnique const * obj_tech = obj->GetRenderTechnique();
 				BOOST_ASSERT(obj_tech);
-				bool found = false;
-				for (auto& items : render_queue_)
-				{
-					if (items.first == obj_tech)
-					{
-						items.second.push_back(obj);
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					render_queue_.emplace_back(obj_tech, std::vector<Renderable*>(1, obj));
-				}
+				render_queue_.emplace_back(obj_tech, obj);
 			}
 		}
 	}
@@ -459,6 +683,8 @@ namespace KlayGE
 	/////////////////////////////////////////////////////////////////////////////////
 	void SceneManager::Update()
 	{
+		KLAYGE_PERF_SCOPE("SceneManager::Update");
+
 		deferred_mode_ = !!Context::Instance().DeferredRenderingLayerInstance();
 
 		App3DFramework& app = Context::Instance().AppInstance();
@@ -468,6 +694,8 @@ namespace KlayGE
 		RenderEngine& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 		re.BeginFrame();
 
+		this->PublishSubThreadUpdate();
+
 		this->FlushScene();
 
 		if (!update_thread_ && !quit_)
@@ -536,6 +764,8 @@ namespace KlayGE
 	/////////////////////////////////////////////////////////////////////////////////
 	void SceneManager::Flush(uint32_t urt)
 	{
+		KLAYGE_PERF_SCOPE("SceneManager::Flush");
+
 		std::lock_guard<std::mutex> lock(update_mutex_);
 
 		urt_ = urt;
@@ -561,38 +791,20 @@ namespace KlayGE
 		{
 			frustum_ = &camera.ViewFrustum();
 
-			std::vector<uint32_t> visible_list((scene_objs.size() + 31) / 32, 0);
-			for (size_t i = 0; i < scene_objs.size(); ++ i)
+			auto drl = Context::Instance().DeferredRenderingLayerInstance();
+			CullingView const view = { &camera, drl ? drl->CurrCascadeIndex() : -1 };
+			size_t const key = this->MakeClipView(view, this->VisibleSeed()).key;
+			auto iter = visible_bits_map_.find(key);
+			if (iter == visible_bits_map_.end())
 			{
-				if (scene_objs[i]->Visible())
-				{
-					visible_list[i / 32] |= (1UL << (i & 31));
-				}
+				this->CullViewsLocked(&view, 1);
+				iter = visible_bits_map_.find(key);
 			}
-			size_t seed = 0;
-			HashRange(seed, visible_list.begin(), visible_list.end());
-			HashCombine(seed, camera.OmniDirectionalMode());
-			HashCombine(seed, &camera);
-
-			auto vmiter = visible_marks_map_.find(seed);
-			if (vmiter == visible_marks_map_.end())
-			{
-				this->ClipScene();
-
-				auto visible_marks = MakeUniquePtr<std::vector<BoundOverlap>>(scene_objs.size());
-				for (size_t i = 0; i < scene_objs.size(); ++ i)
-				{
-					(*visible_marks)[i] = scene_objs[i]->VisibleMark();
-				}
 
-				visible_marks_map_.emplace(seed, std::move(visible_marks));
-			}
-			else
+			auto const & visible_bits = iter->second;
+			for (size_t i = 0; i < scene_objs.size(); ++ i)
 			{
-				for (size_t i = 0; i < scene_objs.size(); ++ i)
-				{
-					scene_objs[i]->VisibleMark((*vmiter->second)[i]);
-				}
+				scene_objs[i]->VisibleMark((visible_bits[i / 32] & (1UL << (i & 31))) ? BO_Yes : BO_No);
 			}
 		}
 		if (urt & App3DFramework::URV_Overlay)
@@ -635,60 +847,12 @@ namespace KlayGE
 			}
 		}
 
-		std::sort(render_queue_.begin(), render_queue_.end(),
-			[](std::pair<RenderTechnique const *, std::vector<Renderable*>> const & lhs,
-				std::pair<RenderTechnique const *, std::vector<Renderable*>> const & rhs)
-			{
-				BOOST_ASSERT(lhs.first);
-				BOOST_ASSERT(rhs.first);
-
-				return lhs.first->Weight() < rhs.first->Weight();
-			});
-
-		float4 const & view_mat_z = camera.ViewMatrix().Col(2);
-		for (auto& items : render_queue_)
+		this->SortRenderQueue(camera);
+		for (auto index : render_indices_)
 		{
-			if (!items.first->Transparent() && !items.first->HasDiscard() && (items.second.size() > 1))
-			{
-				std::vector<std::pair<float, uint32_t>> min_depths(items.second.size());
-				for (size_t j = 0; j < min_depths.size(); ++ j)
-				{
-					Renderable const * renderable = items.second[j];
-					AABBox const & box = renderable->PosBound();
-					uint32_t const num = renderable->NumInstances();
-					float md = 1e10f;
-					for (uint32_t i = 0; i < num; ++ i)
-					{
-						float4x4 const & mat = renderable->GetInstance(i)->ModelMatrix();
-						float4 const zvec(MathLib::dot(mat.Row(0), view_mat_z),
-							MathLib::dot(mat.Row(1), view_mat_z), MathLib::dot(mat.Row(2), view_mat_z),
-							MathLib::dot(mat.Row(3), view_mat_z));
-						for (int k = 0; k < 8; ++ k)
-						{
-							float3 const v = box.Corner(k);
-							md = std::min(md, v.x() * zvec.x() + v.y() * zvec.y() + v.z() * zvec.z() + zvec.w());
-						}
-					}
-
-					min_depths[j] = std::make_pair(md, static_cast<uint32_t>(j));
-				}
-
-				std::sort(min_depths.begin(), min_depths.end());
-
-				std::vector<Renderable*> sorted_items(min_depths.size());
-				for (size_t j = 0; j < min_depths.size(); ++ j)
-				{
-					sorted_items[j] = items.second[min_depths[j].second];
-				}
-				items.second.swap(sorted_items);
-			}
-
-			for (auto const & item : items.second)
-			{
-				item->Render();
-			}
-			num_renderables_rendered_ += static_cast<uint32_t>(items.second.size());
+			render_queue_[index].second->Render();
 		}
+		num_renderables_rendered_ += static_cast<uint32_t>(render_queue_.size());
 		render_queue_.resize(0);
 
 		num_primitives_rendered_ += re.NumPrimitivesJustRendered();
@@ -735,11 +899,118 @@ namespace KlayGE
 		return num_dispatch_calls_;
 	}
 
+	// Packs a 64-bit key for each queued renderable, and radix sorts them. From the highest bits:
+	//  16 bits of technique order, ascending weight
+	//  32 bits of minimal view depth, for opaque techniques without discard, so they're drawn front to back
+	//  16 bits of render layout, to group the draws with the same buffers
+	// Transparent techniques only have the technique bits. The sort is stable, so they're drawn in queued order.
+	void SceneManager::SortRenderQueue(Camera const & camera)
+	{
+		uint32_t const num = static_cast<uint32_t>(render_queue_.size());
+
+		render_techs_.clear();
+		render_layouts_.clear();
+		render_keys_.resize(num);
+		render_indices_.resize(num);
+		render_tech_indices_.resize(num);
+
+		RenderTechnique const * last_tech = nullptr;
+		uint32_t last_tech_index = 0;
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			RenderTechnique const * tech = render_queue_[i].first;
+			if (tech != last_tech)
+			{
+				auto iter = std::find(render_techs_.begin(), render_techs_.end(), tech);
+				last_tech_index = static_cast<uint32_t>(iter - render_techs_.begin());
+				if (iter == render_techs_.end())
+				{
+					render_techs_.push_back(tech);
+				}
+				last_tech = tech;
+			}
+			render_tech_indices_[i] = last_tech_index;
+		}
+
+		// Techniques with the same weight stay in the order they're first queued
+		render_tech_order_.resize(render_techs_.size());
+		for (uint32_t i = 0; i < render_tech_order_.size(); ++ i)
+		{
+			render_tech_order_[i] = i;
+		}
+		std::stable_sort(render_tech_order_.begin(), render_tech_order_.end(),
+			[this](uint32_t lhs, uint32_t rhs)
+			{
+				return render_techs_[lhs]->Weight() < render_techs_[rhs]->Weight();
+			});
+		render_tech_ranks_.resize(render_techs_.size());
+		for (uint32_t i = 0; i < render_tech_order_.size(); ++ i)
+		{
+			render_tech_ranks_[render_tech_order_[i]] = i;
+		}
+
+		// The id of a render layout is its index in the sorted unique list of the layouts of opaque techniques
+		for (auto const & item : render_queue_)
+		{
+			if (!item.first->Transparent())
+			{
+				render_layouts_.push_back(&item.second->GetRenderLayout());
+			}
+		}
+		std::sort(render_layouts_.begin(), render_layouts_.end());
+		render_layouts_.erase(std::unique(render_layouts_.begin(), render_layouts_.end()), render_layouts_.end());
+
+		float4 const & view_mat_z = camera.ViewMatrix().Col(2);
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			RenderTechnique const * tech = render_queue_[i].first;
+			Renderable const * renderable = render_queue_[i].second;
+
+			uint64_t key = static_cast<uint64_t>(render_tech_ranks_[render_tech_indices_[i]]) << 48;
+			if (!tech->Transparent())
+			{
+				if (!tech->HasDiscard())
+				{
+					// The minimal depth of a box is at its center, minus the extent projected on the view axis
+					AABBox const & box = renderable->PosBound();
+					float3 const center = box.Center();
+					float3 const extent = box.HalfSize();
+					uint32_t const num_instances = renderable->NumInstances();
+					float md = 1e10f;
+					for (uint32_t j = 0; j < num_instances; ++ j)
+					{
+						float4x4 const & mat = renderable->GetInstance(j)->ModelMatrix();
+						float4 const zvec(MathLib::dot(mat.Row(0), view_mat_z),
+							MathLib::dot(mat.Row(1), view_mat_z), MathLib::dot(mat.Row(2), view_mat_z),
+							MathLib::dot(mat.Row(3), view_mat_z));
+						md = std::min(md, center.x() * zvec.x() + center.y() * zvec.y() + center.z() * zvec.z() + zvec.w()
+							- (extent.x() * std::abs(zvec.x()) + extent.y() * std::abs(zvec.y()) + extent.z() * std::abs(zvec.z())));
+					}
+
+					// Flips the float bits to an unsigned integer with the same order
+					uint32_t depth_bits;
+					std::memcpy(&depth_bits, &md, sizeof(depth_bits));
+					depth_bits = (depth_bits & 0x80000000U) ? ~depth_bits : (depth_bits | 0x80000000U);
+					key |= static_cast<uint64_t>(depth_bits) << 16;
+				}
+
+				uint32_t const layout_id = static_cast<uint32_t>(std::lower_bound(render_layouts_.begin(),
+					render_layouts_.end(), &renderable->GetRenderLayout()) - render_layouts_.begin());
+				key |= layout_id & 0xFFFF;
+			}
+
+			render_keys_[i] = key;
+			render_indices_[i] = i;
+		}
+
+		RadixSort(render_keys_, render_indices_, render_keys_tmp_, render_indices_tmp_);
+	}
+
 	void SceneManager::FlushScene()
 	{
 		RenderEngine& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 
-		visible_marks_map_.clear();
+		visible_bits_map_.clear();
 
 		uint32_t urt;
 		App3DFramework& app = Context::Instance().AppInstance();
@@ -790,18 +1061,9 @@ namespace KlayGE
 			if (Context::Instance().AppValid())
 			{
 				WindowPtr const & win = Context::Instance().AppInstance().MainWnd();
-				if (win && win->Active())
+				if (win && win->Active() && !sub_thread_update_ready_.load(std::memory_order_acquire))
 				{
-					std::lock_guard<std::mutex> lock(update_mutex_);
-
-					for (auto const & scene_obj : scene_objs_)
-					{
-						scene_obj->SubThreadUpdate(app_time, frame_time);
-					}
-					for (auto const & scene_obj : overlay_scene_objs_)
-					{
-						scene_obj->SubThreadUpdate(app_time, frame_time);
-					}
+					this->SubThreadUpdate(app_time, frame_time);
 				}
 
 				if (frame_time < update_elapse_)
@@ -812,6 +1074,59 @@ namespace KlayGE
 		}
 	}
 
+	void SceneManager::SubThreadUpdate(float app_time, float elapsed_time)
+	{
+		{
+			std::lock_guard<std::mutex> lock(update_mutex_);
+
+			sub_thread_objs_.assign(scene_objs_.begin(), scene_objs_.end());
+			sub_thread_objs_.insert(sub_thread_objs_.end(), overlay_scene_objs_.begin(), overlay_scene_objs_.end());
+
+			// Other objects may write any rendering state, so they are updated under the lock, as Flush reads that
+			//  state
+			sub_thread_parallel_objs_.clear();
+			for (auto const & scene_obj : sub_thread_objs_)
+			{
+				if (scene_obj->Attrib() & SceneObject::SOA_ParallelUpdate)
+				{
+					sub_thread_parallel_objs_.push_back(scene_obj.get());
+				}
+				else
+				{
+					scene_obj->SubThreadUpdate(app_time, elapsed_time);
+				}
+			}
+		}
+
+		// Without such objects, there is nothing to publish, and no need to wait for the main thread
+		if (!sub_thread_parallel_objs_.empty())
+		{
+			Context::Instance().TaskScheduler().parallel_for(0,
+				static_cast<uint32_t>(sub_thread_parallel_objs_.size()), 16,
+				[this, app_time, elapsed_time](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; ++ i)
+					{
+						sub_thread_parallel_objs_[i]->BufferedSubThreadUpdate(app_time, elapsed_time);
+					}
+				});
+
+			sub_thread_update_ready_.store(true, std::memory_order_release);
+		}
+	}
+
+	void SceneManager::PublishSubThreadUpdate()
+	{
+		if (sub_thread_update_ready_.load(std::memory_order_acquire))
+		{
+			for (auto scene_obj : sub_thread_parallel_objs_)
+			{
+				scene_obj->PublishSubThreadUpdate();
+			}
+			sub_thread_update_ready_.store(false, std::memory_order_release);
+		}
+	}
+
 	BoundOverlap SceneManager::VisibleTestFromParent(SceneObject* obj, float3 const & view_dir, float3 const & eye_pos,
 		float4x4 const & view_proj)
 	{
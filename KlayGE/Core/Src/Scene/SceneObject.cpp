@@ -24,12 +24,21 @@
 
 #include <KlayGE/SceneObject.hpp>
 
+namespace
+{
+	using namespace KlayGE;
+
+	// The object running BufferedSubThreadUpdate on this thread
+	thread_local SceneObject const * tls_sub_thread_obj = nullptr;
+}
+
 namespace KlayGE
 {
 	SceneObject::SceneObject(uint32_t attrib)
 		: attrib_(attrib), parent_(nullptr), renderable_hw_res_ready_(false),
 			model_(float4x4::Identity()), abs_model_(float4x4::Identity()),
-			visible_mark_(BO_No)
+			visible_mark_(BO_No),
+			sub_thread_model_dirty_(false), sub_thread_visible_(true), sub_thread_visible_dirty_(false)
 	{
 		if (!(attrib & SOA_Overlay) && (attrib & (SOA_Cullable | SOA_Moveable)))
 		{
@@ -69,12 +78,27 @@ namespace KlayGE
 
 	void SceneObject::ModelMatrix(float4x4 const & mat)
 	{
-		model_ = mat;
+		if (tls_sub_thread_obj == this)
+		{
+			sub_thread_model_ = mat;
+			sub_thread_model_dirty_ = true;
+		}
+		else
+		{
+			model_ = mat;
+		}
 	}
 
 	float4x4 const & SceneObject::ModelMatrix() const
 	{
-		return model_;
+		if ((tls_sub_thread_obj == this) && sub_thread_model_dirty_)
+		{
+			return sub_thread_model_;
+		}
+		else
+		{
+			return model_;
+		}
 	}
 
 	float4x4 const & SceneObject::AbsModelMatrix() const
@@ -156,6 +180,29 @@ namespace KlayGE
 		return refreshed;
 	}
 
+	void SceneObject::BufferedSubThreadUpdate(float app_time, float elapsed_time)
+	{
+		SceneObject const * prev_obj = tls_sub_thread_obj;
+		tls_sub_thread_obj = this;
+		this->SubThreadUpdate(app_time, elapsed_time);
+		tls_sub_thread_obj = prev_obj;
+	}
+
+	void SceneObject::PublishSubThreadUpdate()
+	{
+		if (sub_thread_model_dirty_)
+		{
+			model_ = sub_thread_model_;
+			sub_thread_model_dirty_ = false;
+		}
+		if (sub_thread_visible_dirty_)
+		{
+			// Children are only touched here, since they may be updated by other threads in the sub thread
+			this->Visible(sub_thread_visible_);
+			sub_thread_visible_dirty_ = false;
+		}
+	}
+
 	void SceneObject::AddToSceneManager()
 	{
 		Context::Instance().SceneManagerInstance().AddSceneObject(this->shared_from_this());
@@ -199,11 +246,25 @@ namespace KlayGE
 
 	bool SceneObject::Visible() const
 	{
-		return (0 == (attrib_ & SOA_Invisible));
+		if ((tls_sub_thread_obj == this) && sub_thread_visible_dirty_)
+		{
+			return sub_thread_visible_;
+		}
+		else
+		{
+			return (0 == (attrib_ & SOA_Invisible));
+		}
 	}
 
 	void SceneObject::Visible(bool vis)
 	{
+		if (tls_sub_thread_obj == this)
+		{
+			sub_thread_visible_ = vis;
+			sub_thread_visible_dirty_ = true;
+			return;
+		}
+
 		if (vis)
 		{
 			attrib_ &= ~SOA_Invisible;
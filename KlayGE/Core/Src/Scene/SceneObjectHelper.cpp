@@ -199,14 +199,14 @@ namespace KlayGE
 
 
 	SceneObjectCameraProxy::SceneObjectCameraProxy(CameraPtr const & camera)
-		: SceneObjectHelper(SOA_Cullable | SOA_Moveable | SOA_NotCastShadow),
+		: SceneObjectHelper(SOA_Cullable | SOA_Moveable | SOA_NotCastShadow | SOA_ParallelUpdate),
 			camera_(camera)
 	{
 		this->Init(camera, CreateMeshFactory<RenderableCameraProxy>());
 	}
 
 	SceneObjectCameraProxy::SceneObjectCameraProxy(CameraPtr const & camera, RenderModelPtr const & camera_model)
-		: SceneObjectHelper(SOA_Cullable | SOA_Moveable | SOA_NotCastShadow),
+		: SceneObjectHelper(SOA_Cullable | SOA_Moveable | SOA_NotCastShadow | SOA_ParallelUpdate),
 			camera_(camera)
 	{
 		this->Init(camera, camera_model);
@@ -214,7 +214,7 @@ namespace KlayGE
 
 	SceneObjectCameraProxy::SceneObjectCameraProxy(CameraPtr const & camera,
 			std::function<StaticMeshPtr(RenderModelPtr const &, std::wstring const &)> CreateMeshFactoryFunc)
-		: SceneObjectHelper(SOA_Cullable | SOA_Moveable | SOA_NotCastShadow),
+		: SceneObjectHelper(SOA_Cullable | SOA_Moveable | SOA_NotCastShadow | SOA_ParallelUpdate),
 			camera_(camera)
 	{
 		this->Init(camera, CreateMeshFactoryFunc);
@@ -222,7 +222,7 @@ namespace KlayGE
 
 	void SceneObjectCameraProxy::SubThreadUpdate(float /*app_time*/, float /*elapsed_time*/)
 	{
-		model_ = model_scaling_ * camera_->InverseViewMatrix();
+		this->ModelMatrix(model_scaling_ * camera_->InverseViewMatrix());
 	}
 
 	void SceneObjectCameraProxy::Scaling(float x, float y, float z)
@@ -113,15 +113,15 @@ namespace KlayGE
 			effect_ = effect;
 			if (texture)
 			{
-				technique_ = effect->TechniqueByName("UITec");
+				technique_ = effect->TechniqueByName(CT_HASH("UITec"));
 			}
 			else
 			{
-				technique_ = effect->TechniqueByName("UITecNoTex");
+				technique_ = effect->TechniqueByName(CT_HASH("UITecNoTex"));
 			}
 
-			ui_tex_ep_ = effect->ParameterByName("ui_tex");
-			half_width_height_ep_ = effect->ParameterByName("half_width_height");
+			ui_tex_ep_ = effect->ParameterByName(CT_HASH("ui_tex"));
+			half_width_height_ep_ = effect->ParameterByName(CT_HASH("half_width_height"));
 		}
 
 		bool Empty() const
@@ -93,10 +93,9 @@ namespace KlayGE
 		D3D11ShaderObject();
 
 		bool AttachNativeShader(ShaderType type, RenderEffect const & effect,
-			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids, std::vector<uint8_t> const & native_shader_block) override;
+			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids,
+			uint8_t const * native_shader_block, size_t native_shader_block_size) override;
 
-		bool StreamIn(ResIdentifierPtr const & res, ShaderType type, RenderEffect const & effect,
-			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids) override;
 		void StreamOut(std::ostream& os, ShaderType type) override;
 
 		void AttachShader(ShaderType type, RenderEffect const & effect,
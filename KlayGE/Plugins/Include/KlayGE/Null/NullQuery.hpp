@@ -0,0 +1,90 @@
+/**
+ * @file NullQuery.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _NULLQUERY_HPP
+#define _NULLQUERY_HPP
+
+#pragma once
+
+#include <KlayGE/Query.hpp>
+#include <KFL/Timer.hpp>
+
+namespace KlayGE
+{
+	class NullOcclusionQuery : public OcclusionQuery
+	{
+	public:
+		virtual void Begin() override;
+		virtual void End() override;
+
+		virtual uint64_t SamplesPassed() override;
+	};
+
+	// Nothing is rasterized, so the conditions are always true to keep the CPU work of the conditional draws.
+	class NullConditionalRender : public ConditionalRender
+	{
+	public:
+		virtual void Begin() override;
+		virtual void End() override;
+
+		virtual void BeginConditionalRender() override;
+		virtual void EndConditionalRender() override;
+
+		virtual bool AnySamplesPassed() override;
+	};
+
+	// Measures the CPU time between Begin and End
+	class NullTimerQuery : public TimerQuery
+	{
+	public:
+		NullTimerQuery();
+
+		virtual void Begin() override;
+		virtual void End() override;
+
+		virtual double TimeElapsed() override;
+
+	private:
+		Timer timer_;
+		double elapsed_;
+	};
+
+	class NullSOStatisticsQuery : public SOStatisticsQuery
+	{
+	public:
+		virtual void Begin() override;
+		virtual void End() override;
+
+		virtual uint64_t NumPrimitivesWritten() override;
+		virtual uint64_t PrimitivesGenerated() override;
+	};
+}
+
+#endif			// _NULLQUERY_HPP
@@ -0,0 +1,127 @@
+/**
+ * @file NullRenderEngine.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _NULLRENDERENGINE_HPP
+#define _NULLRENDERENGINE_HPP
+
+#pragma once
+
+#include <KlayGE/RenderEngine.hpp>
+
+#include <array>
+#include <atomic>
+
+namespace KlayGE
+{
+	// Counters of the work that would have been sent to a GPU. Resources are created on loading threads too,
+	//  so they are atomic.
+	enum NullCounter
+	{
+		NC_Draws,
+		NC_Dispatches,
+		NC_Clears,
+		NC_FrameBufferBinds,
+		NC_StateObjectBinds,
+		NC_ShaderObjectBinds,
+		NC_BufferMaps,
+		NC_BufferBytesUploaded,
+		NC_TextureMaps,
+		NC_TextureBytesUploaded,
+		NC_BytesCopied,
+		NC_MipmapGenerations,
+		NC_Queries,
+
+		NC_NumCounters
+	};
+
+	class NullRenderEngine : public RenderEngine
+	{
+	public:
+		NullRenderEngine();
+		~NullRenderEngine();
+
+		virtual std::wstring const & Name() const override;
+
+		virtual bool RequiresFlipping() const override
+		{
+			return false;
+		}
+
+		virtual void ForceFlush() override;
+
+		virtual TexturePtr const & ScreenDepthStencilTexture() const override;
+
+		virtual void ScissorRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+
+		// The counters can be read with "NUM_DRAWS", "BUFFER_BYTES_UPLOADED" and so on into an uint64_t,
+		//  and reset by setting "RESET_COUNTERS".
+		virtual void GetCustomAttrib(std::string const & name, void* value) override;
+		virtual void SetCustomAttrib(std::string const & name, void* value) override;
+
+		virtual bool FullScreen() const override;
+		virtual void FullScreen(bool fs) override;
+
+		void Count(NullCounter counter, uint64_t n = 1)
+		{
+			counters_[counter].fetch_add(n, std::memory_order_relaxed);
+		}
+		uint64_t Counter(NullCounter counter) const
+		{
+			return counters_[counter].load(std::memory_order_relaxed);
+		}
+		void ResetCounters();
+
+	private:
+		virtual void DoCreateRenderWindow(std::string const & name, RenderSettings const & settings) override;
+		virtual void DoBindFrameBuffer(FrameBufferPtr const & fb) override;
+		virtual void DoBindSOBuffers(RenderLayoutPtr const & rl) override;
+		virtual void DoRender(RenderEffect const & effect, RenderTechnique const & tech, RenderLayout const & rl) override;
+		virtual void DoDispatch(RenderEffect const & effect, RenderTechnique const & tech,
+			uint32_t tgx, uint32_t tgy, uint32_t tgz) override;
+		virtual void DoDispatchIndirect(RenderEffect const & effect, RenderTechnique const & tech,
+			GraphicsBufferPtr const & buff_args, uint32_t offset) override;
+		virtual void DoResize(uint32_t width, uint32_t height) override;
+		virtual void DoDestroy() override;
+
+		virtual void DoSuspend() override;
+		virtual void DoResume() override;
+
+		void FillRenderDeviceCaps();
+		void RunPasses(RenderEffect const & effect, RenderTechnique const & tech);
+
+	private:
+		bool full_screen_;
+		TexturePtr screen_ds_tex_;
+
+		std::array<std::atomic<uint64_t>, NC_NumCounters> counters_;
+	};
+}
+
+#endif			// _NULLRENDERENGINE_HPP
@@ -0,0 +1,76 @@
+/**
+ * @file NullShaderObject.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _NULLSHADEROBJECT_HPP
+#define _NULLSHADEROBJECT_HPP
+
+#pragma once
+
+#include <KlayGE/ShaderObject.hpp>
+
+#include <vector>
+
+namespace KlayGE
+{
+	// Nothing is compiled. The stages supported by NullRenderEngine are accepted, and binding updates the constant
+	//  buffers of the effect like a real shader object would, so the CPU side of parameter updates is kept.
+	class NullShaderObject : public ShaderObject
+	{
+	public:
+		NullShaderObject();
+
+		virtual bool AttachNativeShader(ShaderType type, RenderEffect const & effect,
+			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids,
+			uint8_t const * native_shader_block, size_t native_shader_block_size) override;
+
+		virtual void StreamOut(std::ostream& os, ShaderType type) override;
+
+		virtual void AttachShader(ShaderType type, RenderEffect const & effect,
+			RenderTechnique const & tech, RenderPass const & pass,
+			std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids) override;
+		virtual void AttachShader(ShaderType type, RenderEffect const & effect,
+			RenderTechnique const & tech, RenderPass const & pass, ShaderObjectPtr const & shared_so) override;
+		virtual void LinkShaders(RenderEffect const & effect) override;
+		virtual ShaderObjectPtr Clone(RenderEffect const & effect) override;
+
+		virtual void Bind() override;
+		virtual void Unbind() override;
+
+	private:
+		void AttachStage(ShaderType type);
+
+	private:
+		uint32_t attached_stages_;
+
+		std::vector<RenderEffectConstantBuffer*> cbuffs_;
+	};
+}
+
+#endif			// _NULLSHADEROBJECT_HPP
@@ -30,6 +30,7 @@
 #include <KFL/AABBox.hpp>
 
 #include <vector>
+#include <unordered_map>
 
 namespace KlayGE
 {
@@ -41,23 +42,54 @@ namespace KlayGE
 		void MaxTreeDepth(uint32_t max_tree_depth);
 		uint32_t MaxTreeDepth() const;
 
-		virtual void ClipScene() override;
-
 		virtual BoundOverlap AABBVisible(AABBox const & aabb) const override;
 		virtual BoundOverlap OBBVisible(OBBox const & obb) const override;
 		virtual BoundOverlap SphereVisible(Sphere const & sphere) const override;
 
 		virtual void ClearObject() override;
 
+		// The root node, and the number of moveable objects out of it. Inline so they can be checked without linking
+		//  to the plugin.
+		AABBox RootBound() const
+		{
+			if (node_bounds_.empty())
+			{
+				return AABBox(float3(0, 0, 0), float3(0, 0, 0));
+			}
+			float4 const & bound = node_bounds_[0];
+			float3 const center(bound.x(), bound.y(), bound.z());
+			float3 const half_size(bound.w(), bound.w(), bound.w());
+			return AABBox(center - half_size, center + half_size);
+		}
+		uint32_t NumOverflowMoveables() const
+		{
+			return static_cast<uint32_t>(overflow_moveables_.size());
+		}
+
 	private:
 		virtual void OnAddSceneObject(SceneObjectPtr const & obj) override;
 		virtual void OnDelSceneObject(std::vector<SceneObjectPtr>::iterator iter) override;
 		virtual void DoSuspend() override;
 		virtual void DoResume() override;
+		virtual void ClipScene(std::vector<ClipView>& views) override;
 
 		void DivideNode(size_t index, uint32_t curr_depth);
-		void NodeVisible(size_t index);
-		void MarkNodeObjs(size_t index, bool force);
+		void NodesVisible(uint32_t view_mask, std::vector<ClipView> const & views);
+		uint32_t NodeVisible(size_t index, uint32_t view_mask, std::vector<ClipView> const & views);
+		void MarkNodesObjs(uint32_t view_mask, std::vector<ClipView>& views);
+		void MarkNodeObjs(size_t index, uint32_t view_mask, uint32_t force_mask, std::vector<ClipView>& views);
+		bool InTree(SceneObject* so) const;
+
+		void UpdateMoveable(SceneObject* so);
+		void InsertMoveable(SceneObject* so);
+		void RemoveMoveable(SceneObject* so);
+		bool MoveableInNode(size_t index, float3 const & center, float extent) const;
+		bool MoveableFitsNode(size_t index, float3 const & center, float extent) const;
+		void AddNodeMoveables(int index, int32_t delta);
+
+		AABBox NodeBound(size_t index) const;
+		AABBox LooseNodeBound(size_t index) const;
+		BoundOverlap NodeFrustumIntersect(size_t index, Frustum const & frustum) const;
 
 		BoundOverlap BoundVisible(size_t index, AABBox const & aabb) const;
 		BoundOverlap BoundVisible(size_t index, OBBox const & obb) const;
@@ -71,18 +103,39 @@ namespace KlayGE
 	private:
 		struct octree_node_t
 		{
-			AABBox bb;
 			int first_child_index;
+			int parent_index;
+			// One past the last descendant. The 8 children are contiguous, and followed by the rest of the descendants.
+			int subtree_end;
 			BoundOverlap visible;
+			// Moveable objects in this node and its descendants. Such a subtree is tested with the loose bound.
+			uint32_t num_moveables;
 
 			std::vector<SceneObject*> obj_ptrs;
 		};
 
 		std::vector<octree_node_t> octree_;
+		// Center in xyz and half size in w of each node, apart from the nodes so the traversal only touches the bounds.
+		//  Nodes are cubes, and the loose bound of a node is twice its size.
+		std::vector<float4> node_bounds_;
+		// The node a moveable object is in, or -1 if it's out of the tree
+		std::unordered_map<SceneObject*, int> moveable_nodes_;
+		// Moveable objects out of the root. They are tested one by one, until they come back or the root grows to
+		//  take them in the next rebuild.
+		std::vector<SceneObject*> overflow_moveables_;
+
+		// Scratch of ClipScene. Visibility of each node in each view, the views each node is partially in, the views
+		//  each node is in and entirely in, and the index of each object in scene_objs_.
+		std::vector<BoundOverlap> node_visibles_;
+		std::vector<uint32_t> node_partial_masks_;
+		std::vector<uint32_t> node_in_masks_;
+		std::vector<uint32_t> node_yes_masks_;
+		std::unordered_map<SceneObject*, uint32_t> obj_indices_;
 
 		uint32_t max_tree_depth_;
 
 		bool rebuild_tree_;
+		bool grow_root_;
 
 #ifdef KLAYGE_DRAW_NODES
 		RenderablePtr node_renderable_;
@@ -253,15 +253,15 @@ namespace KlayGE
 	}
 
 	bool D3D11ShaderObject::AttachNativeShader(ShaderType type, RenderEffect const & effect, std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids,
-		std::vector<uint8_t> const & native_shader_block)
+		uint8_t const * native_shader_block, size_t native_shader_block_size)
 	{
 		bool ret = false;
 
 		is_shader_validate_[type] = false;
 		std::string shader_profile = this->GetShaderProfile(type, effect, shader_desc_ids[type]);
-		if (native_shader_block.size() >= 25 + shader_profile.size())
+		if (native_shader_block_size >= 25 + shader_profile.size())
 		{
-			uint8_t const * nsbp = &native_shader_block[0];
+			uint8_t const * nsbp = native_shader_block;
 
 			uint8_t len = *nsbp;
 			++ nsbp;
@@ -395,21 +395,6 @@ namespace KlayGE
 		return ret;
 	}
 
-	bool D3D11ShaderObject::StreamIn(ResIdentifierPtr const & res, ShaderType type, RenderEffect const & effect,
-		std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids)
-	{
-		uint32_t len;
-		res->read(&len, sizeof(len));
-		len = LE2Native(len);
-		std::vector<uint8_t> native_shader_block(len);
-		if (len > 0)
-		{
-			res->read(&native_shader_block[0], len * sizeof(native_shader_block[0]));
-		}
-
-		return this->AttachNativeShader(type, effect, shader_desc_ids, native_shader_block);
-	}
-
 	void D3D11ShaderObject::StreamOut(std::ostream& os, ShaderType type)
 	{
 		std::ostringstream oss(std::ios_base::binary | std::ios_base::out);
@@ -0,0 +1,102 @@
+/**
+ * @file NullGraphicsBuffer.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderFactory.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <KlayGE/Null/NullRenderEngine.hpp>
+#include <KlayGE/Null/NullGraphicsBuffer.hpp>
+
+namespace KlayGE
+{
+	NullGraphicsBuffer::NullGraphicsBuffer(BufferUsage usage, uint32_t access_hint, uint32_t size_in_byte, ElementFormat fmt)
+		: GraphicsBuffer(usage, access_hint, size_in_byte),
+			fmt_as_shader_res_(fmt)
+	{
+	}
+
+	void NullGraphicsBuffer::CreateHWResource(void const * init_data)
+	{
+		data_.assign(size_in_byte_, 0);
+		if (init_data != nullptr)
+		{
+			std::memcpy(data_.data(), init_data, size_in_byte_);
+
+			NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+			re.Count(NC_BufferBytesUploaded, size_in_byte_);
+		}
+	}
+
+	void NullGraphicsBuffer::DeleteHWResource()
+	{
+		std::vector<uint8_t>().swap(data_);
+	}
+
+	void* NullGraphicsBuffer::Map(BufferAccess ba)
+	{
+		KFL_UNUSED(ba);
+		BOOST_ASSERT(!data_.empty() || (0 == size_in_byte_));
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_BufferMaps);
+
+		return data_.data();
+	}
+
+	void NullGraphicsBuffer::Unmap()
+	{
+	}
+
+	void NullGraphicsBuffer::CopyToBuffer(GraphicsBuffer& target)
+	{
+		BOOST_ASSERT(this->Size() <= target.Size());
+
+		NullGraphicsBuffer& other = *checked_cast<NullGraphicsBuffer*>(&target);
+		std::copy(data_.begin(), data_.end(), other.data_.begin());
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_BytesCopied, data_.size());
+	}
+
+	void NullGraphicsBuffer::UpdateSubresource(uint32_t offset, uint32_t size, void const * data)
+	{
+		BOOST_ASSERT(offset + size <= data_.size());
+
+		std::memcpy(&data_[offset], data, size);
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_BufferBytesUploaded, size);
+	}
+}
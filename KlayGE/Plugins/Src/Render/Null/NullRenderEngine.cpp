@@ -0,0 +1,343 @@
+/**
+ * @file NullRenderEngine.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KFL/Hash.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderFactory.hpp>
+#include <KlayGE/RenderEffect.hpp>
+#include <KlayGE/RenderLayout.hpp>
+#include <KlayGE/RenderSettings.hpp>
+#include <KlayGE/FrameBuffer.hpp>
+#include <KlayGE/Texture.hpp>
+
+#include <KlayGE/Null/NullRenderView.hpp>
+#include <KlayGE/Null/NullFrameBuffer.hpp>
+#include <KlayGE/Null/NullRenderEngine.hpp>
+
+namespace
+{
+	using namespace KlayGE;
+
+	struct CounterName
+	{
+		size_t name_hash;
+		NullCounter counter;
+	};
+
+	CounterName const counter_names[] =
+	{
+		{ CT_HASH("NUM_DRAWS"), NC_Draws },
+		{ CT_HASH("NUM_DISPATCHES"), NC_Dispatches },
+		{ CT_HASH("NUM_CLEARS"), NC_Clears },
+		{ CT_HASH("NUM_FRAME_BUFFER_BINDS"), NC_FrameBufferBinds },
+		{ CT_HASH("NUM_STATE_OBJECT_BINDS"), NC_StateObjectBinds },
+		{ CT_HASH("NUM_SHADER_OBJECT_BINDS"), NC_ShaderObjectBinds },
+		{ CT_HASH("NUM_BUFFER_MAPS"), NC_BufferMaps },
+		{ CT_HASH("BUFFER_BYTES_UPLOADED"), NC_BufferBytesUploaded },
+		{ CT_HASH("NUM_TEXTURE_MAPS"), NC_TextureMaps },
+		{ CT_HASH("TEXTURE_BYTES_UPLOADED"), NC_TextureBytesUploaded },
+		{ CT_HASH("BYTES_COPIED"), NC_BytesCopied },
+		{ CT_HASH("NUM_MIPMAP_GENERATIONS"), NC_MipmapGenerations },
+		{ CT_HASH("NUM_QUERIES"), NC_Queries }
+	};
+}
+
+namespace KlayGE
+{
+	NullRenderEngine::NullRenderEngine()
+		: full_screen_(false)
+	{
+		native_shader_fourcc_ = MakeFourCC<'N', 'U', 'L', 'L'>::value;
+		native_shader_version_ = 1;
+
+		this->ResetCounters();
+	}
+
+	NullRenderEngine::~NullRenderEngine()
+	{
+		this->Destroy();
+	}
+
+	std::wstring const & NullRenderEngine::Name() const
+	{
+		static std::wstring const name(L"Null Render Engine");
+		return name;
+	}
+
+	void NullRenderEngine::ForceFlush()
+	{
+	}
+
+	TexturePtr const & NullRenderEngine::ScreenDepthStencilTexture() const
+	{
+		return screen_ds_tex_;
+	}
+
+	void NullRenderEngine::ScissorRect(uint32_t /*x*/, uint32_t /*y*/, uint32_t /*width*/, uint32_t /*height*/)
+	{
+	}
+
+	void NullRenderEngine::GetCustomAttrib(std::string const & name, void* value)
+	{
+		size_t const name_hash = RT_HASH(name.c_str());
+		for (auto const & cn : counter_names)
+		{
+			if (cn.name_hash == name_hash)
+			{
+				*static_cast<uint64_t*>(value) = this->Counter(cn.counter);
+				break;
+			}
+		}
+	}
+
+	void NullRenderEngine::SetCustomAttrib(std::string const & name, void* /*value*/)
+	{
+		size_t const name_hash = RT_HASH(name.c_str());
+		if (CT_HASH("RESET_COUNTERS") == name_hash)
+		{
+			this->ResetCounters();
+		}
+	}
+
+	bool NullRenderEngine::FullScreen() const
+	{
+		return full_screen_;
+	}
+
+	void NullRenderEngine::FullScreen(bool fs)
+	{
+		full_screen_ = fs;
+	}
+
+	void NullRenderEngine::ResetCounters()
+	{
+		for (auto& counter : counters_)
+		{
+			counter.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void NullRenderEngine::DoCreateRenderWindow(std::string const & /*name*/, RenderSettings const & settings)
+	{
+		motion_frames_ = settings.motion_frames;
+		full_screen_ = settings.full_screen;
+
+		native_shader_platform_name_ = "null";
+
+		this->FillRenderDeviceCaps();
+
+		FrameBufferPtr win = MakeSharedPtr<NullFrameBuffer>();
+		win->Attach(FrameBuffer::ATT_Color0,
+			MakeSharedPtr<NullRenderView>(settings.width, settings.height, settings.color_fmt));
+		if (NumDepthBits(settings.depth_stencil_fmt) > 0)
+		{
+			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+			screen_ds_tex_ = rf.MakeTexture2D(settings.width, settings.height, 1, 1, settings.depth_stencil_fmt,
+				settings.sample_count, settings.sample_quality, EAH_GPU_Read | EAH_GPU_Write, nullptr);
+			win->Attach(FrameBuffer::ATT_DepthStencil, rf.Make2DDepthStencilRenderView(*screen_ds_tex_, 0, 1, 0));
+		}
+
+		this->BindFrameBuffer(win);
+	}
+
+	void NullRenderEngine::DoBindFrameBuffer(FrameBufferPtr const & /*fb*/)
+	{
+		this->Count(NC_FrameBufferBinds);
+	}
+
+	void NullRenderEngine::DoBindSOBuffers(RenderLayoutPtr const & /*rl*/)
+	{
+	}
+
+	void NullRenderEngine::DoRender(RenderEffect const & effect, RenderTechnique const & tech, RenderLayout const & rl)
+	{
+		uint32_t const num_instances = rl.NumInstances();
+		BOOST_ASSERT(num_instances != 0);
+
+		uint32_t const vertex_count = rl.UseIndices() ? rl.NumIndices() : rl.NumVertices();
+		uint32_t prim_count;
+		switch (rl.TopologyType())
+		{
+		case RenderLayout::TT_PointList:
+			prim_count = vertex_count;
+			break;
+
+		case RenderLayout::TT_LineList:
+			prim_count = vertex_count / 2;
+			break;
+
+		case RenderLayout::TT_LineStrip:
+			prim_count = vertex_count - 1;
+			break;
+
+		case RenderLayout::TT_TriangleList:
+			prim_count = vertex_count / 3;
+			break;
+
+		case RenderLayout::TT_TriangleStrip:
+			prim_count = vertex_count - 2;
+			break;
+
+		default:
+			BOOST_ASSERT((rl.TopologyType() >= RenderLayout::TT_1_Ctrl_Pt_PatchList)
+				&& (rl.TopologyType() <= RenderLayout::TT_32_Ctrl_Pt_PatchList));
+			prim_count = vertex_count / (rl.TopologyType() - RenderLayout::TT_1_Ctrl_Pt_PatchList + 1);
+			break;
+		}
+
+		num_primitives_just_rendered_ += num_instances * prim_count;
+		num_vertices_just_rendered_ += num_instances * vertex_count;
+
+		this->RunPasses(effect, tech);
+
+		num_draws_just_called_ += tech.NumPasses();
+		this->Count(NC_Draws, tech.NumPasses());
+	}
+
+	void NullRenderEngine::DoDispatch(RenderEffect const & effect, RenderTechnique const & tech,
+		uint32_t /*tgx*/, uint32_t /*tgy*/, uint32_t /*tgz*/)
+	{
+		this->RunPasses(effect, tech);
+
+		num_dispatches_just_called_ += tech.NumPasses();
+		this->Count(NC_Dispatches, tech.NumPasses());
+	}
+
+	void NullRenderEngine::DoDispatchIndirect(RenderEffect const & effect, RenderTechnique const & tech,
+		GraphicsBufferPtr const & /*buff_args*/, uint32_t /*offset*/)
+	{
+		this->RunPasses(effect, tech);
+
+		num_dispatches_just_called_ += tech.NumPasses();
+		this->Count(NC_Dispatches, tech.NumPasses());
+	}
+
+	// Binding the passes is where the CPU cost of a draw is, so it's kept
+	void NullRenderEngine::RunPasses(RenderEffect const & effect, RenderTechnique const & tech)
+	{
+		uint32_t const num_passes = tech.NumPasses();
+		for (uint32_t i = 0; i < num_passes; ++ i)
+		{
+			auto& pass = tech.Pass(i);
+
+			pass.Bind(effect);
+			pass.Unbind(effect);
+		}
+	}
+
+	void NullRenderEngine::DoResize(uint32_t width, uint32_t height)
+	{
+		checked_pointer_cast<NullFrameBuffer>(screen_frame_buffer_)->Resize(width, height);
+
+		if (screen_ds_tex_)
+		{
+			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+			screen_ds_tex_ = rf.MakeTexture2D(width, height, 1, 1, screen_ds_tex_->Format(),
+				screen_ds_tex_->SampleCount(), screen_ds_tex_->SampleQuality(), screen_ds_tex_->AccessHint(), nullptr);
+			screen_frame_buffer_->Attach(FrameBuffer::ATT_DepthStencil,
+				rf.Make2DDepthStencilRenderView(*screen_ds_tex_, 0, 1, 0));
+		}
+	}
+
+	void NullRenderEngine::DoDestroy()
+	{
+		screen_ds_tex_.reset();
+	}
+
+	void NullRenderEngine::DoSuspend()
+	{
+	}
+
+	void NullRenderEngine::DoResume()
+	{
+	}
+
+	// Reports a D3D11 class device that accepts every format. Nothing runs on it, so every stage can be faked.
+	void NullRenderEngine::FillRenderDeviceCaps()
+	{
+		caps_.max_shader_model = ShaderModel(5, 0);
+
+		caps_.max_texture_width = caps_.max_texture_height = 16384;
+		caps_.max_texture_depth = 2048;
+		caps_.max_texture_cube_size = 16384;
+		caps_.max_texture_array_length = 2048;
+		caps_.max_vertex_texture_units = 16;
+		caps_.max_pixel_texture_units = 16;
+		caps_.max_geometry_texture_units = 16;
+		caps_.max_simultaneous_rts = 8;
+		caps_.max_simultaneous_uavs = 8;
+		caps_.max_vertex_streams = 16;
+		caps_.max_texture_anisotropy = 16;
+
+		caps_.is_tbdr = false;
+
+		caps_.hw_instancing_support = true;
+		caps_.instance_id_support = true;
+		caps_.stream_output_support = true;
+		caps_.alpha_to_coverage_support = true;
+		caps_.primitive_restart_support = true;
+		caps_.multithread_rendering_support = true;
+		caps_.multithread_res_creating_support = true;
+		caps_.mrt_independent_bit_depths_support = true;
+		caps_.logic_op_support = true;
+		caps_.independent_blend_support = true;
+		caps_.draw_indirect_support = true;
+		caps_.no_overwrite_support = true;
+		caps_.partial_cbuffer_update_support = true;
+		caps_.full_npot_texture_support = true;
+		caps_.render_to_texture_array_support = true;
+		caps_.load_from_buffer_support = true;
+
+		caps_.gs_support = true;
+		caps_.cs_support = true;
+		caps_.hs_support = true;
+		caps_.ds_support = true;
+		caps_.tess_method = TM_Hardware;
+
+		caps_.vertex_format_support = [](ElementFormat elem_fmt)
+			{
+				return !IsCompressedFormat(elem_fmt) && !IsDepthFormat(elem_fmt);
+			};
+		caps_.texture_format_support = [](ElementFormat /*elem_fmt*/)
+			{
+				return true;
+			};
+		caps_.rendertarget_format_support = [](ElementFormat elem_fmt, uint32_t sample_count, uint32_t /*sample_quality*/)
+			{
+				return !IsCompressedFormat(elem_fmt) && (sample_count <= 8);
+			};
+
+		caps_.depth_texture_support = true;
+		caps_.fp_color_support = true;
+		caps_.pack_to_rgba_required = false;
+	}
+}
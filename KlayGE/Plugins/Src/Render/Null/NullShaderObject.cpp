@@ -0,0 +1,168 @@
+/**
+ * @file NullShaderObject.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderFactory.hpp>
+#include <KlayGE/RenderEffect.hpp>
+
+#include <ostream>
+
+#include <KlayGE/Null/NullRenderEngine.hpp>
+#include <KlayGE/Null/NullShaderObject.hpp>
+
+namespace KlayGE
+{
+	NullShaderObject::NullShaderObject()
+		: attached_stages_(0)
+	{
+		is_shader_validate_.fill(true);
+	}
+
+	bool NullShaderObject::AttachNativeShader(ShaderType type, RenderEffect const & effect,
+		std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids,
+		uint8_t const * native_shader_block, size_t native_shader_block_size)
+	{
+		KFL_UNUSED(effect);
+		KFL_UNUSED(shader_desc_ids);
+
+		if (native_shader_block_size < 1)
+		{
+			return false;
+		}
+
+		this->AttachStage(type);
+		is_shader_validate_[type] = (native_shader_block[0] != 0);
+		return true;
+	}
+
+	// The native block is only the validation flag of the stage
+	void NullShaderObject::StreamOut(std::ostream& os, ShaderType type)
+	{
+		uint8_t const validate = is_shader_validate_[type] ? 1 : 0;
+
+		uint32_t len = Native2LE(static_cast<uint32_t>(sizeof(validate)));
+		os.write(reinterpret_cast<char const *>(&len), sizeof(len));
+		os.write(reinterpret_cast<char const *>(&validate), sizeof(validate));
+	}
+
+	void NullShaderObject::AttachShader(ShaderType type, RenderEffect const & effect,
+			RenderTechnique const & tech, RenderPass const & pass, std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids)
+	{
+		KFL_UNUSED(effect);
+		KFL_UNUSED(tech);
+		KFL_UNUSED(pass);
+		KFL_UNUSED(shader_desc_ids);
+
+		this->AttachStage(type);
+	}
+
+	void NullShaderObject::AttachShader(ShaderType type, RenderEffect const & effect,
+			RenderTechnique const & tech, RenderPass const & pass, ShaderObjectPtr const & shared_so)
+	{
+		KFL_UNUSED(effect);
+		KFL_UNUSED(tech);
+		KFL_UNUSED(pass);
+
+		NullShaderObject const & so = *checked_cast<NullShaderObject*>(shared_so.get());
+
+		attached_stages_ |= 1UL << type;
+		is_shader_validate_[type] = so.is_shader_validate_[type];
+		if (ST_HullShader == type)
+		{
+			has_tessellation_ = so.has_tessellation_;
+		}
+	}
+
+	void NullShaderObject::AttachStage(ShaderType type)
+	{
+		attached_stages_ |= 1UL << type;
+
+		// Every stage of a D3D11 class device is faked
+		is_shader_validate_[type] = true;
+		if (ST_HullShader == type)
+		{
+			has_tessellation_ = true;
+		}
+	}
+
+	void NullShaderObject::LinkShaders(RenderEffect const & effect)
+	{
+		is_validate_ = true;
+		for (uint32_t type = 0; type < ST_NumShaderTypes; ++ type)
+		{
+			if (attached_stages_ & (1UL << type))
+			{
+				is_validate_ &= is_shader_validate_[type];
+			}
+		}
+
+		cbuffs_.clear();
+		if (is_validate_)
+		{
+			for (uint32_t i = 0; i < effect.NumCBuffers(); ++ i)
+			{
+				cbuffs_.push_back(effect.CBufferByIndex(i));
+			}
+		}
+	}
+
+	ShaderObjectPtr NullShaderObject::Clone(RenderEffect const & effect)
+	{
+		std::shared_ptr<NullShaderObject> ret = MakeSharedPtr<NullShaderObject>();
+
+		ret->is_shader_validate_ = is_shader_validate_;
+		ret->has_discard_ = has_discard_;
+		ret->has_tessellation_ = has_tessellation_;
+		ret->attached_stages_ = attached_stages_;
+		ret->LinkShaders(effect);
+
+		return ret;
+	}
+
+	void NullShaderObject::Bind()
+	{
+		for (auto cbuff : cbuffs_)
+		{
+			if (cbuff->HWBuff())
+			{
+				cbuff->Update();
+			}
+		}
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_ShaderObjectBinds);
+	}
+
+	void NullShaderObject::Unbind()
+	{
+	}
+}
@@ -0,0 +1,514 @@
+/**
+ * @file NullTexture.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderFactory.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <KlayGE/Null/NullRenderEngine.hpp>
+#include <KlayGE/Null/NullTexture.hpp>
+
+namespace KlayGE
+{
+	NullTexture::NullTexture(TextureType type, uint32_t width, uint32_t height, uint32_t depth, uint32_t num_mip_maps,
+			uint32_t array_size, ElementFormat format, uint32_t sample_count, uint32_t sample_quality, uint32_t access_hint)
+		: Texture(type, sample_count, sample_quality, access_hint),
+			width_(width), height_(height), depth_(depth), hw_res_ready_(false)
+	{
+		if (0 == num_mip_maps)
+		{
+			num_mip_maps = 1;
+			uint32_t w = width;
+			uint32_t h = height;
+			uint32_t d = depth;
+			while ((w != 1) || (h != 1) || (d != 1))
+			{
+				++ num_mip_maps;
+
+				w = std::max<uint32_t>(1U, w / 2);
+				h = std::max<uint32_t>(1U, h / 2);
+				d = std::max<uint32_t>(1U, d / 2);
+			}
+		}
+		num_mip_maps_ = num_mip_maps;
+		array_size_ = array_size;
+		format_ = format;
+
+		uint32_t const num_subres = array_size_ * this->NumFaces() * num_mip_maps_;
+		subres_offsets_.resize(num_subres + 1);
+		size_t offset = 0;
+		for (uint32_t i = 0; i < num_subres; ++ i)
+		{
+			uint32_t const level = i % num_mip_maps_;
+			subres_offsets_[i] = offset;
+			offset += static_cast<size_t>(this->SlicePitch(level)) * this->Depth(level);
+		}
+		subres_offsets_[num_subres] = offset;
+	}
+
+	std::wstring const & NullTexture::Name() const
+	{
+		static std::wstring const name(L"Null Texture");
+		return name;
+	}
+
+	uint32_t NullTexture::Width(uint32_t level) const
+	{
+		BOOST_ASSERT(level < num_mip_maps_);
+
+		return std::max<uint32_t>(1U, width_ >> level);
+	}
+
+	uint32_t NullTexture::Height(uint32_t level) const
+	{
+		BOOST_ASSERT(level < num_mip_maps_);
+
+		return std::max<uint32_t>(1U, height_ >> level);
+	}
+
+	uint32_t NullTexture::Depth(uint32_t level) const
+	{
+		BOOST_ASSERT(level < num_mip_maps_);
+
+		return std::max<uint32_t>(1U, depth_ >> level);
+	}
+
+	uint32_t NullTexture::RowPitch(uint32_t level) const
+	{
+		if (IsCompressedFormat(format_))
+		{
+			uint32_t const block_bytes = NumFormatBytes(format_) * 4;
+			return (this->Width(level) + 3) / 4 * block_bytes;
+		}
+		else
+		{
+			return this->Width(level) * NumFormatBytes(format_);
+		}
+	}
+
+	uint32_t NullTexture::NumRows(uint32_t level) const
+	{
+		return IsCompressedFormat(format_) ? (this->Height(level) + 3) / 4 : this->Height(level);
+	}
+
+	uint32_t NullTexture::SlicePitch(uint32_t level) const
+	{
+		return this->RowPitch(level) * this->NumRows(level);
+	}
+
+	uint8_t* NullTexture::TexelData(uint32_t array_index, uint32_t face, uint32_t level,
+		uint32_t x_offset, uint32_t y_offset, uint32_t z_offset)
+	{
+		BOOST_ASSERT(array_index < array_size_);
+		BOOST_ASSERT(face < this->NumFaces());
+		BOOST_ASSERT(level < num_mip_maps_);
+
+		if (texels_.empty())
+		{
+			texels_.resize(subres_offsets_.back());
+		}
+
+		size_t offset = subres_offsets_[(array_index * this->NumFaces() + face) * num_mip_maps_ + level];
+		offset += static_cast<size_t>(z_offset) * this->SlicePitch(level);
+		if (IsCompressedFormat(format_))
+		{
+			uint32_t const block_bytes = NumFormatBytes(format_) * 4;
+			offset += y_offset / 4 * this->RowPitch(level) + x_offset / 4 * block_bytes;
+		}
+		else
+		{
+			offset += y_offset * this->RowPitch(level) + x_offset * NumFormatBytes(format_);
+		}
+		return &texels_[offset];
+	}
+
+	void NullTexture::UpdateRegion(uint32_t array_index, uint32_t face, uint32_t level,
+		uint32_t x_offset, uint32_t y_offset, uint32_t z_offset, uint32_t width, uint32_t height, uint32_t depth,
+		void const * data, uint32_t row_pitch, uint32_t slice_pitch)
+	{
+		uint32_t row_bytes;
+		uint32_t num_rows;
+		if (IsCompressedFormat(format_))
+		{
+			row_bytes = (width + 3) / 4 * NumFormatBytes(format_) * 4;
+			num_rows = (height + 3) / 4;
+		}
+		else
+		{
+			row_bytes = width * NumFormatBytes(format_);
+			num_rows = height;
+		}
+
+		uint32_t const dst_row_pitch = this->RowPitch(level);
+		uint32_t const dst_slice_pitch = this->SlicePitch(level);
+		uint8_t* dst = this->TexelData(array_index, face, level, x_offset, y_offset, z_offset);
+		uint8_t const * src = static_cast<uint8_t const *>(data);
+		for (uint32_t z = 0; z < depth; ++ z)
+		{
+			for (uint32_t y = 0; y < num_rows; ++ y)
+			{
+				std::memcpy(dst + z * dst_slice_pitch + y * dst_row_pitch, src + z * slice_pitch + y * row_pitch, row_bytes);
+			}
+		}
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_TextureBytesUploaded, static_cast<uint64_t>(row_bytes) * num_rows * depth);
+	}
+
+	void NullTexture::CopyRegion(NullTexture& target,
+		uint32_t dst_array_index, uint32_t dst_face, uint32_t dst_level,
+		uint32_t dst_x_offset, uint32_t dst_y_offset, uint32_t dst_z_offset,
+		uint32_t src_array_index, uint32_t src_face, uint32_t src_level,
+		uint32_t src_x_offset, uint32_t src_y_offset, uint32_t src_z_offset,
+		uint32_t width, uint32_t height, uint32_t depth)
+	{
+		BOOST_ASSERT(format_ == target.Format());
+
+		uint32_t row_bytes;
+		uint32_t num_rows;
+		if (IsCompressedFormat(format_))
+		{
+			row_bytes = (width + 3) / 4 * NumFormatBytes(format_) * 4;
+			num_rows = (height + 3) / 4;
+		}
+		else
+		{
+			row_bytes = width * NumFormatBytes(format_);
+			num_rows = height;
+		}
+
+		uint32_t const dst_row_pitch = target.RowPitch(dst_level);
+		uint32_t const dst_slice_pitch = target.SlicePitch(dst_level);
+		uint32_t const src_row_pitch = this->RowPitch(src_level);
+		uint32_t const src_slice_pitch = this->SlicePitch(src_level);
+		uint8_t* dst = target.TexelData(dst_array_index, dst_face, dst_level, dst_x_offset, dst_y_offset, dst_z_offset);
+		uint8_t const * src = this->TexelData(src_array_index, src_face, src_level, src_x_offset, src_y_offset, src_z_offset);
+		for (uint32_t z = 0; z < depth; ++ z)
+		{
+			for (uint32_t y = 0; y < num_rows; ++ y)
+			{
+				std::memmove(dst + z * dst_slice_pitch + y * dst_row_pitch,
+					src + z * src_slice_pitch + y * src_row_pitch, row_bytes);
+			}
+		}
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_BytesCopied, static_cast<uint64_t>(row_bytes) * num_rows * depth);
+	}
+
+	void NullTexture::CopyToTexture(Texture& target)
+	{
+		BOOST_ASSERT(type_ == target.Type());
+
+		NullTexture& other = *checked_cast<NullTexture*>(&target);
+		if ((width_ == other.width_) && (height_ == other.height_) && (depth_ == other.depth_)
+			&& (format_ == other.format_) && (array_size_ == other.array_size_) && (num_mip_maps_ == other.num_mip_maps_))
+		{
+			other.texels_ = texels_;
+
+			NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+			re.Count(NC_BytesCopied, texels_.size());
+		}
+		else
+		{
+			uint32_t const array_size = std::min(array_size_, target.ArraySize());
+			uint32_t const num_mips = std::min(num_mip_maps_, target.NumMipMaps());
+			for (uint32_t index = 0; index < array_size; ++ index)
+			{
+				for (uint32_t level = 0; level < num_mips; ++ level)
+				{
+					switch (type_)
+					{
+					case TT_1D:
+						this->CopyToSubTexture1D(target,
+							index, level, 0, target.Width(level),
+							index, level, 0, this->Width(level));
+						break;
+
+					case TT_2D:
+						this->CopyToSubTexture2D(target,
+							index, level, 0, 0, target.Width(level), target.Height(level),
+							index, level, 0, 0, this->Width(level), this->Height(level));
+						break;
+
+					case TT_3D:
+						this->CopyToSubTexture3D(target,
+							index, level, 0, 0, 0, target.Width(level), target.Height(level), target.Depth(level),
+							index, level, 0, 0, 0, this->Width(level), this->Height(level), this->Depth(level));
+						break;
+
+					case TT_Cube:
+						for (int f = 0; f < 6; ++ f)
+						{
+							CubeFaces const face = static_cast<CubeFaces>(f);
+							this->CopyToSubTextureCube(target,
+								index, face, level, 0, 0, target.Width(level), target.Height(level),
+								index, face, level, 0, 0, this->Width(level), this->Height(level));
+						}
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	void NullTexture::CopyToSubTexture1D(Texture& target,
+		uint32_t dst_array_index, uint32_t dst_level, uint32_t dst_x_offset, uint32_t dst_width,
+		uint32_t src_array_index, uint32_t src_level, uint32_t src_x_offset, uint32_t src_width)
+	{
+		if ((src_width == dst_width) && (format_ == target.Format()))
+		{
+			this->CopyRegion(*checked_cast<NullTexture*>(&target),
+				dst_array_index, 0, dst_level, dst_x_offset, 0, 0,
+				src_array_index, 0, src_level, src_x_offset, 0, 0,
+				src_width, 1, 1);
+		}
+		else
+		{
+			this->ResizeTexture1D(target, dst_array_index, dst_level, dst_x_offset, dst_width,
+				src_array_index, src_level, src_x_offset, src_width, true);
+		}
+	}
+
+	void NullTexture::CopyToSubTexture2D(Texture& target,
+		uint32_t dst_array_index, uint32_t dst_level, uint32_t dst_x_offset, uint32_t dst_y_offset,
+		uint32_t dst_width, uint32_t dst_height,
+		uint32_t src_array_index, uint32_t src_level, uint32_t src_x_offset, uint32_t src_y_offset,
+		uint32_t src_width, uint32_t src_height)
+	{
+		if ((src_width == dst_width) && (src_height == dst_height) && (format_ == target.Format()))
+		{
+			this->CopyRegion(*checked_cast<NullTexture*>(&target),
+				dst_array_index, 0, dst_level, dst_x_offset, dst_y_offset, 0,
+				src_array_index, 0, src_level, src_x_offset, src_y_offset, 0,
+				src_width, src_height, 1);
+		}
+		else
+		{
+			this->ResizeTexture2D(target, dst_array_index, dst_level, dst_x_offset, dst_y_offset, dst_width, dst_height,
+				src_array_index, src_level, src_x_offset, src_y_offset, src_width, src_height, true);
+		}
+	}
+
+	void NullTexture::CopyToSubTexture3D(Texture& target,
+		uint32_t dst_array_index, uint32_t dst_level, uint32_t dst_x_offset, uint32_t dst_y_offset, uint32_t dst_z_offset,
+		uint32_t dst_width, uint32_t dst_height, uint32_t dst_depth,
+		uint32_t src_array_index, uint32_t src_level, uint32_t src_x_offset, uint32_t src_y_offset, uint32_t src_z_offset,
+		uint32_t src_width, uint32_t src_height, uint32_t src_depth)
+	{
+		if ((src_width == dst_width) && (src_height == dst_height) && (src_depth == dst_depth)
+			&& (format_ == target.Format()))
+		{
+			this->CopyRegion(*checked_cast<NullTexture*>(&target),
+				dst_array_index, 0, dst_level, dst_x_offset, dst_y_offset, dst_z_offset,
+				src_array_index, 0, src_level, src_x_offset, src_y_offset, src_z_offset,
+				src_width, src_height, src_depth);
+		}
+		else
+		{
+			this->ResizeTexture3D(target, dst_array_index, dst_level, dst_x_offset, dst_y_offset, dst_z_offset,
+				dst_width, dst_height, dst_depth,
+				src_array_index, src_level, src_x_offset, src_y_offset, src_z_offset,
+				src_width, src_height, src_depth, true);
+		}
+	}
+
+	void NullTexture::CopyToSubTextureCube(Texture& target,
+		uint32_t dst_array_index, CubeFaces dst_face, uint32_t dst_level, uint32_t dst_x_offset, uint32_t dst_y_offset,
+		uint32_t dst_width, uint32_t dst_height,
+		uint32_t src_array_index, CubeFaces src_face, uint32_t src_level, uint32_t src_x_offset, uint32_t src_y_offset,
+		uint32_t src_width, uint32_t src_height)
+	{
+		if ((src_width == dst_width) && (src_height == dst_height) && (format_ == target.Format()))
+		{
+			uint32_t const dst_face_index = (TT_Cube == target.Type()) ? dst_face : 0;
+			this->CopyRegion(*checked_cast<NullTexture*>(&target),
+				dst_array_index, dst_face_index, dst_level, dst_x_offset, dst_y_offset, 0,
+				src_array_index, src_face, src_level, src_x_offset, src_y_offset, 0,
+				src_width, src_height, 1);
+		}
+		else
+		{
+			this->ResizeTextureCube(target, dst_array_index, dst_face, dst_level, dst_x_offset, dst_y_offset,
+				dst_width, dst_height,
+				src_array_index, src_face, src_level, src_x_offset, src_y_offset, src_width, src_height, true);
+		}
+	}
+
+	// Mipmaps are generated on GPU by the other plugins, so it's only counted here
+	void NullTexture::BuildMipSubLevels()
+	{
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_MipmapGenerations);
+	}
+
+	void NullTexture::Map1D(uint32_t array_index, uint32_t level, TextureMapAccess /*tma*/,
+		uint32_t x_offset, uint32_t /*width*/,
+		void*& data)
+	{
+		BOOST_ASSERT(TT_1D == type_);
+
+		data = this->TexelData(array_index, 0, level, x_offset, 0, 0);
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_TextureMaps);
+	}
+
+	void NullTexture::Map2D(uint32_t array_index, uint32_t level, TextureMapAccess /*tma*/,
+		uint32_t x_offset, uint32_t y_offset, uint32_t /*width*/, uint32_t /*height*/,
+		void*& data, uint32_t& row_pitch)
+	{
+		BOOST_ASSERT(TT_2D == type_);
+
+		data = this->TexelData(array_index, 0, level, x_offset, y_offset, 0);
+		row_pitch = this->RowPitch(level);
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_TextureMaps);
+	}
+
+	void NullTexture::Map3D(uint32_t array_index, uint32_t level, TextureMapAccess /*tma*/,
+		uint32_t x_offset, uint32_t y_offset, uint32_t z_offset,
+		uint32_t /*width*/, uint32_t /*height*/, uint32_t /*depth*/,
+		void*& data, uint32_t& row_pitch, uint32_t& slice_pitch)
+	{
+		BOOST_ASSERT(TT_3D == type_);
+
+		data = this->TexelData(array_index, 0, level, x_offset, y_offset, z_offset);
+		row_pitch = this->RowPitch(level);
+		slice_pitch = this->SlicePitch(level);
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_TextureMaps);
+	}
+
+	void NullTexture::MapCube(uint32_t array_index, CubeFaces face, uint32_t level, TextureMapAccess /*tma*/,
+		uint32_t x_offset, uint32_t y_offset, uint32_t /*width*/, uint32_t /*height*/,
+		void*& data, uint32_t& row_pitch)
+	{
+		BOOST_ASSERT(TT_Cube == type_);
+
+		data = this->TexelData(array_index, face, level, x_offset, y_offset, 0);
+		row_pitch = this->RowPitch(level);
+
+		NullRenderEngine& re = *checked_cast<NullRenderEngine*>(&Context::Instance().RenderFactoryInstance().RenderEngineInstance());
+		re.Count(NC_TextureMaps);
+	}
+
+	void NullTexture::Unmap1D(uint32_t /*array_index*/, uint32_t /*level*/)
+	{
+	}
+
+	void NullTexture::Unmap2D(uint32_t /*array_index*/, uint32_t /*level*/)
+	{
+	}
+
+	void NullTexture::Unmap3D(uint32_t /*array_index*/, uint32_t /*level*/)
+	{
+	}
+
+	void NullTexture::UnmapCube(uint32_t /*array_index*/, CubeFaces /*face*/, uint32_t /*level*/)
+	{
+	}
+
+	void NullTexture::CreateHWResource(ElementInitData const * init_data)
+	{
+		if (init_data != nullptr)
+		{
+			for (uint32_t index = 0; index < array_size_; ++ index)
+			{
+				for (uint32_t face = 0; face < this->NumFaces(); ++ face)
+				{
+					for (uint32_t level = 0; level < num_mip_maps_; ++ level)
+					{
+						ElementInitData const & init = init_data[(index * this->NumFaces() + face) * num_mip_maps_ + level];
+						this->UpdateRegion(index, face, level, 0, 0, 0, this->Width(level), this->Height(level), this->Depth(level),
+							init.data, init.row_pitch, init.slice_pitch);
+					}
+				}
+			}
+		}
+
+		hw_res_ready_ = true;
+	}
+
+	void NullTexture::DeleteHWResource()
+	{
+		std::vector<uint8_t>().swap(texels_);
+		hw_res_ready_ = false;
+	}
+
+	bool NullTexture::HWResourceReady() const
+	{
+		return hw_res_ready_;
+	}
+
+	void NullTexture::UpdateSubresource1D(uint32_t array_index, uint32_t level,
+		uint32_t x_offset, uint32_t width,
+		void const * data)
+	{
+		BOOST_ASSERT(TT_1D == type_);
+
+		this->UpdateRegion(array_index, 0, level, x_offset, 0, 0, width, 1, 1, data, 0, 0);
+	}
+
+	void NullTexture::UpdateSubresource2D(uint32_t array_index, uint32_t level,
+		uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+		void const * data, uint32_t row_pitch)
+	{
+		BOOST_ASSERT(TT_2D == type_);
+
+		this->UpdateRegion(array_index, 0, level, x_offset, y_offset, 0, width, height, 1, data, row_pitch, 0);
+	}
+
+	void NullTexture::UpdateSubresource3D(uint32_t array_index, uint32_t level,
+		uint32_t x_offset, uint32_t y_offset, uint32_t z_offset,
+		uint32_t width, uint32_t height, uint32_t depth,
+		void const * data, uint32_t row_pitch, uint32_t slice_pitch)
+	{
+		BOOST_ASSERT(TT_3D == type_);
+
+		this->UpdateRegion(array_index, 0, level, x_offset, y_offset, z_offset, width, height, depth,
+			data, row_pitch, slice_pitch);
+	}
+
+	void NullTexture::UpdateSubresourceCube(uint32_t array_index, CubeFaces face, uint32_t level,
+		uint32_t x_offset, uint32_t y_offset, uint32_t width, uint32_t height,
+		void const * data, uint32_t row_pitch)
+	{
+		BOOST_ASSERT(TT_Cube == type_);
+
+		this->UpdateRegion(array_index, face, level, x_offset, y_offset, 0, width, height, 1, data, row_pitch, 0);
+	}
+}
@@ -182,7 +182,7 @@ namespace KlayGE
 	}
 
 	bool OGLESShaderObject::AttachNativeShader(ShaderType type, RenderEffect const & effect,
-		std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids, std::vector<uint8_t> const & native_shader_block)
+		std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids, uint8_t const * native_shader_block, size_t native_shader_block_size)
 	{
 		bool ret = false;
 
@@ -191,9 +191,9 @@ namespace KlayGE
 		(*shader_func_names_)[type] = sd.func_name;
 
 		is_shader_validate_[type] = false;
-		if (native_shader_block.size() >= 24)
+		if (native_shader_block_size >= 24)
 		{
-			uint8_t const * nsbp = &native_shader_block[0];
+			uint8_t const * nsbp = native_shader_block;
 
 			is_shader_validate_[type] = true;
 
@@ -325,21 +325,6 @@ namespace KlayGE
 		return ret;
 	}
 
-	bool OGLESShaderObject::StreamIn(ResIdentifierPtr const & res, ShaderType type, RenderEffect const & effect,
-		std::array<uint32_t, ST_NumShaderTypes> const & shader_desc_ids)
-	{
-		uint32_t len;
-		res->read(&len, sizeof(len));
-		len = LE2Native(len);
-		std::vector<uint8_t> native_shader_block(len);
-		if (len > 0)
-		{
-			res->read(&native_shader_block[0], len * sizeof(native_shader_block[0]));
-		}
-
-		return this->AttachNativeShader(type, effect, shader_desc_ids, native_shader_block);
-	}
-
 	void OGLESShaderObject::StreamOut(std::ostream& os, ShaderType type)
 	{
 		std::vector<uint8_t> native_shader_block;
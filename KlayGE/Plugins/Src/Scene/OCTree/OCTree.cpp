@@ -32,7 +32,6 @@
 #include <KlayGE/RenderableHelper.hpp>
 #include <KlayGE/Camera.hpp>
 #include <KlayGE/App3D.hpp>
-#include <KlayGE/DeferredRenderingLayer.hpp>
 
 #include <algorithm>
 #include <functional>
@@ -99,7 +98,7 @@ namespace
 namespace KlayGE
 {
 	OCTree::OCTree()
-		: max_tree_depth_(4), rebuild_tree_(false)
+		: max_tree_depth_(4), rebuild_tree_(false), grow_root_(false)
 	{
 	}
 
@@ -113,20 +112,34 @@ namespace KlayGE
 		return max_tree_depth_;
 	}
 
-	void OCTree::ClipScene()
+	void OCTree::ClipScene(std::vector<ClipView>& views)
 	{
 		if (rebuild_tree_)
 		{
+			float const prev_root_extent = node_bounds_.empty() ? 0 : node_bounds_[0].w();
+
 			octree_.resize(1);
+			node_bounds_.resize(1);
+			moveable_nodes_.clear();
+			overflow_moveables_.clear();
 			AABBox bb_root(float3(0, 0, 0), float3(0, 0, 0));
 			octree_[0].first_child_index = -1;
+			octree_[0].parent_index = -1;
+			octree_[0].subtree_end = 1;
 			octree_[0].visible = BO_No;
+			octree_[0].num_moveables = 0;
+			octree_[0].obj_ptrs.clear();
 			for (auto const & obj : scene_objs_)
 			{
 				uint32_t const attr = obj->Attrib();
-				if ((attr & SceneObject::SOA_Cullable)
-					&& !(attr & SceneObject::SOA_Moveable))
+				if (attr & SceneObject::SOA_Cullable)
 				{
+					if (attr & SceneObject::SOA_Moveable)
+					{
+						obj->UpdateAbsModelMatrix();
+					}
+
+					// Moveable objects take part in dividing the tree, so it's also fine grained where they are
 					bb_root |= obj->PosBoundWS();
 					octree_[0].obj_ptrs.push_back(obj.get());
 				}
@@ -134,12 +147,35 @@ namespace KlayGE
 			float3 const & center = bb_root.Center();
 			float3 const & extent = bb_root.HalfSize();
 			float longest_dim = std::max(std::max(extent.x(), extent.y()), extent.z());
-			float3 new_extent(longest_dim, longest_dim, longest_dim);
-			octree_[0].bb = AABBox(center - new_extent, center + new_extent);
+			if (grow_root_)
+			{
+				// At least doubles, so an object going away only rebuilds the tree a logarithmic number of times
+				longest_dim = std::max(longest_dim, prev_root_extent * 2);
+			}
+			node_bounds_[0] = float4(center.x(), center.y(), center.z(), longest_dim);
 
 			this->DivideNode(0, 1);
 
+			for (auto& node : octree_)
+			{
+				node.obj_ptrs.erase(std::remove_if(node.obj_ptrs.begin(), node.obj_ptrs.end(),
+					[](SceneObject* so)
+					{
+						return (so->Attrib() & SceneObject::SOA_Moveable) != 0;
+					}), node.obj_ptrs.end());
+			}
+
 			rebuild_tree_ = false;
+			grow_root_ = false;
+		}
+
+		for (auto const & obj : scene_objs_)
+		{
+			uint32_t const attr = obj->Attrib();
+			if ((attr & SceneObject::SOA_Cullable) && (attr & SceneObject::SOA_Moveable) && obj->Visible())
+			{
+				this->UpdateMoveable(obj.get());
+			}
 		}
 
 #ifdef KLAYGE_DRAW_NODES
@@ -150,101 +186,92 @@ namespace KlayGE
 		checked_pointer_cast<NodeRenderable>(node_renderable_)->ClearInstances();
 #endif
 
-		if (!octree_.empty())
-		{
-			this->NodeVisible(0);
-		}
-
-		App3DFramework& app = Context::Instance().AppInstance();
-		Camera& camera = app.ActiveCamera();
+		uint32_t const num_objs = static_cast<uint32_t>(scene_objs_.size());
+		uint32_t const num_views = static_cast<uint32_t>(views.size());
+		BOOST_ASSERT(num_views <= MAX_CLIP_VIEWS);
 
-		float4x4 view_proj = camera.ViewProjMatrix();
-		auto drl = Context::Instance().DeferredRenderingLayerInstance();
-		if (drl)
+		// The tree is walked once for all the views that have a frustum
+		uint32_t tree_view_mask = 0;
+		for (uint32_t v = 0; v < num_views; ++ v)
 		{
-			int32_t cas_index = drl->CurrCascadeIndex();
-			if (cas_index >= 0)
+			views[v].marks.assign(num_objs, BO_No);
+			if (!views[v].omni_directional)
 			{
-				view_proj *= drl->GetCascadedShadowLayer()->CascadeCropMatrix(cas_index);
+				tree_view_mask |= 1UL << v;
 			}
 		}
+		if (octree_.empty())
+		{
+			tree_view_mask = 0;
+		}
 
-		if (camera.OmniDirectionalMode())
+		if (tree_view_mask != 0)
 		{
-			for (auto const & obj : scene_objs_)
+			obj_indices_.clear();
+			for (uint32_t i = 0; i < num_objs; ++ i)
 			{
-				if (obj->Visible())
-				{
-					uint32_t const attr = obj->Attrib();
-					if (attr & SceneObject::SOA_Moveable)
-					{
-						obj->UpdateAbsModelMatrix();
-					}
-
-					if (attr & SceneObject::SOA_Cullable)
-					{
-						BoundOverlap bo;
-						if (small_obj_threshold_ > 0)
-						{
-							AABBox const & aabb_ws = obj->PosBoundWS();
-							bo = ((MathLib::ortho_area(camera.ForwardVec(), aabb_ws) > small_obj_threshold_)
-								&& (MathLib::perspective_area(camera.EyePos(), view_proj, aabb_ws) > small_obj_threshold_))
-								? BO_Yes : BO_No;
-						}
-						else
-						{
-							bo = BO_Yes;
-						}
-						obj->VisibleMark(bo);
-					}
-				}
-				else
-				{
-					obj->VisibleMark(BO_No);
-				}
+				obj_indices_.emplace(scene_objs_[i].get(), i);
 			}
-		}
-		else
-		{
-			if (!octree_.empty())
+
+			node_visibles_.assign(octree_.size() * num_views, BO_No);
+			this->NodesVisible(tree_view_mask, views);
+			this->MarkNodesObjs(tree_view_mask, views);
+
+			// AABBVisible and the like test against the nodes of the last view
+			for (size_t i = 0; i < octree_.size(); ++ i)
 			{
-				this->MarkNodeObjs(0, false);
+				octree_[i].visible = node_visibles_[i * num_views + num_views - 1];
 			}
+		}
 
-			for (auto const & obj : scene_objs_)
+		// Objects in the tree are marked already. The rest are non-cullable objects, objects with parent, and
+		//  moveable objects out of the tree. Parents are ahead of their children, so they are resolved in order.
+		for (uint32_t v = 0; v < num_views; ++ v)
+		{
+			ClipView& view = views[v];
+			bool const tree_view = (tree_view_mask & (1UL << v)) != 0;
+			float3 const view_dir = view.camera->ForwardVec();
+			float3 const eye_pos = view.camera->EyePos();
+			for (uint32_t i = 0; i < num_objs; ++ i)
 			{
-				if (obj->Visible())
+				SceneObject* so = scene_objs_[i].get();
+				BoundOverlap visible = BO_No;
+				if (so->Visible())
 				{
-					BoundOverlap visible = this->VisibleTestFromParent(obj.get(), camera.ForwardVec(), camera.EyePos(), view_proj);
-					if (BO_Partial == visible)
+					uint32_t const attr = so->Attrib();
+					if (view.omni_directional)
 					{
-						uint32_t const attr = obj->Attrib();
-						if (attr & SceneObject::SOA_Moveable)
-						{
-							obj->UpdateAbsModelMatrix();
-						}
-
 						if (attr & SceneObject::SOA_Cullable)
 						{
-							if (attr & SceneObject::SOA_Moveable)
+							if (small_obj_threshold_ > 0)
 							{
-								obj->VisibleMark(this->AABBVisible(obj->PosBoundWS()));
+								AABBox const & aabb_ws = so->PosBoundWS();
+								visible = ((MathLib::ortho_area(view_dir, aabb_ws) > small_obj_threshold_)
+									&& (MathLib::perspective_area(eye_pos, view.view_proj, aabb_ws) > small_obj_threshold_))
+									? BO_Yes : BO_No;
 							}
 							else
 							{
-								obj->VisibleMark(visible);
+								visible = BO_Yes;
 							}
 						}
-						else
-						{
-							obj->VisibleMark(BO_Yes);
-						}
+					}
+					else if (tree_view && this->InTree(so))
+					{
+						visible = view.marks[i];
 					}
 					else
 					{
-						obj->VisibleMark(visible);
+						visible = this->VisibleTestFromParent(so, view_dir, eye_pos, view.view_proj);
+						if (BO_Partial == visible)
+						{
+							visible = (attr & SceneObject::SOA_Cullable) ? view.frustum.Intersect(so->PosBoundWS()) : BO_Yes;
+						}
 					}
 				}
+
+				so->VisibleMark(visible);
+				view.marks[i] = visible;
 			}
 		}
 
@@ -258,14 +285,20 @@ namespace KlayGE
 		SceneManager::ClearObject();
 
 		octree_.clear();
+		node_bounds_.clear();
+		moveable_nodes_.clear();
+		overflow_moveables_.clear();
 		rebuild_tree_ = true;
+		grow_root_ = false;
 	}
 
 	void OCTree::OnAddSceneObject(SceneObjectPtr const & obj)
 	{
+		// Moveable objects are inserted into the tree incrementally in ClipScene. If there is no tree yet, it's built
+		//  from them.
 		uint32_t const attr = obj->Attrib();
 		if ((attr & SceneObject::SOA_Cullable)
-			&& !(attr & SceneObject::SOA_Moveable))
+			&& (!(attr & SceneObject::SOA_Moveable) || octree_.empty()))
 		{
 			rebuild_tree_ = true;
 		}
@@ -276,10 +309,16 @@ namespace KlayGE
 		BOOST_ASSERT(iter != scene_objs_.end());
 
 		uint32_t const attr = (*iter)->Attrib();
-		if ((attr & SceneObject::SOA_Cullable)
-			&& !(attr & SceneObject::SOA_Moveable))
+		if (attr & SceneObject::SOA_Cullable)
 		{
-			rebuild_tree_ = true;
+			if (attr & SceneObject::SOA_Moveable)
+			{
+				this->RemoveMoveable(iter->get());
+			}
+			else
+			{
+				rebuild_tree_ = true;
+			}
 		}
 	}
 
@@ -298,12 +337,14 @@ namespace KlayGE
 		if (octree_[index].obj_ptrs.size() > 1)
 		{
 			size_t const this_size = octree_.size();
-			AABBox const parent_bb = octree_[index].bb;
-			float3 const parent_center = parent_bb.Center();
+			float4 const parent_bound = node_bounds_[index];
+			float3 const parent_center(parent_bound.x(), parent_bound.y(), parent_bound.z());
+			float const child_extent = parent_bound.w() / 2;
 			octree_[index].first_child_index = static_cast<int>(this_size);
 			octree_[index].visible = BO_No;
 
 			octree_.resize(this_size + 8);
+			node_bounds_.resize(this_size + 8);
 			for (auto so : octree_[index].obj_ptrs)
 			{
 				AABBox const & aabb = so->PosBoundWS();
@@ -329,12 +370,14 @@ namespace KlayGE
 			{
 				octree_node_t& new_node = octree_[this_size + j];
 				new_node.first_child_index = -1;
-				new_node.bb = AABBox(float3((j & 1) ? parent_center.x() : parent_bb.Min().x(),
-						(j & 2) ? parent_center.y() : parent_bb.Min().y(),
-						(j & 4) ? parent_center.z() : parent_bb.Min().z()),
-					float3((j & 1) ? parent_bb.Max().x() : parent_center.x(),
-						(j & 2) ? parent_bb.Max().y() : parent_center.y(),
-						(j & 4) ? parent_bb.Max().z() : parent_center.z()));
+				new_node.parent_index = static_cast<int>(index);
+				new_node.subtree_end = static_cast<int>(this_size + j + 1);
+				new_node.visible = BO_No;
+				new_node.num_moveables = 0;
+				node_bounds_[this_size + j] = float4(parent_center.x() + ((j & 1) ? child_extent : -child_extent),
+					parent_center.y() + ((j & 2) ? child_extent : -child_extent),
+					parent_center.z() + ((j & 4) ? child_extent : -child_extent),
+					child_extent);
 
 				if (curr_depth < max_tree_depth_)
 				{
@@ -342,109 +385,346 @@ namespace KlayGE
 				}
 			}
 
+			octree_[index].subtree_end = static_cast<int>(octree_.size());
 			octree_[index].obj_ptrs.clear();
 			octree_[index].obj_ptrs.shrink_to_fit();
 		}
 	}
 
-	void OCTree::NodeVisible(size_t index)
+	void OCTree::UpdateMoveable(SceneObject* so)
 	{
-		BOOST_ASSERT(index < octree_.size());
-
-		App3DFramework& app = Context::Instance().AppInstance();
-		Camera& camera = app.ActiveCamera();
+		so->UpdateAbsModelMatrix();
 
-		float4x4 view_proj = camera.ViewProjMatrix();
-		auto drl = Context::Instance().DeferredRenderingLayerInstance();
-		if (drl)
+		auto iter = moveable_nodes_.find(so);
+		if (iter == moveable_nodes_.end())
 		{
-			int32_t cas_index = drl->CurrCascadeIndex();
-			if (cas_index >= 0)
+			this->InsertMoveable(so);
+		}
+		else
+		{
+			AABBox const & aabb = so->PosBoundWS();
+			float3 const center = aabb.Center();
+			float3 const & half_size = aabb.HalfSize();
+			float const extent = std::max(std::max(half_size.x(), half_size.y()), half_size.z());
+			bool reinsert;
+			if (iter->second != -1)
+			{
+				reinsert = !this->MoveableFitsNode(iter->second, center, extent);
+			}
+			else
 			{
-				view_proj *= drl->GetCascadedShadowLayer()->CascadeCropMatrix(cas_index);
+				// Objects out of the root stay in the overflow list until they are back in it
+				reinsert = !octree_.empty() && this->MoveableInNode(0, center, extent);
+			}
+			if (reinsert)
+			{
+				this->RemoveMoveable(so);
+				this->InsertMoveable(so);
 			}
 		}
+	}
 
-		octree_node_t& node = octree_[index];
-		if ((small_obj_threshold_ <= 0)
-			|| ((MathLib::ortho_area(camera.ForwardVec(), node.bb) > small_obj_threshold_)
-				&& (MathLib::perspective_area(camera.EyePos(), view_proj, node.bb) > small_obj_threshold_)))
+	void OCTree::InsertMoveable(SceneObject* so)
+	{
+		AABBox const & aabb = so->PosBoundWS();
+		float3 const center = aabb.Center();
+		float3 const & half_size = aabb.HalfSize();
+		float const extent = std::max(std::max(half_size.x(), half_size.y()), half_size.z());
+
+		int index = -1;
+		if (!octree_.empty() && this->MoveableInNode(0, center, extent))
 		{
-			BoundOverlap const vis = frustum_->Intersect(node.bb);
-			node.visible = vis;
-			if (BO_Partial == vis)
+			index = 0;
+			while (octree_[index].first_child_index != -1)
 			{
-				if (node.first_child_index != -1)
+				float4 const & bound = node_bounds_[index];
+				int const child_index = octree_[index].first_child_index
+					+ ((center.x() >= bound.x()) ? 1 : 0) + ((center.y() >= bound.y()) ? 2 : 0) + ((center.z() >= bound.z()) ? 4 : 0);
+				if (extent > node_bounds_[child_index].w())
 				{
-					for (int i = 0; i < 8; ++ i)
-					{
-						this->NodeVisible(node.first_child_index + i);
-					}
+					break;
 				}
+				index = child_index;
 			}
+
+			octree_[index].obj_ptrs.push_back(so);
+			this->AddNodeMoveables(index, 1);
 		}
 		else
 		{
-			node.visible = BO_No;
+			// The root is grown to take the object in the next frame
+			overflow_moveables_.push_back(so);
+			rebuild_tree_ = true;
+			grow_root_ = true;
+		}
+
+		moveable_nodes_[so] = index;
+	}
+
+	void OCTree::RemoveMoveable(SceneObject* so)
+	{
+		auto iter = moveable_nodes_.find(so);
+		if (iter != moveable_nodes_.end())
+		{
+			if (iter->second != -1)
+			{
+				auto& obj_ptrs = octree_[iter->second].obj_ptrs;
+				auto obj_iter = std::find(obj_ptrs.begin(), obj_ptrs.end(), so);
+				BOOST_ASSERT(obj_iter != obj_ptrs.end());
+				*obj_iter = obj_ptrs.back();
+				obj_ptrs.pop_back();
+
+				this->AddNodeMoveables(iter->second, -1);
+			}
+			else
+			{
+				auto obj_iter = std::find(overflow_moveables_.begin(), overflow_moveables_.end(), so);
+				BOOST_ASSERT(obj_iter != overflow_moveables_.end());
+				*obj_iter = overflow_moveables_.back();
+				overflow_moveables_.pop_back();
+			}
+
+			moveable_nodes_.erase(iter);
+		}
+	}
+
+	// The center is in the node, and the object is in the loose bound of it
+	bool OCTree::MoveableInNode(size_t index, float3 const & center, float extent) const
+	{
+		float4 const & bound = node_bounds_[index];
+		return (extent <= bound.w())
+			&& (std::abs(center.x() - bound.x()) <= bound.w())
+			&& (std::abs(center.y() - bound.y()) <= bound.w())
+			&& (std::abs(center.z() - bound.z()) <= bound.w());
+	}
+
+	// An object stays in a node as long as it's in the node, and it's not small enough for a child
+	bool OCTree::MoveableFitsNode(size_t index, float3 const & center, float extent) const
+	{
+		if (!this->MoveableInNode(index, center, extent))
+		{
+			return false;
+		}
+
+		int const first_child_index = octree_[index].first_child_index;
+		return (-1 == first_child_index) || (extent > node_bounds_[first_child_index].w());
+	}
+
+	void OCTree::AddNodeMoveables(int index, int32_t delta)
+	{
+		for (; index != -1; index = octree_[index].parent_index)
+		{
+			octree_[index].num_moveables += delta;
+		}
+	}
+
+	AABBox OCTree::NodeBound(size_t index) const
+	{
+		float4 const & bound = node_bounds_[index];
+		float3 const center(bound.x(), bound.y(), bound.z());
+		float3 const half_size(bound.w(), bound.w(), bound.w());
+		return AABBox(center - half_size, center + half_size);
+	}
+
+	AABBox OCTree::LooseNodeBound(size_t index) const
+	{
+		float4 const & bound = node_bounds_[index];
+		float const extent = (octree_[index].num_moveables > 0) ? bound.w() * 2 : bound.w();
+		float3 const center(bound.x(), bound.y(), bound.z());
+		float3 const half_size(extent, extent, extent);
+		return AABBox(center - half_size, center + half_size);
+	}
+
+	BoundOverlap OCTree::NodeFrustumIntersect(size_t index, Frustum const & frustum) const
+	{
+		float4 const & bound = node_bounds_[index];
+		float const extent = (octree_[index].num_moveables > 0) ? bound.w() * 2 : bound.w();
+
+		bool intersect = false;
+		for (uint32_t i = 0; i < 6; ++ i)
+		{
+			Plane const & plane = frustum.FrustumPlane(i);
+
+			float const d = plane.a() * bound.x() + plane.b() * bound.y() + plane.c() * bound.z() + plane.d();
+			float const r = extent * (std::abs(plane.a()) + std::abs(plane.b()) + std::abs(plane.c()));
+			if (d + r < 0)
+			{
+				return BO_No;
+			}
+			if (d - r < 0)
+			{
+				intersect = true;
+			}
+		}
+
+		return intersect ? BO_Partial : BO_Yes;
+	}
+
+	bool OCTree::InTree(SceneObject* so) const
+	{
+		uint32_t const attr = so->Attrib();
+		if (!(attr & SceneObject::SOA_Cullable) || so->Parent())
+		{
+			return false;
+		}
+		if (attr & SceneObject::SOA_Moveable)
+		{
+			auto iter = moveable_nodes_.find(so);
+			return (iter != moveable_nodes_.end()) && (iter->second != -1);
+		}
+		return true;
+	}
+
+	// A node is always ahead of its children. When the walk reaches the children of a node that no view goes down,
+	//  all the descendants of that node are skipped at once, since they are contiguous.
+	void OCTree::NodesVisible(uint32_t view_mask, std::vector<ClipView> const & views)
+	{
+		node_partial_masks_.resize(octree_.size());
+		node_partial_masks_[0] = this->NodeVisible(0, view_mask, views);
+		for (size_t i = 1; i < octree_.size();)
+		{
+			int const parent_index = octree_[i].parent_index;
+			uint32_t const parent_mask = node_partial_masks_[parent_index];
+			if (0 == parent_mask)
+			{
+				i = octree_[parent_index].subtree_end;
+			}
+			else
+			{
+				for (size_t j = 0; j < 8; ++ j)
+				{
+					node_partial_masks_[i + j] = this->NodeVisible(i + j, parent_mask, views);
+				}
+				i += 8;
+			}
+		}
+	}
+
+	uint32_t OCTree::NodeVisible(size_t index, uint32_t view_mask, std::vector<ClipView> const & views)
+	{
+		BOOST_ASSERT(index < octree_.size());
+
+		uint32_t const num_views = static_cast<uint32_t>(views.size());
+		AABBox const node_bb = this->LooseNodeBound(index);
+
+		uint32_t partial_mask = 0;
+		for (uint32_t v = 0; v < num_views; ++ v)
+		{
+			if (view_mask & (1UL << v))
+			{
+				ClipView const & view = views[v];
+				BoundOverlap vis;
+				if ((small_obj_threshold_ <= 0)
+					|| ((MathLib::ortho_area(view.camera->ForwardVec(), node_bb) > small_obj_threshold_)
+						&& (MathLib::perspective_area(view.camera->EyePos(), view.view_proj, node_bb) > small_obj_threshold_)))
+				{
+					vis = this->NodeFrustumIntersect(index, view.frustum);
+				}
+				else
+				{
+					vis = BO_No;
+				}
+				node_visibles_[index * num_views + v] = vis;
+				if (BO_Partial == vis)
+				{
+					partial_mask |= 1UL << v;
+				}
+			}
 		}
 
 #ifdef KLAYGE_DRAW_NODES
-		if ((vis != BO_No) && (-1 == node.first_child_index))
+		if ((node_visibles_[index * num_views + num_views - 1] != BO_No) && (-1 == octree_[index].first_child_index))
 		{
-			checked_pointer_cast<NodeRenderable>(node_renderable_)->AddInstance(MathLib::scaling(node.bb.HalfSize()) * MathLib::translation(node.bb.Center()));
+			checked_pointer_cast<NodeRenderable>(node_renderable_)->AddInstance(MathLib::scaling(node_bb.HalfSize()) * MathLib::translation(node_bb.Center()));
 		}
 #endif
+
+		// Only the views the node is partially in go down to the children
+		return partial_mask;
+	}
+
+	void OCTree::MarkNodesObjs(uint32_t view_mask, std::vector<ClipView>& views)
+	{
+		node_in_masks_.resize(octree_.size());
+		node_yes_masks_.resize(octree_.size());
+		this->MarkNodeObjs(0, view_mask, 0, views);
+		for (size_t i = 1; i < octree_.size();)
+		{
+			int const parent_index = octree_[i].parent_index;
+			uint32_t const parent_mask = node_in_masks_[parent_index];
+			if (0 == parent_mask)
+			{
+				i = octree_[parent_index].subtree_end;
+			}
+			else
+			{
+				uint32_t const parent_yes_mask = node_yes_masks_[parent_index];
+				for (size_t j = 0; j < 8; ++ j)
+				{
+					this->MarkNodeObjs(i + j, parent_mask, parent_yes_mask, views);
+				}
+				i += 8;
+			}
+		}
 	}
 
-	void OCTree::MarkNodeObjs(size_t index, bool force)
+	void OCTree::MarkNodeObjs(size_t index, uint32_t view_mask, uint32_t force_mask, std::vector<ClipView>& views)
 	{
 		BOOST_ASSERT(index < octree_.size());
 
-		App3DFramework& app = Context::Instance().AppInstance();
-		Camera& camera = app.ActiveCamera();
+		uint32_t const num_views = static_cast<uint32_t>(views.size());
 
-		float4x4 view_proj = camera.ViewProjMatrix();
-		auto drl = Context::Instance().DeferredRenderingLayerInstance();
-		if (drl)
+		// Views the node is in, and views it's entirely in. Children of a node entirely in a view are in it too.
+		uint32_t node_mask = force_mask;
+		uint32_t yes_mask = force_mask;
+		for (uint32_t v = 0; v < num_views; ++ v)
 		{
-			int32_t cas_index = drl->CurrCascadeIndex();
-			if (cas_index >= 0)
+			uint32_t const bit = 1UL << v;
+			if ((view_mask & bit) && !(force_mask & bit))
 			{
-				view_proj *= drl->GetCascadedShadowLayer()->CascadeCropMatrix(cas_index);
+				BoundOverlap const vis = node_visibles_[index * num_views + v];
+				if (vis != BO_No)
+				{
+					node_mask |= bit;
+				}
+				if (BO_Yes == vis)
+				{
+					yes_mask |= bit;
+				}
 			}
 		}
+		node_in_masks_[index] = node_mask;
+		node_yes_masks_[index] = yes_mask;
+		if (0 == node_mask)
+		{
+			return;
+		}
 
 		octree_node_t const & node = octree_[index];
-		if ((node.visible != BO_No) || force)
+		AABBox const node_bb = this->LooseNodeBound(index);
+		for (auto so : node.obj_ptrs)
 		{
-			for (auto so : node.obj_ptrs)
+			// Objects with parent are resolved after the parents
+			if (!so->Visible() || so->Parent())
 			{
-				if ((BO_No == so->VisibleMark()) && so->Visible())
-				{
-					BoundOverlap visible = this->VisibleTestFromParent(so, camera.ForwardVec(), camera.EyePos(), view_proj);
-					if (BO_Partial == visible)
-					{
-						AABBox const & aabb_ws = so->PosBoundWS();
-						if (so->Parent() || (small_obj_threshold_ <= 0)
-							|| ((MathLib::ortho_area(camera.ForwardVec(), node.bb) > small_obj_threshold_)
-								&& (MathLib::perspective_area(camera.EyePos(), view_proj, aabb_ws) > small_obj_threshold_)))
-						{
-							visible = frustum_->Intersect(aabb_ws);
-						}
-						else
-						{
-							visible = BO_No;
-						}
-					}
-					so->VisibleMark(visible);
-				}
+				continue;
 			}
 
-			if (node.first_child_index != -1)
+			auto iter = obj_indices_.find(so);
+			BOOST_ASSERT(iter != obj_indices_.end());
+			uint32_t const obj_index = iter->second;
+			AABBox const & aabb_ws = so->PosBoundWS();
+			for (uint32_t v = 0; v < num_views; ++ v)
 			{
-				for (int i = 0; i < 8; ++ i)
+				ClipView& view = views[v];
+				if ((node_mask & (1UL << v)) && (BO_No == view.marks[obj_index]))
 				{
-					this->MarkNodeObjs(node.first_child_index + i, (BO_Yes == node.visible) || force);
+					if ((small_obj_threshold_ <= 0)
+						|| ((MathLib::ortho_area(view.camera->ForwardVec(), node_bb) > small_obj_threshold_)
+							&& (MathLib::perspective_area(view.camera->EyePos(), view.view_proj, aabb_ws) > small_obj_threshold_)))
+					{
+						view.marks[obj_index] = view.frustum.Intersect(aabb_ws);
+					}
 				}
 			}
 		}
@@ -456,7 +736,7 @@ namespace KlayGE
 		BoundOverlap visible = BO_Yes;
 		if (!octree_.empty())
 		{
-			if (MathLib::intersect_aabb_aabb(octree_[0].bb, aabb))
+			if (MathLib::intersect_aabb_aabb(this->NodeBound(0), aabb))
 			{
 				visible = this->BoundVisible(0, aabb);
 			}
@@ -487,7 +767,7 @@ namespace KlayGE
 		BoundOverlap visible = BO_Yes;
 		if (!octree_.empty())
 		{
-			if (MathLib::intersect_aabb_obb(octree_[0].bb, obb))
+			if (MathLib::intersect_aabb_obb(this->NodeBound(0), obb))
 			{
 				visible = this->BoundVisible(0, obb);
 			}
@@ -518,7 +798,7 @@ namespace KlayGE
 		BoundOverlap visible = BO_Yes;
 		if (!octree_.empty())
 		{
-			if (MathLib::intersect_aabb_sphere(octree_[0].bb, sphere))
+			if (MathLib::intersect_aabb_sphere(this->NodeBound(0), sphere))
 			{
 				visible = this->BoundVisible(0, sphere);
 			}
@@ -548,7 +828,8 @@ namespace KlayGE
 		BOOST_ASSERT(index < octree_.size());
 
 		octree_node_t const & node = octree_[index];
-		if ((node.visible != BO_No) && MathLib::intersect_aabb_aabb(node.bb, aabb))
+		AABBox const node_bb = this->NodeBound(index);
+		if ((node.visible != BO_No) && MathLib::intersect_aabb_aabb(node_bb, aabb))
 		{
 			if (BO_Yes == node.visible)
 			{
@@ -560,7 +841,7 @@ namespace KlayGE
 
 				if (node.first_child_index != -1)
 				{
-					float3 const center = node.bb.Center();
+					float3 const center = node_bb.Center();
 					int mark[6];
 					mark[0] = aabb.Min().x() >= center.x() ? 1 : 0;
 					mark[1] = aabb.Min().y() >= center.y() ? 2 : 0;
@@ -601,7 +882,8 @@ namespace KlayGE
 		BOOST_ASSERT(index < octree_.size());
 
 		octree_node_t const & node = octree_[index];
-		if ((node.visible != BO_No) && MathLib::intersect_aabb_obb(node.bb, obb))
+		AABBox const node_bb = this->NodeBound(index);
+		if ((node.visible != BO_No) && MathLib::intersect_aabb_obb(node_bb, obb))
 		{
 			if (BO_Yes == node.visible)
 			{
@@ -641,7 +923,8 @@ namespace KlayGE
 		BOOST_ASSERT(index < octree_.size());
 
 		octree_node_t const & node = octree_[index];
-		if ((node.visible != BO_No) && MathLib::intersect_aabb_sphere(node.bb, sphere))
+		AABBox const node_bb = this->NodeBound(index);
+		if ((node.visible != BO_No) && MathLib::intersect_aabb_sphere(node_bb, sphere))
 		{
 			if (BO_Yes == node.visible)
 			{
@@ -681,7 +964,8 @@ namespace KlayGE
 		BOOST_ASSERT(index < octree_.size());
 
 		octree_node_t const & node = octree_[index];
-		if ((node.visible != BO_No) && MathLib::intersect_aabb_frustum(node.bb, frustum))
+		AABBox const node_bb = this->NodeBound(index);
+		if ((node.visible != BO_No) && MathLib::intersect_aabb_frustum(node_bb, frustum))
 		{
 			if (BO_Yes == node.visible)
 			{
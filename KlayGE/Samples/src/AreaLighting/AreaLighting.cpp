@@ -218,6 +218,7 @@ void AreaLightingApp::InputHandler(InputEngine const & /*sender*/, InputAction c
 	case Profile:
 #ifndef KLAYGE_SHIP
 		PerfProfiler::Instance().ExportToCSV("profile.csv");
+		PerfProfiler::Instance().ExportToTrace("profile.json");
 #endif
 		break;
 	}
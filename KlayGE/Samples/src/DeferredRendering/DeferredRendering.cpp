@@ -278,6 +278,7 @@ void DeferredRenderingApp::InputHandler(InputEngine const & /*sender*/, InputAct
 	case Profile:
 #ifndef KLAYGE_SHIP
 		PerfProfiler::Instance().ExportToCSV("profile.csv");
+		PerfProfiler::Instance().ExportToTrace("profile.json");
 #endif
 		break;
 	}
@@ -669,6 +669,9 @@ uint32_t DetailedSurfaceApp::DoUpdate(uint32_t /*pass*/)
 		checked_pointer_cast<PolygonObject>(polygon_)->LightColor(light_->Color());
 		checked_pointer_cast<PolygonObject>(polygon_)->LightFalloff(light_->Falloff());
 
+		// Tiles are streamed in over several frames
+		juda_tex_->UpdateCache(checked_pointer_cast<PolygonObject>(polygon_)->JudaTexTileIDs(0));
+
 		return App3DFramework::URV_NeedFlush | App3DFramework::URV_Finished;
 	}
 }
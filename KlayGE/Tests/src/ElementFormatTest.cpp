@@ -0,0 +1,404 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Half.hpp>
+#include <KFL/Math.hpp>
+#include <KlayGE/ElementFormat.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t FloatBits(float f)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &f, sizeof(bits));
+		return bits;
+	}
+
+	// Bytes that cover every 8-bit value in every channel, and every 10-bit value in A2BGR10
+	std::vector<uint8_t> TestBytes(uint32_t num_bytes)
+	{
+		std::vector<uint8_t> bytes(num_bytes);
+		for (uint32_t i = 0; i < num_bytes; ++ i)
+		{
+			bytes[i] = static_cast<uint8_t>(i * 37 + (i >> 8));
+		}
+		return bytes;
+	}
+
+	// Colors in and out of [0, 1], with values that land on and around the rounding points of 8 and 10 bits
+	std::vector<Color> TestColors(uint32_t num_elems)
+	{
+		std::vector<Color> colors(num_elems);
+		for (uint32_t i = 0; i < num_elems; ++ i)
+		{
+			for (size_t c = 0; c < 4; ++ c)
+			{
+				uint32_t const k = (i * 4 + static_cast<uint32_t>(c)) * 13 % 1300;
+				colors[i][c] = (static_cast<float>(k) - 100) / 1000 + ((k & 1) ? 0.5f / 255 : 0.0f);
+			}
+		}
+		return colors;
+	}
+
+	// Whole groups of texels go through the SIMD path if there is one, one texel at a time always goes through the
+	//  scalar path. An odd count leaves a scalar tail after the SIMD groups.
+	void ConvertToABGR32FTest(ElementFormat fmt)
+	{
+		uint32_t const num_elems = 1027;
+		uint32_t const elem_size = NumFormatBytes(fmt);
+		std::vector<uint8_t> const texels = TestBytes(num_elems * elem_size);
+
+		std::vector<Color> batched(num_elems);
+		ConvertToABGR32F(fmt, &texels[0], num_elems, &batched[0]);
+
+		bool match = true;
+		for (uint32_t i = 0; i < num_elems; ++ i)
+		{
+			Color single;
+			ConvertToABGR32F(fmt, &texels[i * elem_size], 1, &single);
+			for (size_t c = 0; c < 4; ++ c)
+			{
+				match &= (FloatBits(batched[i][c]) == FloatBits(single[c]));
+			}
+		}
+		BOOST_CHECK(match);
+	}
+
+	void ConvertFromABGR32FTest(ElementFormat fmt)
+	{
+		uint32_t const num_elems = 1027;
+		uint32_t const elem_size = NumFormatBytes(fmt);
+		std::vector<Color> const colors = TestColors(num_elems);
+
+		std::vector<uint8_t> batched(num_elems * elem_size);
+		ConvertFromABGR32F(fmt, &colors[0], num_elems, &batched[0]);
+
+		std::vector<uint8_t> single(num_elems * elem_size);
+		for (uint32_t i = 0; i < num_elems; ++ i)
+		{
+			ConvertFromABGR32F(fmt, &colors[i], 1, &single[i * elem_size]);
+		}
+		BOOST_CHECK(batched == single);
+	}
+
+	// Each channel of a texel of an 8-bit format, 255 for alpha if it doesn't exist and 0 for the others
+	uint8_t UNorm8Channel(ElementFormat fmt, uint8_t const * texel, uint32_t channel)
+	{
+		switch (fmt)
+		{
+		case EF_R8:
+			return (0 == channel) ? texel[0] : ((3 == channel) ? 255 : 0);
+
+		case EF_GR8:
+			return (channel < 2) ? texel[channel] : ((3 == channel) ? 255 : 0);
+
+		case EF_BGR8:
+			return (channel < 3) ? texel[channel] : 255;
+
+		case EF_ARGB8:
+		case EF_ARGB8_SRGB:
+			return texel[(3 == channel) ? 3 : (2 - channel)];
+
+		default:
+			return texel[channel];
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ConvertB10G11R11FToABGR32F)
+{
+	// Every 11-bit pattern in R and G, every 10-bit pattern in B. Covers zero, denormals, normals, INF and NAN.
+	std::vector<uint32_t> texels(2048);
+	for (uint32_t i = 0; i < texels.size(); ++ i)
+	{
+		uint32_t const g = (i * 7 + 3) & 0x7FF;
+		uint32_t const b = i & 0x3FF;
+		texels[i] = i | (g << 11) | (b << 22);
+	}
+
+	// Whole groups of 4 texels go through the SIMD path if there is one
+	std::vector<Color> batched(texels.size());
+	ConvertToABGR32F(EF_B10G11R11F, &texels[0], static_cast<uint32_t>(texels.size()), &batched[0]);
+
+	// One texel at a time always goes through the scalar path
+	std::vector<Color> single(texels.size());
+	for (size_t i = 0; i < texels.size(); ++ i)
+	{
+		ConvertToABGR32F(EF_B10G11R11F, &texels[i], 1, &single[i]);
+	}
+
+	for (size_t i = 0; i < texels.size(); ++ i)
+	{
+		for (size_t c = 0; c < 4; ++ c)
+		{
+			BOOST_CHECK_EQUAL(FloatBits(batched[i][c]), FloatBits(single[i][c]));
+		}
+	}
+
+	// An odd count leaves a scalar tail after the SIMD groups
+	std::vector<Color> odd(7);
+	ConvertToABGR32F(EF_B10G11R11F, &texels[0x7C0], static_cast<uint32_t>(odd.size()), &odd[0]);
+	for (size_t i = 0; i < odd.size(); ++ i)
+	{
+		for (size_t c = 0; c < 4; ++ c)
+		{
+			BOOST_CHECK_EQUAL(FloatBits(odd[i][c]), FloatBits(single[0x7C0 + i][c]));
+		}
+	}
+
+	// R: 1.0, G: INF, B: 0.5
+	uint32_t const known = (15U << 6) | (0x1FU << 17) | ((14U << 5) << 22);
+	Color known_color;
+	ConvertToABGR32F(EF_B10G11R11F, &known, 1, &known_color);
+	BOOST_CHECK_EQUAL(known_color.r(), 1.0f);
+	BOOST_CHECK_EQUAL(FloatBits(known_color.g()), 0x7F800000U);
+	BOOST_CHECK_EQUAL(known_color.b(), 0.5f);
+	BOOST_CHECK_EQUAL(known_color.a(), 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(ConvertUNormToABGR32F)
+{
+	ConvertToABGR32FTest(EF_ABGR8);
+	ConvertToABGR32FTest(EF_ARGB8);
+	ConvertToABGR32FTest(EF_R8);
+	ConvertToABGR32FTest(EF_GR8);
+	ConvertToABGR32FTest(EF_A2BGR10);
+
+	// The values are exact divisions, and the missing channels are filled
+	uint8_t const texels[] = { 0, 51, 128, 255, 1, 254, 17, 200 };
+	Color r8[8];
+	ConvertToABGR32F(EF_R8, texels, 8, r8);
+	Color gr8[4];
+	ConvertToABGR32F(EF_GR8, texels, 4, gr8);
+	for (uint32_t i = 0; i < 8; ++ i)
+	{
+		BOOST_CHECK(r8[i] == Color(texels[i] / 255.0f, 0, 0, 1));
+	}
+	for (uint32_t i = 0; i < 4; ++ i)
+	{
+		BOOST_CHECK(gr8[i] == Color(texels[i * 2 + 0] / 255.0f, texels[i * 2 + 1] / 255.0f, 0, 1));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ConvertUNormFromABGR32F)
+{
+	ConvertFromABGR32FTest(EF_ABGR8);
+	ConvertFromABGR32FTest(EF_ARGB8);
+	ConvertFromABGR32FTest(EF_R8);
+	ConvertFromABGR32FTest(EF_GR8);
+	ConvertFromABGR32FTest(EF_A2BGR10);
+}
+
+BOOST_AUTO_TEST_CASE(ConvertHalfToABGR32F)
+{
+	// Every half but NAN, which F16C makes quiet
+	std::vector<half> halves;
+	for (uint32_t bits = 0; bits < 0x10000; ++ bits)
+	{
+		if (((bits & 0x7C00) != 0x7C00) || !(bits & 0x03FF))
+		{
+			uint16_t const bits16 = static_cast<uint16_t>(bits);
+			half h;
+			std::memcpy(&h, &bits16, sizeof(h));
+			halves.push_back(h);
+		}
+	}
+	uint32_t const num_halves = static_cast<uint32_t>(halves.size()) & ~3U;
+
+	// F16C if the CPU has it, otherwise the scalar code. Both must give the values of half.
+	std::vector<Color> r16f(num_halves);
+	ConvertToABGR32F(EF_R16F, &halves[0], num_halves, &r16f[0]);
+	std::vector<Color> gr16f(num_halves / 2);
+	ConvertToABGR32F(EF_GR16F, &halves[0], num_halves / 2, &gr16f[0]);
+	std::vector<Color> abgr16f(num_halves / 4);
+	ConvertToABGR32F(EF_ABGR16F, &halves[0], num_halves / 4, &abgr16f[0]);
+
+	bool match = true;
+	for (uint32_t i = 0; i < num_halves; ++ i)
+	{
+		uint32_t const expected = FloatBits(static_cast<float>(halves[i]));
+		match &= (FloatBits(r16f[i].r()) == expected);
+		match &= (FloatBits(gr16f[i / 2][i % 2]) == expected);
+		match &= (FloatBits(abgr16f[i / 4][i % 4]) == expected);
+
+		// The scalar code, a texel at a time
+		Color single;
+		ConvertToABGR32F(EF_R16F, &halves[i], 1, &single);
+		match &= (FloatBits(single.r()) == expected);
+	}
+	BOOST_CHECK(match);
+	BOOST_CHECK(r16f[5] == Color(r16f[5].r(), 0, 0, 1));
+	BOOST_CHECK(gr16f[5] == Color(gr16f[5].r(), gr16f[5].g(), 0, 1));
+}
+
+BOOST_AUTO_TEST_CASE(ConvertHalfFromABGR32F)
+{
+	std::vector<Color> const colors = TestColors(1024);
+	uint32_t const num_floats = static_cast<uint32_t>(colors.size()) * 4;
+	float const * floats = &colors[0].r();
+
+	std::vector<half> r16f(num_floats);
+	std::vector<Color> r_colors(num_floats);
+	for (uint32_t i = 0; i < num_floats; ++ i)
+	{
+		r_colors[i] = Color(floats[i], 0, 0, 1);
+	}
+	ConvertFromABGR32F(EF_R16F, &r_colors[0], num_floats, &r16f[0]);
+	std::vector<half> abgr16f(num_floats);
+	ConvertFromABGR32F(EF_ABGR16F, &colors[0], num_floats / 4, &abgr16f[0]);
+
+	// F16C rounds ties to even, the scalar half rounds them away from zero. Other values are the same.
+	bool match = true;
+	for (uint32_t i = 0; i < num_floats; ++ i)
+	{
+		uint16_t expected;
+		half const h(floats[i]);
+		std::memcpy(&expected, &h, sizeof(expected));
+
+		uint16_t bits[3];
+		std::memcpy(&bits[0], &r16f[i], sizeof(bits[0]));
+		std::memcpy(&bits[1], &abgr16f[i], sizeof(bits[1]));
+
+		// The scalar code, a texel at a time
+		half single;
+		ConvertFromABGR32F(EF_R16F, &r_colors[i], 1, &single);
+		std::memcpy(&bits[2], &single, sizeof(bits[2]));
+		match &= (bits[2] == expected);
+
+		for (int j = 0; j < 2; ++ j)
+		{
+			match &= (MathLib::abs(static_cast<int>(bits[j]) - static_cast<int>(expected)) <= 1);
+			if (bits[j] != expected)
+			{
+				// Only a tie can round differently
+				float const converted = static_cast<float>((0 == j) ? r16f[i] : abgr16f[i]);
+				match &= (floats[i] == (converted + static_cast<float>(h)) / 2);
+			}
+		}
+	}
+	BOOST_CHECK(match);
+}
+
+BOOST_AUTO_TEST_CASE(ConvertSRGBToABGR32F)
+{
+	// Colors go through the table, alpha stays linear
+	std::vector<uint8_t> texels(256 * 4);
+	for (uint32_t i = 0; i < 256; ++ i)
+	{
+		texels[i * 4 + 0] = static_cast<uint8_t>(i);
+		texels[i * 4 + 1] = static_cast<uint8_t>(255 - i);
+		texels[i * 4 + 2] = static_cast<uint8_t>(i * 7);
+		texels[i * 4 + 3] = static_cast<uint8_t>(i * 3);
+	}
+
+	std::vector<Color> abgr(256);
+	ConvertToABGR32F(EF_ABGR8_SRGB, &texels[0], 256, &abgr[0]);
+	std::vector<Color> argb(256);
+	ConvertToABGR32F(EF_ARGB8_SRGB, &texels[0], 256, &argb[0]);
+
+	bool match = true;
+	for (uint32_t i = 0; i < 256; ++ i)
+	{
+		uint8_t const * p = &texels[i * 4];
+		for (int c = 0; c < 3; ++ c)
+		{
+			match &= (abgr[i][c] == MathLib::srgb_to_linear(p[c] / 255.0f));
+			match &= (argb[i][c] == MathLib::srgb_to_linear(p[2 - c] / 255.0f));
+		}
+		match &= (abgr[i].a() == p[3] / 255.0f);
+		match &= (argb[i].a() == p[3] / 255.0f);
+	}
+	BOOST_CHECK(match);
+	BOOST_CHECK_EQUAL(abgr[0].r(), 0.0f);
+	BOOST_CHECK_CLOSE(abgr[255].r(), 1.0f, 1e-4f);
+}
+
+BOOST_AUTO_TEST_CASE(ConvertFormatUNorm8)
+{
+	// The R/B swap of ABGR8 <-> ARGB8 works on groups of 4 texels, with a tail
+	ElementFormat const formats[] = { EF_R8, EF_GR8, EF_BGR8, EF_ABGR8, EF_ARGB8 };
+	uint32_t const num_elems = 1027;
+	for (auto src_fmt : formats)
+	{
+		uint32_t const src_size = NumFormatBytes(src_fmt);
+		std::vector<uint8_t> const src = TestBytes(num_elems * src_size);
+		for (auto dst_fmt : formats)
+		{
+			uint32_t const dst_size = NumFormatBytes(dst_fmt);
+			std::vector<uint8_t> dst(num_elems * dst_size);
+			ConvertFormat(src_fmt, &src[0], num_elems, dst_fmt, &dst[0]);
+
+			bool match = true;
+			for (uint32_t i = 0; i < num_elems; ++ i)
+			{
+				// The first dst_size channels exist in the destination
+				for (uint32_t c = 0; c < dst_size; ++ c)
+				{
+					match &= (UNorm8Channel(dst_fmt, &dst[i * dst_size], c)
+						== UNorm8Channel(src_fmt, &src[i * src_size], c));
+				}
+			}
+			BOOST_CHECK_MESSAGE(match, "From " << src_fmt << " to " << dst_fmt);
+		}
+	}
+
+	uint32_t const abgr = 0x80402010;
+	uint32_t argb;
+	ConvertFormat(EF_ABGR8, &abgr, 1, EF_ARGB8, &argb);
+	BOOST_CHECK_EQUAL(argb, 0x80102040U);
+	uint8_t const r = 0x42;
+	uint32_t abgr_from_r;
+	ConvertFormat(EF_R8, &r, 1, EF_ABGR8, &abgr_from_r);
+	BOOST_CHECK_EQUAL(abgr_from_r, 0xFF000042U);
+}
+
+BOOST_AUTO_TEST_CASE(ConvertFormatThroughFloats)
+{
+	// Pairs without a byte shuffle, including sRGB <-> linear, are the same as converting to floats and back. More than
+	//  one chunk of floats.
+	std::pair<ElementFormat, ElementFormat> const pairs[] =
+	{
+		{ EF_A2BGR10, EF_ABGR16F },
+		{ EF_ABGR8, EF_ABGR8_SRGB },
+		{ EF_ARGB8_SRGB, EF_ABGR8 },
+		{ EF_R16F, EF_GR8 }
+	};
+	uint32_t const num_elems = 600;
+	for (auto const & pair : pairs)
+	{
+		uint32_t const src_size = NumFormatBytes(pair.first);
+		uint32_t const dst_size = NumFormatBytes(pair.second);
+		std::vector<uint8_t> src = TestBytes(num_elems * src_size);
+		if (EF_R16F == pair.first)
+		{
+			// Finite halves only
+			for (uint32_t i = 1; i < src.size(); i += 2)
+			{
+				src[i] &= 0x3F;
+			}
+		}
+
+		std::vector<uint8_t> dst(num_elems * dst_size);
+		ConvertFormat(pair.first, &src[0], num_elems, pair.second, &dst[0]);
+
+		std::vector<Color> colors(num_elems);
+		ConvertToABGR32F(pair.first, &src[0], num_elems, &colors[0]);
+		std::vector<uint8_t> expected(num_elems * dst_size);
+		ConvertFromABGR32F(pair.second, &colors[0], num_elems, &expected[0]);
+		BOOST_CHECK_MESSAGE(dst == expected, "From " << pair.first << " to " << pair.second);
+	}
+}
@@ -4,6 +4,7 @@
 #include <KlayGE/Texture.hpp>
 #include <KlayGE/ResLoader.hpp>
 #include <KFL/Half.hpp>
+#include <KFL/Math.hpp>
 
 #include <boost/assert.hpp>
 #ifdef KLAYGE_COMPILER_CLANG
@@ -15,6 +16,9 @@
 #pragma clang diagnostic pop
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -60,6 +64,18 @@ void TestEncodeDecodeTex(std::string const & input_name, std::string const & tc_
 		codec = MakeUniquePtr<TexCompressionETC1>();
 		break;
 
+	case EF_ETC2_BGR8:
+		codec = MakeUniquePtr<TexCompressionETC2RGB8>();
+		break;
+
+	case EF_ETC2_A1BGR8:
+		codec = MakeUniquePtr<TexCompressionETC2RGB8A1>();
+		break;
+
+	case EF_ETC2_ABGR8:
+		codec = MakeUniquePtr<TexCompressionETC2RGBA8>();
+		break;
+
 	default:
 		BOOST_ASSERT(false);
 		break;
@@ -89,7 +105,7 @@ void TestEncodeDecodeTex(std::string const & input_name, std::string const & tc_
 			for (uint32_t x = 0; x < width; ++ x)
 			{
 				memcpy(&pixel[0], &src[x * pixel_size], pixel_size);
-				if (EF_BC1 == bc_fmt)
+				if ((EF_BC1 == bc_fmt) || (EF_ETC2_A1BGR8 == bc_fmt))
 				{
 					if (pixel[3] < 128)
 					{
@@ -241,6 +257,313 @@ void TestEncodeDecodeTex(std::string const & input_name, std::string const & tc_
 	BOOST_CHECK(mse < threshold);
 }
 
+// The HDR test media is not part of the repository, so BC6 is measured on a generated image. It has an exponential
+//  ramp, hard edges, a noisy area and sparse highlights. Signed images cross 0 smoothly.
+std::vector<half> GenerateHDRImage(uint32_t width, uint32_t height, bool signed_fmt)
+{
+	std::vector<half> image(width * height * 4);
+	uint32_t seed = 1;
+	for (uint32_t y = 0; y < height; ++ y)
+	{
+		for (uint32_t x = 0; x < width; ++ x)
+		{
+			float const u = static_cast<float>(x) / width;
+			float const v = static_cast<float>(y) / height;
+			float rgb[3];
+			if (y < height / 4)
+			{
+				float const lum = pow(2.0f, 10 * u - 4);
+				rgb[0] = lum;
+				rgb[1] = lum * (0.5f + v);
+				rgb[2] = lum * (1.5f - v);
+			}
+			else if (y < height / 2)
+			{
+				bool const bright = ((x / 6 + y / 6) & 1) != 0;
+				rgb[0] = bright ? 6.0f : 0.25f;
+				rgb[1] = bright ? 5.0f : 0.5f;
+				rgb[2] = bright ? 3.0f : 0.125f;
+			}
+			else
+			{
+				for (int c = 0; c < 3; ++ c)
+				{
+					seed = seed * 1103515245 + 12345;
+					float const noise = ((seed >> 16) & 0xFF) / 255.0f - 0.5f;
+					rgb[c] = (1 + c + 2 * u) * (1 + 0.4f * noise);
+				}
+			}
+			if ((x % 16 == 5) && (y % 16 == 9))
+			{
+				rgb[0] *= 16;
+				rgb[1] *= 16;
+				rgb[2] *= 16;
+			}
+
+			for (int c = 0; c < 3; ++ c)
+			{
+				float const sign = signed_fmt ? cos(PI * (2 * u + v + 0.25f * c)) : 1.0f;
+				image[(y * width + x) * 4 + c] = half(rgb[c] * sign);
+			}
+			image[(y * width + x) * 4 + 3] = half(1.0f);
+		}
+	}
+	return image;
+}
+
+// The root mean square error of all the channels, the decoded alpha is always 1
+void TestEncodeDecodeBC6(bool signed_fmt, TexCompressionMethod method, float threshold)
+{
+	uint32_t const width = 64;
+	uint32_t const height = 64;
+	std::vector<half> const input = GenerateHDRImage(width, height, signed_fmt);
+
+	TexCompressionBC6U bc6u;
+	TexCompressionBC6S bc6s;
+	TexCompression& codec = signed_fmt ? static_cast<TexCompression&>(bc6s) : static_cast<TexCompression&>(bc6u);
+
+	std::vector<half> block_input(4 * 4 * 4);
+	std::vector<half> block_output(4 * 4 * 4);
+	std::vector<uint8_t> block(codec.BlockBytes());
+	float mse = 0;
+	for (uint32_t by = 0; by < height / 4; ++ by)
+	{
+		for (uint32_t bx = 0; bx < width / 4; ++ bx)
+		{
+			for (uint32_t y = 0; y < 4; ++ y)
+			{
+				memcpy(&block_input[y * 4 * 4], &input[((by * 4 + y) * width + bx * 4) * 4], 4 * 4 * sizeof(half));
+			}
+
+			codec.EncodeBlock(&block[0], &block_input[0], method);
+			codec.DecodeBlock(&block_output[0], &block[0]);
+
+			for (size_t i = 0; i < block_input.size(); ++ i)
+			{
+				float const diff = static_cast<float>(block_input[i]) - static_cast<float>(block_output[i]);
+				mse += diff * diff;
+			}
+		}
+	}
+
+	mse = sqrt(mse / (width * height) / 4);
+	BOOST_CHECK_LT(mse, threshold);
+}
+
+// A generated 8-bit image for the ETC2 formats: ramps, hard edges and noise, with a different phase in each channel.
+//  Signed values are in [-127, 127].
+std::vector<uint8_t> Generate8BitImage(uint32_t width, uint32_t height, uint32_t num_channels, bool signed_fmt)
+{
+	std::vector<uint8_t> image(width * height * num_channels);
+	uint32_t seed = 1;
+	for (uint32_t y = 0; y < height; ++ y)
+	{
+		for (uint32_t x = 0; x < width; ++ x)
+		{
+			for (uint32_t c = 0; c < num_channels; ++ c)
+			{
+				float const u = static_cast<float>((x + c * 17) % width) / width;
+				float const v = static_cast<float>(y) / height;
+				float value;
+				if (y < height / 4)
+				{
+					value = u * (0.75f + v);
+				}
+				else if (y < height / 2)
+				{
+					value = (((x + c) / 5 + y / 5) & 1) ? 0.9f - 0.3f * u : 0.1f + 0.2f * v;
+				}
+				else
+				{
+					seed = seed * 1103515245 + 12345;
+					float const noise = ((seed >> 16) & 0xFF) / 255.0f - 0.5f;
+					value = 0.5f + 0.3f * sin(PI * (2 * u + c * 0.5f)) + 0.15f * noise;
+				}
+				value = MathLib::clamp(value, 0.0f, 1.0f);
+
+				image[(y * width + x) * num_channels + c] = signed_fmt
+					? static_cast<uint8_t>(static_cast<int8_t>(static_cast<int>(value * 254 + 0.5f) - 127))
+					: static_cast<uint8_t>(value * 255 + 0.5f);
+			}
+		}
+	}
+	return image;
+}
+
+// The root mean square error of all the channels of a codec decoding to 8-bit channels
+void TestEncodeDecode8Bit(TexCompression& codec, bool signed_fmt, TexCompressionMethod method, float threshold)
+{
+	uint32_t const width = 64;
+	uint32_t const height = 64;
+	uint32_t const num_channels = NumFormatBytes(codec.DecodedFormat());
+	std::vector<uint8_t> const input = Generate8BitImage(width, height, num_channels, signed_fmt);
+
+	std::vector<uint8_t> block_input(4 * 4 * num_channels);
+	std::vector<uint8_t> block_output(4 * 4 * num_channels);
+	std::vector<uint8_t> block(codec.BlockBytes());
+	float mse = 0;
+	for (uint32_t by = 0; by < height / 4; ++ by)
+	{
+		for (uint32_t bx = 0; bx < width / 4; ++ bx)
+		{
+			for (uint32_t y = 0; y < 4; ++ y)
+			{
+				memcpy(&block_input[y * 4 * num_channels], &input[((by * 4 + y) * width + bx * 4) * num_channels],
+					4 * num_channels);
+			}
+
+			codec.EncodeBlock(&block[0], &block_input[0], method);
+			codec.DecodeBlock(&block_output[0], &block[0]);
+
+			for (size_t i = 0; i < block_input.size(); ++ i)
+			{
+				int const diff = signed_fmt
+					? static_cast<int8_t>(block_input[i]) - static_cast<int8_t>(block_output[i])
+					: block_input[i] - block_output[i];
+				mse += static_cast<float>(diff * diff);
+			}
+		}
+	}
+
+	mse = sqrt(mse / (width * height) / num_channels);
+	BOOST_CHECK_LT(mse, threshold);
+}
+
+// Punch-through alpha has to be exact. The color error is measured on the opaque texels.
+void TestEncodeDecodeETC2RGB8A1(TexCompressionMethod method, float threshold)
+{
+	uint32_t const width = 64;
+	uint32_t const height = 64;
+
+	// Smooth colors with holes of various sizes, and fully transparent and fully opaque areas
+	std::vector<ARGBColor32> input(width * height);
+	for (uint32_t y = 0; y < height; ++ y)
+	{
+		for (uint32_t x = 0; x < width; ++ x)
+		{
+			float const dx = (x % 16) - 7.5f;
+			float const dy = (y % 16) - 7.5f;
+			float const radius = 1.0f + (x / 16 + y / 16) * 0.9f;
+			uint8_t const alpha = (x < 8) ? 0 : ((dx * dx + dy * dy < radius * radius) ? 0 : 255);
+			input[y * width + x] = ARGBColor32(alpha, static_cast<uint8_t>(x * 4), static_cast<uint8_t>(255 - y * 3),
+				static_cast<uint8_t>(64 + (x + y) * 2));
+		}
+	}
+
+	TexCompressionETC2RGB8A1 codec;
+	ARGBColor32 block_input[16];
+	ARGBColor32 block_output[16];
+	std::vector<uint8_t> block(codec.BlockBytes());
+	float mse = 0;
+	uint32_t num_opaque = 0;
+	for (uint32_t by = 0; by < height / 4; ++ by)
+	{
+		for (uint32_t bx = 0; bx < width / 4; ++ bx)
+		{
+			for (uint32_t y = 0; y < 4; ++ y)
+			{
+				memcpy(&block_input[y * 4], &input[(by * 4 + y) * width + bx * 4], 4 * sizeof(ARGBColor32));
+			}
+
+			codec.EncodeBlock(&block[0], block_input, method);
+			codec.DecodeBlock(block_output, &block[0]);
+
+			for (uint32_t i = 0; i < 16; ++ i)
+			{
+				BOOST_CHECK_EQUAL(static_cast<int>(block_output[i].a()), static_cast<int>(block_input[i].a()));
+				if (block_input[i].a() != 0)
+				{
+					int const dr = block_input[i].r() - block_output[i].r();
+					int const dg = block_input[i].g() - block_output[i].g();
+					int const db = block_input[i].b() - block_output[i].b();
+					mse += static_cast<float>(dr * dr + dg * dg + db * db);
+					++ num_opaque;
+				}
+			}
+		}
+	}
+
+	mse = sqrt(mse / num_opaque / 3);
+	BOOST_CHECK_LT(mse, threshold);
+}
+
+// EncodeMem encodes rows in parallel and batches blocks, it must give the same bits as EncodeBlock on each block
+void TestEncodeMemMatchesEncodeBlock(TexCompression& codec)
+{
+	// Not a multiple of the block size, and wide enough for several rows per task and a partial batch of blocks
+	uint32_t const width = 133;
+	uint32_t const height = 70;
+
+	uint32_t const elem_size = NumFormatBytes(codec.DecodedFormat());
+	uint32_t const in_row_pitch = width * elem_size;
+	std::vector<uint8_t> input(in_row_pitch * height);
+	uint32_t seed = 1;
+	for (uint32_t y = 0; y < height; ++ y)
+	{
+		for (uint32_t x = 0; x < width * elem_size; ++ x)
+		{
+			seed = seed * 1103515245 + 12345;
+			// Flat areas, gradients and noise
+			uint8_t value;
+			if (y < 16)
+			{
+				value = static_cast<uint8_t>(x * 7);
+			}
+			else if (y < 32)
+			{
+				value = static_cast<uint8_t>(x + y * 3);
+			}
+			else
+			{
+				value = static_cast<uint8_t>(seed >> 16);
+			}
+			input[y * in_row_pitch + x] = value;
+		}
+	}
+
+	uint32_t const block_width = codec.BlockWidth();
+	uint32_t const block_height = codec.BlockHeight();
+	uint32_t const block_bytes = codec.BlockBytes();
+	uint32_t const num_blocks_x = (width + block_width - 1) / block_width;
+	uint32_t const num_blocks_y = (height + block_height - 1) / block_height;
+	uint32_t const out_row_pitch = num_blocks_x * block_bytes;
+
+	TexCompressionMethod const methods[] = { TCM_Speed, TCM_Quality };
+	for (auto method : methods)
+	{
+		std::vector<uint8_t> mem_output(out_row_pitch * num_blocks_y);
+		codec.EncodeMem(width, height, &mem_output[0], out_row_pitch, static_cast<uint32_t>(mem_output.size()),
+			&input[0], in_row_pitch, static_cast<uint32_t>(input.size()), method);
+
+		// Texels out of the image are 0
+		std::vector<uint8_t> block_input(block_width * block_height * elem_size);
+		std::vector<uint8_t> block_output(block_bytes);
+		for (uint32_t by = 0; by < num_blocks_y; ++ by)
+		{
+			for (uint32_t bx = 0; bx < num_blocks_x; ++ bx)
+			{
+				std::fill(block_input.begin(), block_input.end(), static_cast<uint8_t>(0));
+				for (uint32_t y = 0; y < block_height; ++ y)
+				{
+					for (uint32_t x = 0; x < block_width; ++ x)
+					{
+						uint32_t const src_x = bx * block_width + x;
+						uint32_t const src_y = by * block_height + y;
+						if ((src_x < width) && (src_y < height))
+						{
+							memcpy(&block_input[(y * block_width + x) * elem_size],
+								&input[src_y * in_row_pitch + src_x * elem_size], elem_size);
+						}
+					}
+				}
+
+				codec.EncodeBlock(&block_output[0], &block_input[0], method);
+				BOOST_CHECK(0 == memcmp(&block_output[0], &mem_output[by * out_row_pitch + bx * block_bytes], block_bytes));
+			}
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE(DecodeBC1)
 {
 	TestEncodeDecodeTex("Lenna.dds", "Lenna_bc1.dds", EF_BC1, 4.7f);
@@ -291,6 +614,22 @@ BOOST_AUTO_TEST_CASE(EncodeDecodeBC3)
 	TestEncodeDecodeTex("leaf_v3_green_tex.dds", "", EF_BC3, 8.9f);
 }
 
+// Measured errors plus 5%. The encoder minimizes the error in half bits, so a slower method doesn't always get a lower
+//  error in linear values.
+BOOST_AUTO_TEST_CASE(EncodeDecodeBC6U)
+{
+	TestEncodeDecodeBC6(false, TCM_Speed, 0.235f);
+	TestEncodeDecodeBC6(false, TCM_Balanced, 0.254f);
+	TestEncodeDecodeBC6(false, TCM_Quality, 0.245f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeBC6S)
+{
+	TestEncodeDecodeBC6(true, TCM_Speed, 1.10f);
+	TestEncodeDecodeBC6(true, TCM_Balanced, 0.985f);
+	TestEncodeDecodeBC6(true, TCM_Quality, 0.988f);
+}
+
 BOOST_AUTO_TEST_CASE(EncodeDecodeBC7XRGB)
 {
 	TestEncodeDecodeTex("Lenna.dds", "", EF_BC7, 1.8f);
@@ -305,3 +644,88 @@ BOOST_AUTO_TEST_CASE(EncodeDecodeETC1)
 {
 	TestEncodeDecodeTex("Lenna.dds", "", EF_ETC1, 4.8f);
 }
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2RGB8)
+{
+	TestEncodeDecodeTex("Lenna.dds", "", EF_ETC2_BGR8, 4.8f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2RGB8A1)
+{
+	TestEncodeDecodeTex("leaf_v3_green_tex.dds", "", EF_ETC2_A1BGR8, 9.1f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2RGBA8)
+{
+	TestEncodeDecodeTex("leaf_v3_green_tex.dds", "", EF_ETC2_ABGR8, 8.9f);
+}
+
+// Measured errors plus 5%
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2RGB8A1Holes)
+{
+	TestEncodeDecodeETC2RGB8A1(TCM_Speed, 7.85f);
+	TestEncodeDecodeETC2RGB8A1(TCM_Balanced, 2.21f);
+	TestEncodeDecodeETC2RGB8A1(TCM_Quality, 2.21f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2R11)
+{
+	TexCompressionETC2R11 codec;
+	TestEncodeDecode8Bit(codec, false, TCM_Speed, 1.34f);
+	TestEncodeDecode8Bit(codec, false, TCM_Balanced, 1.29f);
+	TestEncodeDecode8Bit(codec, false, TCM_Quality, 1.26f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2SignedR11)
+{
+	TexCompressionETC2SignedR11 codec;
+	TestEncodeDecode8Bit(codec, true, TCM_Speed, 1.35f);
+	TestEncodeDecode8Bit(codec, true, TCM_Balanced, 1.30f);
+	TestEncodeDecode8Bit(codec, true, TCM_Quality, 1.28f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2RG11)
+{
+	TexCompressionETC2RG11 codec;
+	TestEncodeDecode8Bit(codec, false, TCM_Speed, 1.40f);
+	TestEncodeDecode8Bit(codec, false, TCM_Balanced, 1.35f);
+	TestEncodeDecode8Bit(codec, false, TCM_Quality, 1.31f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecodeETC2SignedRG11)
+{
+	TexCompressionETC2SignedRG11 codec;
+	TestEncodeDecode8Bit(codec, true, TCM_Speed, 1.42f);
+	TestEncodeDecode8Bit(codec, true, TCM_Balanced, 1.37f);
+	TestEncodeDecode8Bit(codec, true, TCM_Quality, 1.33f);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeMemBC1)
+{
+	TexCompressionBC1 codec;
+	TestEncodeMemMatchesEncodeBlock(codec);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeMemBC2)
+{
+	TexCompressionBC2 codec;
+	TestEncodeMemMatchesEncodeBlock(codec);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeMemBC3)
+{
+	TexCompressionBC3 codec;
+	TestEncodeMemMatchesEncodeBlock(codec);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeMemBC4)
+{
+	TexCompressionBC4 codec;
+	TestEncodeMemMatchesEncodeBlock(codec);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeMemBC5)
+{
+	TexCompressionBC5 codec;
+	TestEncodeMemMatchesEncodeBlock(codec);
+}
@@ -0,0 +1,241 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/JudaTexture.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t const NUM_TILES = 16;
+	uint32_t const TILE_SIZE = 8;
+	// 4 slots of 10x10 texels with borders, no mipmaps
+	uint32_t const CACHE_PAGES = 4;
+	uint32_t const TILE_BYTES = (TILE_SIZE + 2) * (TILE_SIZE + 2) * 4;
+
+	bool NullRenderEngineActive()
+	{
+		if (Context::Instance().Config().render_factory_name != "Null")
+		{
+			BOOST_TEST_MESSAGE("Skipped. Set KLAYGE_TESTS_RENDER_FACTORY=Null to run the tests on the Null render engine.");
+			return false;
+		}
+		return true;
+	}
+
+	// An in-memory texture with one committed tile. The others are upsampled from the upper levels.
+	JudaTexturePtr MakeJudaTexture()
+	{
+		JudaTexturePtr juda_tex = MakeSharedPtr<JudaTexture>(NUM_TILES, TILE_SIZE, EF_ABGR8);
+
+		std::vector<std::vector<uint8_t>> data(1, std::vector<uint8_t>(TILE_SIZE * TILE_SIZE * 4));
+		for (size_t i = 0; i < data[0].size(); ++ i)
+		{
+			data[0][i] = static_cast<uint8_t>(i * 37);
+		}
+		juda_tex->CommitTiles(data, std::vector<uint32_t>(1, juda_tex->EncodeTileID(juda_tex->TreeLevels() - 1, 0, 0)),
+			std::vector<uint32_t>(1, 0xFFFFFFFF));
+
+		return juda_tex;
+	}
+
+	std::vector<uint32_t> TileIDs(JudaTexture const & juda_tex, uint32_t first, uint32_t num)
+	{
+		std::vector<uint32_t> tile_ids(num);
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			tile_ids[i] = juda_tex.EncodeTileID(juda_tex.TreeLevels() - 1, (first + i) % NUM_TILES, (first + i) / NUM_TILES);
+		}
+		return tile_ids;
+	}
+
+	// Builds the tiles without uploading any, so the next UpdateCache finds all of them ready
+	void BuildTiles(JudaTexture& juda_tex, std::vector<uint32_t> const & tile_ids)
+	{
+		uint32_t const upload_budget = juda_tex.UploadBudget();
+		juda_tex.UploadBudget(0);
+		juda_tex.UpdateCache(tile_ids);
+		juda_tex.WaitForPendingTiles();
+		juda_tex.UploadBudget(upload_budget);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(JudaTextureMaxPendingTiles)
+{
+	if (!NullRenderEngineActive())
+	{
+		return;
+	}
+
+	uint32_t const max_pending_tiles = JudaTexture::MAX_PENDING_TILES;
+
+	JudaTexturePtr juda_tex = MakeJudaTexture();
+	juda_tex->CacheProperty(CACHE_PAGES, EF_ABGR8, 1);
+
+	juda_tex->UploadBudget(0);
+	juda_tex->UpdateCache(TileIDs(*juda_tex, 0, 100));
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), max_pending_tiles);
+	juda_tex->UpdateCache(TileIDs(*juda_tex, 100, 10));
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), max_pending_tiles);
+	juda_tex->WaitForPendingTiles();
+
+	// Uploads release the pending tiles, and the ones refused before can be requested again
+	juda_tex->UploadBudget(1024 * 1024);
+	juda_tex->UpdateCache(std::vector<uint32_t>());
+	BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), CACHE_PAGES);
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), max_pending_tiles - CACHE_PAGES);
+
+	juda_tex->UploadBudget(0);
+	juda_tex->UpdateCache(TileIDs(*juda_tex, 100, 10));
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), max_pending_tiles);
+}
+
+BOOST_AUTO_TEST_CASE(JudaTextureEviction)
+{
+	if (!NullRenderEngineActive())
+	{
+		return;
+	}
+
+	JudaTexturePtr juda_tex = MakeJudaTexture();
+	juda_tex->CacheProperty(CACHE_PAGES, EF_ABGR8, 1);
+
+	std::vector<uint32_t> const tile_ids = TileIDs(*juda_tex, 0, 6);
+
+	std::vector<uint32_t> frame_ids(tile_ids.begin(), tile_ids.begin() + 4);
+	BuildTiles(*juda_tex, frame_ids);
+	juda_tex->UpdateCache(frame_ids);
+	BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), 4U);
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 0U);
+
+	// Tile 0 isn't used in a frame, so it's the least recently used one
+	frame_ids.assign(tile_ids.begin() + 1, tile_ids.begin() + 4);
+	juda_tex->UpdateCache(frame_ids);
+	BuildTiles(*juda_tex, std::vector<uint32_t>(1, tile_ids[4]));
+	frame_ids.assign(tile_ids.begin() + 1, tile_ids.begin() + 5);
+	juda_tex->UpdateCache(frame_ids);
+	BOOST_CHECK(!juda_tex->TileCached(tile_ids[0]));
+	for (size_t i = 1; i < 5; ++ i)
+	{
+		BOOST_CHECK(juda_tex->TileCached(tile_ids[i]));
+	}
+
+	// All the slots are used in this frame. The new tile waits for the next one, and replaces the least recently used.
+	BuildTiles(*juda_tex, std::vector<uint32_t>(1, tile_ids[5]));
+	frame_ids.assign(tile_ids.begin() + 1, tile_ids.begin() + 6);
+	juda_tex->UpdateCache(frame_ids);
+	BOOST_CHECK(!juda_tex->TileCached(tile_ids[5]));
+	BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), 4U);
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 1U);
+
+	juda_tex->UpdateCache(std::vector<uint32_t>(1, tile_ids[5]));
+	BOOST_CHECK(juda_tex->TileCached(tile_ids[5]));
+	BOOST_CHECK(!juda_tex->TileCached(tile_ids[1]));
+	BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), 4U);
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(JudaTextureUploadBudget)
+{
+	if (!NullRenderEngineActive())
+	{
+		return;
+	}
+
+	JudaTexturePtr juda_tex = MakeJudaTexture();
+	juda_tex->CacheProperty(CACHE_PAGES, EF_ABGR8, 1);
+
+	std::vector<uint32_t> const tile_ids = TileIDs(*juda_tex, 0, 4);
+	BuildTiles(*juda_tex, tile_ids);
+
+	// The tile that crosses the budget is still uploaded
+	juda_tex->UploadBudget(1);
+	juda_tex->UpdateCache(tile_ids);
+	BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), 1U);
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 3U);
+
+	juda_tex->UploadBudget(TILE_BYTES);
+	juda_tex->UpdateCache(tile_ids);
+	BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), 2U);
+
+	juda_tex->UploadBudget(TILE_BYTES + 1);
+	juda_tex->UpdateCache(tile_ids);
+	BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), 4U);
+	BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(JudaTextureFailedTiles)
+{
+	if (!NullRenderEngineActive())
+	{
+		return;
+	}
+
+	std::string const file_name = "JudaTextureFailedTiles.jdt";
+	SaveJudaTexture(MakeJudaTexture(), file_name);
+
+	std::vector<uint32_t> tile_ids;
+	{
+		JudaTexturePtr juda_tex = LoadJudaTexture(file_name);
+		juda_tex->CacheProperty(CACHE_PAGES, EF_ABGR8, 1);
+		tile_ids = TileIDs(*juda_tex, 0, 1);
+
+		BuildTiles(*juda_tex, tile_ids);
+		juda_tex->UpdateCache(tile_ids);
+		BOOST_CHECK(juda_tex->TileCached(tile_ids[0]));
+	}
+
+	// Breaks the LZMA properties of the root block, every tile is decoded from it. The offset of the blocks follows the
+	//  fourcc, version, number of tiles, tile size, format, number of non-empty nodes and number of image entries.
+	std::vector<uint8_t> file_data;
+	{
+		std::ifstream ifs(file_name.c_str(), std::ios_base::binary);
+		file_data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	}
+	uint32_t data_blocks_offset;
+	std::memcpy(&data_blocks_offset, &file_data[6 * sizeof(uint32_t) + sizeof(ElementFormat)], sizeof(data_blocks_offset));
+	BOOST_REQUIRE(data_blocks_offset + 2 <= file_data.size());
+	file_data[data_blocks_offset + 0] = 0xFF;
+	file_data[data_blocks_offset + 1] = 0xFF;
+	{
+		std::ofstream ofs(file_name.c_str(), std::ios_base::binary);
+		ofs.write(reinterpret_cast<char const *>(&file_data[0]), file_data.size());
+	}
+
+	{
+		JudaTexturePtr juda_tex = LoadJudaTexture(file_name);
+		juda_tex->CacheProperty(CACHE_PAGES, EF_ABGR8, 1);
+
+		juda_tex->UpdateCache(tile_ids);
+		BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 1U);
+		juda_tex->WaitForPendingTiles();
+
+		// The failed tile isn't pending anymore, and doesn't take a slot
+		juda_tex->UpdateCache(std::vector<uint32_t>());
+		BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 0U);
+		BOOST_CHECK_EQUAL(juda_tex->NumCachedTiles(), 0U);
+
+		juda_tex->UpdateCache(tile_ids);
+		BOOST_CHECK_EQUAL(juda_tex->NumPendingTiles(), 1U);
+		juda_tex->WaitForPendingTiles();
+	}
+
+	std::remove(file_name.c_str());
+}
@@ -2,6 +2,8 @@
 #include <KlayGE/App3D.hpp>
 #include <KlayGE/ResLoader.hpp>
 
+#include <cstdlib>
+
 #if defined(KLAYGE_COMPILER_CLANG)
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
@@ -46,6 +48,12 @@ namespace KlayGE
 			context_cfg.graphics_cfg.hdr = false;
 			context_cfg.graphics_cfg.color_grading = false;
 			context_cfg.graphics_cfg.gamma = false;
+			// KLAYGE_TESTS_RENDER_FACTORY=Null runs the tests on a machine without a GPU
+			char const * render_factory = std::getenv("KLAYGE_TESTS_RENDER_FACTORY");
+			if (render_factory != nullptr)
+			{
+				context_cfg.render_factory_name = render_factory;
+			}
 			Context::Instance().Config(context_cfg);
 
 			app = MakeSharedPtr<KlayGETestsApp>();
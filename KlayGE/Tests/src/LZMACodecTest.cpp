@@ -0,0 +1,92 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/ResIdentifier.hpp>
+#include <KlayGE/LZMACodec.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// Compressible, but not trivially. Every block ends up with different content.
+	std::vector<uint8_t> TestData(size_t len)
+	{
+		std::vector<uint8_t> data(len);
+		uint32_t seed = 1;
+		for (size_t i = 0; i < len; ++ i)
+		{
+			seed = seed * 1103515245 + 12345;
+			data[i] = static_cast<uint8_t>(((seed >> 16) & 0x7) + (i / 1024));
+		}
+		return data;
+	}
+
+	bool IsBlocked(std::vector<uint8_t> const & encoded)
+	{
+		return (encoded.size() >= 4) && (0xFF == encoded[0]) && ('L' == encoded[1]) && ('Z' == encoded[2])
+			&& ('B' == encoded[3]);
+	}
+
+	void RoundTripTest(uint32_t block_size, size_t len, bool expect_blocked)
+	{
+		std::vector<uint8_t> const data = TestData(len);
+
+		LZMACodec encoder(block_size);
+		std::vector<uint8_t> encoded;
+		encoder.Encode(encoded, data.data(), data.size());
+		BOOST_CHECK_EQUAL(IsBlocked(encoded), expect_blocked);
+
+		// Decode doesn't depend on the block size of the codec
+		LZMACodec decoder;
+		std::vector<uint8_t> decoded;
+		decoder.Decode(decoded, encoded.data(), encoded.size(), data.size());
+		BOOST_CHECK(decoded == data);
+
+		// From a memory backed resource, decoded in place
+		auto encoded_res = MakeSharedPtr<ResIdentifier>("encoded", 0, encoded.data(), encoded.size(),
+			std::shared_ptr<void>());
+		std::vector<uint8_t> decoded_in_place;
+		decoder.Decode(decoded_in_place, encoded_res, encoded.size(), data.size());
+		BOOST_CHECK(decoded_in_place == data);
+
+		// From a stream only resource
+		auto encoded_ss = MakeSharedPtr<std::stringstream>(std::string(encoded.begin(), encoded.end()));
+		auto encoded_stream_res = MakeSharedPtr<ResIdentifier>("encoded", 0, encoded_ss);
+		std::vector<uint8_t> decoded_stream(data.size());
+		decoder.Decode(decoded_stream.data(), encoded_stream_res, encoded.size(), data.size());
+		BOOST_CHECK(decoded_stream == data);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(LZMASingleStream)
+{
+	RoundTripTest(0, 100000, false);
+}
+
+BOOST_AUTO_TEST_CASE(LZMAOneBlock)
+{
+	// Data that fits in one block is stored as a single stream
+	RoundTripTest(4096, 4096, false);
+}
+
+BOOST_AUTO_TEST_CASE(LZMABlocks)
+{
+	// Whole blocks
+	RoundTripTest(4096, 4096 * 8, true);
+	// A partial last block
+	RoundTripTest(4096, 4096 * 5 + 123, true);
+	// One more byte than a block
+	RoundTripTest(4096, 4097, true);
+}
@@ -0,0 +1,336 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Log.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// Can be read while the sink thread writes to it
+	class LockedStringBuf : public std::stringbuf
+	{
+	public:
+		std::string Str()
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex_);
+			return this->str();
+		}
+
+	protected:
+		std::streamsize xsputn(char const * s, std::streamsize n) override
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex_);
+			return std::stringbuf::xsputn(s, n);
+		}
+
+		int_type overflow(int_type ch) override
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex_);
+			return std::stringbuf::overflow(ch);
+		}
+
+	private:
+		std::recursive_mutex mutex_;
+	};
+
+	// Redirects the log output into a string, and restores the filters afterwards
+	class LogCapture
+	{
+	public:
+		LogCapture()
+			: min_level_(LogMinLevel()), category_mask_(LogCategoryMask())
+		{
+			LogFlush();
+			old_buf_ = std::clog.rdbuf(&output_);
+		}
+
+		~LogCapture()
+		{
+			LogFlush();
+			std::clog.rdbuf(old_buf_);
+
+			LogMinLevel(min_level_);
+			LogCategoryMask(category_mask_);
+		}
+
+		std::string Output()
+		{
+			LogFlush();
+			return output_.Str();
+		}
+
+		std::string OutputNoFlush()
+		{
+			return output_.Str();
+		}
+
+	private:
+		LogLevel min_level_;
+		uint32_t category_mask_;
+
+		LockedStringBuf output_;
+		std::streambuf* old_buf_;
+	};
+
+	// Stands for the logger of the module that loaded this one
+	class TestLogHost
+	{
+	public:
+		TestLogHost()
+			: min_level_(LL_Info), category_mask_(LC_All)
+		{
+			host_.min_level = &min_level_;
+			host_.category_mask = &category_mask_;
+			host_.vlog = VLog;
+			host_.flush = Flush;
+			host_.num_dropped = NumDropped;
+
+			messages_.clear();
+			KFLLogAttach(&host_);
+		}
+
+		~TestLogHost()
+		{
+			KFLLogAttach(nullptr);
+		}
+
+		LogHost const & Host() const
+		{
+			return host_;
+		}
+
+		int MinLevel() const
+		{
+			return min_level_;
+		}
+
+		std::vector<std::string> const & Messages() const
+		{
+			return messages_;
+		}
+
+	private:
+		static void VLog(LogLevel level, uint32_t category, char const * fmt, va_list args)
+		{
+			char text[256];
+			vsnprintf(text, sizeof(text), fmt, args);
+			messages_.push_back(std::to_string(level) + " " + std::to_string(category) + " " + text);
+		}
+
+		static void Flush()
+		{
+		}
+
+		static uint64_t NumDropped()
+		{
+			return 42;
+		}
+
+	private:
+		std::atomic<int> min_level_;
+		std::atomic<uint32_t> category_mask_;
+		LogHost host_;
+
+		static std::vector<std::string> messages_;
+	};
+
+	std::vector<std::string> TestLogHost::messages_;
+
+	size_t CountOf(std::string const & str, std::string const & sub)
+	{
+		size_t count = 0;
+		for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + sub.size()))
+		{
+			++ count;
+		}
+		return count;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(LogLevels)
+{
+	LogCapture capture;
+
+	LogMinLevel(LL_Warn);
+	LogInfo("LogLevels info");
+	LogWarn("LogLevels warn %d", 1);
+	LogError("LogLevels error %s", "2");
+
+	std::string const output = capture.Output();
+	BOOST_CHECK(output.find("LogLevels info") == std::string::npos);
+	BOOST_CHECK(output.find("(WARN) KlayGE: LogLevels warn 1\n") != std::string::npos);
+	BOOST_CHECK(output.find("(ERROR) KlayGE: LogLevels error 2\n") != std::string::npos);
+
+	LogMinLevel(LL_None);
+	LogError("LogLevels none");
+	BOOST_CHECK(capture.Output().find("LogLevels none") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(LogCategories)
+{
+	LogCapture capture;
+
+	LogMinLevel(LL_Info);
+	LogCategoryMask(LC_All & ~LC_Shader);
+	LogMessage(LL_Info, LC_Shader, "LogCategories shader");
+	LogMessage(LL_Info, LC_Render, "LogCategories render");
+	LogMessage(LL_Warn, LC_Render | LC_Shader, "LogCategories both");
+
+	std::string const output = capture.Output();
+	BOOST_CHECK(output.find("LogCategories shader") == std::string::npos);
+	BOOST_CHECK(output.find("(INFO) KlayGE: LogCategories render\n") != std::string::npos);
+	BOOST_CHECK(output.find("(WARN) KlayGE: LogCategories both\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(LogErrorWrittenOnReturn)
+{
+	LogCapture capture;
+
+	LogMinLevel(LL_Info);
+	LogInfo("LogErrorWrittenOnReturn before");
+	LogError("LogErrorWrittenOnReturn error");
+
+	// No flush, the error and everything logged before it are already out
+	std::string const output = capture.OutputNoFlush();
+	size_t const before = output.find("LogErrorWrittenOnReturn before");
+	size_t const error = output.find("LogErrorWrittenOnReturn error");
+	BOOST_CHECK(before != std::string::npos);
+	BOOST_CHECK(error != std::string::npos);
+	BOOST_CHECK(before < error);
+}
+
+BOOST_AUTO_TEST_CASE(LogRepeats)
+{
+	LogCapture capture;
+
+	LogMinLevel(LL_Info);
+	for (int i = 0; i < 5; ++ i)
+	{
+		LogWarn("LogRepeats same");
+	}
+	LogWarn("LogRepeats different");
+
+	std::string const output = capture.Output();
+	BOOST_CHECK(1 == CountOf(output, "LogRepeats same"));
+	BOOST_CHECK(output.find("Last message repeated 4 time(s)") != std::string::npos);
+	BOOST_CHECK(output.find("Last message repeated 4 time(s)") < output.find("LogRepeats different"));
+}
+
+BOOST_AUTO_TEST_CASE(LogThreads)
+{
+	LogCapture capture;
+
+	LogMinLevel(LL_Info);
+
+	int const num_threads = 4;
+	int const num_messages = 100;
+
+	uint64_t const dropped_before = LogNumDropped();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < num_threads; ++ t)
+	{
+		threads.emplace_back([t, num_messages]
+			{
+				for (int i = 0; i < num_messages; ++ i)
+				{
+					LogInfo("LogThreads %d %d.", t, i);
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::string const output = capture.Output();
+	uint64_t const num_dropped = LogNumDropped() - dropped_before;
+	BOOST_CHECK(static_cast<uint64_t>(num_threads * num_messages)
+		== CountOf(output, "(INFO) KlayGE: LogThreads ") + num_dropped);
+
+	// The messages of a thread keep their order
+	for (int t = 0; t < num_threads; ++ t)
+	{
+		size_t last_pos = 0;
+		for (int i = 0; i < num_messages; ++ i)
+		{
+			size_t const pos = output.find("LogThreads " + std::to_string(t) + " " + std::to_string(i) + ".");
+			if (pos != std::string::npos)
+			{
+				BOOST_CHECK(pos >= last_pos);
+				last_pos = pos;
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(LogWrittenWithoutFlush)
+{
+	LogCapture capture;
+
+	LogMinLevel(LL_Info);
+	LogInfo("LogWrittenWithoutFlush message");
+
+	// The message wakes up the sink, nothing else does
+	bool written = false;
+	for (int i = 0; (i < 5000) && !written; ++ i)
+	{
+		written = (capture.OutputNoFlush().find("LogWrittenWithoutFlush message") != std::string::npos);
+		if (!written)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	BOOST_CHECK(written);
+}
+
+BOOST_AUTO_TEST_CASE(LogAttachedModule)
+{
+	LogCapture capture;
+
+	LogHost const * module_host = LogModuleHost();
+	{
+		TestLogHost host;
+		BOOST_CHECK(LogModuleHost() == &host.Host());
+
+		// The filters and the sink of the host are used
+		LogMinLevel(LL_Warn);
+		BOOST_CHECK_EQUAL(host.MinLevel(), LL_Warn);
+		LogInfo("LogAttachedModule info");
+		LogWarn("LogAttachedModule warn %d", 1);
+		LogMessage(LL_Error, LC_Shader, "LogAttachedModule error");
+		BOOST_CHECK_EQUAL(LogNumDropped(), 42U);
+
+		BOOST_REQUIRE_EQUAL(host.Messages().size(), 2U);
+		BOOST_CHECK_EQUAL(host.Messages()[0], std::to_string(LL_Warn) + " " + std::to_string(LC_General)
+			+ " LogAttachedModule warn 1");
+		BOOST_CHECK_EQUAL(host.Messages()[1], std::to_string(LL_Error) + " " + std::to_string(LC_Shader)
+			+ " LogAttachedModule error");
+	}
+
+	// Detached, back to the logger of this module
+	BOOST_CHECK(LogModuleHost() == module_host);
+	LogMinLevel(LL_Info);
+	LogInfo("LogAttachedModule detached");
+	std::string const output = capture.Output();
+	BOOST_CHECK(output.find("LogAttachedModule warn") == std::string::npos);
+	BOOST_CHECK(output.find("(INFO) KlayGE: LogAttachedModule detached\n") != std::string::npos);
+}
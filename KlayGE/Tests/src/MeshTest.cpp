@@ -0,0 +1,98 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/CXX17/filesystem.hpp>
+#include <KlayGE/Mesh.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <fstream>
+#include <limits>
+#include <string>
+#include <system_error>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// A .model_bin with an empty header and a table of one chunk, followed by len bytes of chunk data
+	void WriteModelBin(std::string const & file_name, uint32_t flags, uint64_t offset, uint64_t original_len, uint64_t len)
+	{
+		std::ofstream ofs(file_name.c_str(), std::ios_base::binary);
+
+		uint32_t const header[] = { MakeFourCC<'K', 'L', 'M', ' '>::value, 14,
+			0, 0, 0, 0, 0, 0, 0, 1 };
+		ofs.write(reinterpret_cast<char const *>(header), sizeof(header));
+
+		uint32_t const id = MakeFourCC<'M', 'T', 'L', 'S'>::value;
+		ofs.write(reinterpret_cast<char const *>(&id), sizeof(id));
+		ofs.write(reinterpret_cast<char const *>(&flags), sizeof(flags));
+		ofs.write(reinterpret_cast<char const *>(&offset), sizeof(offset));
+		ofs.write(reinterpret_cast<char const *>(&original_len), sizeof(original_len));
+		ofs.write(reinterpret_cast<char const *>(&len), sizeof(len));
+
+		std::string const data(16, '\0');
+		ofs.write(data.data(), data.size());
+	}
+
+	void LoadModelBin(std::string const & file_name)
+	{
+		std::vector<RenderMaterialPtr> mtls;
+		std::vector<vertex_element> merged_ves;
+		char all_is_index_16_bit;
+		std::vector<std::vector<uint8_t>> merged_buff;
+		std::vector<uint8_t> merged_indices;
+		std::vector<std::string> mesh_names;
+		std::vector<int32_t> mtl_ids;
+		std::vector<AABBox> pos_bbs;
+		std::vector<AABBox> tc_bbs;
+		std::vector<uint32_t> mesh_num_vertices;
+		std::vector<uint32_t> mesh_base_vertices;
+		std::vector<uint32_t> mesh_num_indices;
+		std::vector<uint32_t> mesh_base_indices;
+		std::vector<Joint> joints;
+		std::shared_ptr<AnimationActionsType> actions;
+		std::function<std::shared_ptr<KeyFramesType>()> kfs_loader;
+		uint32_t num_frames;
+		uint32_t frame_rate;
+		std::vector<std::shared_ptr<AABBKeyFrames>> frame_pos_bbs;
+		LoadModel(file_name, mtls, merged_ves, all_is_index_16_bit, merged_buff, merged_indices,
+			mesh_names, mtl_ids, pos_bbs, tc_bbs, mesh_num_vertices, mesh_base_vertices,
+			mesh_num_indices, mesh_base_indices, joints, actions, kfs_loader, num_frames, frame_rate,
+			frame_pos_bbs);
+	}
+
+	void CorruptChunkTest(std::string const & file_name, uint32_t flags, uint64_t offset, uint64_t original_len, uint64_t len)
+	{
+		WriteModelBin(file_name, flags, offset, original_len, len);
+		BOOST_CHECK_THROW(LoadModelBin(file_name), std::system_error);
+		std::filesystem::remove(file_name);
+	}
+}
+
+// The header and the chunk table take 72 bytes, the file is 88 bytes long
+
+BOOST_AUTO_TEST_CASE(ModelBinChunkPastEnd)
+{
+	CorruptChunkTest("ModelBinChunkPastEnd.model_bin", 0, 72, 32, 32);
+	CorruptChunkTest("ModelBinChunkOffsetPastEnd.model_bin", 0, 1000, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ModelBinChunkOverflow)
+{
+	// offset + len wraps around to 71
+	CorruptChunkTest("ModelBinChunkOverflow.model_bin", 1, 72, 16, std::numeric_limits<uint64_t>::max());
+}
+
+BOOST_AUTO_TEST_CASE(ModelBinChunkStoredTooLong)
+{
+	// A stored chunk is copied as is, so it can't be longer than its data
+	CorruptChunkTest("ModelBinChunkStoredTooLong.model_bin", 0, 72, 17, 16);
+}
@@ -0,0 +1,117 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderFactory.hpp>
+#include <KlayGE/RenderEngine.hpp>
+#include <KlayGE/RenderEffect.hpp>
+#include <KlayGE/Texture.hpp>
+#include <KlayGE/Blitter.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	bool NullRenderEngineActive()
+	{
+		if (Context::Instance().Config().render_factory_name != "Null")
+		{
+			BOOST_TEST_MESSAGE("Skipped. Set KLAYGE_TESTS_RENDER_FACTORY=Null to run the tests on the Null render engine.");
+			return false;
+		}
+		return true;
+	}
+
+	uint64_t NullCounter(std::string const & name)
+	{
+		uint64_t value = 0;
+		Context::Instance().RenderFactoryInstance().RenderEngineInstance().GetCustomAttrib(name, &value);
+		return value;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(NullRenderEngineCaps)
+{
+	if (!NullRenderEngineActive())
+	{
+		return;
+	}
+
+	RenderDeviceCaps const & caps = Context::Instance().RenderFactoryInstance().RenderEngineInstance().DeviceCaps();
+	BOOST_CHECK(caps.gs_support);
+	BOOST_CHECK(caps.cs_support);
+	BOOST_CHECK(caps.hs_support);
+	BOOST_CHECK(caps.ds_support);
+	BOOST_CHECK(caps.texture_format_support(EF_BC7));
+	BOOST_CHECK(caps.rendertarget_format_support(EF_ABGR16F, 1, 0));
+}
+
+BOOST_AUTO_TEST_CASE(NullRenderEngineSmoke)
+{
+	if (!NullRenderEngineActive())
+	{
+		return;
+	}
+
+	RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+	RenderEngine& re = rf.RenderEngineInstance();
+	re.SetCustomAttrib("RESET_COUNTERS", nullptr);
+
+	uint32_t const WIDTH = 64;
+	uint32_t const HEIGHT = 32;
+
+	std::vector<uint32_t> texels(WIDTH * HEIGHT);
+	for (uint32_t i = 0; i < texels.size(); ++ i)
+	{
+		texels[i] = 0xFF000000 | (i * 2654435761U >> 8);
+	}
+	ElementInitData init_data;
+	init_data.data = &texels[0];
+	init_data.row_pitch = WIDTH * sizeof(uint32_t);
+	init_data.slice_pitch = init_data.row_pitch * HEIGHT;
+	TexturePtr src = rf.MakeTexture2D(WIDTH, HEIGHT, 1, 1, EF_ABGR8, 1, 0, EAH_GPU_Read | EAH_Immutable, &init_data);
+
+	// Textures keep their contents in system memory
+	TexturePtr cpu_tex = rf.MakeTexture2D(WIDTH, HEIGHT, 1, 1, EF_ABGR8, 1, 0, EAH_CPU_Read, nullptr);
+	src->CopyToTexture(*cpu_tex);
+	{
+		Texture::Mapper mapper(*cpu_tex, 0, 0, TMA_Read_Only, 0, 0, WIDTH, HEIGHT);
+		uint8_t const * p = mapper.Pointer<uint8_t>();
+		bool match = true;
+		for (uint32_t y = 0; y < HEIGHT; ++ y)
+		{
+			match &= (0 == std::memcmp(p + y * mapper.RowPitch(), &texels[y * WIDTH], WIDTH * sizeof(uint32_t)));
+		}
+		BOOST_CHECK(match);
+	}
+	BOOST_CHECK(NullCounter("BYTES_COPIED") >= texels.size() * sizeof(uint32_t));
+	BOOST_CHECK(NullCounter("NUM_TEXTURE_MAPS") >= 1);
+
+	// A draw through an effect
+	TexturePtr dst = rf.MakeTexture2D(WIDTH, HEIGHT, 1, 1, EF_ABGR8, 1, 0, EAH_GPU_Read | EAH_GPU_Write, nullptr);
+	Blitter blitter;
+	blitter.Blit(dst, 0, 0, 0, 0, WIDTH, HEIGHT, src, 0, 0, 0, 0, WIDTH, HEIGHT, false);
+	BOOST_CHECK(NullCounter("NUM_DRAWS") >= 1);
+	BOOST_CHECK(NullCounter("NUM_SHADER_OBJECT_BINDS") >= 1);
+
+	// Compute shaders are faked too, so their techniques are valid and can be dispatched
+	RenderEffectPtr effect = SyncLoadRenderEffect("SumLum.fxml");
+	RenderTechnique* tech = effect->TechniqueByName("SumLumLogCS");
+	BOOST_REQUIRE(tech != nullptr);
+	BOOST_CHECK(tech->Validate());
+	uint64_t const num_dispatches = NullCounter("NUM_DISPATCHES");
+	re.Dispatch(*effect, *tech, 1, 1, 1);
+	BOOST_CHECK_EQUAL(NullCounter("NUM_DISPATCHES"), num_dispatches + 1);
+}
@@ -0,0 +1,180 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KlayGE/Camera.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/SceneManager.hpp>
+#include <KlayGE/SceneObject.hpp>
+#include <KlayGE/OCTree/OCTree.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// A cube without renderable, moved by setting its bound directly
+	class BoxObject : public SceneObject
+	{
+	public:
+		BoxObject(uint32_t attrib, float3 const & center)
+			: SceneObject(attrib)
+		{
+			this->Center(center);
+		}
+
+		void Center(float3 const & center)
+		{
+			*pos_aabb_ws_ = AABBox(center - float3(0.5f, 0.5f, 0.5f), center + float3(0.5f, 0.5f, 0.5f));
+		}
+	};
+
+	class OCTreeFixture
+	{
+	public:
+		OCTreeFixture()
+			: octree(static_cast<OCTree&>(Context::Instance().SceneManagerInstance()))
+		{
+			BOOST_REQUIRE(Context::Instance().Config().scene_manager_name == "OCTree");
+			octree.ClearObject();
+		}
+
+		~OCTreeFixture()
+		{
+			octree.ClearObject();
+		}
+
+		std::shared_ptr<BoxObject> Add(uint32_t attrib, float3 const & center)
+		{
+			auto obj = MakeSharedPtr<BoxObject>(attrib, center);
+			octree.AddSceneObject(obj);
+			return obj;
+		}
+
+		// A view from (0, 0, -200) to the origin. A new camera every time, so the result is never a cached one.
+		void Cull()
+		{
+			auto camera = MakeSharedPtr<Camera>();
+			camera->ViewParams(float3(0, 0, -200), float3(0, 0, 0));
+			camera->ProjParams(PI / 4, 1, 1, 10000);
+			cameras.push_back(camera);
+
+			SceneManager::CullingView const view = { camera.get(), -1 };
+			octree.CullViews(&view, 1);
+		}
+
+		bool InRoot(SceneObject const & so) const
+		{
+			AABBox const root = octree.RootBound();
+			float3 const center = so.PosBoundWS().Center();
+			return (center.x() >= root.Min().x()) && (center.x() <= root.Max().x())
+				&& (center.y() >= root.Min().y()) && (center.y() <= root.Max().y())
+				&& (center.z() >= root.Min().z()) && (center.z() <= root.Max().z());
+		}
+
+		OCTree& octree;
+		std::vector<CameraPtr> cameras;
+	};
+
+	uint32_t const STATIC_ATTRIB = SceneObject::SOA_Cullable;
+	uint32_t const MOVEABLE_ATTRIB = SceneObject::SOA_Cullable | SceneObject::SOA_Moveable;
+}
+
+BOOST_FIXTURE_TEST_CASE(OCTreeInsertMoveable, OCTreeFixture)
+{
+	// Without static objects, the tree is built from the moveable ones
+	auto in_view = this->Add(MOVEABLE_ATTRIB, float3(0, 0, 300));
+	auto out_of_view = this->Add(MOVEABLE_ATTRIB, float3(300, 0, -100));
+	this->Cull();
+
+	BOOST_CHECK(this->InRoot(*in_view));
+	BOOST_CHECK(this->InRoot(*out_of_view));
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+	BOOST_CHECK(in_view->VisibleMark() != BO_No);
+	BOOST_CHECK(out_of_view->VisibleMark() == BO_No);
+
+	// Small objects added to a divided tree go down to a node too
+	this->Add(STATIC_ATTRIB, float3(-100, -100, -100));
+	this->Add(STATIC_ATTRIB, float3(100, 100, 100));
+	this->Cull();
+	auto small = this->Add(MOVEABLE_ATTRIB, float3(10, 10, 10));
+	this->Cull();
+
+	BOOST_CHECK(this->InRoot(*small));
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+	BOOST_CHECK(small->VisibleMark() != BO_No);
+}
+
+BOOST_FIXTURE_TEST_CASE(OCTreeMoveMoveable, OCTreeFixture)
+{
+	this->Add(STATIC_ATTRIB, float3(-100, -100, -100));
+	this->Add(STATIC_ATTRIB, float3(100, 100, 100));
+	auto obj = this->Add(MOVEABLE_ATTRIB, float3(0, 0, -100));
+	this->Cull();
+
+	AABBox const root = octree.RootBound();
+	BOOST_CHECK(obj->VisibleMark() != BO_No);
+
+	// Out of the view, but still in the root
+	obj->Center(float3(80, 0, -100));
+	this->Cull();
+	BOOST_CHECK(obj->VisibleMark() == BO_No);
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+
+	obj->Center(float3(0, 20, -90));
+	this->Cull();
+	BOOST_CHECK(obj->VisibleMark() != BO_No);
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+
+	// Moving in the root never changes it
+	BOOST_CHECK(octree.RootBound().Min() == root.Min());
+	BOOST_CHECK(octree.RootBound().Max() == root.Max());
+}
+
+BOOST_FIXTURE_TEST_CASE(OCTreeMoveableEscapesRoot, OCTreeFixture)
+{
+	this->Add(STATIC_ATTRIB, float3(-100, -100, -100));
+	this->Add(STATIC_ATTRIB, float3(100, 100, 100));
+	auto obj = this->Add(MOVEABLE_ATTRIB, float3(0, 0, 0));
+	this->Cull();
+
+	float const root_extent = octree.RootBound().HalfSize().x();
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+
+	// In the view, far out of the root. It's tested on its own in this frame.
+	obj->Center(float3(0, 0, 1000));
+	this->Cull();
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 1U);
+	BOOST_CHECK(obj->VisibleMark() != BO_No);
+
+	// The root grows to take it in the next frame
+	this->Cull();
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+	BOOST_CHECK(this->InRoot(*obj));
+	BOOST_CHECK(octree.RootBound().HalfSize().x() >= root_extent * 2);
+	BOOST_CHECK(obj->VisibleMark() != BO_No);
+
+	// Out of the view in the grown root
+	obj->Center(float3(300, 0, -90));
+	this->Cull();
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+	BOOST_CHECK(obj->VisibleMark() == BO_No);
+
+	// Deleting an object out of the root drops it from the overflow list
+	obj->Center(float3(0, 0, 100000));
+	this->Cull();
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 1U);
+	octree.DelSceneObject(obj);
+	BOOST_CHECK_EQUAL(octree.NumOverflowMoveables(), 0U);
+}
@@ -0,0 +1,142 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/PerfProfiler.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// Profilers created in the fixture are enabled, no matter what the config says
+	class PerfProfilerFixture
+	{
+	public:
+		PerfProfilerFixture()
+			: old_perf_profiler_(Context::Instance().Config().perf_profiler)
+		{
+			this->PerfProfilerConfig(true);
+		}
+
+		~PerfProfilerFixture()
+		{
+			this->PerfProfilerConfig(old_perf_profiler_);
+		}
+
+		void PerfProfilerConfig(bool enabled)
+		{
+			ContextCfg cfg = Context::Instance().Config();
+			cfg.perf_profiler = enabled;
+			Context::Instance().Config(cfg);
+		}
+
+		std::string Trace(PerfProfiler const & profiler, std::string const & file_name)
+		{
+			profiler.ExportToTrace(file_name);
+
+			std::ifstream ifs(file_name.c_str());
+			std::stringstream ss;
+			ss << ifs.rdbuf();
+			ifs.close();
+			std::remove(file_name.c_str());
+			return ss.str();
+		}
+
+	private:
+		bool old_perf_profiler_;
+	};
+
+	bool Contains(std::string const & str, std::string const & sub)
+	{
+		return str.find(sub) != std::string::npos;
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(PerfProfilerNestedScopes, PerfProfilerFixture)
+{
+	PerfProfiler profiler;
+	BOOST_REQUIRE(profiler.Enabled());
+
+	double const outer_begin = profiler.BeginScope();
+	double const inner_begin = profiler.BeginScope();
+	double const inner_time = profiler.EndScope("Inner", inner_begin);
+	double const outer_time = profiler.EndScope("Outer", outer_begin);
+	BOOST_CHECK(inner_begin >= outer_begin);
+	BOOST_CHECK(inner_time >= 0);
+	BOOST_CHECK(outer_time >= inner_time);
+
+	std::string const trace = this->Trace(profiler, "PerfProfilerNestedScopes.json");
+	BOOST_CHECK(Contains(trace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	BOOST_CHECK(Contains(trace, "\"name\":\"Inner\",\"cat\":\"CPU\",\"ph\":\"X\""));
+	BOOST_CHECK(Contains(trace, "\"name\":\"Outer\",\"cat\":\"CPU\",\"ph\":\"X\""));
+	BOOST_CHECK(Contains(trace, "\"args\":{\"frame\":0,\"depth\":1}"));
+	BOOST_CHECK(Contains(trace, "\"args\":{\"frame\":0,\"depth\":0}"));
+}
+
+BOOST_FIXTURE_TEST_CASE(PerfProfilerCounter, PerfProfilerFixture)
+{
+	PerfProfiler profiler;
+
+	PerfCounterPtr counter;
+	{
+		// The counter keeps its own copy of the name
+		std::string const name = "Test \"counter\"";
+		counter = profiler.CreatePerfCounter(name);
+	}
+	BOOST_CHECK_EQUAL(counter->Name(), "Test \"counter\"");
+	counter->Value(3);
+	counter->Value(42);
+
+	std::string const trace = this->Trace(profiler, "PerfProfilerCounter.json");
+	BOOST_CHECK(Contains(trace, "\"name\":\"Test \\\"counter\\\"\",\"ph\":\"C\""));
+	BOOST_CHECK(Contains(trace, "\"args\":{\"value\":3.000}"));
+	BOOST_CHECK(Contains(trace, "\"args\":{\"value\":42.000}"));
+}
+
+BOOST_FIXTURE_TEST_CASE(PerfProfilerThreads, PerfProfilerFixture)
+{
+	PerfProfiler profiler;
+	PerfCounterPtr counter = profiler.CreatePerfCounter("Thread counter");
+
+	counter->Value(1);
+	std::thread([&profiler, &counter]
+		{
+			counter->Value(2);
+			profiler.EndScope("Thread scope", profiler.BeginScope());
+		}).join();
+
+	// Each thread records to its own track
+	std::string const trace = this->Trace(profiler, "PerfProfilerThreads.json");
+	BOOST_CHECK(Contains(trace, "\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Thread 0\"}"));
+	BOOST_CHECK(Contains(trace, "\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"Thread 1\"}"));
+	BOOST_CHECK(Contains(trace, "\"pid\":0,\"tid\":0,\"args\":{\"value\":1.000}"));
+	BOOST_CHECK(Contains(trace, "\"pid\":0,\"tid\":1,\"args\":{\"value\":2.000}"));
+	BOOST_CHECK(Contains(trace, "\"name\":\"Thread scope\",\"cat\":\"CPU\""));
+}
+
+BOOST_FIXTURE_TEST_CASE(PerfProfilerDisabled, PerfProfilerFixture)
+{
+	this->PerfProfilerConfig(false);
+	PerfProfiler profiler;
+	BOOST_CHECK(!profiler.Enabled());
+
+	// Samples are dropped, and nothing is exported
+	PerfCounterPtr counter = profiler.CreatePerfCounter("Disabled counter");
+	counter->Value(1);
+	BOOST_CHECK(this->Trace(profiler, "PerfProfilerDisabled.json").empty());
+}
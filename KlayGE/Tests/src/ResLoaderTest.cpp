@@ -0,0 +1,226 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Hash.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/ResLoader.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	std::atomic<int> num_running_stages(0);
+	std::atomic<int> max_running_stages(0);
+
+	// Shared by the descs that match, the way the real descs share their loaded data
+	struct CountingData
+	{
+		CountingData()
+			: sub_thread_stages(0), running_stages(0), overlapped(false)
+		{
+		}
+
+		std::atomic<int> sub_thread_stages;
+		std::atomic<int> running_stages;
+		std::atomic<bool> overlapped;
+	};
+
+	class CountingLoadingDesc : public ResLoadingDesc
+	{
+	public:
+		CountingLoadingDesc(std::string const & name, int sleep_ms)
+			: name_(name), sleep_ms_(sleep_ms),
+				data_(MakeSharedPtr<CountingData>()), res_(MakeSharedPtr<std::shared_ptr<int>>())
+		{
+		}
+
+		uint64_t Type() const override
+		{
+			static uint64_t const type = CT_HASH("CountingLoadingDesc");
+			return type;
+		}
+
+		bool StateLess() const override
+		{
+			return true;
+		}
+
+		std::shared_ptr<void> CreateResource() override
+		{
+			*res_ = MakeSharedPtr<int>(0);
+			return *res_;
+		}
+
+		void SubThreadStage() override
+		{
+			if (data_->running_stages.fetch_add(1) != 0)
+			{
+				data_->overlapped = true;
+			}
+			int const running = num_running_stages.fetch_add(1) + 1;
+			int max_running = max_running_stages;
+			while ((running > max_running) && !max_running_stages.compare_exchange_weak(max_running, running))
+			{
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms_));
+
+			-- num_running_stages;
+			-- data_->running_stages;
+			++ data_->sub_thread_stages;
+		}
+
+		std::shared_ptr<void> MainThreadStage() override
+		{
+			**res_ = data_->sub_thread_stages;
+			return *res_;
+		}
+
+		bool HasSubThreadStage() const override
+		{
+			return true;
+		}
+
+		size_t Hash() const override
+		{
+			size_t seed = HashValue(this->Type());
+			HashRange(seed, name_.begin(), name_.end());
+			return seed;
+		}
+
+		bool Match(ResLoadingDesc const & rhs) const override
+		{
+			return (this->Type() == rhs.Type()) && (name_ == static_cast<CountingLoadingDesc const &>(rhs).name_);
+		}
+
+		void CopyDataFrom(ResLoadingDesc const & rhs) override
+		{
+			CountingLoadingDesc const & cld = static_cast<CountingLoadingDesc const &>(rhs);
+			data_ = cld.data_;
+			res_ = cld.res_;
+		}
+
+		std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) override
+		{
+			return resource;
+		}
+
+		std::shared_ptr<void> Resource() const override
+		{
+			return *res_;
+		}
+
+		CountingData const & Data() const
+		{
+			return *data_;
+		}
+
+	private:
+		std::string name_;
+		int sleep_ms_;
+		std::shared_ptr<CountingData> data_;
+		std::shared_ptr<std::shared_ptr<int>> res_;
+	};
+
+	// Runs the main thread stages until every resource has one, or gives up after a while
+	bool WaitForMainThreadStages(std::vector<std::shared_ptr<int>> const & resources)
+	{
+		Timer timer;
+		for (;;)
+		{
+			ResLoader::Instance().Update();
+
+			bool all_done = true;
+			for (auto const & res : resources)
+			{
+				if (0 == *res)
+				{
+					all_done = false;
+					break;
+				}
+			}
+			if (all_done)
+			{
+				return true;
+			}
+			if (timer.elapsed() > 10)
+			{
+				return false;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ResLoaderConcurrentSubThreadStages)
+{
+	num_running_stages = 0;
+	max_running_stages = 0;
+
+	std::vector<std::shared_ptr<CountingLoadingDesc>> descs;
+	std::vector<std::shared_ptr<int>> resources;
+	for (int i = 0; i < 16; ++ i)
+	{
+		descs.push_back(MakeSharedPtr<CountingLoadingDesc>("Concurrent" + std::to_string(i), 20));
+		resources.push_back(ResLoader::Instance().ASyncQueryT<int>(descs.back()));
+		BOOST_REQUIRE(resources.back());
+	}
+
+	BOOST_REQUIRE(WaitForMainThreadStages(resources));
+
+	for (size_t i = 0; i < descs.size(); ++ i)
+	{
+		BOOST_CHECK_EQUAL(descs[i]->Data().sub_thread_stages.load(), 1);
+		BOOST_CHECK(!descs[i]->Data().overlapped);
+		BOOST_CHECK_EQUAL(*resources[i], 1);
+	}
+
+	BOOST_CHECK(max_running_stages <= 4);
+	if (std::thread::hardware_concurrency() >= 4)
+	{
+		BOOST_CHECK(max_running_stages > 1);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ResLoaderSyncQueryOfPendingRequest)
+{
+	// A SyncQuery of a resource that is still pending either takes the sub thread stage over or waits for the loading
+	//  thread that has it. Some of these hit each case.
+	for (int i = 0; i < 32; ++ i)
+	{
+		std::string const name = "Pending" + std::to_string(i);
+
+		auto async_desc = MakeSharedPtr<CountingLoadingDesc>(name, i % 4);
+		auto async_res = ResLoader::Instance().ASyncQueryT<int>(async_desc);
+		if (i & 1)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		auto sync_desc = MakeSharedPtr<CountingLoadingDesc>(name, 0);
+		auto sync_res = ResLoader::Instance().SyncQueryT<int>(sync_desc);
+
+		BOOST_CHECK(sync_res == async_res);
+		BOOST_CHECK_EQUAL(*sync_res, 1);
+		BOOST_CHECK_EQUAL(async_desc->Data().sub_thread_stages.load(), 1);
+		BOOST_CHECK(!async_desc->Data().overlapped);
+
+		ResLoader::Instance().Update();
+	}
+}
@@ -39,3 +39,53 @@ BOOST_AUTO_TEST_CASE(NormalizeVector4)
 	v = SIMDMathLib::NormalizeVector4(v);
 	BOOST_CHECK(MathLib::abs(SIMDMathLib::GetX(SIMDMathLib::LengthVector4(v)) - 1.0f) < 1e-3f);
 }
+
+BOOST_AUTO_TEST_CASE(MultiplyAddArray)
+{
+	// Lengths around the SIMD widths, from unaligned pointers. The values are exact in float.
+	std::vector<float> src(20);
+	for (size_t i = 0; i < src.size(); ++ i)
+	{
+		src[i] = static_cast<float>(i) - 7;
+	}
+	for (size_t num = 0; num < 19; ++ num)
+	{
+		std::vector<float> dst(20, 3.0f);
+		SIMDMathLib::MultiplyAddArray(&dst[1], &src[1], 0.5f, num);
+		BOOST_CHECK_EQUAL(dst[0], 3.0f);
+		for (size_t i = 1; i < dst.size(); ++ i)
+		{
+			float const expected = (i <= num) ? 3 + src[i] * 0.5f : 3.0f;
+			BOOST_CHECK_EQUAL(dst[i], expected);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(WeightedSumVector4)
+{
+	std::vector<float> src(4 * 9 + 1);
+	std::vector<float> weights(9);
+	for (size_t i = 0; i < weights.size(); ++ i)
+	{
+		weights[i] = 1.0f / (1 << (i % 3)) - 0.75f;
+		for (size_t j = 0; j < 4; ++ j)
+		{
+			src[1 + i * 4 + j] = static_cast<float>(i * 4 + j) - 10;
+		}
+	}
+	for (size_t num = 0; num <= weights.size(); ++ num)
+	{
+		float dst[5] = { 1, 1, 1, 1, 1 };
+		SIMDMathLib::WeightedSumVector4(&dst[1], &src[1], &weights[0], num);
+		BOOST_CHECK_EQUAL(dst[0], 1.0f);
+		for (size_t j = 0; j < 4; ++ j)
+		{
+			float expected = 0;
+			for (size_t i = 0; i < num; ++ i)
+			{
+				expected += src[1 + i * 4 + j] * weights[i];
+			}
+			BOOST_CHECK_EQUAL(dst[1 + j], expected);
+		}
+	}
+}
@@ -0,0 +1,261 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KlayGE/Camera.hpp>
+#include <KlayGE/SceneManager.hpp>
+#include <KlayGE/SceneObject.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// A cube without renderable
+	class BoxObject : public SceneObject
+	{
+	public:
+		BoxObject(float3 const & center, float half_size)
+			: SceneObject(SOA_Cullable)
+		{
+			*pos_aabb_ws_ = AABBox(center - float3(half_size, half_size, half_size),
+				center + float3(half_size, half_size, half_size));
+		}
+	};
+
+	// Holds the objects without a spatial structure, and exposes the steps of the update thread and the cached
+	//  culling results
+	class TestSceneManager : public SceneManager
+	{
+	public:
+		void Add(SceneObjectPtr const & obj)
+		{
+			scene_objs_.push_back(obj);
+		}
+
+		bool CachedVisible(Camera const & camera, uint32_t obj_index) const
+		{
+			CullingView const view = { &camera, -1 };
+			auto iter = visible_bits_map_.find(this->MakeClipView(view, this->VisibleSeed()).key);
+			BOOST_REQUIRE(iter != visible_bits_map_.end());
+			return (iter->second[obj_index / 32] & (1UL << (obj_index & 31))) != 0;
+		}
+
+		void UpdateRound(float app_time)
+		{
+			this->SubThreadUpdate(app_time, 0);
+		}
+
+		void Publish()
+		{
+			this->PublishSubThreadUpdate();
+		}
+
+	private:
+		void OnAddSceneObject(SceneObjectPtr const & /*obj*/) override
+		{
+		}
+
+		void OnDelSceneObject(std::vector<SceneObjectPtr>::iterator /*iter*/) override
+		{
+		}
+
+		void DoSuspend() override
+		{
+		}
+
+		void DoResume() override
+		{
+		}
+	};
+}
+
+BOOST_AUTO_TEST_CASE(SceneManagerParallelUpdate)
+{
+	uint32_t const num_objs = 64;
+
+	std::mutex mutex;
+	std::set<std::thread::id> parallel_threads;
+	std::set<std::thread::id> serial_threads;
+	std::vector<uint32_t> serial_order;
+
+	TestSceneManager sm;
+	std::vector<SceneObjectPtr> parallel_objs;
+	std::vector<SceneObjectPtr> serial_objs;
+	for (uint32_t i = 0; i < num_objs; ++ i)
+	{
+		auto parallel_obj = MakeSharedPtr<SceneObject>(SceneObject::SOA_ParallelUpdate);
+		parallel_obj->BindSubThreadUpdateFunc([&mutex, &parallel_threads](SceneObject& obj, float app_time, float)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					parallel_threads.insert(std::this_thread::get_id());
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				obj.ModelMatrix(MathLib::translation(app_time, 0.0f, 0.0f));
+			});
+		sm.Add(parallel_obj);
+		parallel_objs.push_back(parallel_obj);
+
+		auto serial_obj = MakeSharedPtr<SceneObject>(0);
+		serial_obj->BindSubThreadUpdateFunc([&serial_threads, &serial_order, i](SceneObject& obj, float app_time, float)
+			{
+				serial_threads.insert(std::this_thread::get_id());
+				serial_order.push_back(i);
+				obj.ModelMatrix(MathLib::translation(app_time, 0.0f, 0.0f));
+			});
+		sm.Add(serial_obj);
+		serial_objs.push_back(serial_obj);
+	}
+
+	sm.UpdateRound(1);
+
+	// Unflagged objects are updated in the scene order on the update thread, straight to their state
+	BOOST_REQUIRE_EQUAL(serial_order.size(), num_objs);
+	for (uint32_t i = 0; i < num_objs; ++ i)
+	{
+		BOOST_CHECK_EQUAL(serial_order[i], i);
+		BOOST_CHECK(serial_objs[i]->ModelMatrix() == MathLib::translation(1.0f, 0.0f, 0.0f));
+	}
+	BOOST_CHECK_EQUAL(serial_threads.size(), 1U);
+	BOOST_CHECK(*serial_threads.begin() == std::this_thread::get_id());
+
+	// Flagged objects are spread over the threads, and their state doesn't change until it's published
+	if (std::thread::hardware_concurrency() > 1)
+	{
+		BOOST_CHECK(parallel_threads.size() > 1);
+	}
+	for (auto const & obj : parallel_objs)
+	{
+		BOOST_CHECK(obj->ModelMatrix() == float4x4::Identity());
+	}
+
+	sm.Publish();
+	for (auto const & obj : parallel_objs)
+	{
+		BOOST_CHECK(obj->ModelMatrix() == MathLib::translation(1.0f, 0.0f, 0.0f));
+	}
+
+	// The next round is published the same way
+	sm.UpdateRound(2);
+	sm.Publish();
+	for (auto const & obj : parallel_objs)
+	{
+		BOOST_CHECK(obj->ModelMatrix() == MathLib::translation(2.0f, 0.0f, 0.0f));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SceneManagerCullMultipleViews)
+{
+	// A 10x10x10 grid of cubes, some of them on the sides of the frustums
+	TestSceneManager sm;
+	for (int z = 0; z < 10; ++ z)
+	{
+		for (int y = 0; y < 10; ++ y)
+		{
+			for (int x = 0; x < 10; ++ x)
+			{
+				sm.Add(MakeSharedPtr<BoxObject>(float3(x * 10.0f - 45, y * 10.0f - 45, z * 10.0f - 45), 2.0f));
+			}
+		}
+	}
+
+	float3 const eye_pos[] = { float3(0, 0, -100), float3(100, 20, 0), float3(-150, 60, 30), float3(0, 0, 0) };
+	float3 const look_at[] = { float3(0, 0, 0), float3(0, 0, 0), float3(0, 0, 30), float3(1, 0, 0) };
+	std::vector<CameraPtr> cameras;
+	std::vector<SceneManager::CullingView> views;
+	for (size_t i = 0; i < sizeof(eye_pos) / sizeof(eye_pos[0]); ++ i)
+	{
+		auto camera = MakeSharedPtr<Camera>();
+		camera->ViewParams(eye_pos[i], look_at[i]);
+		camera->ProjParams(PI / 4, 1, 1, 200);
+		cameras.push_back(camera);
+		views.push_back({ camera.get(), -1 });
+	}
+
+	sm.CullViews(views.data(), static_cast<uint32_t>(views.size()));
+
+	// All the views in one walk get the same results as testing each object against each frustum
+	for (auto const & camera : cameras)
+	{
+		uint32_t num_visible = 0;
+		for (uint32_t i = 0; i < sm.NumSceneObjects(); ++ i)
+		{
+			bool const expected = camera->ViewFrustum().Intersect(sm.GetSceneObject(i)->PosBoundWS()) != BO_No;
+			BOOST_CHECK_EQUAL(sm.CachedVisible(*camera, i), expected);
+			num_visible += expected;
+		}
+		BOOST_CHECK(num_visible > 0);
+		BOOST_CHECK(num_visible < sm.NumSceneObjects());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SceneManagerCullWhileChangingScene)
+{
+	TestSceneManager sm;
+	for (int i = 0; i < 256; ++ i)
+	{
+		sm.Add(MakeSharedPtr<BoxObject>(float3(i - 128.0f, 0, 0), 0.5f));
+	}
+
+	// Another thread adds and deletes objects, the way the update thread does, while the scene is being culled
+	std::atomic<bool> quit(false);
+	std::thread changer([&sm, &quit]
+		{
+			std::vector<SceneObjectPtr> objs;
+			for (int round = 0; !quit; ++ round)
+			{
+				if (objs.size() < 64)
+				{
+					objs.push_back(MakeSharedPtr<BoxObject>(float3(0, static_cast<float>(round & 63), 0), 0.5f));
+					sm.AddSceneObject(objs.back());
+				}
+				else
+				{
+					for (auto const & obj : objs)
+					{
+						sm.DelSceneObject(obj);
+					}
+					objs.clear();
+				}
+			}
+			for (auto const & obj : objs)
+			{
+				sm.DelSceneObject(obj);
+			}
+		});
+
+	std::vector<CameraPtr> cameras;
+	for (int i = 0; i < 200; ++ i)
+	{
+		std::vector<SceneManager::CullingView> views;
+		for (int j = 0; j < 3; ++ j)
+		{
+			auto camera = MakeSharedPtr<Camera>();
+			camera->ViewParams(float3(j * 10.0f, 0, -100), float3(j * 10.0f, 0, 0));
+			cameras.push_back(camera);
+			views.push_back({ camera.get(), -1 });
+		}
+		sm.CullViews(views.data(), static_cast<uint32_t>(views.size()));
+	}
+
+	quit = true;
+	changer.join();
+
+	BOOST_CHECK_EQUAL(sm.NumSceneObjects(), 256U);
+}
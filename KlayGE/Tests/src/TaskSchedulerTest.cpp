@@ -0,0 +1,161 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KFL/TaskScheduler.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+BOOST_AUTO_TEST_CASE(TaskSchedulerSubmit)
+{
+	task_scheduler ts(3);
+
+	std::atomic<int> counter(0);
+	std::vector<task_handle> tasks;
+	for (int i = 0; i < 1000; ++ i)
+	{
+		tasks.push_back(ts.submit([&counter]
+			{
+				++ counter;
+			}));
+	}
+	ts.wait_all(tasks);
+	BOOST_CHECK(1000 == counter);
+}
+
+BOOST_AUTO_TEST_CASE(TaskSchedulerDependencies)
+{
+	task_scheduler ts(3);
+
+	int order = 0;
+	int a = -1;
+	int b = -1;
+	int c = -1;
+	task_handle ta = ts.submit([&] { a = order ++; });
+	task_handle tb = ts.continue_with(ta, [&] { b = order ++; });
+	task_handle deps[] = { ta, tb };
+	task_handle tc = ts.submit([&] { c = order ++; }, deps, 2);
+	ts.wait(tc);
+	BOOST_CHECK((0 == a) && (1 == b) && (2 == c));
+}
+
+BOOST_AUTO_TEST_CASE(TaskSchedulerParallelReduce)
+{
+	task_scheduler ts(3);
+
+	std::vector<uint32_t> v(100000);
+	std::iota(v.begin(), v.end(), 0);
+	uint64_t const sum = ts.parallel_reduce<uint64_t>(0, static_cast<uint32_t>(v.size()), 256, 0,
+		[&v](uint32_t begin, uint32_t end)
+		{
+			uint64_t s = 0;
+			for (uint32_t i = begin; i < end; ++ i)
+			{
+				s += v[i];
+			}
+			return s;
+		},
+		[](uint64_t lhs, uint64_t rhs)
+		{
+			return lhs + rhs;
+		});
+	BOOST_CHECK(sum == 99999ULL * 100000 / 2);
+}
+
+BOOST_AUTO_TEST_CASE(TaskSchedulerNestedParallelFor)
+{
+	task_scheduler ts(3);
+
+	std::atomic<uint32_t> total(0);
+	ts.parallel_for(0, 16, 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; ++ i)
+			{
+				ts.parallel_for(0, 1000, 16, [&total](uint32_t sub_begin, uint32_t sub_end)
+					{
+						total += sub_end - sub_begin;
+					});
+			}
+		});
+	BOOST_CHECK(16000 == total);
+}
+
+BOOST_AUTO_TEST_CASE(TaskSchedulerWaitAllException)
+{
+	task_scheduler ts(3);
+
+	std::atomic<int> counter(0);
+	std::vector<task_handle> tasks;
+	for (int i = 0; i < 1000; ++ i)
+	{
+		tasks.push_back(ts.submit([&counter, i]
+			{
+				if (10 == i)
+				{
+					throw std::runtime_error("task failed");
+				}
+				++ counter;
+			}));
+	}
+
+	bool thrown = false;
+	try
+	{
+		ts.wait_all(tasks);
+	}
+	catch (std::runtime_error const &)
+	{
+		thrown = true;
+	}
+	BOOST_CHECK(thrown);
+	BOOST_CHECK(999 == counter);
+	for (auto const & task : tasks)
+	{
+		BOOST_CHECK(task.done());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TaskSchedulerParallelForException)
+{
+	task_scheduler ts(3);
+
+	for (uint32_t throw_at = 0; throw_at < 10000; throw_at += 2500)
+	{
+		std::atomic<uint32_t> total(0);
+		uint32_t failed_size = 0;
+		bool thrown = false;
+		try
+		{
+			ts.parallel_for(0, 10000, 16, [&total, &failed_size, throw_at](uint32_t begin, uint32_t end)
+				{
+					if ((throw_at >= begin) && (throw_at < end))
+					{
+						failed_size = end - begin;
+						throw std::runtime_error("range failed");
+					}
+					total += end - begin;
+				});
+		}
+		catch (std::runtime_error const &)
+		{
+			thrown = true;
+		}
+		BOOST_CHECK(thrown);
+		// All the other ranges are finished when the exception reaches here
+		BOOST_CHECK(10000 == total + failed_size);
+	}
+}
@@ -0,0 +1,210 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/ElementFormat.hpp>
+#include <KlayGE/Texture.hpp>
+
+#include <boost/assert.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter in boost
+#endif
+#include <boost/test/unit_test.hpp>
+#ifdef KLAYGE_COMPILER_CLANG
+#pragma clang diagnostic pop
+#endif
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// A texel value that is exact in float, different in every channel and position
+	Color TexelValue(uint32_t x, uint32_t y, uint32_t z)
+	{
+		float const base = static_cast<float>(x + y * 8 + z * 64);
+		return Color(base, base * 2, base * 4, base * 8);
+	}
+
+	void BoxDownsampleTest(uint32_t src_width, uint32_t src_height, uint32_t src_depth)
+	{
+		uint32_t const dst_width = src_width / 2;
+		uint32_t const dst_height = src_height / 2;
+		uint32_t const dst_depth = std::max(src_depth / 2, 1U);
+
+		std::vector<Color> src(src_width * src_height * src_depth);
+		for (uint32_t z = 0; z < src_depth; ++ z)
+		{
+			for (uint32_t y = 0; y < src_height; ++ y)
+			{
+				for (uint32_t x = 0; x < src_width; ++ x)
+				{
+					src[(z * src_height + y) * src_width + x] = TexelValue(x, y, z);
+				}
+			}
+		}
+
+		std::vector<Color> dst(dst_width * dst_height * dst_depth);
+		ResizeTexture(&dst[0], dst_width * sizeof(Color), dst_width * dst_height * sizeof(Color), EF_ABGR32F,
+			dst_width, dst_height, dst_depth,
+			&src[0], src_width * sizeof(Color), src_width * src_height * sizeof(Color), EF_ABGR32F,
+			src_width, src_height, src_depth,
+			TRF_Box);
+
+		// Each destination texel is the average of its 2x2 (x2) source block. The values are linear in x, y and z.
+		uint32_t const z_scale = src_depth / dst_depth;
+		for (uint32_t z = 0; z < dst_depth; ++ z)
+		{
+			for (uint32_t y = 0; y < dst_height; ++ y)
+			{
+				for (uint32_t x = 0; x < dst_width; ++ x)
+				{
+					Color const & texel = dst[(z * dst_height + y) * dst_width + x];
+					Color const expected = TexelValue(x * 2, y * 2, z * z_scale)
+						+ (TexelValue(1, 1, z_scale - 1) - TexelValue(0, 0, 0)) * 0.5f;
+					for (size_t c = 0; c < 4; ++ c)
+					{
+						BOOST_CHECK_CLOSE(texel[c] + 1, expected[c] + 1, 1e-4f);
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<float> ResizeRow(std::vector<float> const & src, uint32_t dst_width, TexResizeFilter filter)
+	{
+		uint32_t const src_width = static_cast<uint32_t>(src.size());
+		std::vector<float> dst(dst_width);
+		ResizeTexture(&dst[0], dst_width * sizeof(float), dst_width * sizeof(float), EF_R32F, dst_width, 1, 1,
+			&src[0], src_width * sizeof(float), src_width * sizeof(float), EF_R32F, src_width, 1, 1,
+			filter);
+		return dst;
+	}
+
+	// Wide filters have normalized weights, and are symmetric. On a 2:1 reduction, the taps of a destination texel pair
+	//  up around its center, so linear ramps and the highest frequency are reproduced exactly away from the edges.
+	void WideFilterTest(TexResizeFilter filter)
+	{
+		uint32_t const src_width = 64;
+		uint32_t const dst_width = src_width / 2;
+		uint32_t const margin = 4;
+
+		std::vector<float> flat(src_width, 0.25f);
+		for (float value : ResizeRow(flat, dst_width, filter))
+		{
+			BOOST_CHECK_CLOSE(value, 0.25f, 1e-3f);
+		}
+		for (float value : ResizeRow(flat, src_width * 3 / 2, filter))
+		{
+			BOOST_CHECK_CLOSE(value, 0.25f, 1e-3f);
+		}
+
+		std::vector<float> ramp(src_width);
+		std::vector<float> stripes(src_width);
+		for (uint32_t x = 0; x < src_width; ++ x)
+		{
+			ramp[x] = static_cast<float>(x);
+			stripes[x] = (x & 1) ? 1.0f : 0.0f;
+		}
+		std::vector<float> const resized_ramp = ResizeRow(ramp, dst_width, filter);
+		std::vector<float> const resized_stripes = ResizeRow(stripes, dst_width, filter);
+		for (uint32_t x = margin; x < dst_width - margin; ++ x)
+		{
+			BOOST_CHECK_CLOSE(resized_ramp[x], x * 2 + 0.5f, 1e-3f);
+			BOOST_CHECK_CLOSE(resized_stripes[x], 0.5f, 1e-3f);
+		}
+	}
+
+	// A step from 0 to 1, upsampled. Lanczos has negative lobes, so it rings around the edge, Kaiser much less.
+	float StepOvershoot(TexResizeFilter filter)
+	{
+		std::vector<float> step(16);
+		for (uint32_t x = 0; x < step.size(); ++ x)
+		{
+			step[x] = (x < step.size() / 2) ? 0.0f : 1.0f;
+		}
+		std::vector<float> const resized = ResizeRow(step, 64, filter);
+		return *std::max_element(resized.begin(), resized.end()) - 1;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ResizeTextureBox2D)
+{
+	BoxDownsampleTest(8, 6, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ResizeTextureBox3D)
+{
+	BoxDownsampleTest(8, 4, 4);
+}
+
+BOOST_AUTO_TEST_CASE(ResizeTextureKaiser)
+{
+	WideFilterTest(TRF_Kaiser);
+}
+
+BOOST_AUTO_TEST_CASE(ResizeTextureLanczos3)
+{
+	WideFilterTest(TRF_Lanczos3);
+}
+
+BOOST_AUTO_TEST_CASE(ResizeTextureRinging)
+{
+	float const kaiser = StepOvershoot(TRF_Kaiser);
+	float const lanczos = StepOvershoot(TRF_Lanczos3);
+	BOOST_CHECK(lanczos > 0.05f);
+	BOOST_CHECK(kaiser < lanczos);
+}
+
+BOOST_AUTO_TEST_CASE(BuildMipChainLevels)
+{
+	uint32_t const width = 8;
+	uint32_t const height = 4;
+	uint32_t const num_mipmaps = 4;
+
+	// Columns alternate between 0x10 and 0x30 in R, rows between 0x40 and 0x80 in G
+	std::vector<uint32_t> src(width * height);
+	for (uint32_t y = 0; y < height; ++ y)
+	{
+		for (uint32_t x = 0; x < width; ++ x)
+		{
+			uint32_t const r = (x & 1) ? 0x30 : 0x10;
+			uint32_t const g = (y & 1) ? 0x80 : 0x40;
+			src[y * width + x] = 0xFF000000 | (0x20 << 16) | (g << 8) | r;
+		}
+	}
+
+	std::vector<ElementInitData> mip_data;
+	std::vector<uint8_t> data_block;
+	BuildMipChain(mip_data, data_block, EF_ABGR8, width, height, 1, num_mipmaps,
+		&src[0], width * sizeof(uint32_t), width * height * sizeof(uint32_t), TRF_Box);
+
+	BOOST_REQUIRE(num_mipmaps == mip_data.size());
+
+	uint32_t const level_widths[] = { 8, 4, 2, 1 };
+	uint32_t const level_heights[] = { 4, 2, 1, 1 };
+	size_t offset = 0;
+	for (uint32_t level = 0; level < num_mipmaps; ++ level)
+	{
+		BOOST_CHECK_EQUAL(mip_data[level].row_pitch, level_widths[level] * sizeof(uint32_t));
+		BOOST_CHECK_EQUAL(mip_data[level].slice_pitch, level_widths[level] * level_heights[level] * sizeof(uint32_t));
+		BOOST_CHECK(mip_data[level].data == &data_block[offset]);
+		offset += mip_data[level].slice_pitch;
+	}
+	BOOST_CHECK_EQUAL(data_block.size(), offset);
+
+	// Level 0 is a copy
+	uint32_t const * level0 = static_cast<uint32_t const *>(mip_data[0].data);
+	BOOST_CHECK(std::equal(src.begin(), src.end(), level0));
+
+	// Below it, every 2x2 block averages to R 0x20 and G 0x60
+	for (uint32_t level = 1; level < num_mipmaps; ++ level)
+	{
+		uint32_t const * texels = static_cast<uint32_t const *>(mip_data[level].data);
+		for (uint32_t i = 0; i < level_widths[level] * level_heights[level]; ++ i)
+		{
+			BOOST_CHECK_EQUAL(texels[i], 0xFF206020U);
+		}
+	}
+}
@@ -1,7 +1,9 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Math.hpp>
+#include <KFL/TaskScheduler.hpp>
 #include <KFL/Util.hpp>
 #include <KFL/XMLDom.hpp>
+#include <KlayGE/Context.hpp>
 #include <KlayGE/ResLoader.hpp>
 #include <KlayGE/RenderLayout.hpp>
 #include <KlayGE/LZMACodec.hpp>
@@ -76,7 +78,21 @@ namespace
 	}
 
 	std::string const JIT_EXT_NAME = ".model_bin";
-	uint32_t const MODEL_BIN_VERSION = 13;
+	uint32_t const MODEL_BIN_VERSION = 14;
+
+	uint32_t const MODEL_BIN_CHUNK_COMPRESSED = 1UL << 0;
+	uint32_t const MODEL_BIN_CHUNK_ALIGNMENT = 16;
+	uint32_t const MODEL_BIN_LZMA_BLOCK_SIZE = 1UL << 20;
+
+	// A section of a .model_bin, compressed independently from the others
+	struct ModelBinChunk
+	{
+		uint32_t id;
+		std::string data;
+
+		uint32_t flags;
+		std::vector<uint8_t> compressed;
+	};
 
 	struct KeyFrames
 	{
@@ -1767,9 +1783,7 @@ namespace
 		std::vector<AABBox> const & pos_bbs, std::vector<AABBox> const & tc_bbs,
 		std::vector<uint32_t> const & mesh_num_vertices, std::vector<uint32_t> const & mesh_base_vertices,
 		std::vector<uint32_t> const & mesh_num_indices, std::vector<uint32_t> const & mesh_start_indices,
-		std::vector<vertex_element> const & merged_ves,
-		std::vector<std::vector<uint8_t>> const & merged_vertices, std::vector<uint8_t> const & merged_indices,
-		char is_index_16_bit, std::ostream& os)
+		std::vector<vertex_element> const & merged_ves, char is_index_16_bit, std::ostream& os)
 	{
 		uint32_t num_merged_ves = Native2LE(static_cast<uint32_t>(merged_ves.size()));
 		os.write(reinterpret_cast<char*>(&num_merged_ves), sizeof(num_merged_ves));
@@ -1787,12 +1801,6 @@ namespace
 		os.write(reinterpret_cast<char*>(&num_indices), sizeof(num_indices));
 		os.write(&is_index_16_bit, sizeof(is_index_16_bit));
 
-		for (size_t i = 0; i < merged_vertices.size(); ++ i)
-		{
-			os.write(reinterpret_cast<char const *>(&merged_vertices[i][0]), merged_vertices[i].size() * sizeof(merged_vertices[i][0]));
-		}
-		os.write(reinterpret_cast<char const *>(&merged_indices[0]), merged_indices.size() * sizeof(merged_indices[0]));
-
 		for (uint32_t mesh_index = 0; mesh_index < mesh_num_vertices.size(); ++ mesh_index)
 		{
 			WriteShortString(os, mesh_names[mesh_index]);
@@ -1855,14 +1863,8 @@ namespace
 		}
 	}
 
-	void WriteKeyFramesChunk(uint32_t num_frames, uint32_t frame_rate, std::vector<KeyFrames>& kfs,
-		std::ostream& os)
+	void WriteKeyFramesChunk(std::vector<KeyFrames>& kfs, std::ostream& os)
 	{
-		num_frames = Native2LE(num_frames);
-		os.write(reinterpret_cast<char*>(&num_frames), sizeof(num_frames));
-		frame_rate = Native2LE(frame_rate);
-		os.write(reinterpret_cast<char*>(&frame_rate), sizeof(frame_rate));
-
 		for (size_t i = 0; i < kfs.size(); ++ i)
 		{
 			uint32_t num_kf = Native2LE(static_cast<uint32_t>(kfs[i].frame_id.size()));
@@ -2073,7 +2075,6 @@ namespace
 
 	void MeshMLJIT(std::string const & meshml_name, std::string const & output_name, std::string const & platform)
 	{
-		std::ostringstream ss;
 
 		ResIdentifierPtr file = ResLoader::Instance().Open(meshml_name);
 		KlayGE::XMLDocument doc;
@@ -2126,10 +2127,6 @@ namespace
 				}
 			}
 		}
-		{
-			uint32_t num_mtls = Native2LE(static_cast<uint32_t>(mtls.size()));
-			ss.write(reinterpret_cast<char*>(&num_mtls), sizeof(num_mtls));
-		}
 
 		XMLNodePtr meshes_chunk = root->FirstNode("meshes_chunk");
 		std::vector<std::string> mesh_names;
@@ -2152,10 +2149,6 @@ namespace
 				merged_ves, merged_vertices, merged_indices,
 				is_index_16_bit);
 		}
-		{
-			uint32_t num_meshes = Native2LE(static_cast<uint32_t>(pos_bbs.size()));
-			ss.write(reinterpret_cast<char*>(&num_meshes), sizeof(num_meshes));
-		}
 
 		XMLNodePtr bones_chunk = root->FirstNode("bones_chunk");
 		std::vector<Joint> joints;
@@ -2163,10 +2156,6 @@ namespace
 		{
 			CompileBonesChunk(bones_chunk, joints);
 		}
-		{
-			uint32_t num_joints = Native2LE(static_cast<uint32_t>(joints.size()));
-			ss.write(reinterpret_cast<char*>(&num_joints), sizeof(num_joints));
-		}
 
 		XMLNodePtr key_frames_chunk = root->FirstNode("key_frames_chunk");
 		uint32_t num_frames = 0;
@@ -2180,10 +2169,6 @@ namespace
 			XMLNodePtr bb_kfs_chunk = root->FirstNode("bb_key_frames_chunk");
 			CompileBBKeyFramesChunk(bb_kfs_chunk, pos_bbs, num_frames, bb_kfs);
 		}
-		{
-			uint32_t num_kfs = Native2LE(static_cast<uint32_t>(kfs.size()));
-			ss.write(reinterpret_cast<char*>(&num_kfs), sizeof(num_kfs));
-		}
 
 		XMLNodePtr actions_chunk = root->FirstNode("actions_chunk");
 		std::vector<AnimationAction> actions;
@@ -2191,35 +2176,89 @@ namespace
 		{
 			CompileActionsChunk(actions_chunk, num_frames, actions);
 		}
+
+		std::vector<ModelBinChunk> chunks;
+		auto add_chunk = [&chunks](uint32_t id, std::string data)
 		{
-			uint32_t num_actions = Native2LE(key_frames_chunk ? std::max(static_cast<uint32_t>(actions.size()), 1U) : 0);
-			ss.write(reinterpret_cast<char*>(&num_actions), sizeof(num_actions));
-		}
+			ModelBinChunk chunk;
+			chunk.id = id;
+			chunk.data = std::move(data);
+			chunk.flags = 0;
+			chunks.push_back(std::move(chunk));
+		};
 
 		if (materials_chunk)
 		{
+			std::ostringstream ss;
 			WriteMaterialsChunk(mtls, ss);
+			add_chunk(MakeFourCC<'M', 'T', 'L', 'S'>::value, ss.str());
 		}
 
 		if (meshes_chunk)
 		{
+			std::ostringstream ss;
 			WriteMeshesChunk(mesh_names, mtl_ids, pos_bbs, tc_bbs,
 				mesh_num_vertices, mesh_base_vertices, mesh_num_indices, mesh_start_indices,
-				merged_ves, merged_vertices, merged_indices, is_index_16_bit, ss);
+				merged_ves, is_index_16_bit, ss);
+			add_chunk(MakeFourCC<'M', 'E', 'S', 'H'>::value, ss.str());
+
+			// Vertex streams and indices are stored as they're uploaded, one chunk each
+			for (size_t i = 0; i < merged_vertices.size(); ++ i)
+			{
+				add_chunk(MakeFourCC<'V', 'T', 'X', 'S'>::value,
+					std::string(merged_vertices[i].begin(), merged_vertices[i].end()));
+			}
+			add_chunk(MakeFourCC<'I', 'N', 'D', 'X'>::value, std::string(merged_indices.begin(), merged_indices.end()));
 		}
 
 		if (bones_chunk)
 		{
+			std::ostringstream ss;
 			WriteBonesChunk(joints, ss);
+			add_chunk(MakeFourCC<'B', 'O', 'N', 'E'>::value, ss.str());
 		}
 
 		if (key_frames_chunk)
 		{
-			WriteKeyFramesChunk(num_frames, frame_rate, kfs, ss);
-			WriteBBKeyFramesChunk(bb_kfs, ss);
-			WriteActionsChunk(actions, ss);
+			{
+				std::ostringstream ss;
+				WriteKeyFramesChunk(kfs, ss);
+				add_chunk(MakeFourCC<'K', 'E', 'Y', 'F'>::value, ss.str());
+			}
+			{
+				std::ostringstream ss;
+				WriteBBKeyFramesChunk(bb_kfs, ss);
+				add_chunk(MakeFourCC<'B', 'B', 'K', 'F'>::value, ss.str());
+			}
+			{
+				std::ostringstream ss;
+				WriteActionsChunk(actions, ss);
+				add_chunk(MakeFourCC<'A', 'C', 'T', 'N'>::value, ss.str());
+			}
 		}
 
+		Context::Instance().TaskScheduler().parallel_for(0, static_cast<uint32_t>(chunks.size()), 1,
+			[&chunks](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++ i)
+				{
+					auto& chunk = chunks[i];
+					if (!chunk.data.empty())
+					{
+						LZMACodec lzma(MODEL_BIN_LZMA_BLOCK_SIZE);
+						lzma.Encode(chunk.compressed, chunk.data.data(), chunk.data.size());
+						if (chunk.compressed.size() < chunk.data.size())
+						{
+							chunk.flags |= MODEL_BIN_CHUNK_COMPRESSED;
+						}
+						else
+						{
+							chunk.compressed.clear();
+						}
+					}
+				}
+			});
+
 		std::ofstream ofs(output_name.c_str(), std::ios_base::binary);
 		BOOST_ASSERT(ofs);
 		uint32_t fourcc = Native2LE(MakeFourCC<'K', 'L', 'M', ' '>::value);
@@ -2228,19 +2267,60 @@ namespace
 		uint32_t ver = Native2LE(MODEL_BIN_VERSION);
 		ofs.write(reinterpret_cast<char*>(&ver), sizeof(ver));
 
-		uint64_t original_len = Native2LE(static_cast<uint64_t>(ss.str().size()));
-		ofs.write(reinterpret_cast<char*>(&original_len), sizeof(original_len));
+		uint32_t header[] =
+		{
+			static_cast<uint32_t>(mtls.size()),
+			static_cast<uint32_t>(pos_bbs.size()),
+			static_cast<uint32_t>(joints.size()),
+			static_cast<uint32_t>(kfs.size()),
+			key_frames_chunk ? std::max(static_cast<uint32_t>(actions.size()), 1U) : 0,
+			num_frames,
+			frame_rate,
+			static_cast<uint32_t>(chunks.size())
+		};
+		for (auto& h : header)
+		{
+			h = Native2LE(h);
+		}
+		ofs.write(reinterpret_cast<char*>(header), sizeof(header));
+
+		uint64_t offset = sizeof(fourcc) + sizeof(ver) + sizeof(header)
+			+ chunks.size() * (sizeof(uint32_t) * 2 + sizeof(uint64_t) * 3);
+		for (auto const & chunk : chunks)
+		{
+			offset = (offset + MODEL_BIN_CHUNK_ALIGNMENT - 1) & ~static_cast<uint64_t>(MODEL_BIN_CHUNK_ALIGNMENT - 1);
 
-		std::ofstream::pos_type p = ofs.tellp();
-		uint64_t len = 0;
-		ofs.write(reinterpret_cast<char*>(&len), sizeof(len));
+			uint32_t id = Native2LE(chunk.id);
+			ofs.write(reinterpret_cast<char*>(&id), sizeof(id));
+			uint32_t flags = Native2LE(chunk.flags);
+			ofs.write(reinterpret_cast<char*>(&flags), sizeof(flags));
+			uint64_t chunk_offset = Native2LE(offset);
+			ofs.write(reinterpret_cast<char*>(&chunk_offset), sizeof(chunk_offset));
+			uint64_t original_len = Native2LE(static_cast<uint64_t>(chunk.data.size()));
+			ofs.write(reinterpret_cast<char*>(&original_len), sizeof(original_len));
+			uint64_t const stored_len = (chunk.flags & MODEL_BIN_CHUNK_COMPRESSED) ? chunk.compressed.size() : chunk.data.size();
+			uint64_t len = Native2LE(stored_len);
+			ofs.write(reinterpret_cast<char*>(&len), sizeof(len));
 
-		LZMACodec lzma;
-		len = lzma.Encode(ofs, ss.str().c_str(), ss.str().size());
+			offset += stored_len;
+		}
+
+		for (auto const & chunk : chunks)
+		{
+			char const zeros[MODEL_BIN_CHUNK_ALIGNMENT] = { 0 };
+			uint64_t const pos = static_cast<uint64_t>(ofs.tellp());
+			ofs.write(zeros, static_cast<std::streamsize>(((pos + MODEL_BIN_CHUNK_ALIGNMENT - 1)
+				& ~static_cast<uint64_t>(MODEL_BIN_CHUNK_ALIGNMENT - 1)) - pos));
 
-		ofs.seekp(p, std::ios_base::beg);
-		len = Native2LE(len);
-		ofs.write(reinterpret_cast<char*>(&len), sizeof(len));
+			if (chunk.flags & MODEL_BIN_CHUNK_COMPRESSED)
+			{
+				ofs.write(reinterpret_cast<char const *>(chunk.compressed.data()), chunk.compressed.size());
+			}
+			else
+			{
+				ofs.write(chunk.data.data(), chunk.data.size());
+			}
+		}
 	}
 }
 
@@ -14,7 +14,7 @@ using namespace KlayGE;
 
 namespace
 {
-	void GenMipmap(std::string const & in_file, std::string const & out_file)
+	void GenMipmap(std::string const & in_file, std::string const & out_file, TexResizeFilter filter)
 	{
 		Texture::TextureType in_type;
 		uint32_t in_width, in_height, in_depth;
@@ -25,75 +25,30 @@ namespace
 		std::vector<uint8_t> in_data_block;
 		LoadTexture(in_file, in_type, in_width, in_height, in_depth, in_num_mipmaps, in_array_size, in_format, in_data, in_data_block);
 
-		uint32_t const elem_size = NumFormatBytes(in_format);
-
 		uint32_t num_full_mip_maps = 1;
 		uint32_t w = in_width;
 		uint32_t h = in_height;
-		while ((w != 1) || (h != 1))
+		uint32_t d = in_depth;
+		while ((w != 1) || (h != 1) || (d != 1))
 		{
 			++ num_full_mip_maps;
 
 			w = std::max<uint32_t>(1U, w / 2);
 			h = std::max<uint32_t>(1U, h / 2);
+			d = std::max<uint32_t>(1U, d / 2);
 		}
 
 		std::vector<ElementInitData> new_data(in_array_size * num_full_mip_maps);
-		std::vector<std::vector<uint8_t>> new_data_block(new_data.size());
+		std::vector<std::vector<uint8_t>> new_data_block(in_array_size);
 
 		for (uint32_t sub_res = 0; sub_res < in_array_size; ++ sub_res)
 		{
-			uint32_t the_width = in_width;
-			uint32_t the_height = in_height;
-
-			{
-				ElementInitData& dst_data = new_data[sub_res * num_full_mip_maps];
-
-				dst_data.row_pitch = the_width * elem_size;
-				dst_data.slice_pitch = dst_data.row_pitch * the_height;
-
-				new_data_block[sub_res * num_full_mip_maps].resize(dst_data.slice_pitch);
-
-				dst_data.data = &new_data_block[sub_res * num_full_mip_maps][0];
-
-				ElementInitData const & src_data = in_data[sub_res * in_num_mipmaps];
-
-				uint8_t const * src = static_cast<uint8_t const *>(src_data.data);
-				uint8_t* dst = &new_data_block[sub_res * num_full_mip_maps][0];
-				for (uint32_t y = 0; y < the_height; ++ y)
-				{
-					std::memcpy(dst, src, dst_data.row_pitch);
-
-					src += src_data.row_pitch;
-					dst += dst_data.row_pitch;
-				}
-			}
-
-			for (uint32_t mip = 0; mip < num_full_mip_maps - 1; ++ mip)
-			{
-				uint32_t new_width = std::max(the_width / 2, 1U);
-				uint32_t new_height = std::max(the_height / 2, 1U);
-
-				ElementInitData& src_data = new_data[sub_res * num_full_mip_maps + mip];
-				ElementInitData& dst_data = new_data[sub_res * num_full_mip_maps + mip + 1];
-
-				dst_data.row_pitch = new_width * elem_size;
-				dst_data.slice_pitch = dst_data.row_pitch * new_height;
-
-				new_data_block[sub_res * num_full_mip_maps + mip + 1].resize(dst_data.slice_pitch);
+			ElementInitData const & src_data = in_data[sub_res * in_num_mipmaps];
 
-				dst_data.data = &new_data_block[sub_res * num_full_mip_maps + mip + 1][0];
-
-				ResizeTexture(&new_data_block[sub_res * num_full_mip_maps + mip + 1][0],
-					dst_data.row_pitch, dst_data.slice_pitch,
-					in_format, new_width, new_height, 1,
-					src_data.data, src_data.row_pitch, src_data.slice_pitch,
-					in_format, the_width, the_height, 1,
-					true);
-
-				the_width = new_width;
-				the_height = new_height;
-			}
+			std::vector<ElementInitData> mip_data;
+			BuildMipChain(mip_data, new_data_block[sub_res], in_format, in_width, in_height, in_depth, num_full_mip_maps,
+				src_data.data, src_data.row_pitch, src_data.slice_pitch, filter);
+			std::copy(mip_data.begin(), mip_data.end(), new_data.begin() + sub_res * num_full_mip_maps);
 		}
 
 		SaveTexture(out_file, in_type, in_width, in_height, in_depth, num_full_mip_maps, in_array_size, in_format, new_data);
@@ -104,7 +59,7 @@ int main(int argc, char* argv[])
 {
 	if (argc < 2)
 	{
-		cout << "Usage: Mipmapper xxx.dds [yyy.dds]" << endl;
+		cout << "Usage: Mipmapper xxx.dds [yyy.dds] [box | kaiser | lanczos]" << endl;
 		return 1;
 	}
 
@@ -126,7 +81,27 @@ int main(int argc, char* argv[])
 		out_file = argv[2];
 	}
 
-	GenMipmap(in_file, out_file);
+	TexResizeFilter filter = TRF_Box;
+	if (argc >= 4)
+	{
+		std::string const filter_name = argv[3];
+		if ("kaiser" == filter_name)
+		{
+			filter = TRF_Kaiser;
+		}
+		else if ("lanczos" == filter_name)
+		{
+			filter = TRF_Lanczos3;
+		}
+		else if (filter_name != "box")
+		{
+			cout << "Unknown filter " << filter_name << ". It should be box, kaiser or lanczos." << endl;
+			Context::Destroy();
+			return 1;
+		}
+	}
+
+	GenMipmap(in_file, out_file, filter);
 
 	cout << "Mipmapped texture is saved." << endl;
 
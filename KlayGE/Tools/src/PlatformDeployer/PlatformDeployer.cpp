@@ -45,6 +45,7 @@ struct OfflineRenderDeviceCaps
 	bool bc5_support : 1;
 	bool bc7_support : 1;
 	bool etc1_support : 1;
+	bool etc2_support : 1;
 	bool r16_support : 1;
 	bool r16f_support : 1;
 	bool srgb_support : 1;
@@ -153,6 +154,7 @@ OfflineRenderDeviceCaps LoadPlatformConfig(std::string const & platform)
 	caps.bc5_support = RetrieveNodeValue(root, "bc5_support", 0) ? true : false;
 	caps.bc7_support = RetrieveNodeValue(root, "bc7_support", 0) ? true : false;
 	caps.etc1_support = RetrieveNodeValue(root, "etc1_support", 0) ? true : false;
+	caps.etc2_support = RetrieveNodeValue(root, "etc2_support", 0) ? true : false;
 	caps.r16_support = RetrieveNodeValue(root, "r16_support", 0) ? true : false;
 	caps.r16f_support = RetrieveNodeValue(root, "r16f_support", 0) ? true : false;
 	caps.srgb_support = RetrieveNodeValue(root, "srgb_support", 0) ? true : false;
@@ -189,6 +191,10 @@ void Deploy(std::vector<std::string> const & res_names, std::string const & res_
 			{
 				ofs << "TexCompressor BC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
 			}
+			else if (caps.etc2_support)
+			{
+				ofs << "TexCompressor ETC2_RGB8A1 temp.dds \"" << res_names[i] << "\"" << std::endl;
+			}
 			else if (caps.etc1_support)
 			{
 				ofs << "TexCompressor ETC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
@@ -219,6 +225,10 @@ void Deploy(std::vector<std::string> const & res_names, std::string const & res_
 			{
 				ofs << "TexCompressor BC4 temp.dds \"" << res_names[i] << "\"" << std::endl;
 			}
+			else if (caps.etc2_support)
+			{
+				ofs << "TexCompressor EAC_R11 temp.dds \"" << res_names[i] << "\"" << std::endl;
+			}
 			else if (caps.bc1_support)
 			{
 				ofs << "TexCompressor BC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
@@ -251,6 +261,12 @@ void Deploy(std::vector<std::string> const & res_names, std::string const & res_
 			{
 				ofs << "NormalMapCompressor temp.dds \"" << res_names[i] << "\" BC3" << std::endl;
 			}
+			else if (caps.etc2_support)
+			{
+				ofs << "NormalMapCompressor temp.dds temp_gr.dds GR" << std::endl;
+				ofs << "TexCompressor EAC_RG11 temp_gr.dds \"" << res_names[i] << "\"" << std::endl;
+				ofs << "del temp_gr.dds" << std::endl;
+			}
 			else
 			{
 				ofs << "copy temp.dds \"" << res_names[i] << "\"" << std::endl;
@@ -276,6 +292,12 @@ void Deploy(std::vector<std::string> const & res_names, std::string const & res_
 			{
 				ofs << "NormalMapCompressor temp.dds \"" << res_names[i] << "\" BC3" << std::endl;
 			}
+			else if (caps.etc2_support)
+			{
+				ofs << "NormalMapCompressor temp.dds temp_gr.dds GR" << std::endl;
+				ofs << "TexCompressor EAC_RG11 temp_gr.dds \"" << res_names[i] << "\"" << std::endl;
+				ofs << "del temp_gr.dds" << std::endl;
+			}
 			else
 			{
 				ofs << "copy temp.dds \"" << res_names[i] << "\"" << std::endl;
@@ -296,6 +318,10 @@ void Deploy(std::vector<std::string> const & res_names, std::string const & res_
 			{
 				ofs << "TexCompressor BC4 temp.dds \"" << res_names[i] << "\"" << std::endl;
 			}
+			else if (caps.etc2_support)
+			{
+				ofs << "TexCompressor EAC_R11 temp.dds \"" << res_names[i] << "\"" << std::endl;
+			}
 			else if (caps.bc1_support)
 			{
 				ofs << "TexCompressor BC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
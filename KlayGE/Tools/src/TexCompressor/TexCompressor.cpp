@@ -11,6 +11,7 @@
 
 #include <boost/algorithm/string/case_conv.hpp>
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -89,20 +90,23 @@ namespace
 
 			case EF_ETC2_ABGR8:
 			case EF_ETC2_ABGR8_SRGB:
-				// TODO
-				BOOST_ASSERT(false);
+				in_codec = MakeUniquePtr<TexCompressionETC2RGBA8>();
 				break;
 
 			case EF_ETC2_R11:
+				in_codec = MakeUniquePtr<TexCompressionETC2R11>();
+				break;
+
 			case EF_SIGNED_ETC2_R11:
-				// TODO
-				BOOST_ASSERT(false);
+				in_codec = MakeUniquePtr<TexCompressionETC2SignedR11>();
 				break;
 
 			case EF_ETC2_GR11:
+				in_codec = MakeUniquePtr<TexCompressionETC2RG11>();
+				break;
+
 			case EF_SIGNED_ETC2_GR11:
-				// TODO
-				BOOST_ASSERT(false);
+				in_codec = MakeUniquePtr<TexCompressionETC2SignedRG11>();
 				break;
 
 			default:
@@ -173,20 +177,23 @@ namespace
 
 		case EF_ETC2_ABGR8:
 		case EF_ETC2_ABGR8_SRGB:
-			// TODO
-			BOOST_ASSERT(false);
+			out_codec = MakeUniquePtr<TexCompressionETC2RGBA8>();
 			break;
 
 		case EF_ETC2_R11:
+			out_codec = MakeUniquePtr<TexCompressionETC2R11>();
+			break;
+
 		case EF_SIGNED_ETC2_R11:
-			// TODO
-			BOOST_ASSERT(false);
+			out_codec = MakeUniquePtr<TexCompressionETC2SignedR11>();
 			break;
 
 		case EF_ETC2_GR11:
+			out_codec = MakeUniquePtr<TexCompressionETC2RG11>();
+			break;
+
 		case EF_SIGNED_ETC2_GR11:
-			// TODO
-			BOOST_ASSERT(false);
+			out_codec = MakeUniquePtr<TexCompressionETC2SignedRG11>();
 			break;
 
 		default:
@@ -198,7 +205,7 @@ namespace
 		bool const color_conversion = (MakeNonSRGB(block_in_fmt) != out_codec->DecodedFormat());
 		uint32_t const num_texels = out_codec->BlockWidth() * out_codec->BlockHeight();
 		std::vector<uint8_t> block_in_data;
-		std::vector<Color> block_in_data_f32;
+		std::vector<uint8_t> block_out_data;
 
 		while (block_index < static_cast<int>(block_addrs.size()))
 		{
@@ -242,10 +249,9 @@ namespace
 
 			if (color_conversion)
 			{
-				block_in_data_f32.resize(num_texels);
-				ConvertToABGR32F(block_in_fmt, &block_in_data[0], num_texels, &block_in_data_f32[0]);
-				block_in_data.resize(num_texels * NumFormatBytes(out_codec->DecodedFormat()));
-				ConvertFromABGR32F(out_codec->DecodedFormat(), &block_in_data_f32[0], num_texels, &block_in_data[0]);
+				block_out_data.resize(num_texels * NumFormatBytes(out_codec->DecodedFormat()));
+				ConvertFormat(block_in_fmt, &block_in_data[0], num_texels, out_codec->DecodedFormat(), &block_out_data[0]);
+				block_in_data.swap(block_out_data);
 			}
 
 			uint32_t const offset = y / out_codec->BlockHeight() * out_data[sub_res].row_pitch
@@ -337,20 +343,23 @@ namespace
 
 		case EF_ETC2_ABGR8:
 		case EF_ETC2_ABGR8_SRGB:
-			// TODO
-			BOOST_ASSERT(false);
+			out_codec = MakeUniquePtr<TexCompressionETC2RGBA8>();
 			break;
 
 		case EF_ETC2_R11:
+			out_codec = MakeUniquePtr<TexCompressionETC2R11>();
+			break;
+
 		case EF_SIGNED_ETC2_R11:
-			// TODO
-			BOOST_ASSERT(false);
+			out_codec = MakeUniquePtr<TexCompressionETC2SignedR11>();
 			break;
 
 		case EF_ETC2_GR11:
+			out_codec = MakeUniquePtr<TexCompressionETC2RG11>();
+			break;
+
 		case EF_SIGNED_ETC2_GR11:
-			// TODO
-			BOOST_ASSERT(false);
+			out_codec = MakeUniquePtr<TexCompressionETC2SignedRG11>();
 			break;
 
 		default:
@@ -438,7 +447,8 @@ namespace
 
 	void PrintSupportedFormats()
 	{
-		cout << "Supported formats: bc1, bc2, bc3, bc4, bc5, bc7, etc1" << endl;
+		cout << "Supported formats: bc1, bc2, bc3, bc4, bc5, bc6, bc6s, bc7, etc1, etc2_rgb8, etc2_rgb8a1, etc2_rgba8, "
+			<< "eac_r11, eac_r11s, eac_rg11, eac_rg11s" << endl;
 	}
 }
 
@@ -477,6 +487,14 @@ int main(int argc, char* argv[])
 	{
 		fmt = EF_BC5;
 	}
+	else if (CT_HASH("bc6") == fmt_hash)
+	{
+		fmt = EF_BC6;
+	}
+	else if (CT_HASH("bc6s") == fmt_hash)
+	{
+		fmt = EF_SIGNED_BC6;
+	}
 	else if (CT_HASH("bc7") == fmt_hash)
 	{
 		fmt = EF_BC7;
@@ -485,6 +503,34 @@ int main(int argc, char* argv[])
 	{
 		fmt = EF_ETC1;
 	}
+	else if (CT_HASH("etc2_rgb8") == fmt_hash)
+	{
+		fmt = EF_ETC2_BGR8;
+	}
+	else if (CT_HASH("etc2_rgb8a1") == fmt_hash)
+	{
+		fmt = EF_ETC2_A1BGR8;
+	}
+	else if (CT_HASH("etc2_rgba8") == fmt_hash)
+	{
+		fmt = EF_ETC2_ABGR8;
+	}
+	else if (CT_HASH("eac_r11") == fmt_hash)
+	{
+		fmt = EF_ETC2_R11;
+	}
+	else if (CT_HASH("eac_r11s") == fmt_hash)
+	{
+		fmt = EF_SIGNED_ETC2_R11;
+	}
+	else if (CT_HASH("eac_rg11") == fmt_hash)
+	{
+		fmt = EF_ETC2_GR11;
+	}
+	else if (CT_HASH("eac_rg11s") == fmt_hash)
+	{
+		fmt = EF_SIGNED_ETC2_GR11;
+	}
 	else
 	{
 		cout << "Unknown output format. ";
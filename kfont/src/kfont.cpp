@@ -46,8 +46,6 @@ namespace KlayGE
 {
 	uint32_t const KFONT_VERSION = 2;
 
-	std::mutex singleton_mutex;
-
 	typedef int (MY_STD_CALL *LzmaCompressFunc)(unsigned char* dest, size_t* destLen, unsigned char const * src, size_t srcLen,
 		unsigned char* outProps, size_t* outPropsSize, /* *outPropsSize must be = 5 */
 		int level,      /* 0 <= level <= 9, default = 5 */
@@ -65,15 +63,9 @@ namespace KlayGE
 	public:
 		static LZMALoader& Instance()
 		{
-			if (!instance_)
-			{
-				std::lock_guard<std::mutex> lock(singleton_mutex);
-				if (!instance_)
-				{
-					instance_ = MakeSharedPtr<LZMALoader>();
-				}
-			}
-			return *instance_;
+			// Fonts are loaded on the resource loading threads. A function local static is initialized exactly once.
+			static LZMALoader ret;
+			return ret;
 		}
 
 		int LzmaCompress(unsigned char* dest, size_t* destLen, unsigned char const * src, size_t srcLen,
@@ -111,10 +103,7 @@ namespace KlayGE
 #endif
 		LzmaCompressFunc lzma_compress_func_;
 		LzmaUncompressFunc lzma_uncompress_func_;
-
-		static std::shared_ptr<LZMALoader> instance_;
 	};
-	std::shared_ptr<LZMALoader> LZMALoader::instance_;
 
 	bool KFont::Load(std::string const & file_name)
 	{